@@ -0,0 +1,426 @@
+/*
+ *  autofind_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times the AutoFind downsample, PSF convolution and local maximum scan on a
+// synthetic frame:
+//
+//   direct  - the 81-tap convolution and per-peak window statistics that
+//             AutoFind used before the summed-area table kernels
+//   serial  - the summed-area table kernels in a single pass over the frame
+//   N       - the kernels split into row bands on the worker pool, N threads
+//
+// Every banded run must reproduce the serial result bit for bit, and the
+// serial result must find the same stars as the direct one. When the pixel
+// sums are exact (downsample 1 or 2) the convolved images must also match.
+// Finally the convolution alone is timed for larger PSF scales.
+//
+// usage: autofind_benchmark [width height [downsample [iterations]]]
+
+#include "autofind_kernels.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct Peak
+{
+    int x;
+    int y;
+    float val;
+
+    Peak(int x_, int y_, float val_) : x(x_), y(y_), val(val_) { }
+    bool operator<(const Peak& rhs) const { return val < rhs.val; }
+};
+
+struct Result
+{
+    std::vector<float> conv;
+    std::vector<Peak> stars; // brightest first
+};
+
+enum Mode
+{
+    DIRECT,
+    SERIAL,
+    BANDED,
+};
+
+enum
+{
+    BAND_ROWS = 32,
+    CONV_RADIUS = 4,
+    TOP_N = 100,
+};
+
+static void DirectPsfConv(float *dst, const float *src, int width, int height, int y0, int y1)
+{
+    //                       A      B1     B2    C1     C2    C3     D1     D2     D3
+    const double PSF[] = { 0.906, 0.584, 0.365, .117, .049, -0.05, -.064, -.074, -.094 };
+
+    /* PSF Grid is:
+    D3 D3 D3 D3 D3 D3 D3 D3 D3
+    D3 D3 D3 D2 D1 D2 D3 D3 D3
+    D3 D3 C3 C2 C1 C2 C3 D3 D3
+    D3 D2 C2 B2 B1 B2 C2 D2 D3
+    D3 D1 C1 B1 A  B1 C1 D1 D3
+    D3 D2 C2 B2 B1 B2 C2 D2 D3
+    D3 D3 C3 C2 C1 C2 C3 D3 D3
+    D3 D3 D3 D2 D1 D2 D3 D3 D3
+    D3 D3 D3 D3 D3 D3 D3 D3 D3
+
+    1@A
+    4@B1, B2, C1, C3, D1
+    8@C2, D2
+    44 * D3
+    */
+
+    int const psf_size = 4;
+
+    memset(dst + (size_t) width * y0, 0, (size_t) width * (y1 - y0) * sizeof(float));
+
+    // the kernel reads up to psf_size rows above and below the band
+    for (int y = std::max(y0, psf_size); y < std::min(y1, height - psf_size); y++)
+    {
+        for (int x = psf_size; x < width - psf_size; x++)
+        {
+            float A, B1, B2, C1, C2, C3, D1, D2, D3;
+
+#define PX(dx, dy) *(src + width * (y + (dy)) + x + (dx))
+            A = PX(+0, +0);
+            B1 = PX(+0, -1) + PX(+0, +1) + PX(+1, +0) + PX(-1, +0);
+            B2 = PX(-1, -1) + PX(+1, -1) + PX(-1, +1) + PX(+1, +1);
+            C1 = PX(+0, -2) + PX(-2, +0) + PX(+2, +0) + PX(+0, +2);
+            C2 = PX(-1, -2) + PX(+1, -2) + PX(-2, -1) + PX(+2, -1) + PX(-2, +1) + PX(+2, +1) + PX(-1, +2) + PX(+1, +2);
+            C3 = PX(-2, -2) + PX(+2, -2) + PX(-2, +2) + PX(+2, +2);
+            D1 = PX(+0, -3) + PX(-3, +0) + PX(+3, +0) + PX(+0, +3);
+            D2 = PX(-1, -3) + PX(+1, -3) + PX(-3, -1) + PX(+3, -1) + PX(-3, +1) + PX(+3, +1) + PX(-1, +3) + PX(+1, +3);
+            D3 = PX(-4, -2) + PX(-3, -2) + PX(+3, -2) + PX(+4, -2) + PX(-4, -1) + PX(+4, -1) + PX(-4, +0) + PX(+4, +0) +
+                PX(-4, +1) + PX(+4, +1) + PX(-4, +2) + PX(-3, +2) + PX(+3, +2) + PX(+4, +2);
+#undef PX
+            int i;
+            const float *uptr;
+
+            uptr = src + width * (y - 4) + (x - 4);
+            for (i = 0; i < 9; i++)
+                D3 += *uptr++;
+
+            uptr = src + width * (y - 3) + (x - 4);
+            for (i = 0; i < 3; i++)
+                D3 += *uptr++;
+            uptr += 3;
+            for (i = 0; i < 3; i++)
+                D3 += *uptr++;
+
+            uptr = src + width * (y + 3) + (x - 4);
+            for (i = 0; i < 3; i++)
+                D3 += *uptr++;
+            uptr += 3;
+            for (i = 0; i < 3; i++)
+                D3 += *uptr++;
+
+            uptr = src + width * (y + 4) + (x - 4);
+            for (i = 0; i < 9; i++)
+                D3 += *uptr++;
+
+            double mean = (A + B1 + B2 + C1 + C2 + C3 + D1 + D2 + D3) / 81.0;
+            double PSF_fit = PSF[0] * (A - mean) + PSF[1] * (B1 - 4.0 * mean) + PSF[2] * (B2 - 4.0 * mean) +
+                PSF[3] * (C1 - 4.0 * mean) + PSF[4] * (C2 - 8.0 * mean) + PSF[5] * (C3 - 4.0 * mean) +
+                PSF[6] * (D1 - 4.0 * mean) + PSF[7] * (D2 - 8.0 * mean) + PSF[8] * (D3 - 44.0 * mean);
+
+            dst[width * y + x] = (float) PSF_fit;
+        }
+    }
+}
+
+static void DirectLocalMaxima(std::vector<AutoFindCandidate> *out, const float *conv, int width, int left, int top, int right,
+                         int bottom, int srch, double global_stdev, double threshold, int y0, int y1)
+{
+    y0 = std::max(y0, top + srch);
+    y1 = std::min(y1, bottom - srch + 1);
+
+    for (int y = y0; y < y1; y++)
+    {
+        for (int x = left + srch; x <= right - srch; x++)
+        {
+            float val = conv[width * y + x];
+            bool ismax = false;
+            if (val > 0.0)
+            {
+                ismax = true;
+                for (int j = -srch; j <= srch; j++)
+                {
+                    for (int i = -srch; i <= srch; i++)
+                    {
+                        if (i == 0 && j == 0)
+                            continue;
+                        if (conv[width * (y + j) + (x + i)] > val)
+                        {
+                            ismax = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (!ismax)
+                continue;
+
+            // compare local maximum to mean value of surrounding pixels
+            const int local = 7;
+            int const lx0 = std::max(x - local, left);
+            int const ly0 = std::max(y - local, top);
+            int const lx1 = std::min(x + local, right);
+            int const ly1 = std::min(y + local, bottom);
+            double local_mean, local_stdev;
+            AutoFindStats(&local_mean, &local_stdev, conv, width, lx0, ly0, lx1 - lx0 + 1, ly1 - ly0 + 1);
+
+            // this is our measure of star intensity
+            double h = (val - local_mean) / global_stdev;
+
+            if (h < threshold)
+                continue;
+
+            AutoFindCandidate c;
+            c.x = x;
+            c.y = y;
+            c.val = val;
+            c.h = h;
+            out->push_back(c);
+        }
+    }
+}
+
+static void MakeFrame(std::vector<float> *frame, int width, int height, int nstars)
+{
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> noise(1000.0, 25.0);
+    std::uniform_real_distribution<double> pos(0.0, 1.0);
+
+    std::vector<double> img(width * height);
+    for (double& v : img)
+        v = noise(rng);
+
+    int const margin = 32;
+    for (int i = 0; i < nstars; i++)
+    {
+        double sx = margin + pos(rng) * (width - 2 * margin);
+        double sy = margin + pos(rng) * (height - 2 * margin);
+        double amp = 200.0 + pos(rng) * 30000.0;
+        double sigma = 1.0 + pos(rng) * 2.0;
+
+        for (int y = (int) sy - 12; y <= (int) sy + 12; y++)
+            for (int x = (int) sx - 12; x <= (int) sx + 12; x++)
+            {
+                double dx = x - sx, dy = y - sy;
+                img[y * width + x] += amp * exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+            }
+    }
+
+    frame->resize(img.size());
+    for (size_t i = 0; i < img.size(); i++)
+        (*frame)[i] = (float) (unsigned short) std::min(65535.0, std::max(0.0, img[i]));
+}
+
+static void Rows(Mode mode, int y0, int y1, const std::function<void(int, int)>& fn)
+{
+    if (mode == BANDED)
+        WorkerPool::RunRows(y0, y1, BAND_ROWS, fn);
+    else
+        fn(y0, y1);
+}
+
+static void RunAutoFind(Result *r, Mode mode, const std::vector<float>& frame, int width, int height, int ds)
+{
+    std::vector<float> tmp;
+    const float *src = frame.data();
+    if (ds > 1)
+    {
+        int const w = width;
+        int dw = width / ds, dh = height / ds;
+        tmp.resize(dw * dh);
+        Rows(mode, 0, dh, [&](int y0, int y1) { AutoFindDownsample(tmp.data(), dw, frame.data(), w, ds, y0, y1); });
+        src = tmp.data();
+        width = dw;
+        height = dh;
+    }
+
+    r->conv.resize(width * height);
+    Rows(mode, 0, height, [&](int y0, int y1) {
+        if (mode == DIRECT)
+            DirectPsfConv(r->conv.data(), src, width, height, y0, y1);
+        else
+            AutoFindPsfConv(r->conv.data(), src, width, height, 1, y0, y1);
+    });
+
+    int const left = CONV_RADIUS, top = CONV_RADIUS, right = width - CONV_RADIUS - 1, bottom = height - CONV_RADIUS - 1;
+    double mean, stdev;
+    AutoFindStats(&mean, &stdev, r->conv.data(), width, left, top, right - left + 1, bottom - top + 1);
+
+    int const srch = 4;
+    int const scanTop = top + srch;
+    int const scanBottom = bottom - srch + 1;
+    int const nbands = mode == BANDED ? WorkerPool::BandCount(scanBottom - scanTop, BAND_ROWS) : 1;
+    std::vector<std::vector<AutoFindCandidate>> candidates(nbands);
+
+    auto scan = [&](int band) {
+        int y0 = scanTop + (int) ((long long) (scanBottom - scanTop) * band / nbands);
+        int y1 = scanTop + (int) ((long long) (scanBottom - scanTop) * (band + 1) / nbands);
+        if (mode == DIRECT)
+            DirectLocalMaxima(&candidates[band], r->conv.data(), width, left, top, right, bottom, srch, stdev, 0.1, y0, y1);
+        else
+            AutoFindLocalMaxima(&candidates[band], r->conv.data(), width, left, top, right, bottom, srch, stdev, 0.1, y0, y1);
+    };
+    if (mode == BANDED)
+        WorkerPool::Run(nbands, scan);
+    else
+        scan(0);
+
+    std::set<Peak> stars;
+    for (const auto& band : candidates)
+        for (const auto& c : band)
+        {
+            stars.insert(Peak(c.x * ds + ds / 2, c.y * ds + ds / 2, c.h));
+            if (stars.size() > TOP_N)
+                stars.erase(stars.begin());
+        }
+
+    r->stars.assign(stars.rbegin(), stars.rend());
+}
+
+static bool SameConv(const Result& a, const Result& b)
+{
+    return a.conv.size() == b.conv.size() && memcmp(a.conv.data(), b.conv.data(), a.conv.size() * sizeof(float)) == 0;
+}
+
+// same stars in the same order; the intensities must agree to within tol
+static bool SameStars(const Result& a, const Result& b, double tol)
+{
+    if (a.stars.size() != b.stars.size())
+        return false;
+    for (size_t i = 0; i < a.stars.size(); i++)
+        if (a.stars[i].x != b.stars[i].x || a.stars[i].y != b.stars[i].y ||
+            fabs(a.stars[i].val - b.stars[i].val) > tol * fabs(b.stars[i].val))
+            return false;
+    return true;
+}
+
+template<typename F>
+static double TimeMs(int iterations, F fn)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int width = argc > 2 ? atoi(argv[1]) : 3000;
+    int height = argc > 2 ? atoi(argv[2]) : 2000;
+    int ds = argc > 3 ? atoi(argv[3]) : 1;
+    int iterations = argc > 4 ? atoi(argv[4]) : 5;
+    if (width < 64 || height < 64 || ds < 1 || ds > 4 || iterations < 1)
+    {
+        fprintf(stderr, "usage: autofind_benchmark [width height [downsample [iterations]]]\n");
+        return 2;
+    }
+
+    std::vector<float> frame;
+    MakeFrame(&frame, width, height, width * height / 20000);
+
+    Result direct, serial;
+    RunAutoFind(&direct, DIRECT, frame, width, height, ds);
+    RunAutoFind(&serial, SERIAL, frame, width, height, ds);
+
+    bool const exactSums = ds <= 2;
+    bool allMatch = SameStars(serial, direct, 1e-5) && (!exactSums || SameConv(serial, direct));
+
+    printf("AutoFind %dx%d, downsample %d, %zu stars, %d iterations\n\n", width, height, ds, serial.stars.size(), iterations);
+    printf("%8s  %10s  %8s  %8s\n", "threads", "ms", "speedup", "match");
+
+    double base = TimeMs(iterations, [&] {
+        Result r;
+        RunAutoFind(&r, DIRECT, frame, width, height, ds);
+    });
+    printf("%8s  %10.2f  %8.2f  %8s\n", "direct", base, 1.0, "-");
+
+    double ms = TimeMs(iterations, [&] {
+        Result r;
+        RunAutoFind(&r, SERIAL, frame, width, height, ds);
+    });
+    printf("%8s  %10.2f  %8.2f  %8s\n", "serial", ms, base / ms, allMatch ? "yes" : "NO");
+
+    unsigned int const hw = std::max(std::thread::hardware_concurrency(), 1U);
+
+    for (unsigned int n = 1; n <= hw; n = n < hw && n * 2 > hw ? hw : n * 2)
+    {
+        WorkerPool::Init(n);
+
+        Result r;
+        RunAutoFind(&r, BANDED, frame, width, height, ds);
+        bool match = SameConv(r, serial) && SameStars(r, serial, 0.0);
+        allMatch = allMatch && match;
+
+        ms = TimeMs(iterations, [&] {
+            Result r;
+            RunAutoFind(&r, BANDED, frame, width, height, ds);
+        });
+        printf("%8u  %10.2f  %8.2f  %8s\n", n, ms, base / ms, match ? "yes" : "NO");
+
+        if (n == hw)
+            break;
+    }
+
+    WorkerPool::Destroy();
+
+    // the cost of the convolution should not grow with the PSF scale
+    printf("\n%8s  %10s\n", "scale", "conv ms");
+    std::vector<float> conv(frame.size());
+    ms = TimeMs(iterations, [&] { DirectPsfConv(conv.data(), frame.data(), width, height, 0, height); });
+    printf("%8s  %10.2f\n", "direct", ms);
+    for (int scale = 1; scale <= 7; scale += 2)
+    {
+        ms = TimeMs(iterations, [&] { AutoFindPsfConv(conv.data(), frame.data(), width, height, scale, 0, height); });
+        printf("%8d  %10.2f\n", scale, ms);
+    }
+
+    return allMatch ? 0 : 1;
+}
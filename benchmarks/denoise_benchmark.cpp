@@ -0,0 +1,524 @@
+/*
+ *  denoise_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times the noise reduction filters and the frame statistics on synthetic
+// frames of 1 to 60 megapixels:
+//
+//   ref     - the scalar Median3 and QuickLRecon loops that image_math.cpp
+//             used before the denoise kernels, and the copy, 65536-bin
+//             histogram and filtered copy that usImage::CalcStats made
+//   <level> - the denoise kernels at each SIMD level, on a single thread
+//   N       - the kernels at the best SIMD level split into row bands on
+//             the worker pool, N threads
+//
+// Every run must reproduce the reference results bit for bit.
+//
+// usage: denoise_benchmark [megapixels [iterations]]
+
+#include "denoise_kernels.h"
+#include "simd.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/*************      reference implementation      **************************/
+
+static inline void Swap(unsigned short& a, unsigned short& b)
+{
+    unsigned short const t = a;
+    a = b;
+    b = t;
+}
+
+static inline unsigned short median9(const unsigned short l[9])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3], l4 = l[4];
+    unsigned short x;
+    x = l[5];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+    x = l[6];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+    x = l[7];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+    x = l[8];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+
+    if (l1 > l0)
+        l0 = l1;
+    if (l2 > l0)
+        l0 = l2;
+    if (l3 > l0)
+        l0 = l3;
+    if (l4 > l0)
+        l0 = l4;
+
+    return l0;
+}
+
+
+static inline unsigned short median6(const unsigned short l[6])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3];
+    unsigned short x;
+
+    x = l[4];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    x = l[5];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+
+    if (l2 > l0)
+        Swap(l2, l0);
+    if (l2 > l1)
+        Swap(l2, l1);
+
+    if (l3 > l0)
+        Swap(l3, l0);
+    if (l3 > l1)
+        Swap(l3, l1);
+
+    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
+}
+
+
+static inline unsigned short median4(const unsigned short l[4])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
+    unsigned short x;
+    x = l[3];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+
+    if (l2 > l0)
+        Swap(l2, l0);
+    if (l2 > l1)
+        Swap(l2, l1);
+
+    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
+}
+
+
+static void RefMedian3(unsigned short *dst, const unsigned short *src, int W, int H)
+{
+    int const RX = 0;
+    int const RY = 0;
+    int const RW = W;
+    int const RH = H;
+
+    unsigned short a[9];
+    unsigned short *d;
+
+#define IX(x_, y_) ((RY + (y_)) * W + RX + (x_))
+
+    // top row
+    d = &dst[IX(0, 0)];
+
+    // top-left corner
+    a[0] = src[IX(0, 0)];
+    a[1] = src[IX(1, 0)];
+    a[2] = src[IX(0, 1)];
+    a[3] = src[IX(1, 1)];
+    *d++ = median4(a);
+
+    // top row middle pixels
+    for (int x = 1; x <= RW - 2; x++)
+    {
+        a[0] = src[IX(x - 1, 0)];
+        a[1] = src[IX(x, 0)];
+        a[2] = src[IX(x + 1, 0)];
+        a[3] = src[IX(x - 1, 1)];
+        a[4] = src[IX(x, 1)];
+        a[5] = src[IX(x + 1, 1)];
+        *d++ = median6(a);
+    }
+
+    // top-right corner
+    a[0] = src[IX(RW - 2, 0)];
+    a[1] = src[IX(RW - 1, 0)];
+    a[2] = src[IX(RW - 2, 1)];
+    a[3] = src[IX(RW - 1, 1)];
+    *d = median4(a);
+
+    for (int y = 1; y <= RH - 2; y++)
+    {
+        d = &dst[IX(0, y)];
+
+        // leftmost pixel
+        a[0] = src[IX(0, y - 1)];
+        a[1] = src[IX(1, y - 1)];
+        a[2] = src[IX(0, y)];
+        a[3] = src[IX(1, y)];
+        a[4] = src[IX(0, y + 1)];
+        a[5] = src[IX(1, y + 1)];
+        *d++ = median6(a);
+
+        for (int x = 1; x <= RW - 2; x++)
+        {
+            a[0] = src[IX(x - 1, y - 1)];
+            a[1] = src[IX(x, y - 1)];
+            a[2] = src[IX(x + 1, y - 1)];
+            a[3] = src[IX(x - 1, y)];
+            a[4] = src[IX(x, y)];
+            a[5] = src[IX(x + 1, y)];
+            a[6] = src[IX(x - 1, y + 1)];
+            a[7] = src[IX(x, y + 1)];
+            a[8] = src[IX(x + 1, y + 1)];
+            *d++ = median9(a);
+        }
+
+        // rightmost pixel
+        a[0] = src[IX(RW - 2, y - 1)];
+        a[1] = src[IX(RW - 1, y - 1)];
+        a[2] = src[IX(RW - 2, y)];
+        a[3] = src[IX(RW - 1, y)];
+        a[4] = src[IX(RW - 2, y + 1)];
+        a[5] = src[IX(RW - 1, y + 1)];
+        *d++ = median6(a);
+    }
+
+    // bottom row
+    d = &dst[IX(0, RH - 1)];
+
+    // bottom-left corner
+    a[0] = src[IX(0, RH - 2)];
+    a[1] = src[IX(1, RH - 2)];
+    a[2] = src[IX(0, RH - 1)];
+    a[3] = src[IX(1, RH - 1)];
+    *d++ = median4(a);
+
+    // bottom row middle pixels
+    for (int x = 1; x <= RW - 2; x++)
+    {
+        a[0] = src[IX(x - 1, RH - 2)];
+        a[1] = src[IX(x, RH - 2)];
+        a[2] = src[IX(x + 1, RH - 2)];
+        a[3] = src[IX(x - 1, RH - 1)];
+        a[4] = src[IX(x, RH - 1)];
+        a[5] = src[IX(x + 1, RH - 1)];
+        *d++ = median6(a);
+    }
+
+    // bottom-right corner
+    a[0] = src[IX(RW - 2, RH - 2)];
+    a[1] = src[IX(RW - 1, RH - 2)];
+    a[2] = src[IX(RW - 2, RH - 1)];
+    a[3] = src[IX(RW - 1, RH - 1)];
+    *d = median4(a);
+
+#undef IX
+}
+static void RefLRecon(unsigned short *dst, const unsigned short *src, int W, int H)
+{
+    int const RX = 0, RY = 0, RW = W, RH = H;
+
+#define IX(x_, y_) ((RY + (y_)) * W + RX + (x_))
+
+    unsigned short *d;
+    unsigned int t;
+
+    for (int y = 0; y <= RH - 2; y++)
+    {
+        d = &dst[IX(0, y)];
+
+        for (int x = 0; x <= RW - 2; x++)
+        {
+            t = src[IX(x, y)];
+            t += src[IX(x + 1, y)];
+            t += src[IX(x, y + 1)];
+            t += src[IX(x + 1, y + 1)];
+            *d++ = (unsigned short) (t >> 2);
+        }
+
+        // last col
+        t = src[IX(RW - 1, y)];
+        t += src[IX(RW - 1, y + 1)];
+        *d = (unsigned short) (t >> 1);
+    }
+
+    // last row
+
+    d = &dst[IX(0, RH - 1)];
+
+    for (int x = 0; x <= RW - 2; x++)
+    {
+        t = src[IX(x, RH - 1)];
+        t += src[IX(x + 1, RH - 1)];
+        *d++ = (unsigned short) (t >> 1);
+    }
+
+    // bottom-right pixel
+    *d = src[IX(RW - 1, RH - 1)];
+
+#undef IX
+}
+
+static void RefStats(DenoiseStats *stats, const unsigned short *src, int W, int H)
+{
+    size_t const n = (size_t) W * H;
+
+    std::vector<unsigned short> copy(src, src + n);
+    std::vector<int> histo(65536);
+    unsigned short mn = 65535, mx = 0;
+    for (unsigned short v : copy)
+    {
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+        histo[v]++;
+    }
+    stats->minADU = mn;
+    stats->maxADU = mx;
+
+    stats->medianADU = mx;
+    size_t left = n / 2;
+    for (int i = mn; i < mx; i++)
+    {
+        if ((size_t) histo[i] > left)
+        {
+            stats->medianADU = i;
+            break;
+        }
+        left -= histo[i];
+    }
+
+    std::vector<unsigned short> filtered(n);
+    RefMedian3(filtered.data(), copy.data(), W, H);
+    stats->filtMin = *std::min_element(filtered.begin(), filtered.end());
+    stats->filtMax = *std::max_element(filtered.begin(), filtered.end());
+}
+
+/*************      benchmark      **************************/
+
+struct Result
+{
+    std::vector<unsigned short> median;
+    std::vector<unsigned short> lrecon;
+    DenoiseStats stats;
+};
+
+static void MakeFrame(std::vector<unsigned short> *frame, int width, int height)
+{
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> noise(1000.0, 25.0);
+    std::uniform_real_distribution<double> pos(0.0, 1.0);
+
+    frame->resize((size_t) width * height);
+    for (unsigned short& v : *frame)
+        v = (unsigned short) std::max(0.0, noise(rng));
+
+    // stars
+    int const nstars = (int) ((size_t) width * height / 20000);
+    for (int i = 0; i < nstars; i++)
+    {
+        double sx = 16 + pos(rng) * (width - 32);
+        double sy = 16 + pos(rng) * (height - 32);
+        double amp = 200.0 + pos(rng) * 50000.0;
+        double sigma = 1.0 + pos(rng) * 2.0;
+
+        for (int y = (int) sy - 8; y <= (int) sy + 8; y++)
+            for (int x = (int) sx - 8; x <= (int) sx + 8; x++)
+            {
+                double dx = x - sx, dy = y - sy;
+                double v = (*frame)[(size_t) y * width + x] + amp * exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+                (*frame)[(size_t) y * width + x] = (unsigned short) std::min(65535.0, v);
+            }
+    }
+
+    // hot pixels
+    for (int i = 0; i < nstars; i++)
+        (*frame)[(size_t) (pos(rng) * (height - 1)) * width + (size_t) (pos(rng) * (width - 1))] = 65535;
+}
+
+template<typename F>
+static double TimeMs(int iterations, F fn)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+static bool Same(const Result& a, const Result& b)
+{
+    return a.median == b.median && a.lrecon == b.lrecon && memcmp(&a.stats, &b.stats, sizeof(a.stats)) == 0;
+}
+
+static void PrintRow(const char *name, const double ms[3], const double base[3], const char *match)
+{
+    printf("%8s  %10.2f %6.1fx  %10.2f %6.1fx  %10.2f %6.1fx  %6s\n", name, ms[0], base[0] / ms[0], ms[1], base[1] / ms[1],
+           ms[2], base[2] / ms[2], match);
+}
+
+// time the kernels with the current SIMD level and worker pool; returns true if the results match ref
+static bool RunKernels(double ms[3], const std::vector<unsigned short>& frame, int width, int height, int iterations,
+                       const Result& ref)
+{
+    Result r;
+    r.median.resize(frame.size());
+    r.lrecon.resize(frame.size());
+
+    ms[0] = TimeMs(iterations, [&] { DenoiseMedian3(r.median.data(), width, frame.data(), width, width, height); });
+    ms[1] = TimeMs(iterations, [&] { DenoiseLRecon(r.lrecon.data(), width, frame.data(), width, width, height); });
+    ms[2] = TimeMs(iterations, [&] { DenoiseImageStats(&r.stats, frame.data(), width, width, height); });
+
+    return Same(r, ref);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<double> sizes = { 1.0, 8.0, 24.0, 60.0 };
+    if (argc > 1)
+        sizes.assign(1, atof(argv[1]));
+    int iterations = argc > 2 ? atoi(argv[2]) : 3;
+    if (sizes[0] < 0.01 || sizes[0] > 200.0 || iterations < 1)
+    {
+        fprintf(stderr, "usage: denoise_benchmark [megapixels [iterations]]\n");
+        return 2;
+    }
+
+    unsigned int const hw = std::max(std::thread::hardware_concurrency(), 1U);
+    SimdLevel const best = SimdDetect();
+    bool allMatch = true;
+
+    printf("Noise reduction and frame statistics, %d iterations, best SIMD level %s, %u hardware threads\n",
+           iterations, SimdLevelName(best), hw);
+
+    for (double mp : sizes)
+    {
+        // 4:3 frame
+        int const width = (int) sqrt(mp * 1e6 * 4.0 / 3.0);
+        int const height = (int) (mp * 1e6 / width);
+
+        std::vector<unsigned short> frame;
+        MakeFrame(&frame, width, height);
+
+        printf("\n%dx%d (%.1f MP)\n", width, height, (double) width * height / 1e6);
+        printf("%8s  %10s %7s  %10s %7s  %10s %7s  %6s\n", "", "median ms", "", "lrecon ms", "", "stats ms", "", "match");
+
+        Result ref;
+        ref.median.resize(frame.size());
+        ref.lrecon.resize(frame.size());
+        double base[3];
+        base[0] = TimeMs(iterations, [&] { RefMedian3(ref.median.data(), frame.data(), width, height); });
+        base[1] = TimeMs(iterations, [&] { RefLRecon(ref.lrecon.data(), frame.data(), width, height); });
+        base[2] = TimeMs(iterations, [&] { RefStats(&ref.stats, frame.data(), width, height); });
+        PrintRow("ref", base, base, "-");
+
+        double ms[3];
+        for (int l = SIMD_NONE; l <= best; l++)
+        {
+            SimdSetLevel((SimdLevel) l);
+            bool match = RunKernels(ms, frame, width, height, iterations, ref);
+            allMatch = allMatch && match;
+            PrintRow(SimdLevelName((SimdLevel) l), ms, base, match ? "yes" : "NO");
+        }
+
+        for (unsigned int n = 2; n <= hw; n = n < hw && n * 2 > hw ? hw : n * 2)
+        {
+            WorkerPool::Init(n);
+
+            bool match = RunKernels(ms, frame, width, height, iterations, ref);
+            allMatch = allMatch && match;
+            char name[16];
+            snprintf(name, sizeof(name), "%u", n);
+            PrintRow(name, ms, base, match ? "yes" : "NO");
+
+            WorkerPool::Destroy();
+            if (n == hw)
+                break;
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
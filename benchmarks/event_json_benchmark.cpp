@@ -0,0 +1,247 @@
+/*
+ *  event_json_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times the encoding of GuideStep events for the event server and counts the
+// heap allocations per event. The JsonWriter encoder, reusing its buffer, is
+// compared with building the event from one formatted string per field as the
+// event server used to do (with std::string standing in for wxString). Both
+// must produce the same text.
+//
+// usage: event_json_benchmark [events]
+
+#include "json_writer.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static std::atomic<unsigned long long> s_allocs(0);
+
+void *operator new(size_t n)
+{
+    ++s_allocs;
+    if (void *p = malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// the fields of a GuideStep event
+struct Step
+{
+    unsigned int frame;
+    double time;
+    double dx, dy;
+    double raRaw, decRaw;
+    double raGuide, decGuide;
+    int raDuration;
+    int decDuration;
+    double mass, snr, hfd, avgDist;
+};
+
+static const char *const HOST = "observatory-pc";
+static const char *const MOUNT = "On Camera";
+
+// previous scheme: every value is formatted into its own string and appended
+// to the event text, which is copied again to terminate the message
+struct FieldEncoder
+{
+    std::string m_s;
+    bool m_first;
+
+    FieldEncoder() : m_s("{"), m_first(true) { }
+
+    FieldEncoder& nv(const std::string& n, const std::string& v)
+    {
+        if (m_first)
+            m_first = false;
+        else
+            m_s += ',';
+        m_s += '"' + n + "\":" + v;
+        return *this;
+    }
+    static std::string fmt(const char *f, double v, int prec)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), f, prec, v);
+        return buf;
+    }
+    static std::string str(const std::string& s) { return '"' + s + '"'; }
+    static std::string num(long long v) { return std::to_string(v); }
+};
+
+static std::string EncodeFields(const Step& s, double now)
+{
+    FieldEncoder e;
+    e.nv("Event", FieldEncoder::str("GuideStep"))
+        .nv("Timestamp", FieldEncoder::fmt("%.*f", now, 3))
+        .nv("Host", FieldEncoder::str(HOST))
+        .nv("Inst", FieldEncoder::num(1))
+        .nv("Frame", FieldEncoder::num(s.frame))
+        .nv("Time", FieldEncoder::fmt("%.*f", s.time, 3))
+        .nv("Mount", FieldEncoder::str(MOUNT))
+        .nv("dx", FieldEncoder::fmt("%.*f", s.dx, 3))
+        .nv("dy", FieldEncoder::fmt("%.*f", s.dy, 3))
+        .nv("RADistanceRaw", FieldEncoder::fmt("%.*f", s.raRaw, 3))
+        .nv("DECDistanceRaw", FieldEncoder::fmt("%.*f", s.decRaw, 3))
+        .nv("RADistanceGuide", FieldEncoder::fmt("%.*f", s.raGuide, 3))
+        .nv("DECDistanceGuide", FieldEncoder::fmt("%.*f", s.decGuide, 3))
+        .nv("RADuration", FieldEncoder::num(s.raDuration))
+        .nv("RADirection", FieldEncoder::str("West"))
+        .nv("DECDuration", FieldEncoder::num(s.decDuration))
+        .nv("DECDirection", FieldEncoder::str("North"))
+        .nv("StarMass", FieldEncoder::fmt("%.*f", s.mass, 0))
+        .nv("SNR", FieldEncoder::fmt("%.*f", s.snr, 2))
+        .nv("HFD", FieldEncoder::fmt("%.*f", s.hfd, 2))
+        .nv("AvgDist", FieldEncoder::fmt("%.*f", s.avgDist, 2));
+    return e.m_s + "}" + "\r\n";
+}
+
+static void EncodeWriter(JsonWriter& w, const Step& s, double now)
+{
+    w.Clear();
+    w.BeginObject();
+    w.Key("Event").String("GuideStep");
+    w.Key("Timestamp").Fixed(now, 3);
+    w.Key("Host").String(HOST);
+    w.Key("Inst").Int(1);
+    w.Key("Frame").UInt(s.frame);
+    w.Key("Time").Fixed(s.time, 3);
+    w.Key("Mount").String(MOUNT);
+    w.Key("dx").Fixed(s.dx, 3);
+    w.Key("dy").Fixed(s.dy, 3);
+    w.Key("RADistanceRaw").Fixed(s.raRaw, 3);
+    w.Key("DECDistanceRaw").Fixed(s.decRaw, 3);
+    w.Key("RADistanceGuide").Fixed(s.raGuide, 3);
+    w.Key("DECDistanceGuide").Fixed(s.decGuide, 3);
+    w.Key("RADuration").Int(s.raDuration);
+    w.Key("RADirection").String("West");
+    w.Key("DECDuration").Int(s.decDuration);
+    w.Key("DECDirection").String("North");
+    w.Key("StarMass").Fixed(s.mass, 0);
+    w.Key("SNR").Fixed(s.snr, 2);
+    w.Key("HFD").Fixed(s.hfd, 2);
+    w.Key("AvgDist").Fixed(s.avgDist, 2);
+    w.EndObject();
+    w.EndLine();
+}
+
+int main(int argc, char **argv)
+{
+    int events = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (events < 1)
+        events = 1;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> offset(-3.0, 3.0);
+
+    std::vector<Step> steps(1024);
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        Step& s = steps[i];
+        s.frame = (unsigned int) i + 1;
+        s.time = 2.0 * i + offset(rng);
+        s.dx = offset(rng);
+        s.dy = offset(rng);
+        s.raRaw = offset(rng);
+        s.decRaw = offset(rng);
+        s.raGuide = 0.7 * s.raRaw;
+        s.decGuide = 0.7 * s.decRaw;
+        s.raDuration = (int) (200 * (3.0 + offset(rng)));
+        s.decDuration = (int) (150 * (3.0 + offset(rng)));
+        s.mass = 20000 + 1000 * offset(rng);
+        s.snr = 40 + offset(rng);
+        s.hfd = 2.5 + 0.1 * offset(rng);
+        s.avgDist = 0.5 + 0.1 * offset(rng);
+    }
+    double const now = 1789000000.123;
+
+    printf("GuideStep event encoding, %d events\n\n", events);
+    printf("%14s  %14s  %14s  %8s\n", "encoder", "events/s", "allocs/event", "match");
+
+    bool match = true;
+    size_t bytes = 0;
+
+    // per-field strings
+    unsigned long long a0 = s_allocs;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < events; i++)
+    {
+        std::string msg = EncodeFields(steps[i & 1023], now);
+        bytes += msg.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    unsigned long long allocs = s_allocs - a0;
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    printf("%14s  %14.0f  %14.2f  %8s\n", "per-field", events / secs, (double) allocs / events, "-");
+
+    // streaming writer with a reused buffer
+    JsonWriter w;
+    EncodeWriter(w, steps[0], now); // the buffer grows once
+    a0 = s_allocs;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < events; i++)
+    {
+        EncodeWriter(w, steps[i & 1023], now);
+        bytes += w.Size();
+    }
+    t1 = std::chrono::steady_clock::now();
+    allocs = s_allocs - a0;
+    secs = std::chrono::duration<double>(t1 - t0).count();
+
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        EncodeWriter(w, steps[i], now);
+        if (w.Str() != EncodeFields(steps[i], now))
+            match = false;
+    }
+    printf("%14s  %14.0f  %14.2f  %8s\n", "JsonWriter", events / secs, (double) allocs / events, match ? "yes" : "NO");
+
+    printf("\n%zu bytes encoded\n", bytes);
+
+    return match ? 0 : 1;
+}
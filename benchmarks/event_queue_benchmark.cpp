@@ -0,0 +1,153 @@
+/*
+ *  event_queue_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times queueing events for an event server client that has stopped reading,
+// and checks the drop policy: the frame rate events (GuideStep,
+// LoopingExposures, Settling) are coalesced and then dropped once the queue is
+// above the high-water mark, while every other event, e.g. StarLost, stays
+// queued until the hard limit disconnects the client.
+//
+// usage: event_queue_benchmark [events]
+
+#include "event_queue.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+static std::string Event(const char *name, unsigned int frame)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"Event\":\"%s\",\"Timestamp\":1789000000.123,\"Host\":\"observatory-pc\",\"Inst\":1,\"Frame\":%u,"
+             "\"StarMass\":20000,\"SNR\":40.00,\"HFD\":2.50}\r\n",
+             name, frame);
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    int events = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (events < 1)
+        events = 1;
+
+    size_t const highWater = 4 * 1024;
+    size_t const hardLimit = 16 * highWater;
+
+    static const char *const NAMES[] = { "GuideStep", "LoopingExposures", "Settling", "StarLost" };
+    enum
+    {
+        STAR_LOST = 3,
+        STAR_LOST_EVERY = 100,
+    };
+
+    bool ok = true;
+
+    if (EventMsgClass("GuideStep") != MSG_GUIDE_STEP || EventMsgClass("LoopingExposures") != MSG_LOOPING ||
+        EventMsgClass("Settling") != MSG_SETTLING || EventMsgClass("StarLost") != MSG_RELIABLE)
+    {
+        printf("wrong event classes\n");
+        ok = false;
+    }
+
+    // a stalled client: nothing is ever written, the first message is part sent
+    EventQueue q;
+    q.Push(Event("Version", 0), MSG_RELIABLE);
+    q.sent = 10;
+
+    unsigned int starLost = 0;
+    unsigned int starLostQueued = 0;
+    bool overflowed = false;
+
+    auto t0 = std::chrono::steady_clock::now();
+    int i;
+    for (i = 0; i < events && !overflowed; i++)
+    {
+        unsigned int const kind = i % STAR_LOST_EVERY == STAR_LOST_EVERY - 1 ? (unsigned int) STAR_LOST : i % 3;
+        const char *name = NAMES[kind];
+
+        EventQueue::AddResult r = q.Add(Event(name, i), EventMsgClass(name), highWater, hardLimit);
+        if (kind == STAR_LOST)
+        {
+            ++starLost;
+            if (r == EventQueue::ADD_QUEUED)
+                ++starLostQueued;
+            else if (r == EventQueue::ADD_DROPPED)
+            {
+                printf("StarLost event %u dropped\n", starLost);
+                ok = false;
+            }
+        }
+        if (r == EventQueue::ADD_OVERFLOW)
+            overflowed = true;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    // every StarLost before the overflow is still queued, and at most one of each frame rate event
+    unsigned int frameEvents[3] = { 0, 0, 0 };
+    unsigned int starLostInQueue = 0;
+    for (std::deque<OutMsg>::const_iterator it = q.msgs.begin(); it != q.msgs.end(); ++it)
+    {
+        if (it->cls != MSG_RELIABLE)
+            ++frameEvents[it->cls - MSG_GUIDE_STEP];
+        else if (it->data.find("\"StarLost\"") != std::string::npos)
+            ++starLostInQueue;
+    }
+    if (starLostInQueue != starLostQueued)
+    {
+        printf("%u StarLost events queued, %u in the queue\n", starLostQueued, starLostInQueue);
+        ok = false;
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        if (frameEvents[k] > 1)
+        {
+            printf("%u %s events in the queue\n", frameEvents[k], NAMES[k]);
+            ok = false;
+        }
+    }
+    if (events >= (int) (hardLimit / Event("StarLost", 0).size()) * STAR_LOST_EVERY && !overflowed)
+    {
+        printf("queue did not overflow\n");
+        ok = false;
+    }
+
+    printf("stalled client, %d events queued in %.1f ms, %.0f events/s\n", i, secs * 1e3, i / secs);
+    printf("%u StarLost events, %zu messages and %zu bytes queued, %u events dropped%s\n", starLost, q.msgs.size(),
+           q.queued, q.dropped, overflowed ? ", overflowed" : "");
+    printf("drop policy %s\n", ok ? "ok" : "FAILED");
+
+    return ok ? 0 : 1;
+}
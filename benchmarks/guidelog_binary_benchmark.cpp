@@ -0,0 +1,427 @@
+/*
+ *  guidelog_binary_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times the guide log formats on a synthetic log of several guiding sessions:
+// formatting a guide step line with printf, as GuidingLog used to, and with
+// the formatter shared by the text and binary logs; summarizing the sessions
+// by scanning the text log line by line, as the log upload dialog does, and
+// from the binary log, both from its index and record by record as after a
+// crash; and converting the binary log to text. The converted text must be
+// identical to the text log and the summaries must agree.
+//
+// usage: guidelog_binary_benchmark [steps]
+
+#include "guidelog_binary.h"
+
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+enum
+{
+    SESSIONS = 10,
+};
+
+// seconds since the epoch for a UTC calendar date
+static int64_t DaysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = (int) (y - era * 400);
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static std::string FormatTime(int64_t t)
+{
+    int64_t days = t / 86400;
+    int secs = (int) (t % 86400);
+    // civil from days
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = (int) (z - era * 146097);
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp + (mp < 10 ? 3 : -9);
+    int y = (int) (yoe + era * 400) + (m <= 2);
+    // room for six full-width ints and the separators
+    char buf[6 * 11 + 6];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", y, m, d, secs / 3600, secs / 60 % 60, secs % 60);
+    return buf;
+}
+
+static int64_t ParseTime(const char *s)
+{
+    int y, mo, d, h, mi, sec;
+    if (sscanf(s, "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &sec) != 6)
+        return -1;
+    return DaysFromCivil(y, mo, d) * 86400 + h * 3600 + mi * 60 + sec;
+}
+
+// the same guide log written as text and as binary records
+struct LogWriter
+{
+    std::string text;
+    GuideLogBinaryEncoder bin;
+    FILE *binFile;
+
+    void Text(const std::string& s)
+    {
+        text += s;
+        bin.Text(s.data(), s.size());
+    }
+    void Step(const GuideLogStep& step)
+    {
+        GuideLogFormatStep(text, step);
+        bin.Step(step);
+    }
+    void Drop(const GuideLogDrop& drop, const char *status)
+    {
+        GuideLogFormatDrop(text, drop, status, strlen(status));
+        bin.Drop(drop, status, strlen(status));
+    }
+    void Mark(GuideLogMark mark, int64_t t) { bin.Mark(mark, t); }
+    void WriteBinary()
+    {
+        std::string& buf = bin.Buffer();
+        fwrite(buf.data(), 1, buf.size(), binFile);
+        buf.clear();
+    }
+};
+
+static void WriteSession(LogWriter& log, std::mt19937& rng, int64_t& now, int& frame, int steps)
+{
+    std::uniform_real_distribution<double> offset(-1.5, 1.5);
+
+    log.Text("\nCalibration Begins at " + FormatTime(now) + "\n");
+    log.Text("Equipment Profile = Observatory\nMount = On Camera, Calibration Step = 1200 ms\n");
+    log.Text("Direction,Step,dx,dy,x,y,Dist\n");
+    log.Mark(GLOG_CALIBRATION_BEGINS, now);
+    for (int i = 0; i < 24; i++)
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "West,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", i, 1.2 * i, 0.1 * i, 512 + 1.2 * i, 384.,
+                 1.2 * i);
+        log.Text(buf);
+    }
+    now += 120;
+    log.Text("Calibration complete, mount = On Camera.\n");
+    log.Mark(GLOG_CALIBRATION_COMPLETE, now);
+
+    log.Text("\nGuiding Begins at " + FormatTime(now) + "\n");
+    log.Text("Frame,Time,mount,dx,dy,RARawDistance,DECRawDistance,RAGuideDistance,DECGuideDistance,"
+             "RADuration,RADirection,DECDuration,DECDirection,XStep,YStep,StarMass,SNR,ErrorCode\n");
+    log.Mark(GLOG_GUIDING_BEGINS, now);
+
+    double t = 0.;
+    for (int i = 0; i < steps; i++)
+    {
+        t += 2.0 + 0.01 * offset(rng);
+        if (i % 997 == 500)
+        {
+            GuideLogDrop drop = { t, 18000 + 1000 * offset(rng), 30 + offset(rng), ++frame, 2 };
+            log.Drop(drop, "Star lost - mass changed");
+            continue;
+        }
+        if (i % 1500 == 700)
+            log.Text("INFO: DITHER by 3.000, -2.000, new lock pos = 515.000, 382.000\n");
+
+        GuideLogStep s;
+        memset(&s, 0, sizeof(s));
+        s.frameNumber = ++frame;
+        s.time = t;
+        s.cameraX = offset(rng);
+        s.cameraY = offset(rng);
+        s.mountX = offset(rng);
+        s.mountY = offset(rng);
+        s.guideDistanceRA = 0.7 * s.mountX;
+        s.guideDistanceDec = 0.7 * s.mountY;
+        s.durationRA = (int) (300 * fabs(s.guideDistanceRA));
+        s.directionRA = s.durationRA > 0 ? (s.guideDistanceRA > 0 ? 'W' : 'E') : 0;
+        s.durationDec = (int) (300 * fabs(s.guideDistanceDec));
+        s.directionDec = s.durationDec > 0 ? (s.guideDistanceDec > 0 ? 'N' : 'S') : 0;
+        s.starMass = 20000 + 1000 * offset(rng);
+        s.starSNR = 40 + offset(rng);
+        log.Step(s);
+    }
+    now += (int64_t) t;
+
+    log.Text("Guiding Ends at " + FormatTime(now) + "\n");
+    log.Mark(GLOG_GUIDING_ENDS, now);
+    log.Text("INFO: GA Result - Dec Drift Rate= 1.23 arc-sec/min, Dec Backlash= 0.0 arc-sec\n");
+    log.Mark(GLOG_GA_COMPLETE, now);
+    now += 600;
+}
+
+static bool StartsWith(const char *s, const char *pfx)
+{
+    return strncmp(s, pfx, strlen(pfx)) == 0;
+}
+
+// the line by line scan of the log upload dialog
+static GuideLogBinarySummary ScanText(FILE *fp)
+{
+    GuideLogBinarySummary sum = { 0, 0, 0., 0 };
+    int64_t starts = -1;
+    char line[1024];
+
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (StartsWith(line, "Guiding Begins at "))
+            starts = ParseTime(line + 18);
+        else if (StartsWith(line, "Guiding Ends at ") && starts >= 0)
+        {
+            int64_t end = ParseTime(line + 16);
+            if (end > starts)
+            {
+                ++sum.guide_cnt;
+                sum.guide_dur += (double) (end - starts);
+            }
+            starts = -1;
+        }
+        else if (StartsWith(line, "Calibration complete"))
+            ++sum.cal_cnt;
+        else if (StartsWith(line, "INFO: GA Result - Dec Drift Rate="))
+            ++sum.ga_cnt;
+    }
+
+    return sum;
+}
+
+static bool SameSummary(const GuideLogBinarySummary& a, const GuideLogBinarySummary& b)
+{
+    return a.cal_cnt == b.cal_cnt && a.guide_cnt == b.guide_cnt && a.guide_dur == b.guide_dur && a.ga_cnt == b.ga_cnt;
+}
+
+static double Millis(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char **argv)
+{
+    int steps = argc > 1 ? atoi(argv[1]) : 200000;
+    if (steps < SESSIONS)
+        steps = SESSIONS;
+
+    std::mt19937 rng(12345);
+    bool ok = true;
+
+    // step line formatting
+    {
+        std::uniform_real_distribution<double> offset(-1.5, 1.5);
+        std::vector<GuideLogStep> s(1024);
+        for (size_t i = 0; i < s.size(); i++)
+        {
+            memset(&s[i], 0, sizeof(s[i]));
+            s[i].frameNumber = (int) i + 1;
+            s[i].time = 2.0 * i + offset(rng);
+            s[i].cameraX = offset(rng);
+            s[i].cameraY = offset(rng);
+            s[i].mountX = offset(rng);
+            s[i].mountY = offset(rng);
+            s[i].guideDistanceRA = offset(rng);
+            s[i].guideDistanceDec = offset(rng);
+            s[i].durationRA = 250;
+            s[i].directionRA = 'W';
+            s[i].durationDec = 120;
+            s[i].directionDec = 'N';
+            s[i].starMass = 20000 + 1000 * offset(rng);
+            s[i].starSNR = 40 + offset(rng);
+        }
+
+        const int lines = 1000000;
+        char buf[256];
+        std::string line;
+        size_t bytes = 0;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < lines; i++)
+        {
+            const GuideLogStep& st = s[i & 1023];
+            int n = snprintf(buf, sizeof(buf), "%d,%.3f,\"%s\",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,", st.frameNumber, st.time,
+                             "Mount", st.cameraX, st.cameraY, st.mountX, st.mountY, st.guideDistanceRA,
+                             st.guideDistanceDec);
+            n += snprintf(buf + n, sizeof(buf) - n, "%d,%s,%d,%s,,,", st.durationRA, "W", st.durationDec, "N");
+            n += snprintf(buf + n, sizeof(buf) - n, "%.f,%.2f,%d\n", st.starMass, st.starSNR, st.starError);
+            bytes += n;
+        }
+        double printfUs = Millis(t0) * 1000. / lines;
+
+        t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < lines; i++)
+        {
+            line.clear();
+            GuideLogFormatStep(line, s[i & 1023]);
+            bytes += line.size();
+        }
+        double fmtUs = Millis(t0) * 1000. / lines;
+
+        bool match = true;
+        for (const auto& st : s)
+        {
+            snprintf(buf, sizeof(buf), "%d,%.3f,\"Mount\",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,W,%d,N,,,%.f,%.2f,%d\n",
+                     st.frameNumber, st.time, st.cameraX, st.cameraY, st.mountX, st.mountY, st.guideDistanceRA,
+                     st.guideDistanceDec, st.durationRA, st.durationDec, st.starMass, st.starSNR, st.starError);
+            line.clear();
+            GuideLogFormatStep(line, st);
+            match = match && line == buf;
+        }
+        ok = ok && match;
+
+        printf("guide step line formatting (%zu bytes)\n\n", bytes);
+        printf("%22s  %12s  %8s\n", "formatter", "us/line", "match");
+        printf("%22s  %12.3f  %8s\n", "printf", printfUs, "-");
+        printf("%22s  %12.3f  %8s\n\n", "GuideLogFormatStep", fmtUs, match ? "yes" : "NO");
+    }
+
+    // a log written in two runs of PHD2, the binary log reopened in between
+    LogWriter log;
+    log.binFile = tmpfile();
+    FILE *textFile = tmpfile();
+    if (!log.binFile || !textFile)
+    {
+        fprintf(stderr, "cannot create temporary files\n");
+        return 1;
+    }
+
+    int64_t now = ParseTime("2026-10-16 21:00:00");
+    int frame = 0;
+    log.bin.StartFile(0);
+    log.Text("PHD2 version 2.6.13, Log version 2.5. Log enabled at " + FormatTime(now) + "\n");
+    for (int i = 0; i < SESSIONS; i++)
+    {
+        if (i == SESSIONS / 2)
+        {
+            log.Text("\nLog closed at " + FormatTime(now) + "\n");
+            log.bin.Finish();
+            log.WriteBinary();
+            fflush(log.binFile);
+
+            uint64_t prevIndex = GuideLogBinaryLastIndex(log.binFile);
+            fseek(log.binFile, 0, SEEK_END);
+            log.bin.ContinueFile((uint64_t) ftell(log.binFile), prevIndex);
+            log.Text("PHD2 version 2.6.13, Log version 2.5. Log enabled at " + FormatTime(now) + "\n");
+        }
+        WriteSession(log, rng, now, frame, steps / SESSIONS);
+        log.WriteBinary();
+    }
+    log.Text("\nLog closed at " + FormatTime(now) + "\n");
+    log.WriteBinary();
+    fflush(log.binFile);
+
+    // the same log cut short by a crash: no final index and a partial record
+    std::string crashed;
+    {
+        fseek(log.binFile, 0, SEEK_END);
+        long size = ftell(log.binFile);
+        crashed.resize(size);
+        rewind(log.binFile);
+        if (fread(&crashed[0], 1, size, log.binFile) != (size_t) size)
+            ok = false;
+
+        GuideLogBinaryEncoder partial;
+        partial.ContinueFile(0, GLOG_NO_INDEX);
+        GuideLogStep step;
+        memset(&step, 0, sizeof(step));
+        partial.Step(step);
+        crashed += partial.Buffer().substr(0, 20);
+    }
+    FILE *crashFile = tmpfile();
+    fwrite(crashed.data(), 1, crashed.size(), crashFile);
+    fflush(crashFile);
+
+    fseek(log.binFile, 0, SEEK_END);
+    log.bin.Finish();
+    log.WriteBinary();
+    fflush(log.binFile);
+
+    fwrite(log.text.data(), 1, log.text.size(), textFile);
+    fflush(textFile);
+
+    fseek(log.binFile, 0, SEEK_END);
+    long binSize = ftell(log.binFile);
+    printf("session scan, %d steps in %d sessions: text log %zu bytes, binary log %ld bytes\n\n", steps, SESSIONS,
+           log.text.size(), binSize);
+    printf("%22s  %12s  %8s\n", "scan", "ms", "match");
+
+    auto t0 = std::chrono::steady_clock::now();
+    GuideLogBinarySummary textSum = ScanText(textFile);
+    printf("%22s  %12.3f  %8s\n", "text lines", Millis(t0), "-");
+
+    GuideLogBinarySummary binSum;
+    t0 = std::chrono::steady_clock::now();
+    bool scanned = GuideLogBinaryScan(log.binFile, &binSum);
+    double ms = Millis(t0);
+    bool match = scanned && SameSummary(textSum, binSum);
+    ok = ok && match;
+    printf("%22s  %12.3f  %8s\n", "binary index", ms, match ? "yes" : "NO");
+
+    t0 = std::chrono::steady_clock::now();
+    scanned = GuideLogBinaryScan(crashFile, &binSum);
+    ms = Millis(t0);
+    match = scanned && SameSummary(textSum, binSum);
+    ok = ok && match;
+    printf("%22s  %12.3f  %8s\n\n", "binary records", ms, match ? "yes" : "NO");
+
+    // conversion back to text
+    FILE *converted = tmpfile();
+    t0 = std::chrono::steady_clock::now();
+    bool conv = GuideLogBinaryToText(log.binFile, converted);
+    ms = Millis(t0);
+
+    std::string text;
+    fseek(converted, 0, SEEK_END);
+    text.resize(ftell(converted));
+    rewind(converted);
+    match = conv && fread(&text[0], 1, text.size(), converted) == text.size() && text == log.text;
+    ok = ok && match;
+    printf("%22s  %12s  %8s\n", "conversion", "ms", "match");
+    printf("%22s  %12.3f  %8s\n", "binary to text", ms, match ? "yes" : "NO");
+
+    fclose(converted);
+    fclose(crashFile);
+    fclose(textFile);
+    fclose(log.binFile);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,906 @@
+/*
+ *  replay_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Replays recorded guide frames through the image processing of the guide
+// loop as fast as it will go, with no GUI, camera or mount:
+//
+//   calc_stats       frame statistics, as usImage::CalcStats
+//   dark_subtract    dark frame subtraction or defect map correction
+//   noise_reduction  optional 2x2 mean or 3x3 median
+//   auto_find        star selection on the first frame: the GuideStar::AutoFind
+//                    candidates, then the brightest stars Star::Find accepts,
+//                    without the saturation level search
+//   star_find        the primary star, Star::Find
+//   refine           the secondary stars, searched in parallel as GuiderMultiStar::RefineOffset
+//   guide_algorithm  the hysteresis algorithm on each camera axis; with no
+//                    mount there is no calibration to map the offset to RA/Dec
+//
+// Star::Find, the frame statistics, the filters, the defect correction, the
+// AutoFind candidate selection, the multi-star refinement rules and the
+// hysteresis algorithm are the kernels the application uses; the
+// orchestration around them mirrors the application code.
+//
+// Frames are read from FITS files (8 or 16 bits per pixel, a single image or a
+// cube) named on the command line or found in a directory, in file name order.
+// The result for each frame is printed with full precision so that two runs
+// can be compared bit for bit: --output saves the results and --check compares
+// them with a saved file, exiting with status 1 at the first difference.
+//
+// usage: replay_benchmark [options] <file.fit | directory>...
+//
+//   --dark FILE        subtract a dark frame
+//   --defects FILE     correct the pixels listed in a PHD2 defect map instead
+//   --nr mean|median   noise reduction
+//   --star X,Y         guide star position; may be repeated, the first one is
+//                      the primary star. Stars are auto-selected by default.
+//   --max-stars N      stars to use, default 9
+//   --refine-budget MS time allowed for finding the secondary stars in each
+//                      frame, default no limit
+//   --search N         search region, default 15
+//   --repeat N         replay the frames N times
+//   --threads N        worker pool threads, default all
+//   --output FILE      save the per-frame results
+//   --check FILE       compare the per-frame results with a saved file
+
+#include "autofind_kernels.h"
+#include "denoise_kernels.h"
+#include "guide_kernels.h"
+#include "guide_timing.h"
+#include "star_kernels.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+
+struct Frame
+{
+    int width;
+    int height;
+    unsigned char bpp;
+    std::vector<unsigned short> pixels;
+};
+
+struct Options
+{
+    std::vector<std::string> inputs;
+    std::string dark;
+    std::string defects;
+    std::string nr;
+    std::vector<std::pair<int, int>> stars;
+    unsigned int maxStars = 9;
+    unsigned int refineBudget = 0; // ms
+    int searchRegion = 15;
+    int repeat = 1;
+    unsigned int threads = 0;
+    std::string output;
+    std::string check;
+};
+
+// guide star state kept by GuiderMultiStar
+struct TrackedStar
+{
+    double x;
+    double y;
+    double snr;
+    double refX; // reference point
+    double refY;
+    double offX; // offset from the primary star when it was selected
+    double offY;
+    unsigned int missCount;
+    unsigned int zeroCount;
+    bool wasLost;
+};
+
+// DescriptiveStats, for the primary star distance
+struct RunningStats
+{
+    unsigned int count = 0;
+    double mean = 0.;
+    double s = 0.;
+
+    void Add(double v)
+    {
+        count++;
+        if (count == 1)
+            mean = v;
+        else
+        {
+            double newMean = mean + (v - mean) / count;
+            s += (v - mean) * (v - newMean);
+            mean = newMean;
+        }
+    }
+
+    double Sigma() const { return count > 0 ? sqrt(s / (count - 1)) : 0.; }
+};
+
+// GuideAlgorithmHysteresis default settings
+static const double HysteresisMinMove = 0.2;
+static const double HysteresisHysteresis = 0.1;
+static const double HysteresisAggression = 0.7;
+
+// GuiderMultiStar default stability sigma multiplier
+static const double StabilitySigmaX = 5.0;
+
+// ----------------------------------------------------------------------------
+// FITS input
+
+static bool HasFitsExtension(const std::string& name)
+{
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos)
+        return false;
+    std::string ext = name.substr(dot + 1);
+    for (char& c : ext)
+        c = (char) tolower((unsigned char) c);
+    return ext == "fit" || ext == "fits" || ext == "fts";
+}
+
+static bool ListDirectory(const std::string& dir, std::vector<std::string> *files)
+{
+    std::vector<std::string> names;
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE)
+        return false;
+    do
+    {
+        if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && HasFitsExtension(fd.cFileName))
+            names.push_back(fd.cFileName);
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+#else
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return false;
+    while (struct dirent *e = readdir(d))
+        if (HasFitsExtension(e->d_name))
+            names.push_back(e->d_name);
+    closedir(d);
+#endif
+    std::sort(names.begin(), names.end());
+    for (const std::string& n : names)
+        files->push_back(dir + "/" + n);
+    return true;
+}
+
+static bool IsDirectory(const std::string& path)
+{
+#ifdef _WIN32
+    DWORD attr = GetFileAttributesA(path.c_str());
+    return attr != INVALID_FILE_ATTRIBUTES && (attr & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+// Read the primary HDU of a FITS file: a 2D image or a cube of images with
+// BITPIX 8 or 16, scaled by BSCALE and BZERO and clipped to 16 bits
+static bool ReadFits(const std::string& path, std::vector<Frame> *frames, std::string *err)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp)
+    {
+        *err = "cannot open " + path;
+        return false;
+    }
+
+    enum
+    {
+        BLOCK = 2880,
+        CARD = 80
+    };
+    char block[BLOCK];
+    int bitpix = 0, naxis = 0;
+    long naxisn[3] = { 0, 1, 1 };
+    double bzero = 0., bscale = 1.;
+    bool end = false;
+
+    while (!end)
+    {
+        if (fread(block, 1, BLOCK, fp) != BLOCK)
+        {
+            fclose(fp);
+            *err = "truncated FITS header in " + path;
+            return false;
+        }
+        for (int i = 0; i < BLOCK && !end; i += CARD)
+        {
+            std::string key(block + i, 8);
+            key.erase(key.find_last_not_of(' ') + 1);
+            const char *val = block + i + 10;
+
+            if (key == "END")
+                end = true;
+            else if (block[i + 8] != '=')
+                continue;
+            else if (key == "BITPIX")
+                bitpix = atoi(val);
+            else if (key == "NAXIS")
+                naxis = atoi(val);
+            else if (key == "NAXIS1" || key == "NAXIS2" || key == "NAXIS3")
+                naxisn[key[5] - '1'] = atol(val);
+            else if (key == "BZERO")
+                bzero = atof(val);
+            else if (key == "BSCALE")
+                bscale = atof(val);
+        }
+    }
+
+    if ((bitpix != 8 && bitpix != 16) || naxis < 2 || naxis > 3 || naxisn[0] < 3 || naxisn[1] < 3)
+    {
+        fclose(fp);
+        *err = "unsupported FITS image in " + path + " (expected BITPIX 8 or 16 and 2 or 3 axes)";
+        return false;
+    }
+
+    int const width = (int) naxisn[0];
+    int const height = (int) naxisn[1];
+    long const planes = naxis == 3 ? naxisn[2] : 1;
+    size_t const npix = (size_t) width * height;
+    size_t const bytesPerPixel = bitpix / 8;
+    std::vector<unsigned char> raw(npix * bytesPerPixel);
+
+    for (long p = 0; p < planes; p++)
+    {
+        if (fread(raw.data(), 1, raw.size(), fp) != raw.size())
+        {
+            fclose(fp);
+            *err = "truncated FITS data in " + path;
+            return false;
+        }
+
+        Frame f;
+        f.width = width;
+        f.height = height;
+        f.bpp = bitpix == 8 ? 8 : 16;
+        f.pixels.resize(npix);
+
+        for (size_t i = 0; i < npix; i++)
+        {
+            double v;
+            if (bitpix == 8)
+                v = raw[i];
+            else
+                v = (double) (int16_t) (raw[2 * i] << 8 | raw[2 * i + 1]); // big-endian
+            v = v * bscale + bzero;
+            f.pixels[i] = (unsigned short) std::min(65535.0, std::max(0.0, v));
+        }
+
+        frames->push_back(std::move(f));
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static bool ReadDefectMap(const std::string& path, std::vector<std::pair<int, int>> *defects)
+{
+    FILE *fp = fopen(path.c_str(), "r");
+    if (!fp)
+        return false;
+    char line[256];
+    while (fgets(line, sizeof(line), fp))
+    {
+        int x, y;
+        if (line[0] != '#' && sscanf(line, "%d %d", &x, &y) == 2)
+            defects->push_back(std::make_pair(x, y));
+    }
+    fclose(fp);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// guide loop
+
+struct Replay
+{
+    const Options& opt;
+    const Frame *dark = nullptr;
+    unsigned short darkMedian = 0;
+    std::vector<std::pair<int, int>> defects;
+
+    std::vector<TrackedStar> stars; // primary star first
+    double lockX = 0.;
+    double lockY = 0.;
+    RunningStats primaryDist;
+    bool stabilizing = false;
+    size_t refineStart = 1; // secondary star to search first, where the time budget last ran out
+    double lastMoveX = 0.;
+    double lastMoveY = 0.;
+    std::vector<R2M> hfrvec;
+    std::vector<unsigned short> tmp;
+
+    explicit Replay(const Options& o) : opt(o) { }
+
+    StarFindParams FindParams(const Frame& f, unsigned short pedestal) const
+    {
+        StarFindParams p;
+        p.minx = 0;
+        p.miny = 0;
+        p.maxx = f.width - 1;
+        p.maxy = f.height - 1;
+        p.searchRegion = opt.searchRegion;
+        p.peakMode = false;
+        p.minHFD = 1.5;
+        p.maxHFD = 20.0;
+        p.maxADU = 0;
+        p.pedestal = pedestal;
+        p.bitsPerPixel = f.bpp;
+        return p;
+    }
+
+    unsigned short Preprocess(Frame& f);
+    void AutoSelect(const Frame& f, unsigned short pedestal);
+    unsigned int Refine(const Frame& f, unsigned short pedestal, double *dx, double *dy);
+    std::string Step(Frame& f, unsigned int frameNum);
+};
+
+static void SubtractDark(Frame& light, unsigned short lightMedian, const Frame& dark, unsigned short darkMedian,
+                         unsigned short *pedestal)
+{
+    // Subtract() in image_math.cpp for a full frame
+    *pedestal = darkMedian > lightMedian ? darkMedian - lightMedian : 0;
+
+    for (size_t i = 0; i < light.pixels.size(); i++)
+    {
+        int v = (int) light.pixels[i] + *pedestal - (int) dark.pixels[i];
+        light.pixels[i] = (unsigned short) std::min(65535, std::max(0, v));
+    }
+}
+
+// dark subtraction or defect correction, noise reduction and frame statistics;
+// returns the pedestal added by dark subtraction
+unsigned short Replay::Preprocess(Frame& f)
+{
+    unsigned short pedestal = 0;
+    DenoiseStats stats;
+
+    if (dark || !defects.empty())
+    {
+        TimingProbe probe(GuideTiming::STAGE_DARK_SUBTRACT);
+
+        if (!defects.empty())
+        {
+            for (const auto& d : defects)
+                if (d.first >= 0 && d.first < f.width && d.second >= 0 && d.second < f.height)
+                    f.pixels[d.second * f.width + d.first] =
+                        DenoiseDefectPixel(f.pixels.data(), f.width, f.height, d.first, d.second);
+        }
+        else
+        {
+            DenoiseImageStats(&stats, f.pixels.data(), f.width, f.width, f.height);
+            SubtractDark(f, stats.medianADU, *dark, darkMedian, &pedestal);
+        }
+    }
+
+    if (!opt.nr.empty())
+    {
+        TimingProbe probe(GuideTiming::STAGE_NOISE_REDUCTION);
+        tmp.resize(f.pixels.size());
+        if (opt.nr == "median")
+            DenoiseMedian3(tmp.data(), f.width, f.pixels.data(), f.width, f.width, f.height);
+        else
+            DenoiseLRecon(tmp.data(), f.width, f.pixels.data(), f.width, f.width, f.height);
+        f.pixels.swap(tmp);
+    }
+
+    {
+        TimingProbe probe(GuideTiming::STAGE_CALC_STATS);
+        DenoiseImageStats(&stats, f.pixels.data(), f.width, f.width, f.height);
+    }
+
+    return pedestal;
+}
+
+// GuideStar::AutoFind without the downsampling, the saturation level search
+// and the edge allowance: median filter, PSF convolution and candidate
+// selection, then Star::Find on the brightest candidates
+void Replay::AutoSelect(const Frame& f, unsigned short pedestal)
+{
+    TimingProbe probe(GuideTiming::STAGE_AUTO_FIND);
+
+    int const w = f.width, h = f.height;
+    std::vector<unsigned short> smoothed(f.pixels.size());
+    DenoiseMedian3(smoothed.data(), w, f.pixels.data(), w, w, h);
+
+    std::vector<float> src(smoothed.begin(), smoothed.end());
+    std::vector<float> conv(src.size());
+    AutoFindPsfConv(conv.data(), src.data(), w, h, 1, 0, h);
+
+    int const r = 4; // CONV_RADIUS
+    int const left = r, top = r, right = w - r - 1, bottom = h - r - 1;
+    double mean, stdev;
+    AutoFindStats(&mean, &stdev, conv.data(), w, left, top, right - left + 1, bottom - top + 1);
+
+    int const srch = 4;
+    std::vector<std::vector<AutoFindCandidate>> candidates(1);
+    AutoFindLocalMaxima(&candidates[0], conv.data(), w, left, top, right, bottom, srch, stdev, 0.1, top + srch,
+                        bottom - srch + 1);
+
+    std::vector<AutoFindPeak> peaks; // sorted by ascending intensity
+    std::vector<AutoFindPeakNote> notes;
+    AutoFindTopPeaks(&peaks, candidates, 1, 100);
+    AutoFindSeparatePeaks(&peaks, &notes, opt.searchRegion, opt.searchRegion, w, h);
+
+    StarFindParams params = FindParams(f, pedestal);
+    double const minSNR = 6.0;
+
+    for (auto p = peaks.rbegin(); p != peaks.rend() && stars.size() < opt.maxStars; ++p)
+    {
+        StarFindOutput out;
+        StarFindStatus st = StarFind(&out, &hfrvec, f.pixels.data(), w, params, p->x, p->y);
+        if (st != STAR_FIND_OK || out.snr < minSNR)
+            continue;
+
+        bool duplicate = false;
+        for (const TrackedStar& s : stars)
+            if (hypot(s.x - out.x, s.y - out.y) < AUTOFIND_MIN_SEPARATION)
+                duplicate = true;
+        if (duplicate)
+            continue;
+
+        TrackedStar s = {};
+        s.x = s.refX = out.x;
+        s.y = s.refY = out.y;
+        s.snr = out.snr;
+        stars.push_back(s);
+    }
+}
+
+// GuiderMultiStar::RefineOffset: average the primary star offset with the
+// motion of the secondary stars, weighted by SNR. Returns the number of stars used.
+unsigned int Replay::Refine(const Frame& f, unsigned short pedestal, double *dx, double *dy)
+{
+    TimingProbe probe(GuideTiming::STAGE_REFINE, stars.size() > 1);
+
+    unsigned int starsUsed = 1;
+    if (stars.size() < 2)
+        return starsUsed;
+
+    const TrackedStar& primary = stars[0];
+    double primaryDistance = hypot(*dx, *dy);
+    double primarySigma = 0;
+
+    primaryDist.Add(primaryDistance);
+
+    if (primaryDist.count > 5)
+        primarySigma = primaryDist.Sigma();
+    stabilizing = MultiStarStabilizing(stabilizing, primaryDist.count, primaryDistance, primarySigma, StabilitySigmaX);
+
+    if (stabilizing || (*dx == 0 && *dy == 0))
+        return starsUsed;
+
+    StarFindParams params = FindParams(f, pedestal);
+    MultiStarAverage average(*dx, *dy);
+
+    // the secondary stars are searched in parallel in batches of the number
+    // of stars still wanted, and the results applied in list order
+    enum
+    {
+        SEARCH_SKIPPED,
+        SEARCH_LOST,
+        SEARCH_FOUND
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opt.refineBudget);
+    std::vector<TrackedStar> batch;
+    std::vector<StarFindOutput> outs;
+    std::vector<char> results;
+    bool outOfTime = false;
+
+    // start where the previous frame ran out of time, wrapping around the list
+    size_t pos = refineStart < stars.size() ? refineStart : 1;
+    size_t remaining = stars.size() - 1;
+    while (remaining > 0 && starsUsed < opt.maxStars && !outOfTime)
+    {
+        if (pos == stars.size())
+            pos = 1;
+        int count = (int) std::min<size_t>(std::min<size_t>(opt.maxStars - starsUsed, remaining), stars.size() - pos);
+        batch.assign(stars.begin() + pos, stars.begin() + pos + count);
+        outs.resize(count);
+        results.assign(count, SEARCH_SKIPPED);
+
+        WorkerPool::Run(count, [&](int i) {
+            if (opt.refineBudget > 0 && std::chrono::steady_clock::now() >= deadline)
+                return;
+            const TrackedStar& b = batch[i];
+            double fx = b.wasLost ? primary.x + b.offX : b.x;
+            double fy = b.wasLost ? primary.y + b.offY : b.y;
+            std::vector<R2M> hfr;
+            StarFindStatus st = StarFind(&outs[i], &hfr, f.pixels.data(), f.width, params, (int) fx, (int) fy);
+            results[i] = st == STAR_FIND_OK || st == STAR_FIND_SATURATED ? SEARCH_FOUND : SEARCH_LOST;
+        });
+
+        for (int i = 0; i < count; i++)
+        {
+            if (results[i] == SEARCH_SKIPPED)
+            {
+                outOfTime = true;
+                break;
+            }
+
+            auto s = stars.begin() + pos;
+            --remaining;
+            s->x = outs[i].x;
+            s->y = outs[i].y;
+
+            if (results[i] == SEARCH_LOST)
+            {
+                s->wasLost = true;
+                ++pos;
+                continue;
+            }
+
+            s->snr = outs[i].snr;
+            s->wasLost = false;
+            starsUsed++;
+
+            double sdx = s->x - s->refX;
+            double sdy = s->y - s->refY;
+
+            switch (MultiStarClassify(sdx, sdy, primarySigma, &s->zeroCount, &s->missCount))
+            {
+            case MULTISTAR_DROP:
+                stars.erase(s);
+                continue;
+            case MULTISTAR_RESET:
+                s->refX = s->x;
+                s->refY = s->y;
+                break;
+            case MULTISTAR_MISS:
+                break;
+            case MULTISTAR_USE:
+                average.Add(s->snr / stars[0].snr, sdx, sdy);
+                break;
+            }
+            ++pos;
+        }
+    }
+    refineStart = outOfTime ? pos : 1;
+
+    if (average.count > 0 && hypot(average.X(), average.Y()) < primaryDistance)
+    {
+        *dx = average.X();
+        *dy = average.Y();
+    }
+
+    return starsUsed;
+}
+
+std::string Replay::Step(Frame& f, unsigned int frameNum)
+{
+    unsigned short pedestal = Preprocess(f);
+
+    if (stars.empty())
+    {
+        if (opt.stars.empty())
+            AutoSelect(f, pedestal);
+        else
+        {
+            StarFindParams params = FindParams(f, pedestal);
+            for (const auto& p : opt.stars)
+            {
+                StarFindOutput out;
+                StarFind(&out, &hfrvec, f.pixels.data(), f.width, params, p.first, p.second);
+                TrackedStar s = {};
+                s.x = s.refX = out.x;
+                s.y = s.refY = out.y;
+                s.snr = out.snr;
+                stars.push_back(s);
+            }
+        }
+
+        if (!stars.empty())
+        {
+            lockX = stars[0].x;
+            lockY = stars[0].y;
+            for (TrackedStar& s : stars)
+            {
+                s.offX = s.x - lockX;
+                s.offY = s.y - lockY;
+            }
+        }
+    }
+
+    char buf[512];
+
+    if (stars.empty())
+    {
+        snprintf(buf, sizeof(buf), "%u nostar\n", frameNum);
+        return buf;
+    }
+
+    TrackedStar& primary = stars[0];
+    StarFindOutput out;
+    StarFindStatus st;
+    {
+        TimingProbe probe(GuideTiming::STAGE_STAR_FIND);
+        StarFindParams params = FindParams(f, pedestal);
+        st = StarFind(&out, &hfrvec, f.pixels.data(), f.width, params, (int) primary.x, (int) primary.y);
+    }
+
+    if (st != STAR_FIND_OK && st != STAR_FIND_SATURATED)
+    {
+        snprintf(buf, sizeof(buf), "%u lost %d\n", frameNum, (int) st);
+        return buf;
+    }
+
+    primary.x = out.x;
+    primary.y = out.y;
+    primary.snr = out.snr;
+
+    double dx = primary.x - lockX;
+    double dy = primary.y - lockY;
+    unsigned int used = Refine(f, pedestal, &dx, &dy);
+
+    double gx, gy;
+    {
+        TimingProbe probe(GuideTiming::STAGE_GUIDE_ALGORITHM);
+        gx = lastMoveX = HysteresisResult(dx, HysteresisMinMove, HysteresisHysteresis, HysteresisAggression, lastMoveX);
+        gy = lastMoveY = HysteresisResult(dy, HysteresisMinMove, HysteresisHysteresis, HysteresisAggression, lastMoveY);
+    }
+
+    snprintf(buf, sizeof(buf), "%u %d %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %u\n", frameNum, (int) st,
+             primary.x, primary.y, out.mass, out.snr, out.hfd, dx, dy, gx, gy, used);
+    return buf;
+}
+
+// ----------------------------------------------------------------------------
+
+static void Usage()
+{
+    fprintf(stderr, "usage: replay_benchmark [--dark FILE | --defects FILE] [--nr mean|median] [--star X,Y]...\n"
+                    "                        [--max-stars N] [--refine-budget MS] [--search N] [--repeat N] [--threads N]\n"
+                    "                        [--output FILE] [--check FILE] <file.fit | directory>...\n");
+}
+
+static bool ParseArgs(Options *opt, int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (a.compare(0, 2, "--") != 0)
+            opt->inputs.push_back(a);
+        else if (!hasValue)
+            return false;
+        else if (a == "--dark")
+            opt->dark = argv[++i];
+        else if (a == "--defects")
+            opt->defects = argv[++i];
+        else if (a == "--nr")
+        {
+            opt->nr = argv[++i];
+            if (opt->nr != "mean" && opt->nr != "median")
+                return false;
+        }
+        else if (a == "--star")
+        {
+            int x, y;
+            if (sscanf(argv[++i], "%d,%d", &x, &y) != 2)
+                return false;
+            opt->stars.push_back(std::make_pair(x, y));
+        }
+        else if (a == "--max-stars")
+            opt->maxStars = (unsigned int) std::max(1, atoi(argv[++i]));
+        else if (a == "--refine-budget")
+            opt->refineBudget = (unsigned int) std::max(0, atoi(argv[++i]));
+        else if (a == "--search")
+            opt->searchRegion = std::max(3, atoi(argv[++i]));
+        else if (a == "--repeat")
+            opt->repeat = std::max(1, atoi(argv[++i]));
+        else if (a == "--threads")
+            opt->threads = (unsigned int) std::max(0, atoi(argv[++i]));
+        else if (a == "--output")
+            opt->output = argv[++i];
+        else if (a == "--check")
+            opt->check = argv[++i];
+        else
+            return false;
+    }
+
+    return !opt->inputs.empty();
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!ParseArgs(&opt, argc, argv))
+    {
+        Usage();
+        return 2;
+    }
+
+    std::vector<std::string> files;
+    for (const std::string& in : opt.inputs)
+    {
+        if (!IsDirectory(in))
+            files.push_back(in);
+        else if (!ListDirectory(in, &files))
+        {
+            fprintf(stderr, "cannot read directory %s\n", in.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<Frame> frames;
+    std::string err;
+    for (const std::string& file : files)
+    {
+        if (!ReadFits(file, &frames, &err))
+        {
+            fprintf(stderr, "%s\n", err.c_str());
+            return 2;
+        }
+    }
+
+    if (frames.empty())
+    {
+        fprintf(stderr, "no frames\n");
+        return 2;
+    }
+
+    for (const Frame& f : frames)
+    {
+        if (f.width != frames[0].width || f.height != frames[0].height)
+        {
+            fprintf(stderr, "frames differ in size\n");
+            return 2;
+        }
+    }
+
+    Replay replay(opt);
+
+    std::vector<Frame> darkFrames;
+    if (!opt.dark.empty())
+    {
+        if (!ReadFits(opt.dark, &darkFrames, &err))
+        {
+            fprintf(stderr, "%s\n", err.c_str());
+            return 2;
+        }
+        if (darkFrames[0].width != frames[0].width || darkFrames[0].height != frames[0].height)
+        {
+            fprintf(stderr, "dark frame size does not match the frames\n");
+            return 2;
+        }
+        DenoiseStats stats;
+        DenoiseImageStats(&stats, darkFrames[0].pixels.data(), darkFrames[0].width, darkFrames[0].width,
+                          darkFrames[0].height);
+        replay.dark = &darkFrames[0];
+        replay.darkMedian = stats.medianADU;
+    }
+    if (!opt.defects.empty() && !ReadDefectMap(opt.defects, &replay.defects))
+    {
+        fprintf(stderr, "cannot read defect map %s\n", opt.defects.c_str());
+        return 2;
+    }
+
+    WorkerPool::Init(opt.threads);
+
+    std::string results;
+    Frame work;
+    double totalMs = 0.;
+    unsigned int frameNum = 0;
+
+    GuideLoopTiming.Reset();
+
+    for (int r = 0; r < opt.repeat; r++)
+    {
+        for (const Frame& f : frames)
+        {
+            work = f; // the replay modifies the frame, as the guide loop does
+
+            auto t0 = std::chrono::steady_clock::now();
+            std::string line = replay.Step(work, ++frameNum);
+            auto t1 = std::chrono::steady_clock::now();
+
+            totalMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            results += line;
+        }
+    }
+
+    printf("%u frames %dx%d, %zu stars, %u threads\n", frameNum, frames[0].width, frames[0].height, replay.stars.size(),
+           WorkerPool::ThreadCount());
+    printf("%.1f frames/s, %.3f ms/frame\n\n", frameNum * 1000.0 / totalMs, totalMs / frameNum);
+    printf("%s", GuideLoopTiming.FormatSummary().c_str());
+
+    int status = 0;
+
+    if (!opt.output.empty())
+    {
+        FILE *fp = fopen(opt.output.c_str(), "w");
+        if (!fp || fwrite(results.data(), 1, results.size(), fp) != results.size())
+        {
+            fprintf(stderr, "cannot write %s\n", opt.output.c_str());
+            status = 2;
+        }
+        if (fp)
+            fclose(fp);
+    }
+
+    if (!opt.check.empty())
+    {
+        std::string expected;
+        FILE *fp = fopen(opt.check.c_str(), "r");
+        if (fp)
+        {
+            char buf[4096];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+                expected.append(buf, n);
+            fclose(fp);
+        }
+
+        if (!fp)
+        {
+            fprintf(stderr, "cannot read %s\n", opt.check.c_str());
+            status = 2;
+        }
+        else if (expected == results)
+            printf("\nresults match %s\n", opt.check.c_str());
+        else
+        {
+            // report the first frame that differs
+            size_t pos = 0;
+            while (pos < expected.size() && pos < results.size() && expected[pos] == results[pos])
+                pos++;
+            size_t lineStart = results.rfind('\n', pos == 0 ? 0 : pos - 1);
+            lineStart = lineStart == std::string::npos || pos == 0 ? 0 : lineStart + 1;
+            std::string got = results.substr(lineStart, results.find('\n', lineStart) - lineStart);
+            std::string want = expected.substr(lineStart, expected.find('\n', lineStart) - lineStart);
+            printf("\nresults differ from %s\n  expected: %s\n  got:      %s\n", opt.check.c_str(), want.c_str(), got.c_str());
+            status = 1;
+        }
+    }
+
+    WorkerPool::Destroy();
+
+    return status;
+}
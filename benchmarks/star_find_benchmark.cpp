@@ -0,0 +1,223 @@
+/*
+ *  star_find_benchmark.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Times the Star::Find centroiding path per star on synthetic frames for a range
+// of search regions, for each SIMD level supported by the CPU, and checks that
+// every level reproduces the scalar results bit for bit.
+//
+// usage: star_find_benchmark [iterations]
+
+#include "simd.h"
+#include "star_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+struct Frame
+{
+    int width;
+    int height;
+    std::vector<unsigned short> pixels;
+};
+
+struct FindResult
+{
+    double x;
+    double y;
+    double mass;
+    double snr;
+    double hfd;
+    unsigned int peak;
+};
+
+static void MakeFrame(Frame *frame, std::vector<std::pair<int, int>> *stars, int width, int height, int nstars)
+{
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> noise(1000.0, 25.0);
+    std::uniform_real_distribution<double> pos(0.0, 1.0);
+
+    frame->width = width;
+    frame->height = height;
+    frame->pixels.resize(width * height);
+
+    std::vector<double> img(width * height);
+    for (double& v : img)
+        v = noise(rng);
+
+    int const margin = 64;
+    for (int i = 0; i < nstars; i++)
+    {
+        double sx = margin + pos(rng) * (width - 2 * margin);
+        double sy = margin + pos(rng) * (height - 2 * margin);
+        double amp = 2000.0 + pos(rng) * 30000.0;
+        double sigma = 1.0 + pos(rng) * 1.5;
+
+        for (int y = (int) sy - 12; y <= (int) sy + 12; y++)
+            for (int x = (int) sx - 12; x <= (int) sx + 12; x++)
+            {
+                double dx = x - sx, dy = y - sy;
+                img[y * width + x] += amp * exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+            }
+
+        // start the search a couple of pixels off, as when tracking a moving star
+        stars->push_back(std::make_pair((int) sx + 2, (int) sy - 1));
+    }
+
+    for (size_t i = 0; i < img.size(); i++)
+        frame->pixels[i] = (unsigned short) std::min(65535.0, std::max(0.0, img[i]));
+}
+
+// the centroid path of Star::Find
+static FindResult FindStar(const Frame& frame, int searchRegion, int base_x, int base_y, std::vector<R2M>& hfrvec)
+{
+    FindResult r = { 0., 0., 0., 0., 0., 0 };
+
+    int const minx = 0, miny = 0, maxx = frame.width - 1, maxy = frame.height - 1;
+    int start_x = std::max(base_x - searchRegion, minx);
+    int end_x = std::min(base_x + searchRegion, maxx);
+    int start_y = std::max(base_y - searchRegion, miny);
+    int end_y = std::min(base_y + searchRegion, maxy);
+
+    const unsigned short *imgdata = frame.pixels.data();
+    int rowsize = frame.width;
+
+    StarPeak peak = { 0, 0, 0, { 0, 0, 0 } };
+    StarSmoothedPeak(&peak, imgdata, rowsize, start_x + 1, start_y + 1, end_x - 1, end_y - 1);
+    unsigned int peak_val = peak.val / 16;
+
+    int const A = 7, B = 12;
+
+    StarBackground bg;
+    StarAnnulusBackground(&bg, imgdata, rowsize, peak.x, peak.y, A, B, minx, miny, maxx, maxy);
+
+    unsigned short thresh = (unsigned short) (bg.mean + 3.0 * bg.sigma + 0.5);
+
+    hfrvec.clear();
+    StarCentroid c;
+    StarApertureCentroid(&c, &hfrvec, imgdata, rowsize, peak.x, peak.y, A, thresh, bg.mean, minx, miny, maxx, maxy);
+
+    double const gain = .5;
+    r.mass = c.mass;
+    r.snr = c.n > 0 ? c.mass / sqrt(c.mass / gain + bg.sigma2 * (double) c.n * (1.0 + 1.0 / (double) bg.nbg)) : 0.0;
+    r.peak = peak_val;
+
+    if (c.mass >= 10.0)
+    {
+        r.x = peak.x + c.cx / c.mass;
+        r.y = peak.y + c.cy / c.mass;
+        r.hfd = 2.0 * StarHFR(hfrvec, r.x, r.y, c.mass);
+    }
+
+    return r;
+}
+
+static bool SameResult(const FindResult& a, const FindResult& b)
+{
+    return memcmp(&a.x, &b.x, sizeof(double)) == 0 && memcmp(&a.y, &b.y, sizeof(double)) == 0 &&
+        memcmp(&a.mass, &b.mass, sizeof(double)) == 0 && memcmp(&a.snr, &b.snr, sizeof(double)) == 0 &&
+        memcmp(&a.hfd, &b.hfd, sizeof(double)) == 0 && a.peak == b.peak;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations < 1)
+        iterations = 1;
+
+    Frame frame;
+    std::vector<std::pair<int, int>> stars;
+    MakeFrame(&frame, &stars, 1280, 960, 40);
+
+    static const int regions[] = { 7, 10, 15, 20, 30, 40, 50 };
+
+    std::vector<SimdLevel> levels;
+    for (int l = SIMD_NONE; l <= SimdDetect(); l++)
+        levels.push_back((SimdLevel) l);
+
+    printf("Star::Find per star, %zu stars, %d iterations, detected SIMD level %s\n\n", stars.size(), iterations,
+           SimdLevelName(SimdDetect()));
+    printf("%8s", "region");
+    for (SimdLevel l : levels)
+        printf("  %10s us", SimdLevelName(l));
+    printf("  %8s\n", "match");
+
+    std::vector<R2M> hfrvec;
+    hfrvec.reserve(256);
+    bool allMatch = true;
+
+    for (int region : regions)
+    {
+        printf("%8d", region);
+
+        std::vector<FindResult> reference;
+        bool match = true;
+
+        for (SimdLevel l : levels)
+        {
+            SimdSetLevel(l);
+
+            std::vector<FindResult> results;
+            for (const auto& s : stars)
+                results.push_back(FindStar(frame, region, s.first, s.second, hfrvec));
+
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++)
+                for (const auto& s : stars)
+                    FindStar(frame, region, s.first, s.second, hfrvec);
+            auto t1 = std::chrono::steady_clock::now();
+
+            double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / ((double) iterations * stars.size());
+            printf("  %13.2f", us);
+
+            if (l == SIMD_NONE)
+                reference = results;
+            else
+                for (size_t i = 0; i < results.size(); i++)
+                    if (!SameResult(results[i], reference[i]))
+                        match = false;
+        }
+
+        printf("  %8s\n", match ? "yes" : "NO");
+        allMatch = allMatch && match;
+    }
+
+    SimdSetLevel(SimdDetect());
+
+    return allMatch ? 0 : 1;
+}
@@ -62,7 +62,9 @@ GP::GP()
       data_loc_(Eigen::VectorXd()), data_out_(Eigen::VectorXd()), data_var_(Eigen::VectorXd()), gram_matrix_(Eigen::MatrixXd()),
       alpha_(Eigen::VectorXd()), chol_gram_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), log_noise_sd_(-1E20),
       use_explicit_trend_(false), feature_vectors_(Eigen::MatrixXd()), feature_matrix_(Eigen::MatrixXd()),
-      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd())
+      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd()),
+      chol_factor_(Eigen::MatrixXd()), factor_loc_(Eigen::VectorXd()), factor_var_(Eigen::VectorXd()),
+      factor_hyper_parameters_(Eigen::VectorXd()), use_chol_factor_(false)
 {
 }
 
@@ -71,7 +73,9 @@ GP::GP(const covariance_functions::CovFunc& covFunc)
       data_var_(Eigen::VectorXd()), gram_matrix_(Eigen::MatrixXd()), alpha_(Eigen::VectorXd()),
       chol_gram_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), log_noise_sd_(-1E20), use_explicit_trend_(false),
       feature_vectors_(Eigen::MatrixXd()), feature_matrix_(Eigen::MatrixXd()),
-      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd())
+      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd()),
+      chol_factor_(Eigen::MatrixXd()), factor_loc_(Eigen::VectorXd()), factor_var_(Eigen::VectorXd()),
+      factor_hyper_parameters_(Eigen::VectorXd()), use_chol_factor_(false)
 {
 }
 
@@ -80,7 +84,9 @@ GP::GP(const double noise_variance, const covariance_functions::CovFunc& covFunc
       data_var_(Eigen::VectorXd()), gram_matrix_(Eigen::MatrixXd()), alpha_(Eigen::VectorXd()),
       chol_gram_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), log_noise_sd_(std::log(noise_variance)), use_explicit_trend_(false),
       feature_vectors_(Eigen::MatrixXd()), feature_matrix_(Eigen::MatrixXd()),
-      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd())
+      chol_feature_matrix_(Eigen::LDLT<Eigen::MatrixXd>()), beta_(Eigen::VectorXd()),
+      chol_factor_(Eigen::MatrixXd()), factor_loc_(Eigen::VectorXd()), factor_var_(Eigen::VectorXd()),
+      factor_hyper_parameters_(Eigen::VectorXd()), use_chol_factor_(false)
 {
 }
 
@@ -96,7 +102,9 @@ GP::GP(const GP& that)
       data_loc_(that.data_loc_), data_out_(that.data_out_), data_var_(that.data_var_), gram_matrix_(that.gram_matrix_),
       alpha_(that.alpha_), chol_gram_matrix_(that.chol_gram_matrix_), log_noise_sd_(that.log_noise_sd_),
       use_explicit_trend_(that.use_explicit_trend_), feature_vectors_(that.feature_vectors_),
-      feature_matrix_(that.feature_matrix_), chol_feature_matrix_(that.chol_feature_matrix_), beta_(that.beta_)
+      feature_matrix_(that.feature_matrix_), chol_feature_matrix_(that.chol_feature_matrix_), beta_(that.beta_),
+      chol_factor_(that.chol_factor_), factor_loc_(that.factor_loc_), factor_var_(that.factor_var_),
+      factor_hyper_parameters_(that.factor_hyper_parameters_), use_chol_factor_(that.use_chol_factor_)
 {
     covFunc_ = that.covFunc_->clone();
     covFuncProj_ = that.covFuncProj_->clone();
@@ -141,6 +149,11 @@ GP& GP::operator=(const GP& that)
         alpha_ = that.alpha_;
         chol_gram_matrix_ = that.chol_gram_matrix_;
         log_noise_sd_ = that.log_noise_sd_;
+        chol_factor_ = that.chol_factor_;
+        factor_loc_ = that.factor_loc_;
+        factor_var_ = that.factor_var_;
+        factor_hyper_parameters_ = that.factor_hyper_parameters_;
+        use_chol_factor_ = that.use_chol_factor_;
     }
     return *this;
 }
@@ -161,7 +174,7 @@ Eigen::VectorXd GP::drawSample(const Eigen::VectorXd& locations, const Eigen::Ve
     prior_covariance = covFunc_->evaluate(locations, locations);
     kernel_matrix = prior_covariance;
 
-    if (gram_matrix_.cols() == 0) // no data, i.e. only a prior
+    if (data_loc_.rows() == 0) // no data, i.e. only a prior
     {
         kernel_matrix = prior_covariance + JITTER * Eigen::MatrixXd::Identity(prior_covariance.rows(), prior_covariance.cols());
     }
@@ -170,7 +183,7 @@ Eigen::VectorXd GP::drawSample(const Eigen::VectorXd& locations, const Eigen::Ve
         Eigen::MatrixXd mixed_covariance;
         mixed_covariance = covFunc_->evaluate(locations, data_loc_);
         Eigen::MatrixXd posterior_covariance;
-        posterior_covariance = prior_covariance - mixed_covariance * (chol_gram_matrix_.solve(mixed_covariance.transpose()));
+        posterior_covariance = prior_covariance - mixed_covariance * solveGram(mixed_covariance.transpose());
         kernel_matrix =
             posterior_covariance + JITTER * Eigen::MatrixXd::Identity(posterior_covariance.rows(), posterior_covariance.cols());
     }
@@ -187,6 +200,8 @@ void GP::infer()
 {
     assert(data_loc_.rows() > 0 && "Error: the GP is not yet initialized!");
 
+    use_chol_factor_ = false;
+
     // The data covariance matrix
     Eigen::MatrixXd data_cov = covFunc_->evaluate(data_loc_, data_loc_);
 
@@ -234,9 +249,8 @@ void GP::infer(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out,
     infer(); // updates the Gram matrix and its Cholesky decomposition
 }
 
-void GP::inferSD(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
-                 const Eigen::VectorXd& data_var /* = EigenVectorXd() */,
-                 const double prediction_point /*= std::numeric_limits<double>::quiet_NaN()*/)
+void GP::selectSubsetOfData(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
+                            const Eigen::VectorXd& data_var, const double prediction_point)
 {
     Eigen::VectorXd covariance;
 
@@ -298,13 +312,239 @@ void GP::inferSD(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_ou
             data_var_ = data_var;
         }
     }
+}
+
+void GP::inferSD(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
+                 const Eigen::VectorXd& data_var /* = EigenVectorXd() */,
+                 const double prediction_point /*= std::numeric_limits<double>::quiet_NaN()*/)
+{
+    selectSubsetOfData(data_loc, data_out, n, data_var, prediction_point);
     infer();
 }
 
+/*
+ * Removes row and column j from the lower Cholesky factor L. The rows below j
+ * move up and the trailing block absorbs the removed column through a rank-1
+ * update, which is what factorizing the reduced matrix would have given.
+ */
+static void remove_from_cholesky_factor(Eigen::MatrixXd& L, int j)
+{
+    const int n = static_cast<int>(L.rows());
+    const int m = n - j - 1;
+    if (m > 0)
+    {
+        Eigen::VectorXd column = L.col(j).tail(m);
+        L.block(j, 0, m, j) = L.block(j + 1, 0, m, j).eval();
+        L.block(j, j, m, m) = L.block(j + 1, j + 1, m, m).eval();
+        math_tools::cholesky_rank1_update(L.block(j, j, m, m), column, 1.0); // an update can't fail
+    }
+    L.conservativeResize(n - 1, n - 1);
+}
+
+double GP::dataNoiseVariance(int i) const
+{
+    if (data_var_.rows() == 0) // homoscedastic
+    {
+        return std::exp(2 * log_noise_sd_) + JITTER;
+    }
+    return data_var_(i); // heteroscedastic
+}
+
+void GP::factorizeFromScratch()
+{
+    const int n = static_cast<int>(data_loc_.rows());
+
+    Eigen::MatrixXd data_cov = covFunc_->evaluate(data_loc_, data_loc_);
+    factor_var_.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        factor_var_(i) = dataNoiseVariance(i);
+        data_cov(i, i) += factor_var_(i);
+    }
+
+    Eigen::LLT<Eigen::MatrixXd> llt(data_cov);
+    if (llt.info() != Eigen::Success)
+    {
+        // not numerically positive definite, let the pivoting LDLT handle it
+        factor_loc_ = Eigen::VectorXd();
+        chol_factor_ = Eigen::MatrixXd();
+        infer();
+        return;
+    }
+
+    chol_factor_ = llt.matrixL();
+    factor_loc_ = data_loc_;
+    factor_hyper_parameters_ = getHyperParameters();
+    use_chol_factor_ = true;
+}
+
+bool GP::updateFactor()
+{
+    const int n = static_cast<int>(data_loc_.rows());
+    const int old_n = static_cast<int>(factor_loc_.rows());
+
+    if (old_n == 0 || chol_factor_.rows() != old_n)
+        return false;
+
+    Eigen::VectorXd hyper_parameters = getHyperParameters();
+    if (factor_hyper_parameters_.rows() != hyper_parameters.rows() || factor_hyper_parameters_ != hyper_parameters)
+        return false;
+
+    Eigen::VectorXd var(n);
+    for (int i = 0; i < n; ++i)
+    {
+        var(i) = dataNoiseVariance(i);
+    }
+
+    // find the points of the factor that are still in the data, matched by location and noise
+    std::vector<int> sorted(n);
+    for (int i = 0; i < n; ++i)
+    {
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [this](int a, int b) { return data_loc_(a) < data_loc_(b); });
+
+    std::vector<bool> matched(n, false);
+    std::vector<int> kept(old_n, -1); // index into the data, or -1 if the point left
+    int num_kept = 0;
+    for (int j = 0; j < old_n; ++j)
+    {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), factor_loc_(j),
+                                   [this](int a, double loc) { return data_loc_(a) < loc; });
+        for (; it != sorted.end() && data_loc_(*it) == factor_loc_(j); ++it)
+        {
+            if (!matched[*it] && var(*it) == factor_var_(j))
+            {
+                matched[*it] = true;
+                kept[j] = *it;
+                ++num_kept;
+                break;
+            }
+        }
+    }
+
+    // every removal and addition costs O(n^2), so beyond a third of the
+    // points the O(n^3/3) factorization from scratch is cheaper
+    const int num_changes = (old_n - num_kept) + (n - num_kept);
+    if (num_kept == 0 || 3 * num_changes > n)
+        return false;
+
+    for (int j = old_n - 1; j >= 0; --j)
+    {
+        if (kept[j] < 0)
+        {
+            remove_from_cholesky_factor(chol_factor_, j);
+        }
+    }
+
+    // reorder the data to match the factor: kept points first, new points appended
+    Eigen::VectorXd loc(n);
+    Eigen::VectorXd out(n);
+    Eigen::VectorXd new_var(n);
+    int m = 0;
+    for (int j = 0; j < old_n; ++j)
+    {
+        if (kept[j] >= 0)
+        {
+            loc(m) = data_loc_(kept[j]);
+            out(m) = data_out_(kept[j]);
+            new_var(m) = var(kept[j]);
+            ++m;
+        }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        if (!matched[i])
+        {
+            loc(m) = data_loc_(i);
+            out(m) = data_out_(i);
+            new_var(m) = var(i);
+            ++m;
+        }
+    }
+
+    if (data_var_.rows() > 0)
+    {
+        data_var_ = new_var;
+    }
+    data_loc_ = loc;
+    data_out_ = out;
+
+    // append the new points as rows of the factor
+    Eigen::MatrixXd added_cov = covFunc_->evaluate(data_loc_, data_loc_.tail(n - num_kept));
+    chol_factor_.conservativeResize(n, n);
+    for (int i = num_kept; i < n; ++i)
+    {
+        chol_factor_.col(i).setZero();
+        Eigen::VectorXd row = added_cov.col(i - num_kept).head(i);
+        chol_factor_.topLeftCorner(i, i).triangularView<Eigen::Lower>().solveInPlace(row);
+        double d2 = added_cov(i, i - num_kept) + new_var(i) - row.squaredNorm();
+        if (!(d2 > 0))
+            return false;
+        chol_factor_.row(i).head(i) = row.transpose();
+        chol_factor_(i, i) = std::sqrt(d2);
+    }
+
+    factor_loc_ = data_loc_;
+    factor_var_ = new_var;
+    return true;
+}
+
+void GP::updatePosterior()
+{
+    alpha_ = solveGram(data_out_);
+
+    if (use_explicit_trend_)
+    {
+        feature_vectors_ = Eigen::MatrixXd(2, data_loc_.rows());
+        // precompute necessary matrices for the explicit trend function
+        feature_vectors_.row(0) = Eigen::MatrixXd::Ones(1, data_loc_.rows()); // instead of pow(0)
+        feature_vectors_.row(1) = data_loc_.array(); // instead of pow(1)
+
+        feature_matrix_ = feature_vectors_ * solveGram(feature_vectors_.transpose());
+        chol_feature_matrix_ = feature_matrix_.ldlt();
+
+        beta_ = chol_feature_matrix_.solve(feature_vectors_) * alpha_;
+    }
+}
+
+Eigen::MatrixXd GP::solveGram(const Eigen::MatrixXd& rhs) const
+{
+    if (use_chol_factor_)
+    {
+        Eigen::MatrixXd y = chol_factor_.triangularView<Eigen::Lower>().solve(rhs);
+        return chol_factor_.transpose().triangularView<Eigen::Upper>().solve(y);
+    }
+    return chol_gram_matrix_.solve(rhs);
+}
+
+void GP::inferSDIncremental(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
+                            const Eigen::VectorXd& data_var /* = EigenVectorXd() */,
+                            const double prediction_point /*= std::numeric_limits<double>::quiet_NaN()*/)
+{
+    selectSubsetOfData(data_loc, data_out, n, data_var, prediction_point);
+    assert(data_loc_.rows() > 0 && "Error: the GP is not yet initialized!");
+
+    use_chol_factor_ = updateFactor();
+    if (!use_chol_factor_)
+    {
+        factorizeFromScratch();
+        if (!use_chol_factor_)
+            return; // fell back to infer()
+    }
+
+    // the Gram matrix is only kept in factored form
+    gram_matrix_ = Eigen::MatrixXd();
+    chol_gram_matrix_ = Eigen::LDLT<Eigen::MatrixXd>();
+
+    updatePosterior();
+}
+
 void GP::clearData()
 {
     gram_matrix_ = Eigen::MatrixXd();
     chol_gram_matrix_ = Eigen::LDLT<Eigen::MatrixXd>();
+    use_chol_factor_ = false;
     data_loc_ = Eigen::VectorXd();
     data_out_ = Eigen::VectorXd();
 }
@@ -393,7 +633,7 @@ Eigen::VectorXd GP::predict(const Eigen::MatrixXd& prior_cov, const Eigen::Matri
     Eigen::VectorXd m = mixed_cov * alpha_;
 
     // precompute K^{-1} * mixed_cov
-    Eigen::MatrixXd gamma = chol_gram_matrix_.solve(mixed_cov.transpose());
+    Eigen::MatrixXd gamma = solveGram(mixed_cov.transpose());
 
     Eigen::MatrixXd R;
 
@@ -77,6 +77,52 @@ private:
     Eigen::LDLT<Eigen::MatrixXd> chol_feature_matrix_;
     Eigen::VectorXd beta_;
 
+    // State of the incremental inference. The lower Cholesky factor of the
+    // Gram matrix is kept together with the locations, variances and
+    // hyperparameters it was computed for, so that the next incremental
+    // inference can update it instead of factorizing from scratch. It
+    // survives clearData(), which only forgets the data.
+    Eigen::MatrixXd chol_factor_;
+    Eigen::VectorXd factor_loc_;
+    Eigen::VectorXd factor_var_;
+    Eigen::VectorXd factor_hyper_parameters_;
+    bool use_chol_factor_; // solves use chol_factor_ instead of chol_gram_matrix_
+
+    /*!
+     * Selects the subset of data points for the SD approximation and stores
+     * it as the current data.
+     */
+    void selectSubsetOfData(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
+                            const Eigen::VectorXd& data_var, const double prediction_point);
+
+    /*!
+     * Noise variance of the i-th data point, as added to the Gram matrix.
+     */
+    double dataNoiseVariance(int i) const;
+
+    /*!
+     * Factorizes the Gram matrix of the current data from scratch and keeps
+     * the factor for later incremental updates.
+     */
+    void factorizeFromScratch();
+
+    /*!
+     * Brings the Cholesky factor up to date with the current data by
+     * removing and adding single points. Returns false if the factor could
+     * not be updated and needs to be computed from scratch.
+     */
+    bool updateFactor();
+
+    /*!
+     * Computes alpha and the explicit trend from the current factorization.
+     */
+    void updatePosterior();
+
+    /*!
+     * Solves the Gram matrix against the given right-hand side.
+     */
+    Eigen::MatrixXd solveGram(const Eigen::MatrixXd& rhs) const;
+
 public:
     typedef std::pair<Eigen::VectorXd, Eigen::MatrixXd> VectorMatrixPair;
 
@@ -145,6 +191,18 @@ public:
                  const Eigen::VectorXd& data_var = Eigen::VectorXd(),
                  const double prediction_point = std::numeric_limits<double>::quiet_NaN());
 
+    /*!
+     * Same as inferSD(), but instead of factorizing the Gram matrix of the
+     * selected subset in O(n^3), the Cholesky factor of the previous
+     * incremental inference is updated in O(n^2) per point that entered or
+     * left the subset (row append and rank-1 update). The factor is computed
+     * from scratch when the hyperparameters changed or when most of the
+     * subset was replaced.
+     */
+    void inferSDIncremental(const Eigen::VectorXd& data_loc, const Eigen::VectorXd& data_out, const int n,
+                            const Eigen::VectorXd& data_var = Eigen::VectorXd(),
+                            const double prediction_point = std::numeric_limits<double>::quiet_NaN());
+
     /*!
      * Sets the GP back to the prior:
      * Removes datapoints, empties the Gram matrix.
@@ -64,7 +64,7 @@ GaussianProcessGuider::GaussianProcessGuider(guide_parameters parameters)
     : start_time_(clock::now()), last_time_(clock::now()), control_signal_(0), prediction_(0), last_prediction_end_(0),
       dither_steps_(0), dithering_active_(false), dither_offset_(0.0), circular_buffer_data_(CIRCULAR_BUFFER_SIZE),
       covariance_function_(), output_covariance_function_(), gp_(covariance_function_), learning_rate_(DEFAULT_LEARNING_RATE),
-      parameters(parameters)
+      steps_since_period_estimation_(0), parameters(parameters)
 {
     circular_buffer_data_.push_front(data_point()); // add first point
     circular_buffer_data_[0].control = 0; // set first control to zero
@@ -205,8 +205,22 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
 
     // calculate period length if we have enough points already
     double period_length = GetGPHyperparameters()[PKPeriodLength];
-    if (GetBoolComputePeriod() && get_last_point().timestamp > parameters.min_periods_for_period_estimation_ * period_length)
+    bool estimate_period =
+        GetBoolComputePeriod() && get_last_point().timestamp > parameters.min_periods_for_period_estimation_ * period_length;
+
+    // the FFT only needs to run every few steps, the period changes slowly
+    if (estimate_period && ++steps_since_period_estimation_ < parameters.period_estimation_interval_)
+    {
+        estimate_period = false;
+    }
+
+    if (estimate_period)
     {
+        steps_since_period_estimation_ = 0;
+
+        // the GP is inferred again below, no need to refactorize the old data when the hyperparameters change
+        gp_.clearData();
+
         // find periodicity parameter with FFT
         period_length = EstimatePeriodLength(timestamps, gear_error_detrend);
         UpdatePeriodLength(period_length);
@@ -222,7 +236,14 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
 #endif
 
     // inference of the GP with the new points, maximum accuracy should be reached around current time
-    gp_.inferSD(timestamps, gear_error, parameters.points_for_approximation_, variances, prediction_point);
+    if (parameters.incremental_inference_)
+    {
+        gp_.inferSDIncremental(timestamps, gear_error, parameters.points_for_approximation_, variances, prediction_point);
+    }
+    else
+    {
+        gp_.inferSD(timestamps, gear_error, parameters.points_for_approximation_, variances, prediction_point);
+    }
 
 #if PRINT_TIMINGS_
     end = std::clock();
@@ -471,6 +492,33 @@ bool GaussianProcessGuider::SetBoolComputePeriod(bool active)
     return false;
 }
 
+int GaussianProcessGuider::GetPeriodEstimationInterval() const
+{
+    return parameters.period_estimation_interval_;
+}
+
+bool GaussianProcessGuider::SetPeriodEstimationInterval(int num_steps)
+{
+    if (num_steps < 1)
+    {
+        parameters.period_estimation_interval_ = 1;
+        return true; // error: at least every step
+    }
+    parameters.period_estimation_interval_ = num_steps;
+    return false;
+}
+
+bool GaussianProcessGuider::GetBoolIncrementalInference() const
+{
+    return parameters.incremental_inference_;
+}
+
+bool GaussianProcessGuider::SetBoolIncrementalInference(bool active)
+{
+    parameters.incremental_inference_ = active;
+    return false;
+}
+
 std::vector<double> GaussianProcessGuider::GetGPHyperparameters() const
 {
     // since the GP class works in log space, we have to exp() the parameters first.
@@ -676,8 +724,15 @@ void GaussianProcessGuider::UpdatePeriodLength(double period_length)
         period_length = hypers[PKPeriodLength]; // just use the old value instead
     }
 
-    // we just apply a simple learning rate to slow down parameter jumps
-    hypers[PKPeriodLength] = (1 - learning_rate_) * hypers[PKPeriodLength] + learning_rate_ * period_length;
+    // we just apply a simple learning rate to slow down parameter jumps. When
+    // the period is only estimated every few steps, the rate is compounded to
+    // adapt as fast as estimating in every step would.
+    double learning_rate = learning_rate_;
+    if (parameters.period_estimation_interval_ > 1)
+    {
+        learning_rate = 1 - std::pow(1 - learning_rate_, parameters.period_estimation_interval_);
+    }
+    hypers[PKPeriodLength] = (1 - learning_rate) * hypers[PKPeriodLength] + learning_rate * period_length;
 
     SetGPHyperparameters(hypers); // the setter function is needed to convert parameters
 }
@@ -96,6 +96,9 @@ public:
         int points_for_approximation_;
 
         bool compute_period_;
+        int period_estimation_interval_; // guide steps between two FFT period estimations
+
+        bool incremental_inference_; // update the Cholesky factor instead of refactorizing
 
         double SE0KLengthScale_;
         double SE0KSignalVariance_;
@@ -108,8 +111,9 @@ public:
         guide_parameters()
             : control_gain_(0.0), min_move_(0.0), prediction_gain_(0.0), min_periods_for_inference_(0.0),
               min_periods_for_period_estimation_(0.0), points_for_approximation_(0), compute_period_(false),
-              SE0KLengthScale_(0.0), SE0KSignalVariance_(0.0), PKLengthScale_(0.0), PKSignalVariance_(0.0),
-              SE1KLengthScale_(0.0), SE1KSignalVariance_(0.0), PKPeriodLength_(0.0)
+              period_estimation_interval_(1), incremental_inference_(false), SE0KLengthScale_(0.0),
+              SE0KSignalVariance_(0.0), PKLengthScale_(0.0), PKSignalVariance_(0.0), SE1KLengthScale_(0.0),
+              SE1KSignalVariance_(0.0), PKPeriodLength_(0.0)
         {
         }
     };
@@ -139,6 +143,11 @@ private:
      */
     double learning_rate_;
 
+    /**
+     * Guide steps since the last period estimation.
+     */
+    int steps_since_period_estimation_;
+
     /**
      * Guiding parameters of this instance.
      */
@@ -201,6 +210,12 @@ public:
     bool GetBoolComputePeriod() const;
     bool SetBoolComputePeriod(bool active);
 
+    int GetPeriodEstimationInterval() const;
+    bool SetPeriodEstimationInterval(int num_steps);
+
+    bool GetBoolIncrementalInference() const;
+    bool SetBoolIncrementalInference(bool active);
+
     std::vector<double> GetGPHyperparameters() const;
     bool SetGPHyperparameters(const std::vector<double>& hyperparameters);
 
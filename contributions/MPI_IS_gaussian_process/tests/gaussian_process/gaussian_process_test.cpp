@@ -209,6 +209,49 @@ TEST_F(GPTest, infer_prediction_clear_test)
     EXPECT_NEAR(prediction(1), 0, 1e-6);
 }
 
+// The incremental inference has to give the same predictions as the
+// inference from scratch on a sliding window of data
+TEST_F(GPTest, inferSDIncremental_test)
+{
+    int N = 60;
+    int n = 20;
+    Eigen::VectorXd locations = Eigen::VectorXd::LinSpaced(N, 0, 6);
+    Eigen::VectorXd outputs = locations.array().sin() + 0.1 * locations.array();
+    Eigen::VectorXd variances = Eigen::VectorXd::Constant(N, 0.01);
+
+    GP gp(0.1, covariance_function_);
+    gp.enableExplicitTrend();
+    GP gp_incremental(0.1, covariance_function_);
+    gp_incremental.enableExplicitTrend();
+
+    Eigen::VectorXd prediction_location(3);
+    for (int k = 5; k <= N; ++k)
+    {
+        if (k == 40) // the factor has to follow changes of the hyperparameters
+        {
+            Eigen::VectorXd hyper_parameters = gp.getHyperParameters();
+            hyper_parameters(1) += 0.1;
+            gp.setHyperParameters(hyper_parameters);
+            gp_incremental.setHyperParameters(hyper_parameters);
+        }
+
+        gp.inferSD(locations.head(k), outputs.head(k), n, variances.head(k));
+        gp_incremental.inferSDIncremental(locations.head(k), outputs.head(k), n, variances.head(k));
+
+        prediction_location << locations(k - 1) - 0.5, locations(k - 1), locations(k - 1) + 0.5;
+        Eigen::VectorXd variance;
+        Eigen::VectorXd variance_incremental;
+        Eigen::VectorXd prediction = gp.predict(prediction_location, &variance);
+        Eigen::VectorXd prediction_incremental = gp_incremental.predict(prediction_location, &variance_incremental);
+
+        for (int i = 0; i < prediction_location.rows(); ++i)
+        {
+            EXPECT_NEAR(prediction(i), prediction_incremental(i), 1e-6);
+            EXPECT_NEAR(variance(i), variance_incremental(i), 1e-6);
+        }
+    }
+}
+
 TEST_F(GPTest, squareDistanceTest)
 {
     Eigen::MatrixXd a(4, 3);
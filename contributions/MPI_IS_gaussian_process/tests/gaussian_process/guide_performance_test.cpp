@@ -69,6 +69,7 @@ public:
     GAHysteresis GAH;
     std::string filename;
     double improvement;
+    std::vector<double> step_latency;
 
     GuidePerformanceTest() : GPG(0), improvement(0.0)
     {
@@ -115,67 +116,108 @@ const bool GuidePerformanceTest::DefaultComputePeriod = true;
 TEST_F(GuidePerformanceTest, performance_dataset01)
 {
     filename = "performance_dataset01.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset02)
 {
     filename = "performance_dataset02.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset03)
 {
     filename = "performance_dataset03.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset04)
 {
     filename = "performance_dataset04.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset05)
 {
     filename = "performance_dataset05.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset06)
 {
     filename = "performance_dataset06.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset07)
 {
     filename = "performance_dataset07.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
 TEST_F(GuidePerformanceTest, performance_dataset08)
 {
     filename = "performance_dataset08.txt";
-    improvement = calculate_improvement(filename, GAH, GPG);
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
     std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
     EXPECT_GT(improvement, 0);
 }
 
+/*
+ * The same datasets with the incremental GP inference and the period
+ * estimated only every few guide steps.
+ */
+class IncrementalGuidePerformanceTest : public GuidePerformanceTest, public ::testing::WithParamInterface<const char *>
+{
+public:
+    static const int DefaultPeriodEstimationInterval; // guide steps between FFT period estimations
+
+    IncrementalGuidePerformanceTest()
+    {
+        GPG->SetBoolIncrementalInference(true);
+        GPG->SetPeriodEstimationInterval(DefaultPeriodEstimationInterval);
+    }
+};
+
+const int IncrementalGuidePerformanceTest::DefaultPeriodEstimationInterval = 10;
+
+TEST_P(IncrementalGuidePerformanceTest, performance)
+{
+    filename = GetParam();
+    improvement = calculate_improvement(filename, GAH, GPG, &step_latency);
+    std::cout << "Improvement of GPGuiding over Hysteresis: " << 100 * improvement << "%" << std::endl;
+    print_step_latency(step_latency);
+    EXPECT_GT(improvement, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Datasets, IncrementalGuidePerformanceTest,
+                         ::testing::Values("performance_dataset01.txt", "performance_dataset02.txt",
+                                           "performance_dataset03.txt", "performance_dataset04.txt",
+                                           "performance_dataset05.txt", "performance_dataset06.txt",
+                                           "performance_dataset07.txt", "performance_dataset08.txt"));
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
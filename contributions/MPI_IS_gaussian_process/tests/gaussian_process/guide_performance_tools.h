@@ -34,6 +34,8 @@
 
 #include "gaussian_process_guider.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <iostream>
 #include <fstream>
@@ -197,8 +199,11 @@ public:
 
 /*
  * Calculates the improvement of the GP Guider over Hysteresis on a dataset.
+ * If step_latency is given, it receives the time in microseconds that each
+ * guide step of the GP Guider took.
  */
-inline double calculate_improvement(std::string filename, GAHysteresis GAH, GaussianProcessGuider *GPG)
+inline double calculate_improvement(std::string filename, GAHysteresis GAH, GaussianProcessGuider *GPG,
+                                    std::vector<double> *step_latency = nullptr)
 {
     Eigen::ArrayXXd data = read_data_from_file(filename);
     double exposure = get_exposure_from_file(filename);
@@ -229,7 +234,13 @@ inline double calculate_improvement(std::string filename, GAHysteresis GAH, Gaus
         {
             GPG->inject_data_point(times(j), measurements(j), SNRs(j), controls(j));
         }
+        auto step_start = std::chrono::steady_clock::now();
         gp_guider_control = GPG->result(gp_guider_state, SNRs(i), exposure);
+        if (step_latency != nullptr)
+        {
+            step_latency->push_back(
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - step_start).count());
+        }
         gp_guider_state = gp_guider_state + (measurements(i + 1) - (measurements(i) - controls(i))) - gp_guider_control;
         assert(fabs(gp_guider_state) < 100);
 
@@ -241,3 +252,25 @@ inline double calculate_improvement(std::string filename, GAHysteresis GAH, Gaus
 
     return 1 - gp_guider_rms / hysteresis_rms;
 }
+
+/*
+ * Prints mean, median, 95th percentile and maximum of the per-step latency.
+ */
+inline void print_step_latency(std::vector<double> step_latency)
+{
+    if (step_latency.empty())
+    {
+        return;
+    }
+    std::sort(step_latency.begin(), step_latency.end());
+    double mean = 0.0;
+    for (double latency : step_latency)
+    {
+        mean += latency;
+    }
+    mean /= step_latency.size();
+
+    size_t n = step_latency.size();
+    std::cout << "Latency per guide step [us]: mean " << mean << ", median " << step_latency[n / 2] << ", p95 "
+              << step_latency[std::min(n - 1, (95 * n) / 100)] << ", max " << step_latency[n - 1] << std::endl;
+}
@@ -206,6 +206,30 @@ TEST(MathToolsTest, StdTest)
     EXPECT_NEAR(math_tools::stdandard_deviation(data), matlab_result, 1e-3);
 }
 
+TEST(MathToolsTest, CholeskyRank1UpdateTest)
+{
+    Eigen::MatrixXd A(4, 4);
+    A << 4, 1, 0.5, 0.2, 1, 3, 0.3, 0.1, 0.5, 0.3, 2, 0.4, 0.2, 0.1, 0.4, 1;
+    Eigen::VectorXd x(4);
+    x << 0.3, -0.2, 0.5, 0.1;
+
+    Eigen::MatrixXd L = A.llt().matrixL();
+
+    // update: L * L^T = A + x * x^T
+    EXPECT_TRUE(math_tools::cholesky_rank1_update(L, x, 1.0));
+    Eigen::MatrixXd expected_L = Eigen::MatrixXd((A + x * x.transpose()).llt().matrixL());
+    EXPECT_NEAR((L - expected_L).cwiseAbs().maxCoeff(), 0, 1e-12);
+
+    // downdate back to A
+    EXPECT_TRUE(math_tools::cholesky_rank1_update(L, x, -1.0));
+    expected_L = A.llt().matrixL();
+    EXPECT_NEAR((L - expected_L).cwiseAbs().maxCoeff(), 0, 1e-12);
+
+    // a downdate that loses positive definiteness fails
+    Eigen::VectorXd y = 10 * x;
+    EXPECT_FALSE(math_tools::cholesky_rank1_update(L, y, -1.0));
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -43,6 +43,7 @@
 
 #include "math_tools.h"
 #include <stdexcept>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 
@@ -224,4 +225,31 @@ double stdandard_deviation(Eigen::VectorXd& input)
     return std::sqrt(centered.pow(2).sum() / (centered.size() - 1));
 }
 
+bool cholesky_rank1_update(Eigen::Ref<Eigen::MatrixXd> L, Eigen::VectorXd x, double sigma /* = 1.0 */)
+{
+    const Eigen::Index n = L.rows();
+    assert(L.cols() == n && x.rows() == n);
+
+    for (Eigen::Index k = 0; k < n; ++k)
+    {
+        double r2 = L(k, k) * L(k, k) + sigma * x(k) * x(k);
+        if (!(r2 > 0.0))
+        {
+            return false; // not positive definite any more
+        }
+        double r = std::sqrt(r2);
+        double c = r / L(k, k);
+        double s = x(k) / L(k, k);
+        L(k, k) = r;
+
+        const Eigen::Index m = n - k - 1;
+        if (m > 0)
+        {
+            L.col(k).tail(m) = (L.col(k).tail(m) + sigma * s * x.tail(m)) / c;
+            x.tail(m) = c * x.tail(m) - s * L.col(k).tail(m);
+        }
+    }
+    return true;
+}
+
 } // namespace math_tools
@@ -153,6 +153,16 @@ Eigen::VectorXd hamming_window(int N);
  */
 double stdandard_deviation(Eigen::VectorXd& input);
 
+/*!
+ * Rank-1 update (sigma = 1) or downdate (sigma = -1) of a Cholesky factor.
+ *
+ * Given the lower triangular factor L of A = L * L^T, overwrites L with the
+ * factor of A + sigma * x * x^T in O(n^2) operations. Returns false if the
+ * downdated matrix is not positive definite, in which case L is left in an
+ * undefined state.
+ */
+bool cholesky_rank1_update(Eigen::Ref<Eigen::MatrixXd> L, Eigen::VectorXd x, double sigma = 1.0);
+
 } // namespace math_tools
 
 #endif // define GP_MATH_TOOLS_H
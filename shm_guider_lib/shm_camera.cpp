@@ -305,6 +305,9 @@ int shm_camera_write_selected(uint32_t index)
     munmap(shm, shm_size);
     close(shm_fd);
 
+    // Wake the PHD2 monitor thread
+    shm_camera_signal_client_request();
+
     return 0;
 }
 
@@ -408,6 +411,12 @@ void shm_camera_signal_client_request(void)
 }
 
 int shm_camera_wait_client_request(void)
+{
+    // Use timed wait with 1 second timeout to allow thread to check for shutdown
+    return shm_camera_timedwait_client_request(1000);
+}
+
+int shm_camera_timedwait_client_request(int timeout_ms)
 {
     sem_t* sem = sem_open(PHD2_CAMERA_SEM_CLIENT_REQUEST, O_CREAT, 0666, 0);
     if (sem == SEM_FAILED)
@@ -415,12 +424,19 @@ int shm_camera_wait_client_request(void)
         return -1;
     }
 
-    // Use timed wait with 1 second timeout to allow thread to check for shutdown
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
-    ts.tv_sec += 1;  // 1 second timeout
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
 
-    int result = sem_timedwait(sem, &ts);
+    int result;
+    while ((result = sem_timedwait(sem, &ts)) == -1 && errno == EINTR)
+        ;
     sem_close(sem);
     return result;
 }
@@ -455,6 +471,9 @@ int shm_camera_write_selected_id(const char* camera_id)
     shm->selected_change_counter++;
     shm->timestamp = (uint32_t)time(NULL);
 
+    // Wake the PHD2 monitor thread
+    shm_camera_signal_client_request();
+
     return 0;
 }
 
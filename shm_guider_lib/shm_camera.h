@@ -253,6 +253,13 @@ void shm_camera_signal_client_request(void);
  */
 int shm_camera_wait_client_request(void);
 
+/**
+ * Wait for client request with a timeout (called by PHD2)
+ * @param timeout_ms Timeout in milliseconds
+ * @return 0 when a client signalled a request, -1 on timeout or error
+ */
+int shm_camera_timedwait_client_request(int timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
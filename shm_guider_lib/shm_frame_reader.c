@@ -0,0 +1,256 @@
+/*
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ *  shm_frame_reader.c
+ *  PHD Guiding
+ *
+ *  Example frame ring consumer: waits for guide frames published by PHD2,
+ *  reads them in place and prints the frame and guide step information
+ *
+ *  usage: shm_frame_reader [-i instance] [-n frames] [-t timeout_ms] [-o last_frame.pgm]
+ *
+ */
+
+#include "shm_frame_ring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char* dir_name(int32_t dir)
+{
+    switch (dir)
+    {
+    case FRAME_RING_DIR_NORTH: return "N";
+    case FRAME_RING_DIR_SOUTH: return "S";
+    case FRAME_RING_DIR_EAST: return "E";
+    case FRAME_RING_DIR_WEST: return "W";
+    default: return "-";
+    }
+}
+
+static void print_frame(const FrameRingRecord* rec, double mean, uint16_t maxval)
+{
+    printf("#%llu frame %u %ux%u at (%u,%u) of %ux%u mean %.1f max %u", (unsigned long long)rec->index, rec->frame_number,
+           rec->width, rec->height, rec->origin_x, rec->origin_y, rec->full_width, rec->full_height, mean, maxval);
+
+    if (rec->flags & FRAME_RING_STAR_FOUND)
+        printf(" star (%.2f,%.2f) mass %.0f snr %.1f hfd %.2f stars %u", rec->star_x, rec->star_y, rec->star_mass,
+               rec->star_snr, rec->star_hfd, rec->num_stars);
+
+    printf("\n");
+}
+
+static void print_step(const FrameRingRecord* rec)
+{
+    const FrameRingStep* step = &rec->step;
+    printf("    step for frame %u: offset (%.2f,%.2f) ra %.2f dec %.2f pulses %s%dms%s %s%dms%s\n", rec->frame_number,
+           step->camera_dx, step->camera_dy, step->ra_distance, step->dec_distance, dir_name(step->ra_direction),
+           step->ra_duration, step->ra_limited ? "*" : "", dir_name(step->dec_direction), step->dec_duration,
+           step->dec_limited ? "*" : "");
+}
+
+static int write_pgm(const char* path, const FrameRingRecord* rec, const uint16_t* pixels)
+{
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(f, "P5\n%u %u\n65535\n", rec->width, rec->height);
+    for (size_t i = 0; i < (size_t)rec->width * rec->height; i++)
+    {
+        unsigned char be[2] = { (unsigned char)(pixels[i] >> 8), (unsigned char)(pixels[i] & 0xff) };
+        fwrite(be, 1, 2, f);
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int instance = 1;
+    long max_frames = 0;
+    int timeout_ms = 10000;
+    const char* pgm_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:n:t:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i': instance = (unsigned int)atoi(optarg); break;
+        case 'n': max_frames = atol(optarg); break;
+        case 't': timeout_ms = atoi(optarg); break;
+        case 'o': pgm_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-i instance] [-n frames] [-t timeout_ms] [-o last_frame.pgm]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const FrameRingSHM* ring = shm_frame_ring_open(instance);
+    if (ring == NULL)
+    {
+        fprintf(stderr, "frame ring not available, is PHD2 instance %u running with the frame ring enabled?\n", instance);
+        return 1;
+    }
+
+    printf("frame ring: %u slots, %u pixels per slot\n", ring->num_slots, ring->max_pixels);
+
+    uint64_t last = shm_frame_ring_latest(ring);
+    long frames = 0;
+    long torn = 0;
+    uint16_t* last_pixels = NULL;
+    uint16_t* scratch = NULL;
+    FrameRingRecord last_rec;
+    memset(&last_rec, 0, sizeof(last_rec));
+    int have_pending_step = 0;
+    uint64_t pending_step_index = 0;
+
+    while (max_frames == 0 || frames < max_frames)
+    {
+        if (shm_frame_ring_is_closed(ring))
+        {
+            // PHD2 replaced the ring, e.g. for a larger frame size
+            shm_frame_ring_close(ring);
+            struct timespec delay = { 0, 100000000L };
+            int waited = 0;
+            while ((ring = shm_frame_ring_open(instance)) == NULL && waited < timeout_ms)
+            {
+                nanosleep(&delay, NULL);
+                waited += 100;
+            }
+            if (ring == NULL)
+            {
+                fprintf(stderr, "frame ring closed\n");
+                break;
+            }
+            last = 0;
+            have_pending_step = 0;
+            continue;
+        }
+
+        // the guide step is attached to a frame after the frame is published, so poll
+        // for it until the next frame arrives
+        int step_poll = have_pending_step;
+        int rslt = shm_frame_ring_wait(ring, last, step_poll ? 5 : timeout_ms);
+
+        if (have_pending_step)
+        {
+            FrameRingRecord rec;
+            if (shm_frame_ring_read(ring, pending_step_index, &rec, NULL, 0) != 0)
+                have_pending_step = 0;
+            else if (rec.flags & FRAME_RING_STEP_VALID)
+            {
+                print_step(&rec);
+                have_pending_step = 0;
+            }
+        }
+
+        if (rslt != 0)
+        {
+            if (step_poll || shm_frame_ring_is_closed(ring))
+                continue;
+            fprintf(stderr, "no frame within %d ms\n", timeout_ms);
+            break;
+        }
+
+        uint64_t index = shm_frame_ring_latest(ring);
+        if (last != 0 && index > last + 1)
+            printf("    skipped %llu frames\n", (unsigned long long)(index - last - 1));
+        last = index;
+
+        // compute simple statistics straight from shared memory
+        FrameRingView view;
+        if (shm_frame_ring_read_begin(ring, index, &view) != 0)
+            continue;
+
+        FrameRingRecord rec = *view.record;
+        size_t npix = (size_t)rec.width * rec.height;
+        if (npix > ring->max_pixels)
+            npix = 0;  // torn header, discarded below
+        uint64_t sum = 0;
+        uint16_t maxval = 0;
+        for (size_t i = 0; i < npix; i++)
+        {
+            uint16_t v = view.pixels[i];
+            sum += v;
+            if (v > maxval)
+                maxval = v;
+        }
+        if (pgm_path != NULL)
+        {
+            scratch = (uint16_t*)realloc(scratch, npix ? npix * sizeof(uint16_t) : 1);
+            memcpy(scratch, view.pixels, npix * sizeof(uint16_t));
+        }
+
+        if (shm_frame_ring_read_end(&view) != 0)
+        {
+            ++torn;
+            continue;
+        }
+
+        print_frame(&rec, npix ? (double)sum / npix : 0.0, maxval);
+        last_rec = rec;
+        if (pgm_path != NULL)
+        {
+            uint16_t* tmp = last_pixels;
+            last_pixels = scratch;
+            scratch = tmp;
+        }
+        ++frames;
+
+        if (rec.flags & FRAME_RING_STEP_VALID)
+            print_step(&rec);
+        else if (rec.flags & FRAME_RING_GUIDING)
+        {
+            have_pending_step = 1;
+            pending_step_index = index;
+        }
+    }
+
+    printf("%ld frames read, %ld overwritten while reading\n", frames, torn);
+
+    if (pgm_path != NULL && frames > 0 && write_pgm(pgm_path, &last_rec, last_pixels) == 0)
+        printf("wrote last frame to %s\n", pgm_path);
+
+    free(last_pixels);
+    free(scratch);
+    if (ring != NULL)
+        shm_frame_ring_close(ring);
+
+    return 0;
+}
@@ -0,0 +1,474 @@
+/*
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ *  shm_frame_ring.cpp
+ *  PHD Guiding
+ *
+ *  POSIX Shared Memory ring of recent guide frames
+ *
+ */
+
+#include "shm_frame_ring.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <stdio.h>
+
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+#endif
+
+// ===== FRAME RING SHARED MEMORY IMPLEMENTATION =====
+
+static int g_ring_shm_fd = -1;
+static FrameRingSHM* g_ring_shm_ptr = NULL;
+static char g_ring_shm_name[64];
+
+static void ring_name(char* name, size_t len, uint32_t instance)
+{
+    snprintf(name, len, PHD2_FRAME_RING_SHM_NAME_FMT, instance);
+}
+
+static inline uint64_t align_up(uint64_t n, uint64_t align)
+{
+    return (n + align - 1) & ~(align - 1);
+}
+
+static inline FrameRingSlot* ring_slot(const FrameRingSHM* shm, uint64_t index)
+{
+    uint64_t slot = (index - 1) % shm->num_slots;
+    return (FrameRingSlot*)((char*)shm + shm->slots_offset + slot * shm->slot_stride);
+}
+
+static inline uint16_t* slot_pixels(const FrameRingSHM* shm, const FrameRingSlot* slot)
+{
+    return (uint16_t*)((char*)slot + shm->slot_pixel_offset);
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Readers sleep on publish_seq. The segment is shared between processes, so the
+// futex must not be process-private.
+static void wake_readers(FrameRingSHM* shm)
+{
+#ifdef __linux__
+    syscall(SYS_futex, &shm->publish_seq, FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+#else
+    (void)shm;
+#endif
+}
+
+static void wait_readers(const FrameRingSHM* shm, uint32_t seq, int timeout_ms)
+{
+#ifdef __linux__
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, &shm->publish_seq, FUTEX_WAIT, seq, &ts, NULL, 0);
+#else
+    (void)shm;
+    (void)seq;
+    struct timespec ts = { 0, (timeout_ms < 1 ? timeout_ms : 1) * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// Seqlock writer: the slot sequence is odd while the slot is modified
+static inline uint32_t slot_write_begin(FrameRingSlot* slot)
+{
+    uint32_t seq = slot->seq;
+    __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return seq;
+}
+
+static inline void slot_write_end(FrameRingSlot* slot, uint32_t seq)
+{
+    __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+// A segment left over from an earlier run of this PHD2 instance (or from a smaller
+// ring) may still be mapped by readers; mark it closed so they reopen the new one.
+// Each instance has its own segment name, so this never touches another instance's ring.
+static void close_stale_segment(const char* name)
+{
+    int fd = shm_open(name, O_RDWR, 0666);
+    if (fd == -1)
+        return;
+
+    struct stat sb;
+    if (fstat(fd, &sb) == 0 && (size_t)sb.st_size >= sizeof(FrameRingSHM))
+    {
+        FrameRingSHM* shm = (FrameRingSHM*)mmap(NULL, sizeof(FrameRingSHM), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (shm != MAP_FAILED)
+        {
+            __atomic_store_n(&shm->closed, 1, __ATOMIC_RELEASE);
+            wake_readers(shm);
+            munmap(shm, sizeof(FrameRingSHM));
+        }
+    }
+
+    close(fd);
+    shm_unlink(name);
+}
+
+FrameRingSHM* shm_frame_ring_init(uint32_t instance, uint32_t num_slots, uint32_t max_pixels)
+{
+    char name[sizeof(g_ring_shm_name)];
+    ring_name(name, sizeof(name), instance);
+
+    if (g_ring_shm_ptr != NULL)
+    {
+        if (strcmp(name, g_ring_shm_name) == 0 && g_ring_shm_ptr->num_slots == num_slots &&
+            g_ring_shm_ptr->max_pixels >= max_pixels)
+        {
+            return g_ring_shm_ptr;  // Already initialized
+        }
+
+        shm_frame_ring_cleanup(g_ring_shm_ptr, 1);
+    }
+
+    if (num_slots == 0 || max_pixels == 0)
+    {
+        return NULL;
+    }
+
+    close_stale_segment(name);
+
+    uint64_t slots_offset = align_up(sizeof(FrameRingSHM), 4096);
+    uint64_t pixel_offset = align_up(sizeof(FrameRingSlot), 64);
+    uint64_t stride = align_up(pixel_offset + (uint64_t)max_pixels * sizeof(uint16_t), 4096);
+    uint64_t total_size = slots_offset + num_slots * stride;
+
+    g_ring_shm_fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+
+    if (g_ring_shm_fd == -1)
+    {
+        fprintf(stderr, "shm_guider: Failed to create frame ring shared memory: %s\n", strerror(errno));
+        return NULL;
+    }
+
+    if (ftruncate(g_ring_shm_fd, (off_t)total_size) == -1)
+    {
+        fprintf(stderr, "shm_guider: Failed to set frame ring size: %s\n", strerror(errno));
+        close(g_ring_shm_fd);
+        g_ring_shm_fd = -1;
+        shm_unlink(name);
+        return NULL;
+    }
+
+    g_ring_shm_ptr = (FrameRingSHM*)mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, g_ring_shm_fd, 0);
+
+    if (g_ring_shm_ptr == MAP_FAILED)
+    {
+        fprintf(stderr, "shm_guider: Failed to map frame ring shared memory: %s\n", strerror(errno));
+        close(g_ring_shm_fd);
+        g_ring_shm_fd = -1;
+        g_ring_shm_ptr = NULL;
+        shm_unlink(name);
+        return NULL;
+    }
+
+    strcpy(g_ring_shm_name, name);
+
+    // ftruncate zero-fills the segment, so all slots start out empty with an even sequence
+    g_ring_shm_ptr->version = PHD2_FRAME_RING_VERSION;
+    g_ring_shm_ptr->num_slots = num_slots;
+    g_ring_shm_ptr->max_pixels = max_pixels;
+    g_ring_shm_ptr->total_size = total_size;
+    g_ring_shm_ptr->slots_offset = slots_offset;
+    g_ring_shm_ptr->slot_stride = stride;
+    g_ring_shm_ptr->slot_pixel_offset = pixel_offset;
+    // readers check the magic number, so set it last
+    __atomic_store_n(&g_ring_shm_ptr->magic, PHD2_FRAME_RING_MAGIC, __ATOMIC_RELEASE);
+
+    fprintf(stderr, "shm_guider: Created frame ring shared memory %s, %u slots of %u pixels\n", name, num_slots,
+            max_pixels);
+
+    return g_ring_shm_ptr;
+}
+
+void shm_frame_ring_cleanup(FrameRingSHM* shm, int unlink)
+{
+    if (shm == NULL || shm != g_ring_shm_ptr)
+        return;
+
+    if (unlink)
+    {
+        __atomic_store_n(&shm->closed, 1, __ATOMIC_RELEASE);
+        wake_readers(shm);
+    }
+
+    munmap(g_ring_shm_ptr, g_ring_shm_ptr->total_size);
+    g_ring_shm_ptr = NULL;
+
+    if (g_ring_shm_fd != -1)
+    {
+        close(g_ring_shm_fd);
+        g_ring_shm_fd = -1;
+    }
+
+    if (unlink)
+    {
+        shm_unlink(g_ring_shm_name);
+        fprintf(stderr, "shm_guider: Unlinked frame ring shared memory %s\n", g_ring_shm_name);
+    }
+}
+
+uint64_t shm_frame_ring_publish(FrameRingSHM* shm, const FrameRingRecord* record, const uint16_t* pixels, uint32_t stride)
+{
+    if (shm == NULL || record == NULL)
+        return 0;
+
+    uint64_t npix = (uint64_t)record->width * record->height;
+    if (npix > shm->max_pixels || (npix != 0 && pixels == NULL))
+    {
+        return 0;
+    }
+
+    // PHD2 is the only writer, so publish_count cannot change under us
+    uint64_t index = shm->publish_count + 1;
+    FrameRingSlot* slot = ring_slot(shm, index);
+    uint16_t* dst = slot_pixels(shm, slot);
+
+    uint32_t seq = slot_write_begin(slot);
+
+    memcpy(&slot->record, record, sizeof(FrameRingRecord));
+    slot->record.index = index;
+    slot->record.timestamp = now_seconds();
+    if (slot->record.num_stars > PHD2_FRAME_RING_MAX_STARS)
+        slot->record.num_stars = PHD2_FRAME_RING_MAX_STARS;
+
+    if (stride == record->width)
+    {
+        memcpy(dst, pixels, npix * sizeof(uint16_t));
+    }
+    else
+    {
+        for (uint32_t y = 0; y < record->height; y++)
+        {
+            memcpy(dst + (size_t)y * record->width, pixels + (size_t)y * stride, record->width * sizeof(uint16_t));
+        }
+    }
+
+    slot_write_end(slot, seq);
+
+    __atomic_store_n(&shm->publish_count, index, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->publish_seq, (uint32_t)index, __ATOMIC_RELEASE);
+    wake_readers(shm);
+
+    return index;
+}
+
+int shm_frame_ring_publish_step(FrameRingSHM* shm, uint32_t frame_number, const FrameRingStep* step)
+{
+    if (shm == NULL || step == NULL)
+        return -1;
+
+    // the step usually belongs to the newest frame, so search from newest to oldest
+    for (uint64_t index = shm->publish_count; index > 0 && index + shm->num_slots > shm->publish_count; index--)
+    {
+        FrameRingSlot* slot = ring_slot(shm, index);
+        if (slot->record.frame_number != frame_number)
+            continue;
+
+        uint32_t seq = slot_write_begin(slot);
+        slot->record.step = *step;
+        slot->record.flags |= FRAME_RING_STEP_VALID;
+        slot_write_end(slot, seq);
+
+        return 0;
+    }
+
+    return -1;
+}
+
+const FrameRingSHM* shm_frame_ring_open(uint32_t instance)
+{
+    char name[64];
+    ring_name(name, sizeof(name), instance);
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1)
+    {
+        return NULL;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || (size_t)sb.st_size < sizeof(FrameRingSHM))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void* p = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED)
+    {
+        fprintf(stderr, "shm_guider: Failed to map frame ring shared memory: %s\n", strerror(errno));
+        return NULL;
+    }
+
+    const FrameRingSHM* shm = (const FrameRingSHM*)p;
+
+    // PHD2 may still be setting the ring up
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != PHD2_FRAME_RING_MAGIC || shm->version != PHD2_FRAME_RING_VERSION ||
+        shm->total_size != (uint64_t)sb.st_size)
+    {
+        munmap(p, sb.st_size);
+        return NULL;
+    }
+
+    return shm;
+}
+
+void shm_frame_ring_close(const FrameRingSHM* shm)
+{
+    if (shm != NULL)
+        munmap((void*)shm, shm->total_size);
+}
+
+int shm_frame_ring_is_closed(const FrameRingSHM* shm)
+{
+    return shm == NULL || __atomic_load_n(&shm->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+uint64_t shm_frame_ring_latest(const FrameRingSHM* shm)
+{
+    if (shm == NULL)
+        return 0;
+
+    return __atomic_load_n(&shm->publish_count, __ATOMIC_ACQUIRE);
+}
+
+int shm_frame_ring_wait(const FrameRingSHM* shm, uint64_t after_index, int timeout_ms)
+{
+    if (shm == NULL)
+        return -1;
+
+    int64_t deadline = monotonic_ms() + timeout_ms;
+
+    for (;;)
+    {
+        // read the futex word before checking, so a publish in between makes the wait return at once
+        uint32_t seq = __atomic_load_n(&shm->publish_seq, __ATOMIC_ACQUIRE);
+
+        if (shm_frame_ring_latest(shm) > after_index)
+            return 0;
+
+        if (shm_frame_ring_is_closed(shm))
+            return -1;
+
+        int64_t remaining = deadline - monotonic_ms();
+        if (remaining <= 0)
+            return -1;
+
+        wait_readers(shm, seq, (int)remaining);
+    }
+}
+
+int shm_frame_ring_read_begin(const FrameRingSHM* shm, uint64_t index, FrameRingView* view)
+{
+    if (shm == NULL || view == NULL || index == 0 || index > shm_frame_ring_latest(shm))
+        return -1;
+
+    const FrameRingSlot* slot = ring_slot(shm, index);
+
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if ((seq & 1) != 0 || slot->record.index != index)
+        return -1;
+
+    view->record = &slot->record;
+    view->pixels = slot_pixels(shm, slot);
+    view->seq_ptr = &slot->seq;
+    view->seq = seq;
+
+    return 0;
+}
+
+int shm_frame_ring_read_end(const FrameRingView* view)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(view->seq_ptr, __ATOMIC_RELAXED) == view->seq ? 0 : -1;
+}
+
+int shm_frame_ring_read(const FrameRingSHM* shm, uint64_t index, FrameRingRecord* record, uint16_t* pixels,
+                        uint32_t max_pixels)
+{
+    if (record == NULL)
+        return -1;
+
+    // retry while PHD2 is updating the slot, give up once the frame has been overwritten
+    for (int tries = 0; tries < 100; tries++)
+    {
+        if (index + shm->num_slots <= shm_frame_ring_latest(shm))
+            return -1;
+
+        FrameRingView view;
+        if (shm_frame_ring_read_begin(shm, index, &view) != 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        memcpy(record, view.record, sizeof(FrameRingRecord));
+
+        uint64_t npix = (uint64_t)record->width * record->height;
+        int fits = npix <= max_pixels && npix <= shm->max_pixels;
+        if (pixels != NULL && fits)
+            memcpy(pixels, view.pixels, npix * sizeof(uint16_t));
+
+        if (shm_frame_ring_read_end(&view) == 0)
+            return pixels == NULL || fits ? 0 : -1;
+    }
+
+    return -1;
+}
@@ -0,0 +1,262 @@
+/*
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ *  shm_frame_ring.h
+ *  PHD Guiding
+ *
+ *  POSIX Shared Memory ring of recent guide frames
+ *  Lets local processes read guide frames and guide step results without copying
+ *  them through a socket
+ *
+ */
+
+#ifndef SHM_FRAME_RING_H_INCLUDED
+#define SHM_FRAME_RING_H_INCLUDED
+
+#include <stdint.h>
+
+// Shared memory segment name; %u is the PHD2 instance number
+#define PHD2_FRAME_RING_SHM_NAME_FMT "/phd2_frame_ring_%u"
+// Magic number ("PHFR") and version for compatibility checking
+#define PHD2_FRAME_RING_MAGIC 0x52464850
+#define PHD2_FRAME_RING_VERSION 1
+// Maximum number of guide star positions stored with a frame
+#define PHD2_FRAME_RING_MAX_STARS 32
+
+// FrameRingRecord flags
+#define FRAME_RING_STAR_FOUND 0x1   // star_x/star_y, mass, SNR and HFD are valid
+#define FRAME_RING_LOCK_VALID 0x2   // lock_x/lock_y are valid
+#define FRAME_RING_GUIDING 0x4      // the frame was taken while guiding
+#define FRAME_RING_STEP_VALID 0x8   // step holds the guide step issued for this frame
+
+// Guide directions, same values as PHD2's GUIDE_DIRECTION
+#define FRAME_RING_DIR_NONE -1
+#define FRAME_RING_DIR_NORTH 0
+#define FRAME_RING_DIR_SOUTH 1
+#define FRAME_RING_DIR_EAST 2
+#define FRAME_RING_DIR_WEST 3
+
+/**
+ * Guide step issued for a frame
+ */
+typedef struct {
+    float camera_dx;                    // Star offset from the lock position, camera pixels
+    float camera_dy;
+    float ra_distance;                  // Offset in mount coordinates, pixels
+    float dec_distance;
+    int32_t ra_duration;                // RA pulse issued, milliseconds
+    int32_t dec_duration;               // Dec pulse issued, milliseconds
+    int32_t ra_direction;               // FRAME_RING_DIR_* of the RA pulse
+    int32_t dec_direction;              // FRAME_RING_DIR_* of the Dec pulse
+    uint32_t ra_limited;                // Nonzero if the RA pulse was clipped to the max duration
+    uint32_t dec_limited;               // Nonzero if the Dec pulse was clipped to the max duration
+} FrameRingStep;
+
+/**
+ * Description of one guide frame in the ring
+ */
+typedef struct {
+    uint64_t index;                     // Publication index, 1 for the first frame in the segment
+    double timestamp;                   // Publication time, seconds since the epoch
+    uint32_t frame_number;              // PHD2 frame number
+    uint32_t flags;                     // FRAME_RING_* flags
+    uint32_t width;                     // Size of the stored pixels (the subframe when subframes are used)
+    uint32_t height;
+    uint32_t full_width;                // Full camera frame size
+    uint32_t full_height;
+    uint32_t origin_x;                  // Position of the stored pixels in the full frame
+    uint32_t origin_y;
+    float star_x;                       // Primary star position, full frame pixels
+    float star_y;
+    float lock_x;                       // Lock position, full frame pixels
+    float lock_y;
+    float star_mass;
+    float star_snr;
+    float star_hfd;
+    uint32_t num_stars;                 // Number of entries in stars
+    float stars[PHD2_FRAME_RING_MAX_STARS][2];  // x, y of each guide star, primary star first
+    FrameRingStep step;                 // Valid when FRAME_RING_STEP_VALID is set
+    uint8_t reserved[32];               // Reserved for future expansion
+} FrameRingRecord;
+
+/**
+ * Header of each ring slot. The pixels (uint16_t, row by row) follow at
+ * FrameRingSHM.slot_pixel_offset from the start of the slot.
+ *
+ * The slot is protected by a sequence lock: seq is odd while PHD2 is writing
+ * the slot. A reader that sees the same even seq before and after reading
+ * has read a consistent frame.
+ */
+typedef struct {
+    uint32_t seq;
+    uint32_t reserved;
+    FrameRingRecord record;
+} FrameRingSlot;
+
+/**
+ * Header of the frame ring shared memory segment
+ */
+typedef struct {
+    uint32_t magic;                     // PHD2_FRAME_RING_MAGIC
+    uint32_t version;                   // PHD2_FRAME_RING_VERSION
+    uint32_t num_slots;                 // Number of frames kept
+    uint32_t max_pixels;                // Pixel capacity of each slot
+    uint64_t total_size;                // Size of the segment in bytes
+    uint64_t slots_offset;              // Offset of the first slot from the start of the segment
+    uint64_t slot_stride;               // Bytes from one slot to the next
+    uint64_t slot_pixel_offset;         // Offset of the pixels from the start of a slot
+    uint64_t publish_count;             // Frames published; the newest is in slot (publish_count - 1) % num_slots
+    uint32_t publish_seq;               // Low 32 bits of publish_count, used to wake waiting readers
+    uint32_t closed;                    // Set when PHD2 replaces or removes the segment; readers should reopen
+    uint8_t reserved[48];               // Reserved for future expansion
+} FrameRingSHM;
+
+/**
+ * Zero-copy view of a frame, see shm_frame_ring_read_begin
+ */
+typedef struct {
+    const FrameRingRecord* record;
+    const uint16_t* pixels;
+    const uint32_t* seq_ptr;
+    uint32_t seq;
+} FrameRingView;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== PHD2 (WRITER) FUNCTIONS =====
+
+/**
+ * Create the frame ring shared memory, or return the existing one if it is
+ * large enough. A ring that is too small is closed and replaced.
+ * @param instance PHD2 instance number
+ * @param num_slots Number of frames to keep
+ * @param max_pixels Largest frame to be published, in pixels
+ * @return Pointer to shared memory structure, or NULL on error
+ */
+FrameRingSHM* shm_frame_ring_init(uint32_t instance, uint32_t num_slots, uint32_t max_pixels);
+
+/**
+ * Cleanup frame ring shared memory resources
+ * @param shm Pointer to shared memory structure
+ * @param unlink If true, mark the ring closed and unlink (delete) the shared memory
+ */
+void shm_frame_ring_cleanup(FrameRingSHM* shm, int unlink);
+
+/**
+ * Publish a frame into the oldest slot of the ring
+ * @param shm Pointer to shared memory structure
+ * @param record Frame description; index and timestamp are filled in by the ring
+ * @param pixels First pixel of the frame
+ * @param stride Distance between rows of pixels, in pixels
+ * @return Publication index of the frame, or 0 on error (frame too large)
+ */
+uint64_t shm_frame_ring_publish(FrameRingSHM* shm, const FrameRingRecord* record, const uint16_t* pixels, uint32_t stride);
+
+/**
+ * Attach the guide step issued for a frame that is still in the ring
+ * @param shm Pointer to shared memory structure
+ * @param frame_number PHD2 frame number of the frame
+ * @param step Guide step
+ * @return 0 on success, -1 if the frame is no longer in the ring
+ */
+int shm_frame_ring_publish_step(FrameRingSHM* shm, uint32_t frame_number, const FrameRingStep* step);
+
+// ===== CLIENT (READER) FUNCTIONS =====
+
+/**
+ * Map the frame ring read-only (for external processes)
+ * @param instance PHD2 instance number, 1 for the first instance
+ * @return Pointer to shared memory structure, or NULL if PHD2 has not created it
+ */
+const FrameRingSHM* shm_frame_ring_open(uint32_t instance);
+
+/**
+ * Unmap a frame ring opened with shm_frame_ring_open
+ */
+void shm_frame_ring_close(const FrameRingSHM* shm);
+
+/**
+ * Check whether PHD2 has closed the ring; the reader should close it and open it again
+ * @return Nonzero if the ring is closed
+ */
+int shm_frame_ring_is_closed(const FrameRingSHM* shm);
+
+/**
+ * Get the publication index of the newest frame
+ * @return Publication index, or 0 if no frame has been published
+ */
+uint64_t shm_frame_ring_latest(const FrameRingSHM* shm);
+
+/**
+ * Wait for a frame newer than after_index to be published
+ * @param shm Pointer to shared memory structure
+ * @param after_index Publication index of the last frame seen
+ * @param timeout_ms Timeout in milliseconds
+ * @return 0 when a newer frame is available, -1 on timeout or if the ring was closed
+ */
+int shm_frame_ring_wait(const FrameRingSHM* shm, uint64_t after_index, int timeout_ms);
+
+/**
+ * Start a zero-copy read of a frame. The record and pixels in the view point
+ * straight into shared memory and may be overwritten at any time; anything
+ * derived from them is only valid if shm_frame_ring_read_end returns 0.
+ * @param shm Pointer to shared memory structure
+ * @param index Publication index of the frame
+ * @param view Output view of the frame
+ * @return 0 on success, -1 if the frame is being written or no longer in the ring
+ */
+int shm_frame_ring_read_begin(const FrameRingSHM* shm, uint64_t index, FrameRingView* view);
+
+/**
+ * Finish a zero-copy read started with shm_frame_ring_read_begin
+ * @return 0 if the frame was unchanged during the read, -1 if it was overwritten
+ */
+int shm_frame_ring_read_end(const FrameRingView* view);
+
+/**
+ * Copy a frame out of the ring
+ * @param shm Pointer to shared memory structure
+ * @param index Publication index of the frame
+ * @param record Output frame description
+ * @param pixels Output pixels, or NULL to copy only the description
+ * @param max_pixels Capacity of pixels
+ * @return 0 on success, -1 if the frame is no longer in the ring or does not fit
+ */
+int shm_frame_ring_read(const FrameRingSHM* shm, uint64_t index, FrameRingRecord* record, uint16_t* pixels,
+                        uint32_t max_pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHM_FRAME_RING_H_INCLUDED
@@ -34,7 +34,7 @@
  *  PHD Guiding
  *
  *  Unified header for SHM guider equipment interfaces
- *  Includes camera and mount shared memory definitions
+ *  Includes camera, mount and guide frame ring shared memory definitions
  *
  */
 
@@ -43,5 +43,6 @@
 
 #include "shm_camera.h"
 #include "shm_mount.h"
+#include "shm_frame_ring.h"
 
 #endif // SHM_GUIDER_H_INCLUDED
@@ -251,7 +251,13 @@ int shm_mount_write_selected(uint32_t index)
         return -1;
     }
 
-    return shm_mount_set_selected(shm, index);
+    int result = shm_mount_set_selected(shm, index);
+
+    // Wake the PHD2 monitor thread
+    if (result == 0)
+        shm_mount_signal_client_request();
+
+    return result;
 }
 
 const EquipmentListSHM* shm_mount_get_readonly(void)
@@ -337,6 +343,11 @@ void shm_mount_signal_client_request(void)
 }
 
 int shm_mount_wait_client_request(void)
+{
+    return shm_mount_timedwait_client_request(1000);  // 1 second timeout
+}
+
+int shm_mount_timedwait_client_request(int timeout_ms)
 {
     sem_t* sem = sem_open(PHD2_MOUNT_SEM_CLIENT_REQUEST, O_CREAT, 0666, 0);
     if (sem == SEM_FAILED)
@@ -346,9 +357,17 @@ int shm_mount_wait_client_request(void)
 
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
-    ts.tv_sec += 1;  // 1 second timeout
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
 
-    int result = sem_timedwait(sem, &ts);
+    int result;
+    while ((result = sem_timedwait(sem, &ts)) == -1 && errno == EINTR)
+        ;
     sem_close(sem);
     return result;
 }
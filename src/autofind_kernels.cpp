@@ -0,0 +1,405 @@
+/*
+ *  autofind_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "autofind_kernels.h"
+
+#include <algorithm>
+#include <math.h>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
+
+void AutoFindStats(double *mean, double *stdev, const float *img, int width, int left, int top, int w, int h)
+{
+    // Determine the mean and standard deviation
+    double sum = 0.0;
+    double a = 0.0;
+    double q = 0.0;
+    double k = 1.0;
+    double km1 = 0.0;
+
+    const float *p0 = &img[top * width + left];
+    for (int y = 0; y < h; y++)
+    {
+        const float *end = p0 + w;
+        for (const float *p = p0; p < end; p++)
+        {
+            double const x = (double) *p;
+            sum += x;
+            double const a0 = a;
+            a += (x - a) / k;
+            q += (x - a0) * (x - a);
+            km1 = k;
+            k += 1.0;
+        }
+        p0 += width;
+    }
+
+    *mean = sum / km1;
+    *stdev = sqrt(q / km1);
+}
+
+void AutoFindDownsample(float *dst, int dw, const float *src, int width, int ds, int y0, int y1)
+{
+    float const d2 = ds * ds;
+
+    for (int yy = y0; yy < y1; yy++)
+    {
+        for (int xx = 0; xx < dw; xx++)
+        {
+            float sum = 0.0;
+            for (int j = 0; j < ds; j++)
+                for (int i = 0; i < ds; i++)
+                    sum += src[(yy * ds + j) * width + xx * ds + i];
+            float val = sum / d2;
+            dst[yy * dw + xx] = val;
+        }
+    }
+}
+
+// Summed-area tables are built for fixed blocks of rows, aligned to the top
+// of the image, so that the sums (and therefore the output) do not depend on
+// how the image was split into bands.
+enum
+{
+    SAT_BLOCK_ROWS = 64
+};
+
+// Summed-area table of rows [y0, y1) and columns [x0, x1) of an image
+struct SumTable
+{
+    std::vector<double> sum;
+    int stride;
+    int x0;
+    int y0;
+
+    void Build(const float *img, int width, int x0_, int y0_, int x1, int y1)
+    {
+        x0 = x0_;
+        y0 = y0_;
+        stride = x1 - x0 + 1;
+        int const rows = y1 - y0;
+        sum.resize((size_t) stride * (rows + 1));
+
+        double *s = sum.data();
+        std::fill(s, s + stride, 0.0);
+        for (int r = 0; r < rows; r++)
+        {
+            const float *p = img + (size_t) (y0 + r) * width + x0;
+            const double *above = s + (size_t) r * stride;
+            double *row = s + (size_t) (r + 1) * stride;
+            double acc = 0.0;
+            row[0] = 0.0;
+            for (int c = 1; c < stride; c++)
+            {
+                acc += p[c - 1];
+                row[c] = above[c] + acc;
+            }
+        }
+    }
+
+    // sum of the pixels in columns [xa, xb] and rows [ya, yb], inclusive
+    double Rect(int xa, int ya, int xb, int yb) const
+    {
+        const double *top = sum.data() + (size_t) (ya - y0) * stride - x0;
+        const double *bot = sum.data() + (size_t) (yb - y0 + 1) * stride - x0;
+        return bot[xb + 1] - bot[xa] - top[xb + 1] + top[xa];
+    }
+};
+
+static thread_local SumTable s_convSum;
+static thread_local SumTable s_localSum;
+
+int AutoFindPsfRadius(int scale)
+{
+    return 4 * scale + scale / 2;
+}
+
+void AutoFindPsfConv(float *dst, const float *src, int width, int height, int scale, int y0, int y1)
+{
+    //                       A      B1     B2    C1     C2    C3     D1     D2     D3
+    const double PSF[] = { 0.906, 0.584, 0.365, .117, .049, -0.05, -.064, -.074, -.094 };
+
+    /* PSF Grid is:
+    D3 D3 D3 D3 D3 D3 D3 D3 D3
+    D3 D3 D3 D2 D1 D2 D3 D3 D3
+    D3 D3 C3 C2 C1 C2 C3 D3 D3
+    D3 D2 C2 B2 B1 B2 C2 D2 D3
+    D3 D1 C1 B1 A  B1 C1 D1 D3
+    D3 D2 C2 B2 B1 B2 C2 D2 D3
+    D3 D3 C3 C2 C1 C2 C3 D3 D3
+    D3 D3 D3 D2 D1 D2 D3 D3 D3
+    D3 D3 D3 D3 D3 D3 D3 D3 D3
+
+    1@A
+    4@B1, B2, C1, C3, D1
+    8@C2, D2
+    44 * D3
+
+    Each cell of the grid covers scale x scale pixels. Every group of cells is
+    a combination of rectangles (crosses, boxes and 3-cell wide bands), so its
+    sum takes a fixed number of summed-area table lookups whatever the scale.
+    */
+
+    int const psf_size = AutoFindPsfRadius(scale);
+    int const half = scale / 2;
+    double const cells = (double) scale * scale;
+
+    memset(dst + (size_t) width * y0, 0, (size_t) width * (y1 - y0) * sizeof(float));
+
+    if (width <= 2 * psf_size)
+        return;
+
+    y0 = std::max(y0, psf_size);
+    y1 = std::min(y1, height - psf_size);
+
+    SumTable& sat = s_convSum;
+
+    for (int b0 = y0; b0 < y1;)
+    {
+        int const b1 = std::min((b0 / SAT_BLOCK_ROWS + 1) * SAT_BLOCK_ROWS, y1);
+        int const blockTop = b0 / SAT_BLOCK_ROWS * SAT_BLOCK_ROWS;
+        int const blockBottom = std::min(blockTop + SAT_BLOCK_ROWS, height - psf_size);
+
+        // the table covers the whole block plus the kernel radius above and below
+        sat.Build(src, width, 0, std::max(blockTop - psf_size, 0), width, std::min(blockBottom + psf_size, height));
+
+        for (int y = b0; y < b1; y++)
+        {
+            for (int x = psf_size; x < width - psf_size; x++)
+            {
+                // sum of the cells [i0, i1] x [j0, j1] around the center cell
+#define CELLS(i0, i1, j0, j1) \
+    sat.Rect(x + (i0) * scale - half, y + (j0) * scale - half, x + (i1) * scale + half, y + (j1) * scale + half)
+                double const A = CELLS(0, 0, 0, 0);
+                double const cross1 = CELLS(-1, 1, 0, 0) + CELLS(0, 0, -1, 1) - A;
+                double const cross2 = CELLS(-2, 2, 0, 0) + CELLS(0, 0, -2, 2) - A;
+                double const cross3 = CELLS(-3, 3, 0, 0) + CELLS(0, 0, -3, 3) - A;
+                double const box1 = CELLS(-1, 1, -1, 1);
+                double const box2 = CELLS(-2, 2, -2, 2);
+                double const box4 = CELLS(-4, 4, -4, 4);
+                double const band2 = CELLS(-2, 2, -1, 1) + CELLS(-1, 1, -2, 2) - box1;
+                double const band3 = CELLS(-3, 3, -1, 1) + CELLS(-1, 1, -3, 3) - box1;
+#undef CELLS
+                double const B1 = cross1 - A;
+                double const B2 = box1 - cross1;
+                double const C1 = cross2 - cross1;
+                double const C2 = band2 - box1 - C1;
+                double const C3 = box2 - band2;
+                double const D1 = cross3 - cross2;
+                double const D2 = band3 - band2 - D1;
+                double const D3 = box4 - box2 - D1 - D2;
+
+                double mean = (A + B1 + B2 + C1 + C2 + C3 + D1 + D2 + D3) / (81.0 * cells);
+                double PSF_fit = PSF[0] * (A - cells * mean) + PSF[1] * (B1 - 4.0 * cells * mean) +
+                    PSF[2] * (B2 - 4.0 * cells * mean) + PSF[3] * (C1 - 4.0 * cells * mean) +
+                    PSF[4] * (C2 - 8.0 * cells * mean) + PSF[5] * (C3 - 4.0 * cells * mean) +
+                    PSF[6] * (D1 - 4.0 * cells * mean) + PSF[7] * (D2 - 8.0 * cells * mean) +
+                    PSF[8] * (D3 - 44.0 * cells * mean);
+
+                dst[width * y + x] = (float) PSF_fit;
+            }
+        }
+
+        b0 = b1;
+    }
+}
+
+void AutoFindLocalMaxima(std::vector<AutoFindCandidate> *out, const float *conv, int width, int left, int top, int right,
+                         int bottom, int srch, double global_stdev, double threshold, int y0, int y1)
+{
+    y0 = std::max(y0, top + srch);
+    y1 = std::min(y1, bottom - srch + 1);
+
+    // the local mean is taken over a 15x15 window
+    const int local = 7;
+    SumTable& local_sum = s_localSum;
+    int localBlock = -SAT_BLOCK_ROWS;
+
+    for (int y = y0; y < y1; y++)
+    {
+        for (int x = left + srch; x <= right - srch; x++)
+        {
+            float val = conv[width * y + x];
+            bool ismax = false;
+            if (val > 0.0)
+            {
+                ismax = true;
+                for (int j = -srch; j <= srch; j++)
+                {
+                    for (int i = -srch; i <= srch; i++)
+                    {
+                        if (i == 0 && j == 0)
+                            continue;
+                        if (conv[width * (y + j) + (x + i)] > val)
+                        {
+                            ismax = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (!ismax)
+                continue;
+
+            // the table for this block of rows, built on the first local maximum in the block
+            if (y >= localBlock + SAT_BLOCK_ROWS)
+            {
+                localBlock = y / SAT_BLOCK_ROWS * SAT_BLOCK_ROWS;
+                local_sum.Build(conv, width, left, std::max(localBlock - local, top), right + 1,
+                                std::min(localBlock + SAT_BLOCK_ROWS + local, bottom + 1));
+            }
+
+            // compare local maximum to mean value of surrounding pixels
+            int const lx0 = std::max(x - local, left);
+            int const ly0 = std::max(y - local, top);
+            int const lx1 = std::min(x + local, right);
+            int const ly1 = std::min(y + local, bottom);
+            double local_mean = local_sum.Rect(lx0, ly0, lx1, ly1) / ((lx1 - lx0 + 1) * (ly1 - ly0 + 1));
+
+            // this is our measure of star intensity
+            double h = (val - local_mean) / global_stdev;
+
+            if (h < threshold)
+                continue;
+
+            AutoFindCandidate c;
+            c.x = x;
+            c.y = y;
+            c.val = val;
+            c.h = h;
+            out->push_back(c);
+        }
+    }
+}
+
+void AutoFindTopPeaks(std::vector<AutoFindPeak> *peaks, const std::vector<std::vector<AutoFindCandidate>>& bands,
+                      int downsample, int maxPeaks)
+{
+    std::set<AutoFindPeak> top; // sorted by ascending intensity
+
+    for (const auto& band : bands)
+    {
+        for (const auto& c : band)
+        {
+            AutoFindPeak p;
+            p.x = c.x * downsample + downsample / 2;
+            p.y = c.y * downsample + downsample / 2;
+            p.val = (float) c.h;
+
+            top.insert(p);
+            if (top.size() > (size_t) maxPeaks)
+                top.erase(top.begin());
+        }
+    }
+
+    peaks->assign(top.begin(), top.end());
+}
+
+static void AddNote(std::vector<AutoFindPeakNote> *notes, AutoFindPeakAction action, const AutoFindPeak& a,
+                    const AutoFindPeak& b)
+{
+    AutoFindPeakNote n;
+    n.action = action;
+    n.a = a;
+    n.b = b;
+    notes->push_back(n);
+}
+
+void AutoFindSeparatePeaks(std::vector<AutoFindPeak> *peaks, std::vector<AutoFindPeakNote> *notes, int searchRegion,
+                           int edgeDist, int width, int height)
+{
+    std::vector<AutoFindPeak>& stars = *peaks;
+
+    // merge stars that are very close into a single star
+    const int minlimitsq = 5 * 5;
+    for (size_t a = 0; a < stars.size();)
+    {
+        size_t b = a + 1;
+        for (; b < stars.size(); b++)
+        {
+            int dx = stars[a].x - stars[b].x;
+            int dy = stars[a].y - stars[b].y;
+            if (dx * dx + dy * dy < minlimitsq)
+                break;
+        }
+        if (b < stars.size())
+        {
+            // erase the dimmer one and start over
+            AddNote(notes, AUTOFIND_MERGED, stars[a], stars[b]);
+            stars.erase(stars.begin() + a);
+            a = 0;
+        }
+        else
+            ++a;
+    }
+
+    // exclude stars that would fit within a single searchRegion box
+    const int extra = 5; // extra safety margin
+    const int fullw = searchRegion + extra;
+    std::vector<char> erase(stars.size(), 0);
+    for (size_t a = 0; a < stars.size(); a++)
+    {
+        for (size_t b = a + 1; b < stars.size(); b++)
+        {
+            if (abs(stars[a].x - stars[b].x) <= fullw && abs(stars[a].y - stars[b].y) <= fullw)
+            {
+                // stars closer than search region, exclude them both
+                // but do not let a very dim star eliminate a very bright star
+                if (stars[b].val / stars[a].val >= 5.0)
+                    AddNote(notes, AUTOFIND_DIM_BRIGHT, stars[a], stars[b]);
+                else
+                {
+                    AddNote(notes, AUTOFIND_TOO_CLOSE, stars[a], stars[b]);
+                    erase[a] = erase[b] = 1;
+                }
+            }
+        }
+    }
+
+    // exclude stars too close to the edge
+    size_t n = 0;
+    for (size_t i = 0; i < stars.size(); i++)
+    {
+        if (erase[i])
+            continue;
+        const AutoFindPeak& p = stars[i];
+        if (p.x <= edgeDist || p.x >= width - edgeDist || p.y <= edgeDist || p.y >= height - edgeDist)
+        {
+            AddNote(notes, AUTOFIND_NEAR_EDGE, p, p);
+            continue;
+        }
+        stars[n++] = p;
+    }
+    stars.resize(n);
+}
@@ -0,0 +1,126 @@
+/*
+ *  autofind_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef AUTOFIND_KERNELS_INCLUDED
+#define AUTOFIND_KERNELS_INCLUDED
+
+#include <vector>
+
+// Image kernels used by GuideStar::AutoFind.
+//
+// Each kernel processes a band of rows [y0, y1) of the output and only reads
+// the (shared, read-only) source image, reaching as far outside the band as
+// the kernel radius requires. Window sums come from summed-area tables built
+// for fixed blocks of rows in per-thread scratch buffers. Bands can therefore
+// be processed concurrently on the worker pool, and the result does not
+// depend on how the image was split.
+
+// a local maximum of the convolved image, in convolved image coordinates
+struct AutoFindCandidate
+{
+    int x;
+    int y;
+    float val; // convolved value at the peak
+    double h; // peak value above the local mean, in units of the global stdev
+};
+
+// mean and standard deviation of a window of the image
+void AutoFindStats(double *mean, double *stdev, const float *img, int width, int left, int top, int w, int h);
+
+// box-filter and decimate by ds; output rows [y0, y1) of the dw x dh result
+void AutoFindDownsample(float *dst, int dw, const float *src, int width, int ds, int y0, int y1);
+
+// number of pixels at the image border that the PSF convolution cannot reach
+int AutoFindPsfRadius(int scale);
+
+// 9x9 PSF convolution, output rows [y0, y1). Each cell of the PSF template
+// covers scale x scale pixels (scale is odd); the cost per pixel does not
+// depend on the scale. Pixels within AutoFindPsfRadius(scale) of the image
+// border are set to zero.
+void AutoFindPsfConv(float *dst, const float *src, int width, int height, int scale, int y0, int y1);
+
+// Find the local maxima of the convolved image in rows [y0, y1) and measure
+// them against the mean of the surrounding 15x15 pixels. Only pixels within the valid region
+// (left, top, right, bottom inclusive) and at least srch pixels from its edge
+// are considered. Candidates with h below threshold are dropped; the rest
+// are appended in raster order.
+void AutoFindLocalMaxima(std::vector<AutoFindCandidate> *out, const float *conv, int width, int left, int top, int right,
+                         int bottom, int srch, double global_stdev, double threshold, int y0, int y1);
+
+// a star candidate in full-size image coordinates
+struct AutoFindPeak
+{
+    int x;
+    int y;
+    float val;
+
+    bool operator<(const AutoFindPeak& rhs) const { return val < rhs.val; }
+};
+
+// what AutoFindSeparatePeaks did with a pair of peaks, for logging
+enum AutoFindPeakAction
+{
+    AUTOFIND_MERGED, // a was within 5 pixels of the brighter b and was dropped
+    AUTOFIND_DIM_BRIGHT, // a and b share a search region but b is much brighter; both kept
+    AUTOFIND_TOO_CLOSE, // a and b share a search region; both dropped
+    AUTOFIND_NEAR_EDGE, // a was too close to the edge of the image and was dropped
+};
+
+struct AutoFindPeakNote
+{
+    AutoFindPeakAction action;
+    AutoFindPeak a;
+    AutoFindPeak b;
+};
+
+// stars closer than this to a star already selected are duplicates
+enum
+{
+    AUTOFIND_MIN_SEPARATION = 25
+};
+
+// Scale the candidates of each band up to image coordinates and keep the
+// maxPeaks with the largest h, in ascending order. The bands are taken in
+// order, so the result does not depend on how the image was split; as with a
+// std::set, a peak as bright as one already kept is ignored.
+void AutoFindTopPeaks(std::vector<AutoFindPeak> *peaks, const std::vector<std::vector<AutoFindCandidate>>& bands,
+                      int downsample, int maxPeaks);
+
+// Merge peaks within 5 pixels of each other into the brighter one, drop pairs
+// of peaks that would share a search region unless one is at least 5 times
+// brighter, then drop peaks within edgeDist of the edge of the width x height
+// image. peaks stays in ascending order; each decision is appended to notes.
+void AutoFindSeparatePeaks(std::vector<AutoFindPeak> *peaks, std::vector<AutoFindPeakNote> *notes, int searchRegion,
+                           int edgeDist, int width, int height);
+
+#endif // AUTOFIND_KERNELS_INCLUDED
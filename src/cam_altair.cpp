@@ -621,8 +621,7 @@ bool AltairCamera::Capture(int duration, usImage& img, int options, const wxRect
 
     } // discard loop
 
-    for (unsigned int i = 0; i < img.NPixels; i++)
-        img.ImageData[i] = m_buffer[i];
+    CaptureWiden8(img.ImageData, m_buffer, img.NPixels);
 
     if (options & CAPTURE_SUBTRACT_DARK)
         SubtractDark(img);
@@ -663,41 +663,23 @@ bool CameraOgma::Capture(int duration, usImage& img, int options, const wxRect&
         int xofs = (subframe.GetLeft() * binning - roi.GetLeft()) / binning;
         int yofs = (subframe.GetTop() * binning - roi.GetTop()) / binning;
 
-        int dxr = sz.x - subframe.width - xofs;
+        unsigned short *dst = img.ImageData + subframe.GetTop() * FrameSize.GetWidth() + subframe.GetLeft();
         if (m_cam.m_bpp == 8)
         {
-            const unsigned char *src = static_cast<unsigned char *>(m_cam.m_buffer) + yofs * sz.x;
-            unsigned short *dst = img.ImageData + subframe.GetTop() * FrameSize.GetWidth() + subframe.GetLeft();
-            for (int y = 0; y < subframe.height; y++)
-            {
-                unsigned short *d = dst;
-                src += xofs;
-                for (int x = 0; x < subframe.width; x++)
-                    *d++ = (unsigned short) *src++;
-                src += dxr;
-                dst += FrameSize.GetWidth();
-            }
+            const unsigned char *src = static_cast<unsigned char *>(m_cam.m_buffer) + yofs * sz.x + xofs;
+            CaptureCopyRect8(dst, FrameSize.GetWidth(), src, sz.x, subframe.width, subframe.height);
         }
         else // bpp == 16
         {
-            const unsigned short *src = static_cast<unsigned short *>(m_cam.m_buffer) + yofs * sz.x;
-            unsigned short *dst = img.ImageData + subframe.GetTop() * FrameSize.GetWidth() + subframe.GetLeft();
-            for (int y = 0; y < subframe.height; y++)
-            {
-                src += xofs;
-                memcpy(dst, src, subframe.width * sizeof(unsigned short));
-                src += subframe.width + dxr;
-                dst += FrameSize.GetWidth();
-            }
+            const unsigned short *src = static_cast<unsigned short *>(m_cam.m_buffer) + yofs * sz.x + xofs;
+            CaptureCopyRect16(dst, FrameSize.GetWidth(), src, sz.x, subframe.width, subframe.height);
         }
     }
     else
     {
         if (m_cam.m_bpp == 8)
         {
-            const char *src = static_cast<char *>(m_cam.m_buffer);
-            for (unsigned int i = 0; i < img.NPixels; i++)
-                img.ImageData[i] = *src++;
+            CaptureWiden8(img.ImageData, static_cast<unsigned char *>(m_cam.m_buffer), img.NPixels);
         }
         else
         {
@@ -61,8 +61,6 @@ class PlayerOneCamera : public GuideCamera
     wxSize m_maxSize;
     wxRect m_frame;
     unsigned short m_prevBinning;
-    void *m_buffer;
-    size_t m_buffer_size;
     wxByte m_bpp; // bits per pixel: 8 or 16
     CaptureMode m_mode;
     bool m_capturing;
@@ -110,7 +108,7 @@ private:
     POAErrors SetConfig(int nCameraID, POAConfig confID, POABool isEnable);
 };
 
-PlayerOneCamera::PlayerOneCamera() : m_buffer(nullptr)
+PlayerOneCamera::PlayerOneCamera()
 {
     Name = _T("Player One Camera");
     PropertyDialogType = PROPDLG_WHEN_DISCONNECTED;
@@ -127,10 +125,7 @@ PlayerOneCamera::PlayerOneCamera() : m_buffer(nullptr)
     CameraConfigManager::PublishOption("bitdepth", m_bpp, 8, 16);
 }
 
-PlayerOneCamera::~PlayerOneCamera()
-{
-    ::free(m_buffer);
-}
+PlayerOneCamera::~PlayerOneCamera() { }
 
 wxByte PlayerOneCamera::BitsPerPixel()
 {
@@ -470,10 +465,6 @@ bool PlayerOneCamera::Connect(const wxString& camId)
     FrameSize = BinnedFrameSize(Binning);
     m_prevBinning = Binning;
 
-    ::free(m_buffer);
-    m_buffer_size = info.maxWidth * info.maxHeight * (m_bpp == 8 ? 1 : 2);
-    m_buffer = ::malloc(m_buffer_size);
-
     m_devicePixelSize = info.pixelSize;
 
     wxYield();
@@ -597,9 +588,6 @@ bool PlayerOneCamera::Disconnect()
 
     Connected = false;
 
-    ::free(m_buffer);
-    m_buffer = nullptr;
-
     return false;
 }
 
@@ -802,7 +790,14 @@ bool PlayerOneCamera::Capture(int duration, usImage& img, int options, const wxR
 
     int poll = wxMin(duration, 100);
 
-    unsigned char *const buffer = m_bpp == 16 && !useSubframe ? (unsigned char *) img.ImageData : (unsigned char *) m_buffer;
+    // a full frame is read out straight into img, subframes are copied from the readout buffer
+    CaptureReadout readout = BeginReadout(img, frame.GetSize(), m_bpp, !useSubframe);
+    if (!readout.Buffer)
+    {
+        DisconnectWithAlert(CAPT_FAIL_MEMORY);
+        return true;
+    }
+    unsigned char *const buffer = readout.Buffer;
 
     if (m_mode == CM_VIDEO)
     {
@@ -810,7 +805,7 @@ bool PlayerOneCamera::Capture(int duration, usImage& img, int options, const wxR
         // which could be quite stale. read out all buffered frames so the frame we
         // get is current
 
-        flush_buffered_image(m_cameraId, m_buffer, m_buffer_size);
+        flush_buffered_image(m_cameraId, buffer, readout.BufferSize);
 
         if (!m_capturing)
         {
@@ -823,7 +818,7 @@ bool PlayerOneCamera::Capture(int duration, usImage& img, int options, const wxR
 
         while (true)
         {
-            POAErrors status = POAGetImageData(m_cameraId, buffer, m_buffer_size, poll);
+            POAErrors status = POAGetImageData(m_cameraId, buffer, readout.BufferSize, poll);
             if (status == POA_OK)
                 break;
             if (WorkerThread::InterruptRequested())
@@ -911,7 +906,7 @@ bool PlayerOneCamera::Capture(int duration, usImage& img, int options, const wxR
             return true;
         }
 
-        POAErrors status = POAGetImageData(m_cameraId, buffer, m_buffer_size, -1);
+        POAErrors status = POAGetImageData(m_cameraId, buffer, readout.BufferSize, -1);
         if (status != POA_OK)
         {
             Debug.Write(wxString::Format("Player One: getdataafterexp ret %d\n", status));
@@ -927,38 +922,12 @@ bool PlayerOneCamera::Capture(int duration, usImage& img, int options, const wxR
         // Clear out the image
         img.Clear();
 
-        if (m_bpp == 8)
-        {
-            for (int y = 0; y < subframe.height; y++)
-            {
-                const unsigned char *src = buffer + (y + subframePos.y) * frame.width + subframePos.x;
-                unsigned short *dst = img.ImageData + (y + subframe.y) * FrameSize.GetWidth() + subframe.x;
-                for (int x = 0; x < subframe.width; x++)
-                    *dst++ = *src++;
-            }
-        }
-        else
-        {
-            for (int y = 0; y < subframe.height; y++)
-            {
-                const unsigned short *src = (unsigned short *) buffer + (y + subframePos.y) * frame.width + subframePos.x;
-                unsigned short *dst = img.ImageData + (y + subframe.y) * FrameSize.GetWidth() + subframe.x;
-                for (int x = 0; x < subframe.width; x++)
-                    *dst++ = *src++;
-            }
-        }
+        EndReadout(img, readout, subframe, subframePos);
     }
     else
     {
-        if (m_bpp == 8)
-        {
-            for (unsigned int i = 0; i < img.NPixels; i++)
-                img.ImageData[i] = buffer[i];
-        }
-        else
-        {
-            // 16-bit mode and no subframe: data is already in img.ImageData
-        }
+        // full frame: 16-bit data is already in img.ImageData, 8-bit data is widened in place
+        EndReadout(img, readout);
     }
 
     if (options & CAPTURE_SUBTRACT_DARK)
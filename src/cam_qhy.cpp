@@ -1151,52 +1151,19 @@ bool Camera_QHY::Capture(int duration, usImage& img, int options, const wxRect&
         int xofs = subframe.GetLeft() - roi.GetLeft();
         int yofs = subframe.GetTop() - roi.GetTop();
 
-        int dxr = w - frame.width - xofs;
+        unsigned short *dst = img.ImageData + frame.GetTop() * FrameSize.GetWidth() + frame.GetLeft();
         if (bpp == 8)
-        {
-            const unsigned char *src = RawBuffer + yofs * w;
-            unsigned short *dst = img.ImageData + frame.GetTop() * FrameSize.GetWidth() + frame.GetLeft();
-            for (int y = 0; y < frame.height; y++)
-            {
-                unsigned short *d = dst;
-                src += xofs;
-                for (int x = 0; x < frame.width; x++)
-                    *d++ = (unsigned short) *src++;
-                src += dxr;
-                dst += FrameSize.GetWidth();
-            }
-        }
+            CaptureCopyRect8(dst, FrameSize.GetWidth(), RawBuffer + yofs * w + xofs, w, frame.width, frame.height);
         else // bpp == 16
-        {
-            const unsigned short *src = (const unsigned short *) RawBuffer + yofs * w;
-            unsigned short *dst = img.ImageData + frame.GetTop() * FrameSize.GetWidth() + frame.GetLeft();
-            for (int y = 0; y < frame.height; y++)
-            {
-                src += xofs;
-                memcpy(dst, src, frame.width * sizeof(unsigned short));
-                src += frame.width + dxr;
-                dst += FrameSize.GetWidth();
-            }
-        }
+            CaptureCopyRect16(dst, FrameSize.GetWidth(), (const unsigned short *) RawBuffer + yofs * w + xofs, w, frame.width,
+                              frame.height);
     }
     else
     {
         if (bpp == 8)
-        {
-            const unsigned char *src = RawBuffer;
-            unsigned short *dst = img.ImageData;
-            for (int y = 0; y < h; y++)
-            {
-                for (int x = 0; x < w; x++)
-                {
-                    *dst++ = (unsigned short) *src++;
-                }
-            }
-        }
+            CaptureWiden8(img.ImageData, RawBuffer, (size_t) w * h);
         else // bpp == 16
-        {
             memcpy(img.ImageData, RawBuffer, w * h * sizeof(unsigned short));
-        }
     }
 
     if (options & CAPTURE_SUBTRACT_DARK)
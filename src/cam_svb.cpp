@@ -54,8 +54,6 @@ class SVBCamera : public GuideCamera
     wxSize m_maxSize;
     wxRect m_frame;
     unsigned short m_prevBinning;
-    void *m_buffer;
-    size_t m_buffer_size;
     wxByte m_bpp; // bits per pixel: 8 or 16
     CaptureMode m_mode;
     bool m_capturing;
@@ -90,7 +88,7 @@ private:
     bool StopExposure();
 };
 
-SVBCamera::SVBCamera() : m_buffer(nullptr)
+SVBCamera::SVBCamera()
 {
     Name = _T("Svbony Camera");
     PropertyDialogType = PROPDLG_WHEN_DISCONNECTED;
@@ -107,10 +105,7 @@ SVBCamera::SVBCamera() : m_buffer(nullptr)
     CameraConfigManager::PublishOption("bitdepth", m_bpp, 8, 16);
 }
 
-SVBCamera::~SVBCamera()
-{
-    ::free(m_buffer);
-}
+SVBCamera::~SVBCamera() { }
 
 wxByte SVBCamera::BitsPerPixel()
 {
@@ -426,10 +421,6 @@ bool SVBCamera::Connect(const wxString& camId)
     FrameSize.y = m_maxSize.y / Binning;
     m_prevBinning = Binning;
 
-    ::free(m_buffer);
-    m_buffer_size = props.MaxWidth * props.MaxHeight * (m_bpp == 8 ? 1 : 2);
-    m_buffer = ::malloc(m_buffer_size);
-
     float pxsize;
     if ((r = SVBGetSensorPixelSize(m_cameraId, &pxsize)) == SVB_SUCCESS)
         m_devicePixelSize = pxsize;
@@ -532,9 +523,6 @@ bool SVBCamera::Disconnect()
 
     Connected = false;
 
-    ::free(m_buffer);
-    m_buffer = nullptr;
-
     return false;
 }
 
@@ -671,7 +659,14 @@ bool SVBCamera::Capture(int duration, usImage& img, int options, const wxRect& s
 
     int poll = wxMin(duration, 100);
 
-    unsigned char *const buffer = m_bpp == 16 && !useSubframe ? (unsigned char *) img.ImageData : (unsigned char *) m_buffer;
+    // a full frame is read out straight into img, subframes are copied from the readout buffer
+    CaptureReadout readout = BeginReadout(img, frame.GetSize(), m_bpp, !useSubframe);
+    if (!readout.Buffer)
+    {
+        DisconnectWithAlert(CAPT_FAIL_MEMORY);
+        return true;
+    }
+    unsigned char *const buffer = readout.Buffer;
 
     if (m_mode == CM_VIDEO)
     {
@@ -679,7 +674,7 @@ bool SVBCamera::Capture(int duration, usImage& img, int options, const wxRect& s
         // which could be quite stale. read out all buffered frames so the frame we
         // get is current
 
-        flush_buffered_image(m_cameraId, m_buffer, m_buffer_size);
+        flush_buffered_image(m_cameraId, buffer, readout.BufferSize);
 
         if (!m_capturing)
         {
@@ -692,7 +687,7 @@ bool SVBCamera::Capture(int duration, usImage& img, int options, const wxRect& s
 
         while (true)
         {
-            SVB_ERROR_CODE status = SVBGetVideoData(m_cameraId, buffer, m_buffer_size, poll);
+            SVB_ERROR_CODE status = SVBGetVideoData(m_cameraId, buffer, readout.BufferSize, poll);
             if (status == SVB_SUCCESS)
                 break;
             if (WorkerThread::InterruptRequested())
@@ -748,7 +743,7 @@ bool SVBCamera::Capture(int duration, usImage& img, int options, const wxRect& s
 
             while (true)
             {
-                SVB_ERROR_CODE status = SVBGetVideoData(m_cameraId, buffer, m_buffer_size, poll);
+                SVB_ERROR_CODE status = SVBGetVideoData(m_cameraId, buffer, readout.BufferSize, poll);
                 if (status == SVB_SUCCESS)
                 {
                     frame_ready = true;
@@ -783,38 +778,12 @@ bool SVBCamera::Capture(int duration, usImage& img, int options, const wxRect& s
         // Clear out the image
         img.Clear();
 
-        if (m_bpp == 8)
-        {
-            for (int y = 0; y < subframe.height; y++)
-            {
-                const unsigned char *src = buffer + (y + subframePos.y) * frame.width + subframePos.x;
-                unsigned short *dst = img.ImageData + (y + subframe.y) * FrameSize.GetWidth() + subframe.x;
-                for (int x = 0; x < subframe.width; x++)
-                    *dst++ = *src++;
-            }
-        }
-        else
-        {
-            for (int y = 0; y < subframe.height; y++)
-            {
-                const unsigned short *src = (unsigned short *) buffer + (y + subframePos.y) * frame.width + subframePos.x;
-                unsigned short *dst = img.ImageData + (y + subframe.y) * FrameSize.GetWidth() + subframe.x;
-                for (int x = 0; x < subframe.width; x++)
-                    *dst++ = *src++;
-            }
-        }
+        EndReadout(img, readout, subframe, subframePos);
     }
     else
     {
-        if (m_bpp == 8)
-        {
-            for (unsigned int i = 0; i < img.NPixels; i++)
-                img.ImageData[i] = buffer[i];
-        }
-        else
-        {
-            // 16-bit mode and no subframe: data is already in img.ImageData
-        }
+        // full frame: 16-bit data is already in img.ImageData, 8-bit data is widened in place
+        EndReadout(img, readout);
     }
 
     if (options & CAPTURE_SUBTRACT_DARK)
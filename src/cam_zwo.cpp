@@ -62,8 +62,6 @@ class Camera_ZWO : public GuideCamera
     wxSize m_maxSize;
     wxRect m_frame;
     unsigned short m_prevBinning;
-    void *m_buffer;
-    size_t m_buffer_size;
     wxByte m_bpp; // bits per pixel: 8 or 16
     CaptureMode m_mode;
     bool m_capturing;
@@ -85,6 +83,8 @@ public:
     bool Disconnect() override;
 
     bool ST4PulseGuideScope(int direction, int duration) override;
+    bool ST4CanPulseAxesConcurrently() override { return true; }
+    bool ST4PulseGuideScopeAxes(int raDirection, int raDuration, int decDirection, int decDuration) override;
 
     void ShowPropertyDialog() override;
     bool HasNonGuiCapture() override { return true; }
@@ -105,7 +105,7 @@ private:
     wxSize BinnedFrameSize(unsigned int binning);
 };
 
-Camera_ZWO::Camera_ZWO() : m_buffer(nullptr)
+Camera_ZWO::Camera_ZWO()
 {
     Name = _T("ZWO ASI Camera");
     PropertyDialogType = PROPDLG_WHEN_DISCONNECTED;
@@ -123,10 +123,7 @@ Camera_ZWO::Camera_ZWO() : m_buffer(nullptr)
     CameraConfigManager::PublishOption("bitdepth", m_bpp, 8, 16);
 }
 
-Camera_ZWO::~Camera_ZWO()
-{
-    ::free(m_buffer);
-}
+Camera_ZWO::~Camera_ZWO() { }
 
 wxByte Camera_ZWO::BitsPerPixel()
 {
@@ -481,10 +478,6 @@ bool Camera_ZWO::Connect(const wxString& camId)
     FrameSize = BinnedFrameSize(Binning);
     m_prevBinning = Binning;
 
-    ::free(m_buffer);
-    m_buffer_size = info.MaxWidth * info.MaxHeight * (m_bpp == 8 ? 1 : 2);
-    m_buffer = ::malloc(m_buffer_size);
-
     m_devicePixelSize = info.PixelSize;
 
     wxYield();
@@ -603,9 +596,6 @@ bool Camera_ZWO::Disconnect()
 
     Connected = false;
 
-    ::free(m_buffer);
-    m_buffer = nullptr;
-
     return false;
 }
 
@@ -731,34 +721,6 @@ static void flush_buffered_image(int cameraId, void *buf, size_t size)
     }
 }
 
-inline static void copy_rect_8bit(usImage& img, const unsigned char *buffer, const wxRect& subframe, const wxPoint& subframePos,
-                                  const wxRect& frame)
-{
-    // copy bytes from source buffer to target usImage
-    int const image_width = img.Size.GetWidth();
-    for (int y = 0; y < subframe.height; y++)
-    {
-        const unsigned char *src = buffer + (y + subframePos.y) * frame.width + subframePos.x;
-        unsigned short *dst = img.ImageData + (y + subframe.y) * image_width + subframe.x;
-        for (int x = 0; x < subframe.width; x++)
-            *dst++ = *src++;
-    }
-}
-
-inline static void copy_rect_16bit(usImage& img, const unsigned char *buffer, const wxRect& subframe,
-                                   const wxPoint& subframePos, const wxRect& frame)
-{
-    // copy shorts from source buffer to target usImage
-    int const image_width = img.Size.GetWidth();
-    for (int y = 0; y < subframe.height; y++)
-    {
-        const unsigned short *src = (unsigned short *) buffer + (y + subframePos.y) * frame.width + subframePos.x;
-        unsigned short *dst = img.ImageData + (y + subframe.y) * image_width + subframe.x;
-        for (int x = 0; x < subframe.width; x++)
-            *dst++ = *src++;
-    }
-}
-
 bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect& subframe)
 {
     bool binning_change = false;
@@ -860,8 +822,14 @@ bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect&
 
     int poll = wxMin(duration, 100);
 
-    bool const camera_data_straight_to_img = m_bpp == 16 && !useSubframe && limit_frame.IsEmpty();
-    unsigned char *const buffer = camera_data_straight_to_img ? (unsigned char *) img.ImageData : (unsigned char *) m_buffer;
+    // a full frame is read out straight into img, other frames are copied from the readout buffer
+    CaptureReadout readout = BeginReadout(img, frame.GetSize(), m_bpp, !useSubframe && limit_frame.IsEmpty());
+    if (!readout.Buffer)
+    {
+        DisconnectWithAlert(CAPT_FAIL_MEMORY);
+        return true;
+    }
+    unsigned char *const buffer = readout.Buffer;
 
     if (m_mode == CM_VIDEO)
     {
@@ -869,7 +837,7 @@ bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect&
         // which could be quite stale. read out all buffered frames so the frame we
         // get is current
 
-        flush_buffered_image(m_cameraId, m_buffer, m_buffer_size);
+        flush_buffered_image(m_cameraId, buffer, readout.BufferSize);
 
         if (!m_capturing)
         {
@@ -882,7 +850,7 @@ bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect&
 
         while (true)
         {
-            ASI_ERROR_CODE status = ASIGetVideoData(m_cameraId, buffer, m_buffer_size, poll);
+            ASI_ERROR_CODE status = ASIGetVideoData(m_cameraId, buffer, readout.BufferSize, poll);
             if (status == ASI_SUCCESS)
                 break;
             if (WorkerThread::InterruptRequested())
@@ -970,7 +938,7 @@ bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect&
             return true;
         }
 
-        ASI_ERROR_CODE status = ASIGetDataAfterExp(m_cameraId, buffer, m_buffer_size);
+        ASI_ERROR_CODE status = ASIGetDataAfterExp(m_cameraId, buffer, readout.BufferSize);
         if (status != ASI_SUCCESS)
         {
             Debug.Write(wxString::Format("ZWO: getdataafterexp ret %d\n", status));
@@ -986,31 +954,17 @@ bool Camera_ZWO::Capture(int duration, usImage& img, int options, const wxRect&
         // Clear out the image
         img.Clear();
 
-        if (m_bpp == 8)
-            copy_rect_8bit(img, buffer, subframe, subframePos, frame);
-        else
-            copy_rect_16bit(img, buffer, subframe, subframePos, frame);
+        EndReadout(img, readout, subframe, subframePos);
     }
     else if (limit_frame.IsEmpty())
     {
-        if (m_bpp == 8)
-        {
-            for (unsigned int i = 0; i < img.NPixels; i++)
-                img.ImageData[i] = buffer[i];
-        }
-        else
-        {
-            // 16-bit mode and no subframe and no LimitFrame: data is already in
-            // img.ImageData
-        }
+        // full frame: 16-bit data is already in img.ImageData, 8-bit data is widened in place
+        EndReadout(img, readout);
     }
     else // LimitFrame
     {
         wxRect destFrame(FrameSize); // aka limit_frame.Size() and img.Size
-        if (m_bpp == 8)
-            copy_rect_8bit(img, buffer, destFrame, limitFramePos, frame);
-        else
-            copy_rect_16bit(img, buffer, destFrame, limitFramePos, frame);
+        EndReadout(img, readout, destFrame, limitFramePos);
     }
 
     if (options & CAPTURE_SUBTRACT_DARK)
@@ -1047,6 +1001,32 @@ bool Camera_ZWO::ST4PulseGuideScope(int direction, int duration)
     return false;
 }
 
+// The ST4 port has an independent output for each direction, so both axes can be driven at once
+bool Camera_ZWO::ST4PulseGuideScopeAxes(int raDirection, int raDuration, int decDirection, int decDuration)
+{
+    ASI_GUIDE_DIRECTION first = GetASIDirection(raDirection);
+    ASI_GUIDE_DIRECTION second = GetASIDirection(decDirection);
+    int firstDuration = raDuration;
+    int secondDuration = decDuration;
+
+    if (secondDuration < firstDuration)
+    {
+        std::swap(first, second);
+        std::swap(firstDuration, secondDuration);
+    }
+
+    ASIPulseGuideOn(m_cameraId, first);
+    ASIPulseGuideOn(m_cameraId, second);
+    bool interrupted = WorkerThread::MilliSleep(firstDuration, WorkerThread::INT_ANY) != 0;
+    ASIPulseGuideOff(m_cameraId, first);
+    // on interrupt, stop the longer pulse now as well
+    if (!interrupted)
+        WorkerThread::MilliSleep(secondDuration - firstDuration, WorkerThread::INT_ANY);
+    ASIPulseGuideOff(m_cameraId, second);
+
+    return false;
+}
+
 GuideCamera *ZWOCameraFactory::MakeZWOCamera()
 {
     return new Camera_ZWO();
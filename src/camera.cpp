@@ -207,6 +207,8 @@ double GuideCamera::GetProfilePixelSize()
 
 GuideCamera::GuideCamera()
 {
+    m_readoutBuffer = nullptr;
+    m_readoutBufferSize = 0;
     Connected = false;
     m_hasGuideOutput = false;
     PropertyDialogType = PROPDLG_NONE;
@@ -230,12 +232,14 @@ GuideCamera::GuideCamera()
     Binning = pConfig->Profile.GetInt("/camera/binning", 1);
     CurrentDarkFrame = nullptr;
     CurrentDefectMap = nullptr;
+    PendingDarkExposure = 0;
 }
 
 GuideCamera::~GuideCamera()
 {
     ClearDarks();
     ClearDefectMap();
+    ::free(m_readoutBuffer);
 }
 
 static int CompareNoCase(const wxString& first, const wxString& second)
@@ -1389,7 +1393,7 @@ wxString GuideCamera::GetSettingsSummary()
 
     { // lock scope
         wxCriticalSectionLocker lck(DarkFrameLock);
-        darkDur = CurrentDarkFrame ? CurrentDarkFrame->ImgExpDur : 0;
+        darkDur = CurrentDarkFrame ? CurrentDarkFrame->ImgExpDur : PendingDarkExposure;
     } // lock scope
 
     // return a loggable summary of current camera settings
@@ -1424,9 +1428,88 @@ void GuideCamera::AddDark(usImage *dark)
             delete prior;
         }
 
+        Darks[expdur] = dark;
+
+        // a dark that was captured in this session cannot be re-read from the library file
+        DarkLibHdus.erase(expdur);
     } // lock scope
+}
+
+// Register a dark library frame without reading its pixels. The frame is read from the
+// library file when it is first selected.
+void GuideCamera::AddLibraryDark(const wxString& fname, int exposureDuration, int hdu)
+{
+    // the camera worker thread reads library darks, so the library index is only changed under the lock
+    wxCriticalSectionLocker lck(DarkFrameLock);
+
+    if (fname != DarkLibFile)
+    {
+        // darks from a different library file that were never read are no longer reachable;
+        // the ones that were read are kept as ordinary in-memory darks
+        for (auto it = DarkLibHdus.begin(); it != DarkLibHdus.end(); ++it)
+        {
+            ExposureImgMap::iterator pos = Darks.find(it->first);
+            if (pos != Darks.end() && !pos->second)
+                Darks.erase(pos);
+        }
+        DarkLibHdus.clear();
+        DarkLibFile = fname;
+    }
+
+    ExposureImgMap::iterator pos = Darks.find(exposureDuration);
+    if (pos != Darks.end())
+    {
+        usImage *prior = pos->second;
+        if (prior == CurrentDarkFrame)
+            CurrentDarkFrame = nullptr;
+        delete prior;
+        pos->second = nullptr;
+    }
+    else
+        Darks[exposureDuration] = nullptr;
+
+    DarkLibHdus[exposureDuration] = hdu;
+}
+
+// Read a dark library frame if it has not been read yet. The caller must hold DarkFrameLock.
+usImage *GuideCamera::LoadLibraryDark(ExposureImgMap::iterator it)
+{
+    if (!it->second)
+    {
+        auto hdu = DarkLibHdus.find(it->first);
+        if (hdu == DarkLibHdus.end())
+            return nullptr;
+
+        usImage *img = MyFrame::ReadDarkLibraryFrame(DarkLibFile, hdu->second);
+        if (!img)
+            return nullptr;
+
+        if (img->ImgExpDur != it->first)
+        {
+            // the library file was replaced since it was loaded
+            Debug.Write(wxString::Format("dark library %s changed, expected exposure %d at hdu %d, found %d\n", DarkLibFile,
+                                         it->first, hdu->second, img->ImgExpDur));
+            delete img;
+            return nullptr;
+        }
+
+        it->second = img;
+    }
 
-    Darks[expdur] = dark;
+    return it->second;
+}
+
+// Read any library darks that have not been loaded yet, e.g. before the library file is rewritten
+bool GuideCamera::LoadAllDarks()
+{
+    wxCriticalSectionLocker lck(DarkFrameLock);
+
+    for (ExposureImgMap::iterator it = Darks.begin(); it != Darks.end(); ++it)
+    {
+        if (!LoadLibraryDark(it))
+            return false;
+    }
+    return true;
 }
 
 void GuideCamera::SelectDark(int exposureDuration)
@@ -1436,13 +1519,74 @@ void GuideCamera::SelectDark(int exposureDuration)
 
     wxCriticalSectionLocker lck(DarkFrameLock);
 
-    CurrentDarkFrame = 0;
-    for (ExposureImgMap::const_iterator it = Darks.begin(); it != Darks.end(); ++it)
+    ExposureImgMap::iterator sel = Darks.end();
+    for (ExposureImgMap::iterator it = Darks.begin(); it != Darks.end(); ++it)
     {
-        CurrentDarkFrame = it->second;
+        sel = it;
         if (it->first >= exposureDuration)
             break;
     }
+
+    PendingDarkExposure = 0;
+
+    if (sel == Darks.end())
+    {
+        CurrentDarkFrame = nullptr;
+        return;
+    }
+
+    if (sel->second)
+    {
+        SetCurrentDark(sel->second);
+        return;
+    }
+
+    // The library frame is read by SubtractDark before the next frame is corrected, so that the
+    // main thread does not wait for the disk. Until then no dark is subtracted, rather than the
+    // dark for a different exposure.
+    CurrentDarkFrame = nullptr;
+    PendingDarkExposure = sel->first;
+}
+
+// Make dark the current dark frame. Only the current library dark is kept in memory, the others
+// are read again when needed. The caller must hold DarkFrameLock.
+void GuideCamera::SetCurrentDark(usImage *dark)
+{
+    CurrentDarkFrame = dark;
+
+    for (auto it = DarkLibHdus.begin(); it != DarkLibHdus.end(); ++it)
+    {
+        ExposureImgMap::iterator pos = Darks.find(it->first);
+        if (pos != Darks.end() && pos->second && pos->second != dark)
+        {
+            delete pos->second;
+            pos->second = nullptr;
+        }
+    }
+}
+
+// Read the library dark chosen by SelectDark. The caller must hold DarkFrameLock.
+void GuideCamera::LoadPendingDark()
+{
+    int const exposure = PendingDarkExposure;
+    PendingDarkExposure = 0;
+
+    ExposureImgMap::iterator pos = Darks.find(exposure);
+    if (pos == Darks.end())
+        return;
+
+    Debug.Write(wxString::Format("reading dark frame exposure = %d\n", exposure));
+
+    usImage *dark = LoadLibraryDark(pos);
+    if (!dark)
+    {
+        pFrame->Alert(wxString::Format(_("Could not read the %.3f s dark frame from the dark library, "
+                                         "see the debug log for more information."),
+                                       exposure / 1000.0));
+        return;
+    }
+
+    SetCurrentDark(dark);
 }
 
 void GuideCamera::GetDarkLibraryProperties(int *pNumDarks, double *pMinExp, double *pMaxExp)
@@ -1497,17 +1641,25 @@ void GuideCamera::ClearDarks()
         delete it->second;
         Darks.erase(it);
     }
+    DarkLibHdus.clear();
+    DarkLibFile.Clear();
     CurrentDarkFrame = nullptr;
+    PendingDarkExposure = 0;
 }
 
 void GuideCamera::SubtractDark(usImage& img)
 {
+    TimingProbe probe(GuideTiming::STAGE_DARK_SUBTRACT);
+
     // dark subtraction is done in the camera worker thread, so we need to acquire the
     // DarkFrameLock to protect against the dark frame disappearing when the main
     // thread does "Load Darks" or "Clear Darks"
 
     wxCriticalSectionLocker lck(DarkFrameLock);
 
+    if (PendingDarkExposure && !CurrentDefectMap)
+        LoadPendingDark();
+
     if (CurrentDefectMap)
     {
         RemoveDefects(img, *CurrentDefectMap);
@@ -1518,6 +1670,71 @@ void GuideCamera::SubtractDark(usImage& img)
     }
 }
 
+CaptureReadout GuideCamera::BeginReadout(usImage& img, const wxSize& readoutSize, int bpp, bool wholeImage)
+{
+    CaptureReadout readout;
+    readout.Size = readoutSize;
+    readout.Bpp = bpp;
+    readout.Direct = wholeImage && readoutSize == img.Size;
+
+    size_t const npixels = (size_t) readoutSize.GetWidth() * readoutSize.GetHeight();
+    size_t const size = bpp == 8 ? npixels : npixels * sizeof(unsigned short);
+
+    if (readout.Direct)
+    {
+        // an 8-bit frame goes into the upper half of the image buffer so that
+        // it can be widened in place without overwriting unread pixels
+        readout.Buffer = reinterpret_cast<unsigned char *>(img.ImageData) + (bpp == 8 ? npixels : 0);
+        readout.BufferSize = size;
+        return readout;
+    }
+
+    if (size > m_readoutBufferSize)
+    {
+        ::free(m_readoutBuffer);
+        m_readoutBuffer = static_cast<unsigned char *>(::malloc(size));
+        m_readoutBufferSize = m_readoutBuffer ? size : 0;
+        Debug.Write(wxString::Format("Camera: readout buffer %dx%d %d bpp\n", readoutSize.GetWidth(),
+                                     readoutSize.GetHeight(), bpp));
+    }
+
+    readout.Buffer = m_readoutBuffer;
+    readout.BufferSize = m_readoutBufferSize;
+    return readout;
+}
+
+void GuideCamera::EndReadout(usImage& img, const CaptureReadout& readout)
+{
+    if (readout.Direct)
+    {
+        if (readout.Bpp == 8)
+            CaptureWiden8(img.ImageData, readout.Buffer, img.NPixels);
+        // a 16-bit frame is already in place
+        return;
+    }
+
+    EndReadout(img, readout, wxRect(img.Size), wxPoint(0, 0));
+}
+
+void GuideCamera::EndReadout(usImage& img, const CaptureReadout& readout, const wxRect& dstRect, const wxPoint& srcPos)
+{
+    assert(!readout.Direct);
+
+    unsigned short *dst = img.ImageData + dstRect.GetTop() * img.Size.GetWidth() + dstRect.GetLeft();
+    size_t const srcofs = (size_t) srcPos.y * readout.Size.GetWidth() + srcPos.x;
+
+    if (readout.Bpp == 8)
+    {
+        CaptureCopyRect8(dst, img.Size.GetWidth(), readout.Buffer + srcofs, readout.Size.GetWidth(), dstRect.GetWidth(),
+                         dstRect.GetHeight());
+    }
+    else
+    {
+        CaptureCopyRect16(dst, img.Size.GetWidth(), reinterpret_cast<const unsigned short *>(readout.Buffer) + srcofs,
+                          readout.Size.GetWidth(), dstRect.GetWidth(), dstRect.GetHeight());
+    }
+}
+
 static void InitiateReconnect()
 {
     WorkerThread *thr = WorkerThread::This();
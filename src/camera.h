@@ -105,12 +105,24 @@ enum CaptureOptionBits
     CAPTURE_BPM_REVIEW = CAPTURE_SUBTRACT_DARK | CAPTURE_IGNORE_FRAME_LIMIT,
 };
 
+// Where the camera SDK should read out a frame, see GuideCamera::BeginReadout()
+struct CaptureReadout
+{
+    unsigned char *Buffer; // buffer to pass to the SDK
+    size_t BufferSize; // size of Buffer in bytes
+    wxSize Size; // size of the readout in pixels
+    int Bpp; // 8 or 16
+    bool Direct; // the SDK writes into the image buffer itself
+};
+
 class GuideCamera : public wxMessageBoxProxy, public OnboardST4
 {
     friend class CameraConfigDialogPane;
     friend class CameraConfigDialogCtrlSet;
 
     double m_pixelSize;
+    unsigned char *m_readoutBuffer; // scratch readout buffer, kept between frames
+    size_t m_readoutBufferSize;
 
 protected:
     bool m_hasGuideOutput;
@@ -143,8 +155,11 @@ public:
 
     wxCriticalSection DarkFrameLock; // dark frames can be accessed in the main thread or the camera worker thread
     usImage *CurrentDarkFrame;
-    ExposureImgMap Darks; // map exposure => dark frame
+    ExposureImgMap Darks; // map exposure => dark frame, null for library darks not yet read
+    std::map<int, int> DarkLibHdus; // map exposure => dark library HDU for darks that are read on demand
+    wxString DarkLibFile;
     DefectMap *CurrentDefectMap;
+    int PendingDarkExposure; // library dark selected by SelectDark that SubtractDark still has to read, 0 for none
 
     static wxArrayString GuideCameraList();
     static GuideCamera *Factory(const wxString& choice);
@@ -201,6 +216,8 @@ public:
 
     virtual wxString GetSettingsSummary();
     void AddDark(usImage *dark);
+    void AddLibraryDark(const wxString& fname, int exposureDuration, int hdu);
+    bool LoadAllDarks();
     void SelectDark(int exposureDuration);
     void SetDefectMap(DefectMap *newMap);
     void ClearDefectMap();
@@ -224,6 +241,9 @@ public:
     virtual bool Capture(int duration, usImage& img, int captureOptions, const wxRect& subframe) = 0;
 
 protected:
+    usImage *LoadLibraryDark(ExposureImgMap::iterator it);
+    void SetCurrentDark(usImage *dark);
+    void LoadPendingDark();
     int GetTimeoutMs() const;
     void SetTimeoutMs(int timeoutMs);
 
@@ -241,6 +261,19 @@ protected:
     };
     void DisconnectWithAlert(CaptureFailType type);
     void DisconnectWithAlert(const wxString& msg, ReconnectType reconnect);
+
+    // Get the buffer the camera SDK should read a frame of readoutSize pixels
+    // and bpp bits into. img must already be initialized to its final size.
+    // When the readout becomes the whole image (wholeImage, and the sizes
+    // match) the frame lands in the image buffer itself, 8-bit frames in its
+    // upper half to be widened in place; otherwise in a scratch buffer kept by
+    // the camera. Returns a null Buffer if the scratch buffer cannot be
+    // allocated.
+    CaptureReadout BeginReadout(usImage& img, const wxSize& readoutSize, int bpp, bool wholeImage);
+    // Move the whole readout into img
+    void EndReadout(usImage& img, const CaptureReadout& readout);
+    // Move the readout pixels starting at srcPos into dstRect of img (not for wholeImage readouts)
+    void EndReadout(usImage& img, const CaptureReadout& readout, const wxRect& dstRect, const wxPoint& srcPos);
 };
 
 inline int GuideCamera::GetTimeoutMs() const
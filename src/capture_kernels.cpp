@@ -0,0 +1,229 @@
+/*
+ *  capture_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "capture_kernels.h"
+#include "simd.h"
+
+#include <string.h>
+
+/*************      8 to 16-bit widening      **************************/
+
+// The loops below only ever write bytes that have already been read: when
+// converting in place, the store of block i ends at byte 2 * (i + B) - 1,
+// which is below the next unread source byte n + i + B as long as i + B <= n.
+
+static void Widen8Scalar(unsigned short *dst, const unsigned char *src, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = src[i];
+}
+
+#if PHD_SIMD_X86
+
+PHD_TARGET_SSE2 static void Widen8SSE2(unsigned short *dst, const unsigned char *src, size_t n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i *) (dst + i), lo);
+        _mm_storeu_si128((__m128i *) (dst + i + 8), hi);
+    }
+    Widen8Scalar(dst + i, src + i, n - i);
+}
+
+PHD_TARGET_AVX2 static void Widen8AVX2(unsigned short *dst, const unsigned char *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (src + i + 16));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_cvtepu8_epi16(v0));
+        _mm256_storeu_si256((__m256i *) (dst + i + 16), _mm256_cvtepu8_epi16(v1));
+    }
+    Widen8Scalar(dst + i, src + i, n - i);
+}
+
+#endif // PHD_SIMD_X86
+
+void CaptureWiden8(unsigned short *dst, const unsigned char *src, size_t n)
+{
+#if PHD_SIMD_X86
+    switch (SimdGetLevel())
+    {
+    case SIMD_AVX2:
+        Widen8AVX2(dst, src, n);
+        return;
+    case SIMD_SSE2:
+        Widen8SSE2(dst, src, n);
+        return;
+    default:
+        break;
+    }
+#endif
+    Widen8Scalar(dst, src, n);
+}
+
+/*************      rect copies      **************************/
+
+void CaptureCopyRect8(unsigned short *dst, int dst_stride, const unsigned char *src, int src_stride, int w, int h)
+{
+    for (int y = 0; y < h; y++)
+        CaptureWiden8(dst + (size_t) y * dst_stride, src + (size_t) y * src_stride, w);
+}
+
+void CaptureCopyRect16(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h)
+{
+    if (w == dst_stride && w == src_stride)
+    {
+        memcpy(dst, src, (size_t) w * h * sizeof(unsigned short));
+        return;
+    }
+    for (int y = 0; y < h; y++)
+        memcpy(dst + (size_t) y * dst_stride, src + (size_t) y * src_stride, w * sizeof(unsigned short));
+}
+
+/*************      binning      **************************/
+
+template<typename T>
+static void BinScalar(T *dst, const T *src, int srcw, int srch, unsigned int binning)
+{
+    int const b = binning;
+    int const dw = srcw / b;
+    int const dh = srch / b;
+    unsigned int const n = binning * binning;
+
+    for (int y = 0; y < dh; y++)
+    {
+        const T *row = src + (size_t) y * b * srcw;
+        T *d = dst + (size_t) y * dw;
+        for (int x = 0; x < dw; x++)
+        {
+            unsigned int sum = 0;
+            for (int j = 0; j < b; j++)
+                for (int i = 0; i < b; i++)
+                    sum += row[j * srcw + x * b + i];
+            d[x] = sum / n;
+        }
+    }
+}
+
+#if PHD_SIMD_X86
+
+// 2x2 binning of 16 source columns of two rows into 8 output pixels
+PHD_TARGET_SSE2 static void Bin2Rows8SSE2(unsigned char *dst, const unsigned char *r0, const unsigned char *r1, int dw,
+                                          int *done)
+{
+    const __m128i lomask = _mm_set1_epi16(0x00ff);
+    int x = 0;
+    for (; x + 8 <= dw; x += 8)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *) (r0 + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i *) (r1 + 2 * x));
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, lomask), _mm_srli_epi16(a, 8)),
+                                    _mm_add_epi16(_mm_and_si128(b, lomask), _mm_srli_epi16(b, 8)));
+        sum = _mm_srli_epi16(sum, 2);
+        _mm_storel_epi64((__m128i *) (dst + x), _mm_packus_epi16(sum, sum));
+    }
+    *done = x;
+}
+
+// 2x2 binning of 8 source columns of two rows into 4 output pixels
+PHD_TARGET_SSE2 static void Bin2Rows16SSE2(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, int dw,
+                                           int *done)
+{
+    const __m128i lomask = _mm_set1_epi32(0xffff);
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16((short) 0x8000);
+    int x = 0;
+    for (; x + 4 <= dw; x += 4)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *) (r0 + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i *) (r1 + 2 * x));
+        __m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(a, lomask), _mm_srli_epi32(a, 16)),
+                                    _mm_add_epi32(_mm_and_si128(b, lomask), _mm_srli_epi32(b, 16)));
+        sum = _mm_srli_epi32(sum, 2);
+        // SSE2 has no unsigned 32 -> 16 bit pack; shift into the signed range and back
+        __m128i packed = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(sum, bias32), _mm_sub_epi32(sum, bias32)), bias16);
+        _mm_storel_epi64((__m128i *) (dst + x), packed);
+    }
+    *done = x;
+}
+
+template<typename T>
+static void Bin2SSE2(T *dst, const T *src, int srcw, int srch,
+                     void (*rows)(T *dst, const T *r0, const T *r1, int dw, int *done))
+{
+    int const dw = srcw / 2;
+    int const dh = srch / 2;
+    for (int y = 0; y < dh; y++)
+    {
+        const T *r0 = src + (size_t) 2 * y * srcw;
+        const T *r1 = r0 + srcw;
+        T *d = dst + (size_t) y * dw;
+        int x;
+        rows(d, r0, r1, dw, &x);
+        for (; x < dw; x++)
+            d[x] = ((unsigned int) r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1]) / 4;
+    }
+}
+
+#endif // PHD_SIMD_X86
+
+void CaptureBin8(unsigned char *dst, const unsigned char *src, int srcw, int srch, unsigned int binning)
+{
+#if PHD_SIMD_X86
+    if (binning == 2 && SimdGetLevel() >= SIMD_SSE2)
+    {
+        Bin2SSE2(dst, src, srcw, srch, Bin2Rows8SSE2);
+        return;
+    }
+#endif
+    BinScalar(dst, src, srcw, srch, binning);
+}
+
+void CaptureBin16(unsigned short *dst, const unsigned short *src, int srcw, int srch, unsigned int binning)
+{
+#if PHD_SIMD_X86
+    if (binning == 2 && SimdGetLevel() >= SIMD_SSE2)
+    {
+        Bin2SSE2(dst, src, srcw, srch, Bin2Rows16SSE2);
+        return;
+    }
+#endif
+    BinScalar(dst, src, srcw, srch, binning);
+}
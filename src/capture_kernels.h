@@ -0,0 +1,59 @@
+/*
+ *  capture_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CAPTURE_KERNELS_INCLUDED
+#define CAPTURE_KERNELS_INCLUDED
+
+#include <stddef.h>
+
+// Pixel conversions used by the camera drivers to move a frame from the
+// camera SDK's readout buffer into a usImage. The vectorized versions are
+// selected at run time (see simd.h) and give the same results as the scalar
+// code.
+
+// Widen n 8-bit pixels to 16 bits. The conversion may be done in place with
+// the 8-bit data in the upper half of the 16-bit buffer, i.e. with
+// src == (const unsigned char *) dst + n. Other overlaps are not allowed.
+void CaptureWiden8(unsigned short *dst, const unsigned char *src, size_t n);
+
+// Copy a w x h rect of 8-bit or 16-bit pixels into a 16-bit image; strides are in pixels
+void CaptureCopyRect8(unsigned short *dst, int dst_stride, const unsigned char *src, int src_stride, int w, int h);
+void CaptureCopyRect16(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h);
+
+// Software binning by averaging binning x binning blocks (binning 2, 3 or 4).
+// The result has (srcw / binning) x (srch / binning) pixels; leftover rows and
+// columns are dropped.
+void CaptureBin8(unsigned char *dst, const unsigned char *src, int srcw, int srch, unsigned int binning);
+void CaptureBin16(unsigned short *dst, const unsigned short *src, int srcw, int srch, unsigned int binning);
+
+#endif // CAPTURE_KERNELS_INCLUDED
@@ -86,6 +86,7 @@ enum BRAIN_CTRL_IDS
     AD_cbReverseDecOnFlip,
     AD_cbAssumeOrthogonal,
     AD_cbSlewDetection,
+    AD_cbConcurrentPulses,
     AD_cbUseDecComp,
     AD_cbBeepForLostStar,
     AD_GUIDER_TAB_BOUNDARY, // --------------- end of guiding tab controls
@@ -37,15 +37,150 @@
 
 #include <wx/dir.h>
 
+#include <atomic>
+
 #define ALWAYS_FLUSH_DEBUGLOG
 const int RetentionPeriod = 30;
 
-DebugLog::DebugLog() : m_enabled(false), m_lastWriteTime(wxDateTime::UNow()) { }
+// maximum number of lines waiting for the writer thread (a power of 2);
+// further lines are dropped
+enum
+{
+    QUEUE_SIZE = 8192,
+    // lines formatted before each write to the file
+    BATCH_LINES = 256,
+};
+
+struct DebugLogLine
+{
+    wxDateTime time;
+    wxThreadIdType thread;
+    wxString text;
+};
+
+// Bounded multi-producer queue. Each slot has a sequence number that tells the
+// producers and the consumer whose turn it is to use the slot, so producers
+// only contend on an atomic increment of the tail. Lines are consumed with
+// the write lock held, so there is only ever one consumer.
+struct DebugLogQueue
+{
+    struct Slot
+    {
+        std::atomic<size_t> seq;
+        DebugLogLine line;
+    };
+
+    Slot slots[QUEUE_SIZE];
+    std::atomic<size_t> tail; // next slot to fill
+    size_t head; // next slot to consume
+    std::atomic<unsigned long> dropped;
+    unsigned long reportedDropped;
+    std::atomic<bool> writerRunning;
+    std::atomic<bool> writerWaiting;
+    wxSemaphore wakeup; // posted when a line is queued while the writer is waiting
+
+    DebugLogQueue() : tail(0), head(0), dropped(0), reportedDropped(0), writerRunning(false), writerWaiting(false)
+    {
+        for (size_t i = 0; i < QUEUE_SIZE; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    void Push(const wxDateTime& time, wxThreadIdType thread, const wxString& text)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[pos & (QUEUE_SIZE - 1)];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            if (seq == pos)
+            {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (seq < pos)
+            {
+                // full: the writer has not caught up
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+                pos = tail.load(std::memory_order_relaxed);
+        }
+
+        slot->line.time = time;
+        slot->line.thread = thread;
+        slot->line.text = text;
+        slot->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    bool Ready() const { return slots[head & (QUEUE_SIZE - 1)].seq.load(std::memory_order_acquire) == head + 1; }
+
+    bool Pop(DebugLogLine *line)
+    {
+        if (!Ready())
+            return false;
+
+        Slot& slot = slots[head & (QUEUE_SIZE - 1)];
+        line->time = slot.line.time;
+        line->thread = slot.line.thread;
+        line->text.swap(slot.line.text);
+        slot.seq.store(head + QUEUE_SIZE, std::memory_order_release);
+        ++head;
+        return true;
+    }
+};
+
+class DebugLogWriter : public wxThread
+{
+    DebugLog *m_log;
+    std::atomic<bool> m_stop;
+
+public:
+    DebugLogWriter(DebugLog *log) : wxThread(wxTHREAD_JOINABLE), m_log(log), m_stop(false) { }
+    void Stop()
+    {
+        m_stop = true;
+        m_log->m_queue->wakeup.Post();
+    }
+
+protected:
+    ExitCode Entry() override;
+};
+
+wxThread::ExitCode DebugLogWriter::Entry()
+{
+    DebugLogQueue *queue = m_log->m_queue;
+
+    while (!m_stop)
+    {
+        m_log->WriteQueuedLines();
+
+        // producers post the semaphore when they see the waiting flag; the
+        // fences make sure that either we see their line or they see the flag
+        queue->writerWaiting = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!queue->Ready() && !m_stop)
+            queue->wakeup.WaitTimeout(1000);
+        queue->writerWaiting = false;
+    }
+
+    m_log->WriteQueuedLines();
+
+    return (wxThread::ExitCode) 0;
+}
+
+DebugLog::DebugLog() : m_enabled(false), m_lastWriteTime(wxDateTime::UNow()), m_queue(new DebugLogQueue()), m_writer(nullptr)
+{
+}
 
 DebugLog::~DebugLog()
 {
+    StopWriter();
+    WriteQueuedLines();
     wxFFile::Flush();
     wxFFile::Close();
+    delete m_queue;
 }
 
 static bool ParseLogTimestamp(wxDateTime *p, const wxString& s)
@@ -99,10 +234,11 @@ void DebugLog::InitDebugLog(bool enable, bool forceOpen)
 {
     const wxDateTime& logFileTime = wxGetApp().GetLogFileTime();
 
-    wxCriticalSectionLocker lock(m_criticalSection);
+    wxMutexLocker lock(m_writeLock);
 
     if (m_enabled)
     {
+        WriteQueuedLinesLocked();
         wxFFile::Flush();
         wxFFile::Close();
 
@@ -121,9 +257,59 @@ void DebugLog::InitDebugLog(bool enable, bool forceOpen)
         }
     }
 
+    if (enable && !m_writer)
+    {
+        m_writer = new DebugLogWriter(this);
+        if (m_writer->Run() == wxTHREAD_NO_ERROR)
+            m_queue->writerRunning = true;
+        else
+        {
+            // lines will be written by the threads that log them
+            delete m_writer;
+            m_writer = nullptr;
+        }
+    }
+
     m_enabled = enable;
 }
 
+void DebugLog::StopWriter()
+{
+    if (m_writer)
+    {
+        m_queue->writerRunning = false;
+        m_writer->Stop();
+        m_writer->Wait();
+        delete m_writer;
+        m_writer = nullptr;
+    }
+}
+
+// called from the fatal exception handler
+void DebugLog::FlushOnCrash()
+{
+    if (!m_enabled)
+        return;
+
+    Write("Fatal exception, flushing debug log\n");
+
+    // The writer thread should release the lock shortly, but it may be the
+    // thread that crashed. Write the remaining lines regardless after a while.
+    bool locked = false;
+    for (int i = 0; i < 50 && !locked; i++)
+    {
+        locked = m_writeLock.TryLock() == wxMUTEX_NO_ERROR;
+        if (!locked)
+            wxMilliSleep(10);
+    }
+
+    WriteQueuedLinesLocked();
+    wxFFile::Flush();
+
+    if (locked)
+        m_writeLock.Unlock();
+}
+
 bool DebugLog::ChangeDirLog(const wxString& newdir)
 {
     bool enabled = IsEnabled();
@@ -171,33 +357,90 @@ bool DebugLog::Flush()
 
     if (m_enabled)
     {
-        wxCriticalSectionLocker lock(m_criticalSection);
+        wxMutexLocker lock(m_writeLock);
 
+        WriteQueuedLinesLocked();
         ret = wxFFile::Flush();
     }
 
     return ret;
 }
 
-wxString DebugLog::Write(const wxString& str)
+void DebugLog::WriteQueuedLines()
 {
-    if (m_enabled)
+    wxMutexLocker lock(m_writeLock);
+    WriteQueuedLinesLocked();
+}
+
+void DebugLog::WriteQueuedLinesLocked()
+{
+    DebugLogLine line;
+    wxString batch;
+    unsigned int lines = 0;
+
+    while (true)
     {
-        wxCriticalSectionLocker lock(m_criticalSection);
+        bool more = m_queue->Pop(&line);
+
+        if (!more)
+        {
+            unsigned long dropped = m_queue->dropped.load(std::memory_order_relaxed);
+            if (dropped != m_queue->reportedDropped)
+            {
+                line.time = wxDateTime::UNow();
+                line.thread = wxThread::GetCurrentId();
+                line.text = wxString::Format("DebugLog: %lu lines dropped\n", dropped - m_queue->reportedDropped);
+                m_queue->reportedDropped = dropped;
+                more = true;
+            }
+        }
 
-        wxDateTime now = wxDateTime::UNow();
-        wxTimeSpan deltaTime = now - m_lastWriteTime;
-        m_lastWriteTime = now;
-        wxString outputLine = wxString::Format("%s %s %lu %s", now.Format("%H:%M:%S.%l"), deltaTime.Format("%S.%l"),
-                                               (unsigned long) wxThread::GetCurrentId(), str);
+        if (more)
+        {
+            // lines from different threads can be queued slightly out of order
+            wxTimeSpan deltaTime = line.time.IsLaterThan(m_lastWriteTime) ? line.time - m_lastWriteTime : wxTimeSpan(0);
+            if (line.time.IsLaterThan(m_lastWriteTime))
+                m_lastWriteTime = line.time;
+            batch += wxString::Format("%s %s %lu %s", line.time.Format("%H:%M:%S.%l"), deltaTime.Format("%S.%l"),
+                                      (unsigned long) line.thread, line.text);
+            ++lines;
+        }
+
+        if (lines > 0 && (!more || lines == BATCH_LINES))
+        {
+            if (IsOpened())
+                wxFFile::Write(batch);
+#if defined(__WINDOWS__) && defined(_DEBUG)
+            OutputDebugString(batch.c_str());
+#endif
+            batch.clear();
+            lines = 0;
+        }
+
+        if (!more)
+            break;
+    }
 
-        wxFFile::Write(outputLine);
 #if defined(ALWAYS_FLUSH_DEBUGLOG)
+    if (IsOpened())
         wxFFile::Flush();
 #endif
-#if defined(__WINDOWS__) && defined(_DEBUG)
-        OutputDebugString(outputLine.c_str());
-#endif
+}
+
+wxString DebugLog::Write(const wxString& str)
+{
+    if (m_enabled)
+    {
+        m_queue->Push(wxDateTime::UNow(), wxThread::GetCurrentId(), str);
+
+        if (!m_queue->writerRunning)
+            WriteQueuedLines();
+        else
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_queue->writerWaiting.exchange(false))
+                m_queue->wakeup.Post();
+        }
     }
 
     return str;
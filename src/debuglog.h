@@ -38,12 +38,25 @@
 
 #include "logger.h"
 
+struct DebugLogQueue;
+class DebugLogWriter;
+
+// Lines passed to Write() are queued without taking a lock and written to the
+// file in batches by a dedicated writer thread, which also formats the line
+// prefix. When the queue is full, lines are dropped and counted, and the count
+// is reported in the log.
 class DebugLog : public wxFFile, public Logger
 {
     bool m_enabled;
-    wxCriticalSection m_criticalSection;
+    wxMutex m_writeLock; // held while queued lines are written to the file
     wxDateTime m_lastWriteTime;
     wxString m_path;
+    DebugLogQueue *m_queue;
+    DebugLogWriter *m_writer;
+
+    friend class DebugLogWriter;
+    void WriteQueuedLines();
+    void WriteQueuedLinesLocked();
 
 public:
     DebugLog();
@@ -59,6 +72,9 @@ public:
     wxString Write(const wxString& str);
     bool Flush();
 
+    void StopWriter();
+    void FlushOnCrash();
+
     bool ChangeDirLog(const wxString& newdir) override;
     void RemoveOldFiles();
 };
@@ -0,0 +1,787 @@
+/*
+ *  denoise_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "denoise_kernels.h"
+#include "simd.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+// minimum number of rows in a band of work handed to the worker pool
+enum
+{
+    DENOISE_BAND_ROWS = 64
+};
+
+/*************      3x3 median      **************************/
+
+// The median of the 3x3 neighborhood is found by sorting each of the three
+// columns and taking the median of (the max of the column minimums, the
+// median of the column medians, the min of the column maximums). This needs
+// only min and max operations, so the vectorized versions compute exactly
+// the same values as the scalar code.
+
+static inline void Sort2(unsigned short& a, unsigned short& b)
+{
+    unsigned short const t = std::min(a, b);
+    b = std::max(a, b);
+    a = t;
+}
+
+static inline void Sort3(unsigned short& a, unsigned short& b, unsigned short& c)
+{
+    Sort2(a, b);
+    Sort2(b, c);
+    Sort2(a, b);
+}
+
+static inline unsigned short Med3(unsigned short a, unsigned short b, unsigned short c)
+{
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// median of an even number of pixels: the mean of the middle two, rounded down
+template<int N>
+static inline unsigned short MedianEven(unsigned short (&v)[N])
+{
+    std::sort(v, v + N);
+    return (unsigned short) (((unsigned int) v[N / 2 - 1] + (unsigned int) v[N / 2]) / 2);
+}
+
+static void Median9RowScalar(unsigned short *dst, const unsigned short *r0, const unsigned short *r1,
+                             const unsigned short *r2, int x0, int x1)
+{
+    for (int x = x0; x < x1; x++)
+    {
+        unsigned short lo[3], mid[3], hi[3];
+        for (int i = 0; i < 3; i++)
+        {
+            lo[i] = r0[x - 1 + i];
+            mid[i] = r1[x - 1 + i];
+            hi[i] = r2[x - 1 + i];
+            Sort3(lo[i], mid[i], hi[i]);
+        }
+        unsigned short const l = std::max(std::max(lo[0], lo[1]), lo[2]);
+        unsigned short const m = Med3(mid[0], mid[1], mid[2]);
+        unsigned short const h = std::min(std::min(hi[0], hi[1]), hi[2]);
+        dst[x] = Med3(l, m, h);
+    }
+}
+
+#if PHD_SIMD_X86
+
+// SSE2 has no unsigned 16-bit min/max, so the pixels are biased by 0x8000 and
+// compared as signed values
+
+PHD_TARGET_SSE2 static inline void Sort2SSE2(__m128i& a, __m128i& b)
+{
+    __m128i const t = _mm_min_epi16(a, b);
+    b = _mm_max_epi16(a, b);
+    a = t;
+}
+
+PHD_TARGET_SSE2 static inline __m128i Med3SSE2(__m128i a, __m128i b, __m128i c)
+{
+    return _mm_max_epi16(_mm_min_epi16(a, b), _mm_min_epi16(_mm_max_epi16(a, b), c));
+}
+
+PHD_TARGET_SSE2 static int Median9RowSSE2(unsigned short *dst, const unsigned short *r0, const unsigned short *r1,
+                                          const unsigned short *r2, int x0, int x1)
+{
+    __m128i const bias = _mm_set1_epi16((short) 0x8000);
+    int x = x0;
+    for (; x + 8 <= x1; x += 8)
+    {
+        __m128i lo[3], mid[3], hi[3];
+        for (int i = 0; i < 3; i++)
+        {
+            lo[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (r0 + x - 1 + i)), bias);
+            mid[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (r1 + x - 1 + i)), bias);
+            hi[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (r2 + x - 1 + i)), bias);
+            Sort2SSE2(lo[i], mid[i]);
+            Sort2SSE2(mid[i], hi[i]);
+            Sort2SSE2(lo[i], mid[i]);
+        }
+        __m128i const l = _mm_max_epi16(_mm_max_epi16(lo[0], lo[1]), lo[2]);
+        __m128i const m = Med3SSE2(mid[0], mid[1], mid[2]);
+        __m128i const h = _mm_min_epi16(_mm_min_epi16(hi[0], hi[1]), hi[2]);
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_xor_si128(Med3SSE2(l, m, h), bias));
+    }
+    return x;
+}
+
+PHD_TARGET_AVX2 static inline void Sort2AVX2(__m256i& a, __m256i& b)
+{
+    __m256i const t = _mm256_min_epu16(a, b);
+    b = _mm256_max_epu16(a, b);
+    a = t;
+}
+
+PHD_TARGET_AVX2 static inline __m256i Med3AVX2(__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_max_epu16(_mm256_min_epu16(a, b), _mm256_min_epu16(_mm256_max_epu16(a, b), c));
+}
+
+PHD_TARGET_AVX2 static int Median9RowAVX2(unsigned short *dst, const unsigned short *r0, const unsigned short *r1,
+                                          const unsigned short *r2, int x0, int x1)
+{
+    int x = x0;
+    for (; x + 16 <= x1; x += 16)
+    {
+        __m256i lo[3], mid[3], hi[3];
+        for (int i = 0; i < 3; i++)
+        {
+            lo[i] = _mm256_loadu_si256((const __m256i *) (r0 + x - 1 + i));
+            mid[i] = _mm256_loadu_si256((const __m256i *) (r1 + x - 1 + i));
+            hi[i] = _mm256_loadu_si256((const __m256i *) (r2 + x - 1 + i));
+            Sort2AVX2(lo[i], mid[i]);
+            Sort2AVX2(mid[i], hi[i]);
+            Sort2AVX2(lo[i], mid[i]);
+        }
+        __m256i const l = _mm256_max_epu16(_mm256_max_epu16(lo[0], lo[1]), lo[2]);
+        __m256i const m = Med3AVX2(mid[0], mid[1], mid[2]);
+        __m256i const h = _mm256_min_epu16(_mm256_min_epu16(hi[0], hi[1]), hi[2]);
+        _mm256_storeu_si256((__m256i *) (dst + x), Med3AVX2(l, m, h));
+    }
+    return x;
+}
+
+#endif // PHD_SIMD_X86
+
+// 3x3 median of pixels [x0, x1) of row r1; the pixels x0 - 1 and x1 must exist
+static void Median9Row(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, const unsigned short *r2,
+                       int x0, int x1)
+{
+#if PHD_SIMD_X86
+    switch (SimdGetLevel())
+    {
+    case SIMD_AVX2:
+        x0 = Median9RowAVX2(dst, r0, r1, r2, x0, x1);
+        break;
+    case SIMD_SSE2:
+        x0 = Median9RowSSE2(dst, r0, r1, r2, x0, x1);
+        break;
+    default:
+        break;
+    }
+#endif
+    Median9RowScalar(dst, r0, r1, r2, x0, x1);
+}
+
+void DenoiseMedian3Row(unsigned short *dst, const unsigned short *src, int stride, int w, int h, int y)
+{
+    const unsigned short *r1 = src + (size_t) y * stride;
+
+    if (y == 0 || y == h - 1)
+    {
+        // top or bottom row: 2 x 2 at the corners, 3 x 2 in between
+        const unsigned short *a = y == 0 ? r1 : r1 - stride;
+        const unsigned short *b = a + stride;
+
+        unsigned short c[4] = { a[0], a[1], b[0], b[1] };
+        dst[0] = MedianEven(c);
+
+        for (int x = 1; x <= w - 2; x++)
+        {
+            unsigned short v[6] = { a[x - 1], a[x], a[x + 1], b[x - 1], b[x], b[x + 1] };
+            dst[x] = MedianEven(v);
+        }
+
+        unsigned short d[4] = { a[w - 2], a[w - 1], b[w - 2], b[w - 1] };
+        dst[w - 1] = MedianEven(d);
+        return;
+    }
+
+    const unsigned short *r0 = r1 - stride;
+    const unsigned short *r2 = r1 + stride;
+
+    unsigned short l[6] = { r0[0], r0[1], r1[0], r1[1], r2[0], r2[1] };
+    dst[0] = MedianEven(l);
+
+    Median9Row(dst, r0, r1, r2, 1, w - 1);
+
+    unsigned short r[6] = { r0[w - 2], r0[w - 1], r1[w - 2], r1[w - 1], r2[w - 2], r2[w - 1] };
+    dst[w - 1] = MedianEven(r);
+}
+
+void DenoiseMedian3(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h)
+{
+    if (w < 2 || h < 2)
+    {
+        for (int y = 0; y < h; y++)
+            memcpy(dst + (size_t) y * dst_stride, src + (size_t) y * src_stride, w * sizeof(unsigned short));
+        return;
+    }
+
+    WorkerPool::RunRows(0, h, DENOISE_BAND_ROWS, [&](int y0, int y1) {
+        for (int y = y0; y < y1; y++)
+            DenoiseMedian3Row(dst + (size_t) y * dst_stride, src, src_stride, w, h, y);
+    });
+}
+
+/*************      2x2 mean      **************************/
+
+static void Mean4RowScalar(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, int x0, int x1)
+{
+    for (int x = x0; x < x1; x++)
+    {
+        unsigned int const t = (unsigned int) r0[x] + r0[x + 1] + r1[x] + r1[x + 1];
+        dst[x] = (unsigned short) (t >> 2);
+    }
+}
+
+#if PHD_SIMD_X86
+
+// the sums are formed in 32 bits; SSE2 has no unsigned 32 to 16-bit pack, so
+// the results are biased into the signed range for _mm_packs_epi32
+
+PHD_TARGET_SSE2 static int Mean4RowSSE2(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, int x0,
+                                        int x1)
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const bias32 = _mm_set1_epi32(0x8000);
+    __m128i const bias16 = _mm_set1_epi16((short) 0x8000);
+    int x = x0;
+    for (; x + 8 <= x1; x += 8)
+    {
+        __m128i const a = _mm_loadu_si128((const __m128i *) (r0 + x));
+        __m128i const b = _mm_loadu_si128((const __m128i *) (r0 + x + 1));
+        __m128i const c = _mm_loadu_si128((const __m128i *) (r1 + x));
+        __m128i const d = _mm_loadu_si128((const __m128i *) (r1 + x + 1));
+        __m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpacklo_epi16(b, zero)),
+                                   _mm_add_epi32(_mm_unpacklo_epi16(c, zero), _mm_unpacklo_epi16(d, zero)));
+        __m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_unpackhi_epi16(a, zero), _mm_unpackhi_epi16(b, zero)),
+                                   _mm_add_epi32(_mm_unpackhi_epi16(c, zero), _mm_unpackhi_epi16(d, zero)));
+        lo = _mm_sub_epi32(_mm_srli_epi32(lo, 2), bias32);
+        hi = _mm_sub_epi32(_mm_srli_epi32(hi, 2), bias32);
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16));
+    }
+    return x;
+}
+
+PHD_TARGET_AVX2 static int Mean4RowAVX2(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, int x0,
+                                        int x1)
+{
+    // the unpacks and the pack work within 128-bit lanes, so the pixel order is preserved
+    __m256i const zero = _mm256_setzero_si256();
+    int x = x0;
+    for (; x + 16 <= x1; x += 16)
+    {
+        __m256i const a = _mm256_loadu_si256((const __m256i *) (r0 + x));
+        __m256i const b = _mm256_loadu_si256((const __m256i *) (r0 + x + 1));
+        __m256i const c = _mm256_loadu_si256((const __m256i *) (r1 + x));
+        __m256i const d = _mm256_loadu_si256((const __m256i *) (r1 + x + 1));
+        __m256i lo = _mm256_add_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(a, zero), _mm256_unpacklo_epi16(b, zero)),
+                                      _mm256_add_epi32(_mm256_unpacklo_epi16(c, zero), _mm256_unpacklo_epi16(d, zero)));
+        __m256i hi = _mm256_add_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(a, zero), _mm256_unpackhi_epi16(b, zero)),
+                                      _mm256_add_epi32(_mm256_unpackhi_epi16(c, zero), _mm256_unpackhi_epi16(d, zero)));
+        _mm256_storeu_si256((__m256i *) (dst + x), _mm256_packus_epi32(_mm256_srli_epi32(lo, 2), _mm256_srli_epi32(hi, 2)));
+    }
+    return x;
+}
+
+#endif // PHD_SIMD_X86
+
+// 2x2 mean of pixels [0, n) of row r0; pixel n of both rows must exist
+static void Mean4Row(unsigned short *dst, const unsigned short *r0, const unsigned short *r1, int n)
+{
+    int x = 0;
+#if PHD_SIMD_X86
+    switch (SimdGetLevel())
+    {
+    case SIMD_AVX2:
+        x = Mean4RowAVX2(dst, r0, r1, 0, n);
+        break;
+    case SIMD_SSE2:
+        x = Mean4RowSSE2(dst, r0, r1, 0, n);
+        break;
+    default:
+        break;
+    }
+#endif
+    Mean4RowScalar(dst, r0, r1, x, n);
+}
+
+void DenoiseLRecon(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h)
+{
+    if (w <= 0 || h <= 0)
+        return;
+
+    WorkerPool::RunRows(0, h, DENOISE_BAND_ROWS, [&](int y0, int y1) {
+        for (int y = y0; y < y1; y++)
+        {
+            unsigned short *d = dst + (size_t) y * dst_stride;
+            const unsigned short *r0 = src + (size_t) y * src_stride;
+
+            if (y < h - 1)
+            {
+                const unsigned short *r1 = r0 + src_stride;
+                Mean4Row(d, r0, r1, w - 1);
+                // last column
+                d[w - 1] = (unsigned short) (((unsigned int) r0[w - 1] + r1[w - 1]) >> 1);
+            }
+            else
+            {
+                // last row
+                for (int x = 0; x < w - 1; x++)
+                    d[x] = (unsigned short) (((unsigned int) r0[x] + r0[x + 1]) >> 1);
+                d[w - 1] = r0[w - 1];
+            }
+        }
+    });
+}
+
+/*************      frame statistics      **************************/
+
+static void RowMinMaxScalar(unsigned short *pmin, unsigned short *pmax, const unsigned short *p, int n)
+{
+    unsigned short mn = *pmin, mx = *pmax;
+    for (int i = 0; i < n; i++)
+    {
+        mn = std::min(mn, p[i]);
+        mx = std::max(mx, p[i]);
+    }
+    *pmin = mn;
+    *pmax = mx;
+}
+
+#if PHD_SIMD_X86
+
+PHD_TARGET_SSE2 static int RowMinMaxSSE2(unsigned short *pmin, unsigned short *pmax, const unsigned short *p, int n)
+{
+    if (n < 8)
+        return 0;
+
+    __m128i const bias = _mm_set1_epi16((short) 0x8000);
+    __m128i mn = _mm_set1_epi16((short) (*pmin ^ 0x8000));
+    __m128i mx = _mm_set1_epi16((short) (*pmax ^ 0x8000));
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i const v = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (p + i)), bias);
+        mn = _mm_min_epi16(mn, v);
+        mx = _mm_max_epi16(mx, v);
+    }
+
+    unsigned short lanes[2][8];
+    _mm_storeu_si128((__m128i *) lanes[0], _mm_xor_si128(mn, bias));
+    _mm_storeu_si128((__m128i *) lanes[1], _mm_xor_si128(mx, bias));
+    *pmin = *std::min_element(lanes[0], lanes[0] + 8);
+    *pmax = *std::max_element(lanes[1], lanes[1] + 8);
+    return i;
+}
+
+PHD_TARGET_AVX2 static int RowMinMaxAVX2(unsigned short *pmin, unsigned short *pmax, const unsigned short *p, int n)
+{
+    if (n < 16)
+        return 0;
+
+    __m256i mn = _mm256_set1_epi16((short) *pmin);
+    __m256i mx = _mm256_set1_epi16((short) *pmax);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i const v = _mm256_loadu_si256((const __m256i *) (p + i));
+        mn = _mm256_min_epu16(mn, v);
+        mx = _mm256_max_epu16(mx, v);
+    }
+
+    unsigned short lanes[2][16];
+    _mm256_storeu_si256((__m256i *) lanes[0], mn);
+    _mm256_storeu_si256((__m256i *) lanes[1], mx);
+    *pmin = *std::min_element(lanes[0], lanes[0] + 16);
+    *pmax = *std::max_element(lanes[1], lanes[1] + 16);
+    return i;
+}
+
+#endif // PHD_SIMD_X86
+
+// fold the pixels of a row into a running min and max
+static void RowMinMax(unsigned short *pmin, unsigned short *pmax, const unsigned short *p, int n)
+{
+    int i = 0;
+#if PHD_SIMD_X86
+    switch (SimdGetLevel())
+    {
+    case SIMD_AVX2:
+        i = RowMinMaxAVX2(pmin, pmax, p, n);
+        break;
+    case SIMD_SSE2:
+        i = RowMinMaxSSE2(pmin, pmax, p, n);
+        break;
+    default:
+        break;
+    }
+#endif
+    RowMinMaxScalar(pmin, pmax, p + i, n - i);
+}
+
+// The median comes from a 256-bin histogram of the high byte of each pixel,
+// refined with a histogram of the low byte of the pixels in the median's bin.
+// The histogram is split four ways so that runs of pixels falling in the same
+// bin do not serialize on a single counter.
+struct StatsBand
+{
+    unsigned short minADU;
+    unsigned short maxADU;
+    unsigned short filtMin;
+    unsigned short filtMax;
+    unsigned int histo[4][256];
+};
+
+static void RowHistogram(unsigned int (*histo)[256], const unsigned short *p, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        histo[0][p[i] >> 8]++;
+        histo[1][p[i + 1] >> 8]++;
+        histo[2][p[i + 2] >> 8]++;
+        histo[3][p[i + 3] >> 8]++;
+    }
+    for (; i < n; i++)
+        histo[0][p[i] >> 8]++;
+}
+
+// Histogram of the low byte of the pixels in [base, base + 256). The other
+// pixels are counted in an overflow bin so that the loop does not branch on
+// the pixel values.
+struct FineBand
+{
+    unsigned int histo[4][257];
+};
+
+static void RowFineHistogram(unsigned int (*histo)[257], const unsigned short *p, int n, unsigned int base)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        histo[0][std::min(p[i] - base, 256U)]++;
+        histo[1][std::min(p[i + 1] - base, 256U)]++;
+        histo[2][std::min(p[i + 2] - base, 256U)]++;
+        histo[3][std::min(p[i + 3] - base, 256U)]++;
+    }
+    for (; i < n; i++)
+        histo[0][std::min(p[i] - base, 256U)]++;
+}
+
+void DenoiseImageStats(DenoiseStats *stats, const unsigned short *src, int stride, int w, int h)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (w <= 0 || h <= 0)
+        return;
+
+    bool const filter = w >= 2 && h >= 2;
+    int const nbands = WorkerPool::BandCount(h, DENOISE_BAND_ROWS);
+    std::vector<StatsBand> bands(nbands);
+
+    // pass 1: min, max, coarse histogram and median filtered min and max
+    WorkerPool::Run(nbands, [&](int band) {
+        int const y0 = (int) ((long long) h * band / nbands);
+        int const y1 = (int) ((long long) h * (band + 1) / nbands);
+
+        StatsBand& sb = bands[band];
+        sb.minADU = sb.filtMin = 65535;
+        sb.maxADU = sb.filtMax = 0;
+        memset(sb.histo, 0, sizeof(sb.histo));
+
+        std::vector<unsigned short> filtered(filter ? w : 0);
+
+        for (int y = y0; y < y1; y++)
+        {
+            const unsigned short *p = src + (size_t) y * stride;
+            RowMinMax(&sb.minADU, &sb.maxADU, p, w);
+            RowHistogram(sb.histo, p, w);
+
+            if (filter)
+            {
+                DenoiseMedian3Row(&filtered[0], src, stride, w, h, y);
+                RowMinMax(&sb.filtMin, &sb.filtMax, &filtered[0], w);
+            }
+        }
+    });
+
+    unsigned long long coarse[256] = { 0 };
+    stats->minADU = stats->filtMin = 65535;
+    for (const StatsBand& sb : bands)
+    {
+        stats->minADU = std::min(stats->minADU, sb.minADU);
+        stats->maxADU = std::max(stats->maxADU, sb.maxADU);
+        stats->filtMin = std::min(stats->filtMin, sb.filtMin);
+        stats->filtMax = std::max(stats->filtMax, sb.filtMax);
+        for (int k = 0; k < 4; k++)
+            for (int i = 0; i < 256; i++)
+                coarse[i] += sb.histo[k][i];
+    }
+
+    if (!filter)
+    {
+        stats->filtMin = stats->minADU;
+        stats->filtMax = stats->maxADU;
+    }
+
+    // the median is the smallest value v such that more than half of the
+    // pixels are <= v
+    unsigned long long left = (unsigned long long) w * h / 2;
+    int bin = 0;
+    while (coarse[bin] <= left)
+        left -= coarse[bin++];
+
+    // pass 2: exact median within the bin
+    std::vector<FineBand> fine(nbands);
+    WorkerPool::Run(nbands, [&](int band) {
+        int const y0 = (int) ((long long) h * band / nbands);
+        int const y1 = (int) ((long long) h * (band + 1) / nbands);
+
+        memset(fine[band].histo, 0, sizeof(fine[band].histo));
+        for (int y = y0; y < y1; y++)
+            RowFineHistogram(fine[band].histo, src + (size_t) y * stride, w, bin << 8);
+    });
+
+    int lsb = 0;
+    for (;; lsb++)
+    {
+        unsigned long long cnt = 0;
+        for (const FineBand& fb : fine)
+            cnt += fb.histo[0][lsb] + fb.histo[1][lsb] + fb.histo[2][lsb] + fb.histo[3][lsb];
+        if (cnt > left)
+            break;
+        left -= cnt;
+    }
+
+    stats->medianADU = (unsigned short) (bin << 8 | lsb);
+}
+
+static inline void Swap(unsigned short& a, unsigned short& b)
+{
+    unsigned short const t = a;
+    a = b;
+    b = t;
+}
+
+static inline unsigned short MedianOf8(const unsigned short l[8])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3], l4 = l[4];
+    unsigned short x;
+
+    x = l[5];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+    x = l[6];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+    x = l[7];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    if (x < l3)
+        Swap(x, l3);
+    if (x < l4)
+        Swap(x, l4);
+
+    if (l2 > l0)
+        Swap(l2, l0);
+    if (l2 > l1)
+        Swap(l2, l1);
+
+    if (l3 > l0)
+        Swap(l3, l0);
+    if (l3 > l1)
+        Swap(l3, l1);
+
+    if (l4 > l0)
+        Swap(l4, l0);
+    if (l4 > l1)
+        Swap(l4, l1);
+
+    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
+}
+
+static inline unsigned short MedianOf5(const unsigned short l[5])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
+    unsigned short x;
+    x = l[3];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+    x = l[4];
+    if (x < l0)
+        Swap(x, l0);
+    if (x < l1)
+        Swap(x, l1);
+    if (x < l2)
+        Swap(x, l2);
+
+    if (l1 > l0)
+        l0 = l1;
+    if (l2 > l0)
+        l0 = l2;
+
+    return l0;
+}
+
+static inline unsigned short MedianOf3(const unsigned short l[3])
+{
+    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
+    if (l2 < l0)
+        Swap(l2, l0);
+    if (l2 < l1)
+        Swap(l2, l1);
+    if (l1 > l0)
+        l0 = l1;
+    return l0;
+}
+
+// defect map correction: the median of the pixels bordering (x, y)
+unsigned short DenoiseDefectPixel(const unsigned short *img, int xsize, int ysize, int x, int y)
+{
+    unsigned short array[8];
+
+    if (x > 0 && y > 0 && x < xsize - 1 && y < ysize - 1)
+    {
+        array[0] = img[(x - 1) + (y - 1) * xsize];
+        array[1] = img[(x) + (y - 1) * xsize];
+        array[2] = img[(x + 1) + (y - 1) * xsize];
+        array[3] = img[(x - 1) + (y) * xsize];
+        array[4] = img[(x + 1) + (y) * xsize];
+        array[5] = img[(x - 1) + (y + 1) * xsize];
+        array[6] = img[(x) + (y + 1) * xsize];
+        array[7] = img[(x + 1) + (y + 1) * xsize];
+        return MedianOf8(array);
+    }
+
+    if (x == 0 && y > 0 && y < ysize - 1)
+    {
+        // On left edge
+        array[0] = img[(x) + (y - 1) * xsize];
+        array[1] = img[(x) + (y + 1) * xsize];
+        array[2] = img[(x + 1) + (y - 1) * xsize];
+        array[3] = img[(x + 1) + (y) * xsize];
+        array[4] = img[(x + 1) + (y + 1) * xsize];
+        return MedianOf5(array);
+    }
+
+    if (x == xsize - 1 && y > 0 && y < ysize - 1)
+    {
+        // On right edge
+        array[0] = img[(x) + (y - 1) * xsize];
+        array[1] = img[(x) + (y + 1) * xsize];
+        array[2] = img[(x - 1) + (y - 1) * xsize];
+        array[3] = img[(x - 1) + (y) * xsize];
+        array[4] = img[(x - 1) + (y + 1) * xsize];
+        return MedianOf5(array);
+    }
+
+    if (y == 0 && x > 0 && x < xsize - 1)
+    {
+        // On bottom edge
+        array[0] = img[(x - 1) + (y) * xsize];
+        array[1] = img[(x - 1) + (y + 1) * xsize];
+        array[2] = img[(x) + (y + 1) * xsize];
+        array[3] = img[(x + 1) + (y) * xsize];
+        array[4] = img[(x + 1) + (y + 1) * xsize];
+        return MedianOf5(array);
+    }
+
+    if (y == ysize - 1 && x > 0 && x < xsize - 1)
+    {
+        // On top edge
+        array[0] = img[(x - 1) + (y) * xsize];
+        array[1] = img[(x - 1) + (y - 1) * xsize];
+        array[2] = img[(x) + (y - 1) * xsize];
+        array[3] = img[(x + 1) + (y) * xsize];
+        array[4] = img[(x + 1) + (y - 1) * xsize];
+        return MedianOf5(array);
+    }
+
+    if (x == 0 && y == 0)
+    {
+        // At lower left corner
+        array[0] = img[(x + 1) + (y) * xsize];
+        array[1] = img[(x) + (y + 1) * xsize];
+        array[2] = img[(x + 1) + (y + 1) * xsize];
+    }
+    else if (x == 0 && y == ysize - 1)
+    {
+        // At upper left corner
+        array[0] = img[(x + 1) + (y) * xsize];
+        array[1] = img[(x) + (y - 1) * xsize];
+        array[2] = img[(x + 1) + (y - 1) * xsize];
+    }
+    else if (x == xsize - 1 && y == ysize - 1)
+    {
+        // At upper right corner
+        array[0] = img[(x - 1) + (y) * xsize];
+        array[1] = img[(x) + (y - 1) * xsize];
+        array[2] = img[(x - 1) + (y - 1) * xsize];
+    }
+    else if (x == xsize - 1 && y == 0)
+    {
+        // At lower right corner
+        array[0] = img[(x - 1) + (y) * xsize];
+        array[1] = img[(x) + (y + 1) * xsize];
+        array[2] = img[(x - 1) + (y + 1) * xsize];
+    }
+    else
+    {
+        // unreachable
+        return 0;
+    }
+
+    return MedianOf3(array);
+}
@@ -0,0 +1,82 @@
+/*
+ *  denoise_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef DENOISE_KERNELS_INCLUDED
+#define DENOISE_KERNELS_INCLUDED
+
+// Noise reduction filters and the frame statistics that are built on them.
+// The vectorized versions are selected at run time (see simd.h) and give the
+// same results as the scalar code.
+//
+// Images are passed as a pointer to the top-left pixel of a w x h rect and
+// the row stride of the underlying buffer in pixels.
+
+// Row y of the 3x3 median filter of a w x h rect (w, h >= 2). Pixels on the
+// border use the median of their 4 or 6 neighbors within the rect, rounded
+// down, the same as Median3() in image_math.cpp.
+void DenoiseMedian3Row(unsigned short *dst, const unsigned short *src, int stride, int w, int h, int y);
+
+// 3x3 median filter of a w x h rect into a rect of the same size in dst,
+// split into row bands on the worker pool. Rects narrower or shorter than
+// 2 pixels are copied unchanged.
+void DenoiseMedian3(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h);
+
+// Luminance of a one-shot color frame from a sliding 2x2 mean: each pixel
+// becomes the mean of itself and its right, lower and lower-right neighbors,
+// rounded down. The last column and row average the neighbors that exist.
+// Split into row bands on the worker pool.
+void DenoiseLRecon(unsigned short *dst, int dst_stride, const unsigned short *src, int src_stride, int w, int h);
+
+struct DenoiseStats
+{
+    unsigned short minADU;
+    unsigned short maxADU;
+    unsigned short medianADU;
+    // min and max of the 3x3 median filtered image
+    unsigned short filtMin;
+    unsigned short filtMax;
+};
+
+// Statistics of a w x h rect computed without a temporary copy of the image:
+// the min, max and histogram are gathered in the same pass over the rows as
+// the median filtered min and max, and the exact median is resolved with a
+// second pass over the pixels in the median's histogram bin. Rects smaller
+// than 2 x 2 report the unfiltered min and max for the filtered values.
+void DenoiseImageStats(DenoiseStats *stats, const unsigned short *src, int stride, int w, int h);
+
+// Replacement value for a defective pixel at (x, y) of a w x h image: the
+// median of the 8 pixels around it, or of the 5 or 3 that exist on the
+// border of the image.
+unsigned short DenoiseDefectPixel(const unsigned short *img, int w, int h, int x, int y);
+
+#endif // DENOISE_KERNELS_INCLUDED
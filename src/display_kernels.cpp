@@ -0,0 +1,142 @@
+/*
+ *  display_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "display_kernels.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+// minimum number of display rows in a band of work handed to the worker pool
+enum
+{
+    DISPLAY_BAND_ROWS = 16
+};
+
+void DisplayBuildLut(unsigned char *lut, int blevel, int wlevel, double power)
+{
+    blevel = std::min(std::max(blevel, 0), DISPLAY_LUT_SIZE - 1);
+    wlevel = std::min(std::max(wlevel, 0), DISPLAY_LUT_SIZE - 1);
+
+    for (int i = 0; i <= blevel; ++i)
+        lut[i] = 0;
+
+    float range = wlevel - blevel;
+    for (int i = blevel + 1; i < wlevel; ++i)
+    {
+        float d = (i - blevel) / range;
+        lut[i] = pow(d, (float) power) * 255.0;
+    }
+
+    for (int i = wlevel; i < DISPLAY_LUT_SIZE; ++i)
+        lut[i] = 255;
+}
+
+// The source pixels covered by display pixel d are [Start(d), End(d)). The
+// blocks tile the source exactly; when enlarging, each block is a single
+// pixel.
+static inline int BlockStart(int d, int dn, int sn)
+{
+    return (int) ((long long) d * sn / dn);
+}
+
+static inline int BlockEnd(int d, int dn, int sn)
+{
+    return std::max(BlockStart(d, dn, sn) + 1, BlockStart(d + 1, dn, sn));
+}
+
+void DisplayRender(unsigned char *rgb, int dw, int dh, const unsigned short *src, int sw, int sh, const unsigned char *lut,
+                   int x0, int y0, int x1, int y1)
+{
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    std::vector<int> xs(x1 - x0 + 1);
+    for (int x = x0; x < x1; x++)
+        xs[x - x0] = BlockStart(x, dw, sw);
+    xs[x1 - x0] = BlockEnd(x1 - 1, dw, sw);
+
+    int const sx0 = xs[0];
+    int const sx1 = xs[x1 - x0];
+
+    WorkerPool::RunRows(y0, y1, DISPLAY_BAND_ROWS, [&](int by0, int by1) {
+        // column sums of the source rows covered by a display row
+        std::vector<unsigned int> colsum(sx1 - sx0);
+
+        for (int y = by0; y < by1; y++)
+        {
+            int const ys = BlockStart(y, dh, sh);
+            int const ye = BlockEnd(y, dh, sh);
+
+            const unsigned short *s = src + (size_t) ys * sw + sx0;
+            for (int i = 0; i < sx1 - sx0; i++)
+                colsum[i] = s[i];
+            for (int sy = ys + 1; sy < ye; sy++)
+            {
+                s += sw;
+                for (int i = 0; i < sx1 - sx0; i++)
+                    colsum[i] += s[i];
+            }
+
+            unsigned char *d = rgb + ((size_t) y * dw + x0) * 3;
+            for (int x = x0; x < x1; x++)
+            {
+                // xs[] holds the block starts; the last block ends at sx1
+                int const bs = xs[x - x0];
+                int const be = x + 1 < x1 ? std::max(bs + 1, xs[x + 1 - x0]) : sx1;
+
+                unsigned long long sum = 0;
+                for (int i = bs; i < be; i++)
+                    sum += colsum[i - sx0];
+                unsigned int const n = (unsigned int) (be - bs) * (unsigned int) (ye - ys);
+
+                unsigned char const v = lut[sum / n];
+                *d++ = v;
+                *d++ = v;
+                *d++ = v;
+            }
+        }
+    });
+}
+
+void DisplayDirtyRect(int *x0, int *y0, int *x1, int *y1, int dw, int dh, int sw, int sh, int sx0, int sy0, int sx1,
+                      int sy1)
+{
+    // display pixel d covers source pixels [d * sn / dn, (d + 1) * sn / dn), so
+    // the first one reaching past s0 is s0 * dn / sn, give or take one
+    *x0 = std::max(0, (int) ((long long) sx0 * dw / sw) - 1);
+    *y0 = std::max(0, (int) ((long long) sy0 * dh / sh) - 1);
+    *x1 = std::min(dw, (int) (((long long) sx1 * dw + sw - 1) / sw) + 1);
+    *y1 = std::min(dh, (int) (((long long) sy1 * dh + sh - 1) / sh) + 1);
+}
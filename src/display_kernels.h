@@ -0,0 +1,64 @@
+/*
+ *  display_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef DISPLAY_KERNELS_INCLUDED
+#define DISPLAY_KERNELS_INCLUDED
+
+// Conversion of a 16-bit frame to the 8-bit RGB image shown in the guider
+// window.
+
+enum
+{
+    DISPLAY_LUT_SIZE = 0x10000
+};
+
+// Stretch table mapping each 16-bit pixel value to a display value: 0 up to
+// blevel, 255 from wlevel on and a power-law curve in between
+void DisplayBuildLut(unsigned char *lut, int blevel, int wlevel, double power);
+
+// Render the rect [x0, x1) x [y0, y1) of a dw x dh RGB display image (3 bytes
+// per pixel, no row padding) from a sw x sh 16-bit image. When the display
+// image is smaller than the source, each display pixel is the mean of the
+// block of source pixels it covers; otherwise it is the nearest source pixel.
+// The value is then mapped through the lut. The rows are split into bands on
+// the worker pool.
+void DisplayRender(unsigned char *rgb, int dw, int dh, const unsigned short *src, int sw, int sh, const unsigned char *lut,
+                   int x0, int y0, int x1, int y1);
+
+// Display rect [*x0, *x1) x [*y0, *y1) covering the source rect [sx0, sx1) x
+// [sy0, sy1), i.e. the part of the display that must be rendered again when
+// those source pixels change
+void DisplayDirtyRect(int *x0, int *y0, int *x1, int *y1, int dw, int dh, int sw, int sh, int sx0, int sy0, int sx1,
+                      int sy1);
+
+#endif // DISPLAY_KERNELS_INCLUDED
@@ -0,0 +1,97 @@
+/*
+ *  event_queue.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "event_queue.h"
+
+#include <string.h>
+
+MsgClass EventMsgClass(const char *event)
+{
+    if (strcmp(event, "GuideStep") == 0)
+        return MSG_GUIDE_STEP;
+    if (strcmp(event, "LoopingExposures") == 0)
+        return MSG_LOOPING;
+    if (strcmp(event, "Settling") == 0)
+        return MSG_SETTLING;
+    return MSG_RELIABLE;
+}
+
+void EventQueue::Push(const std::string& buf, MsgClass cls)
+{
+    msgs.push_back(OutMsg(buf, cls));
+    queued += buf.size();
+}
+
+void EventQueue::Pop()
+{
+    queued -= msgs.front().data.size();
+    msgs.pop_front();
+    sent = 0;
+}
+
+void EventQueue::Clear()
+{
+    msgs.clear();
+    queued = 0;
+    sent = 0;
+}
+
+EventQueue::AddResult EventQueue::Add(const std::string& buf, MsgClass cls, size_t highWater, size_t hardLimit)
+{
+    if (cls != MSG_RELIABLE)
+    {
+        // replace an older event of the same kind that has not been started
+        for (std::deque<OutMsg>::iterator it = msgs.begin() + (sent ? 1 : 0); it != msgs.end(); ++it)
+        {
+            if (it->cls == cls)
+            {
+                queued -= it->data.size();
+                msgs.erase(it);
+                ++dropped;
+                break;
+            }
+        }
+
+        if (queued + buf.size() > highWater)
+        {
+            ++dropped;
+            return ADD_DROPPED;
+        }
+    }
+
+    if (queued + buf.size() > hardLimit)
+        return ADD_OVERFLOW;
+
+    Push(buf, cls);
+    return ADD_QUEUED;
+}
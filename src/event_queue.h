@@ -0,0 +1,96 @@
+/*
+ *  event_queue.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef EVENT_QUEUE_INCLUDED
+#define EVENT_QUEUE_INCLUDED
+
+#include <deque>
+#include <stddef.h>
+#include <string>
+
+// Output queue of an event server client.
+//
+// Frame rate events are the only messages that may be lost: when a client
+// falls behind, a queued event of the same kind is replaced by the newer one,
+// and once the queue is above the high-water mark new ones are dropped. Other
+// messages are never dropped; a queue that would pass the hard limit
+// overflows instead and the client is disconnected.
+
+enum MsgClass
+{
+    MSG_RELIABLE, // never dropped
+    MSG_GUIDE_STEP,
+    MSG_LOOPING,
+    MSG_SETTLING,
+};
+
+// The class of the named event
+MsgClass EventMsgClass(const char *event);
+
+struct OutMsg
+{
+    std::string data;
+    MsgClass cls;
+    OutMsg(const std::string& data_, MsgClass cls_) : data(data_), cls(cls_) { }
+};
+
+struct EventQueue
+{
+    enum AddResult
+    {
+        ADD_QUEUED,
+        ADD_DROPPED,
+        ADD_OVERFLOW, // nothing was queued, the client must be disconnected
+    };
+
+    std::deque<OutMsg> msgs;
+    size_t sent; // bytes of the first message already written
+    size_t queued; // bytes queued
+    unsigned int dropped; // events not sent since the last drop report
+
+    EventQueue() : sent(0), queued(0), dropped(0) { }
+
+    bool empty() const { return msgs.empty(); }
+
+    // append a message unconditionally
+    void Push(const std::string& buf, MsgClass cls);
+    // remove the first message once it has been written
+    void Pop();
+    void Clear();
+
+    // Queue a message behind the messages already waiting, replacing or dropping
+    // frame rate events when the client has fallen behind
+    AddResult Add(const std::string& buf, MsgClass cls, size_t highWater, size_t hardLimit);
+};
+
+#endif // EVENT_QUEUE_INCLUDED
@@ -34,8 +34,13 @@
 
 #include "phd.h"
 
+#include "event_queue.h"
+#include "json_writer.h"
+
 #include <wx/sstream.h>
 #include <wx/sckstrm.h>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string.h>
 
@@ -45,6 +50,8 @@ EventServer EvtServer;
 wxBEGIN_EVENT_TABLE(EventServer, wxEvtHandler)
     EVT_SOCKET(EVENT_SERVER_ID, EventServer::OnEventServerEvent)
     EVT_SOCKET(EVENT_SERVER_CLIENT_ID, EventServer::OnEventServerClientEvent)
+    EVT_SOCKET(FRAME_SERVER_ID, EventServer::OnFrameServerEvent)
+    EVT_SOCKET(FRAME_SERVER_CLIENT_ID, EventServer::OnFrameServerClientEvent)
 wxEND_EVENT_TABLE();
 // clang-format on
 
@@ -53,10 +60,6 @@ enum
     MSG_PROTOCOL_VERSION = 1,
 };
 
-static const wxString literal_null("null");
-static const wxString literal_true("true");
-static const wxString literal_false("false");
-
 static wxString state_name(EXPOSED_STATE st)
 {
     switch (st)
@@ -80,169 +83,218 @@ static wxString state_name(EXPOSED_STATE st)
     }
 }
 
-static wxString json_escape(const wxString& s)
-{
-    wxString t(s);
-    static const wxString BACKSLASH("\\");
-    static const wxString BACKSLASHBACKSLASH("\\\\");
-    static const wxString DQUOT("\"");
-    static const wxString BACKSLASHDQUOT("\\\"");
-    static const wxString CR("\r");
-    static const wxString BACKSLASHCR("\\r");
-    static const wxString LF("\n");
-    static const wxString BACKSLASHLF("\\n");
-    t.Replace(BACKSLASH, BACKSLASHBACKSLASH);
-    t.Replace(DQUOT, BACKSLASHDQUOT);
-    t.Replace(CR, BACKSLASHCR);
-    t.Replace(LF, BACKSLASHLF);
-    return t;
-}
-
-template<char LDELIM, char RDELIM>
-struct JSeq
-{
-    wxString m_s;
-    bool m_first;
-    bool m_closed;
-    JSeq() : m_first(true), m_closed(false) { m_s << LDELIM; }
-    void close()
-    {
-        m_s << RDELIM;
-        m_closed = true;
-    }
-    wxString str()
-    {
-        if (!m_closed)
-            close();
-        return m_s;
-    }
-};
-
-typedef JSeq<'[', ']'> JAry;
-typedef JSeq<'{', '}'> JObj;
-
-static JAry& operator<<(JAry& a, const wxString& str)
-{
-    if (a.m_first)
-        a.m_first = false;
-    else
-        a.m_s << ',';
-    a.m_s << str;
-    return a;
-}
-
-static JAry& operator<<(JAry& a, double d)
-{
-    return a << wxString::Format("%.2f", d);
-}
+// The JSON text of events and responses is built as UTF-8 in a JsonWriter
+// buffer, so a message is encoded once and the same bytes are written to
+// every client.
 
-static JAry& operator<<(JAry& a, int i)
+static std::string json_string(const wxString& s)
 {
-    return a << wxString::Format("%d", i);
+    std::string ret;
+    wxScopedCharBuffer utf8(s.utf8_str());
+    JsonAppendString(ret, utf8.data(), utf8.length());
+    return ret;
 }
 
-static wxString json_format(const json_value *j)
+static void json_format(std::string& out, const json_value *j)
 {
     if (!j)
-        return literal_null;
+    {
+        out += "null";
+        return;
+    }
 
     switch (j->type)
     {
     default:
     case JSON_NULL:
-        return literal_null;
+        out += "null";
+        break;
     case JSON_OBJECT:
     {
-        wxString ret("{");
+        out += '{';
         bool first = true;
         json_for_each(jj, j)
         {
             if (first)
                 first = false;
             else
-                ret << ",";
-            ret << '"' << jj->name << "\":" << json_format(jj);
+                out += ',';
+            JsonAppendString(out, jj->name);
+            out += ':';
+            json_format(out, jj);
         }
-        ret << "}";
-        return ret;
+        out += '}';
+        break;
     }
     case JSON_ARRAY:
     {
-        wxString ret("[");
+        out += '[';
         bool first = true;
         json_for_each(jj, j)
         {
             if (first)
                 first = false;
             else
-                ret << ",";
-            ret << json_format(jj);
+                out += ',';
+            json_format(out, jj);
         }
-        ret << "]";
-        return ret;
+        out += ']';
+        break;
     }
     case JSON_STRING:
-        return '"' + json_escape(j->string_value) + '"';
+        JsonAppendString(out, j->string_value);
+        break;
     case JSON_INT:
-        return wxString::Format("%d", j->int_value);
+        JsonAppendInt(out, j->int_value);
+        break;
     case JSON_FLOAT:
-        return wxString::Format("%g", (double) j->float_value);
+        JsonAppendDouble(out, (double) j->float_value);
+        break;
     case JSON_BOOL:
-        return j->int_value ? literal_true : literal_false;
+        out += j->int_value ? "true" : "false";
+        break;
     }
 }
 
+static wxString json_format(const json_value *j)
+{
+    std::string s;
+    json_format(s, j);
+    return wxString::FromUTF8(s.data(), s.size());
+}
+
+template<char LDELIM, char RDELIM>
+struct JSeq
+{
+    JsonWriter m_w;
+    bool m_closed;
+    JSeq() : m_closed(false)
+    {
+        if (LDELIM == '{')
+            m_w.BeginObject();
+        else
+            m_w.BeginArray();
+    }
+    void close()
+    {
+        if (RDELIM == '}')
+            m_w.EndObject();
+        else
+            m_w.EndArray();
+        m_closed = true;
+    }
+    const std::string& str()
+    {
+        if (!m_closed)
+            close();
+        return m_w.Str();
+    }
+    // the sequence terminated as a protocol message; nothing can be added afterwards
+    const std::string& line()
+    {
+        str();
+        m_w.EndLine();
+        return m_w.Str();
+    }
+};
+
+typedef JSeq<'[', ']'> JAry;
+typedef JSeq<'{', '}'> JObj;
+
+// a value that is already JSON text
+static JAry& operator<<(JAry& a, const std::string& json)
+{
+    a.m_w.Raw(json);
+    return a;
+}
+
+static JAry& operator<<(JAry& a, double d)
+{
+    a.m_w.Fixed(d, 2);
+    return a;
+}
+
+static JAry& operator<<(JAry& a, int i)
+{
+    a.m_w.Int(i);
+    return a;
+}
+
 struct NULL_TYPE
 {
 } NULL_VALUE;
 
-// name-value pair
+// Name of a name-value pair. Names are nearly always string literals, which
+// are used without copying.
+struct JName
+{
+    const char *lit;
+    std::string buf;
+    JName(const char *s) : lit(s) { }
+    JName(const wxString& s) : lit(nullptr), buf(s.utf8_str().data()) { }
+    const char *c_str() const { return lit ? lit : buf.c_str(); }
+};
+
+// name-value pair; the value is kept as JSON text
 struct NV
 {
-    wxString n;
-    wxString v;
-    NV(const wxString& n_, const wxString& v_) : n(n_), v('"' + json_escape(v_) + '"') { }
-    NV(const wxString& n_, const char *v_) : n(n_), v('"' + json_escape(v_) + '"') { }
-    NV(const wxString& n_, const wchar_t *v_) : n(n_), v('"' + json_escape(v_) + '"') { }
-    NV(const wxString& n_, int v_) : n(n_), v(wxString::Format("%d", v_)) { }
-    NV(const wxString& n_, unsigned int v_) : n(n_), v(wxString::Format("%u", v_)) { }
-    NV(const wxString& n_, double v_) : n(n_), v(wxString::Format("%g", v_)) { }
-    NV(const wxString& n_, double v_, int prec) : n(n_), v(wxString::Format("%.*f", prec, v_)) { }
-    NV(const wxString& n_, bool v_) : n(n_), v(v_ ? literal_true : literal_false) { }
+    JName n;
+    std::string v;
+    NV(const JName& n_, const wxString& v_) : n(n_), v(json_string(v_)) { }
+    NV(const JName& n_, const std::string& v_) : n(n_) { JsonAppendString(v, v_.data(), v_.size()); }
+    NV(const JName& n_, const char *v_) : n(n_) { JsonAppendString(v, v_); }
+    NV(const JName& n_, const wchar_t *v_) : n(n_), v(json_string(v_)) { }
+    NV(const JName& n_, int v_) : n(n_) { JsonAppendInt(v, v_); }
+    NV(const JName& n_, unsigned int v_) : n(n_) { JsonAppendUInt(v, v_); }
+    NV(const JName& n_, double v_) : n(n_) { JsonAppendDouble(v, v_); }
+    NV(const JName& n_, double v_, int prec) : n(n_) { JsonAppendFixed(v, v_, prec); }
+    NV(const JName& n_, bool v_) : n(n_), v(v_ ? "true" : "false") { }
     template<typename T>
-    NV(const wxString& n_, const std::vector<T>& vec);
-    NV(const wxString& n_, JAry& ary) : n(n_), v(ary.str()) { }
-    NV(const wxString& n_, JObj& obj) : n(n_), v(obj.str()) { }
-    NV(const wxString& n_, const json_value *v_) : n(n_), v(json_format(v_)) { }
-    NV(const wxString& n_, const PHD_Point& p) : n(n_)
+    NV(const JName& n_, const std::vector<T>& vec);
+    NV(const JName& n_, JAry& ary) : n(n_), v(ary.str()) { }
+    NV(const JName& n_, JObj& obj) : n(n_), v(obj.str()) { }
+    NV(const JName& n_, const json_value *v_) : n(n_) { json_format(v, v_); }
+    NV(const JName& n_, const PHD_Point& p) : n(n_)
     {
-        JAry ary;
-        ary << p.X << p.Y;
-        v = ary.str();
+        v += '[';
+        JsonAppendFixed(v, p.X, 2);
+        v += ',';
+        JsonAppendFixed(v, p.Y, 2);
+        v += ']';
     }
-    NV(const wxString& n_, const wxPoint& p) : n(n_)
+    NV(const JName& n_, const wxPoint& p) : n(n_)
     {
-        JAry ary;
-        ary << p.x << p.y;
-        v = ary.str();
+        int a[] = { p.x, p.y };
+        ints(a, 2);
     }
-    NV(const wxString& n_, const wxSize& s) : n(n_)
+    NV(const JName& n_, const wxSize& s) : n(n_)
     {
-        JAry ary;
-        ary << s.x << s.y;
-        v = ary.str();
+        int a[] = { s.x, s.y };
+        ints(a, 2);
     }
-    NV(const wxString& n_, const wxRect& r) : n(n_)
+    NV(const JName& n_, const wxRect& r) : n(n_)
     {
-        JAry ary;
-        ary << r.x << r.y << r.width << r.height;
-        v = ary.str();
+        int a[] = { r.x, r.y, r.width, r.height };
+        ints(a, 4);
+    }
+    NV(const JName& n_, const NULL_TYPE& nul) : n(n_), v("null") { }
+
+private:
+    void ints(const int *a, int cnt)
+    {
+        v += '[';
+        for (int i = 0; i < cnt; i++)
+        {
+            if (i != 0)
+                v += ',';
+            JsonAppendInt(v, a[i]);
+        }
+        v += ']';
     }
-    NV(const wxString& n_, const NULL_TYPE& nul) : n(n_), v(literal_null) { }
 };
 
 template<typename T>
-NV::NV(const wxString& n_, const std::vector<T>& vec) : n(n_)
+NV::NV(const JName& n_, const std::vector<T>& vec) : n(n_)
 {
     std::ostringstream os;
     os << '[';
@@ -258,11 +310,7 @@ NV::NV(const wxString& n_, const std::vector<T>& vec) : n(n_)
 
 static JObj& operator<<(JObj& j, const NV& nv)
 {
-    if (j.m_first)
-        j.m_first = false;
-    else
-        j.m_s << ',';
-    j.m_s << '"' << nv.n << "\":" << nv.v;
+    j.m_w.Key(nv.n.c_str()).Raw(nv.v);
     return j;
 }
 
@@ -281,13 +329,24 @@ static JAry& operator<<(JAry& a, JObj& j)
     return a << j.str();
 }
 
+// the host name does not change, so its JSON text is only built once
+static const std::string& host_json()
+{
+    static const std::string s(json_string(wxGetHostName()));
+    return s;
+}
+
 struct Ev : public JObj
 {
-    Ev(const wxString& event)
+    const char *m_name;
+
+    Ev(const char *event) : m_name(event)
     {
+        m_w.Reserve(512);
         double const now = ::wxGetUTCTimeMillis().ToDouble() / 1000.0;
-        *this << NV("Event", event) << NV("Timestamp", now, 3) << NV("Host", wxGetHostName())
-              << NV("Inst", wxGetApp().GetInstanceNumber());
+        *this << NV("Event", event) << NV("Timestamp", now, 3);
+        m_w.Key("Host").Raw(host_json());
+        *this << NV("Inst", wxGetApp().GetInstanceNumber());
     }
 };
 
@@ -393,14 +452,95 @@ struct ClientReadBuf
     void reset() { dest = &m_buf[0]; }
 };
 
+// Outgoing messages are written without blocking. Whatever a client cannot take right
+// away is queued (see EventQueue) and written when the socket signals wxSOCKET_OUTPUT,
+// so a slow client never stalls the guide loop. Messages are sent in order. The client
+// is told how many events it missed when its queue has drained, and a client that stops
+// reading entirely is disconnected once its queue passes a hard limit.
+
+enum
+{
+    DEFAULT_CLIENT_QUEUE_LIMIT_KB = 256,
+    CLIENT_QUEUE_HARD_LIMIT_FACTOR = 16, // hard limit as a multiple of the high-water mark
+};
+
+static size_t s_clientQueueLimit = DEFAULT_CLIENT_QUEUE_LIMIT_KB * 1024; // high-water mark in bytes
+
+// Events a client receives. Clients get every event until they subscribe to named
+// events, and from then on only the events they subscribed to. Subscribing to "*"
+// brings back all events. A subscription can pass on only every Nth event or at most
+// one event per interval, counted separately for each kind of event.
+
+struct EventSub
+{
+    bool on;
+    unsigned int every; // send every Nth event
+    double interval; // minimum seconds between events
+    unsigned int count;
+    double lastSent;
+
+    EventSub() : on(true), every(1), interval(0.0), count(0), lastSent(0.0) { }
+};
+
+struct EventFilter
+{
+    bool all; // events not in subs are sent
+    bool subscribed; // the client has used the subscribe method
+    EventSub allSub; // decimation of the events not in subs
+    std::map<std::string, EventSub> subs;
+
+    EventFilter() : all(true), subscribed(false) { }
+
+    bool Wants(const char *name) const
+    {
+        std::map<std::string, EventSub>::const_iterator it = subs.find(name);
+        return it == subs.end() ? all : it->second.on;
+    }
+
+    // whether the next event of this kind is sent, applying decimation
+    bool Pass(const char *name, double now)
+    {
+        std::map<std::string, EventSub>::iterator it = subs.find(name);
+        if (it == subs.end())
+        {
+            if (!all)
+                return false;
+            if (allSub.every <= 1 && allSub.interval <= 0.0)
+                return true;
+            // start counting this kind of event
+            it = subs.insert(std::make_pair(std::string(name), allSub)).first;
+        }
+
+        EventSub& sub = it->second;
+        if (!sub.on)
+            return false;
+        if (sub.every > 1 && sub.count++ % sub.every != 0)
+            return false;
+        if (sub.interval > 0.0)
+        {
+            if (now - sub.lastSent < sub.interval)
+                return false;
+            sub.lastSent = now;
+        }
+        return true;
+    }
+};
+
 struct ClientData
 {
     wxSocketClient *cli;
     int refcnt;
     ClientReadBuf rdbuf;
     wxMutex wrlock;
+    EventQueue outq;
+    unsigned int totalDropped;
+    bool overflowed; // queue passed the hard limit, client is being disconnected
+    EventFilter filter;
 
-    ClientData(wxSocketClient *cli_) : cli(cli_), refcnt(1) { }
+    ClientData(wxSocketClient *cli_)
+        : cli(cli_), refcnt(1), totalDropped(0), overflowed(false)
+    {
+    }
     void AddRef() { ++refcnt; }
     void RemoveRef()
     {
@@ -420,11 +560,6 @@ struct ClientDataGuard
     ClientData *operator->() const { return cd; }
 };
 
-inline static wxMutex *client_wrlock(wxSocketClient *cli)
-{
-    return &((ClientData *) cli->GetClientData())->wrlock;
-}
-
 static wxString SockErrStr(wxSocketError e)
 {
     switch (e)
@@ -454,45 +589,140 @@ static wxString SockErrStr(wxSocketError e)
     }
 }
 
-static void send_buf(wxSocketClient *client, const wxCharBuffer& buf)
+static size_t write_nowait(wxSocketClient *client, const char *buf, size_t len)
+{
+    client->Write(buf, len);
+    size_t const n = client->LastWriteCount();
+    if (n < len && client->Error() && client->LastError() != wxSOCKET_WOULDBLOCK)
+        Debug.Write(wxString::Format("evsrv: cli %p write error %s\n", client, SockErrStr(client->LastError())));
+    return n;
+}
+
+// Discard the queue of a client that is not reading and have the main thread disconnect
+// it. The extra reference keeps the client alive until then.
+static void drop_overflowed_client(ClientData *cd)
+{
+    Debug.Write(wxString::Format("evsrv: cli %p output queue over %u KB, disconnecting\n", cd->cli,
+                                 (unsigned int) (cd->outq.queued / 1024)));
+
+    cd->overflowed = true;
+    cd->outq.Clear();
+
+    cd->AddRef();
+    EvtServer.CallAfter(&EventServer::DisconnectClient, cd->cli);
+}
+
+static void send_buf(wxSocketClient *client, const std::string& buf, MsgClass cls = MSG_RELIABLE)
 {
-    wxMutexLocker lock(*client_wrlock(client));
-    client->Write(buf.data(), buf.length());
-    if (client->LastWriteCount() != buf.length())
+    ClientData *cd = (ClientData *) client->GetClientData();
+    wxMutexLocker lock(cd->wrlock);
+
+    if (cd->overflowed)
+        return;
+
+    if (cd->outq.empty())
+    {
+        size_t const n = write_nowait(client, buf.data(), buf.size());
+        if (n == buf.size())
+            return;
+
+        // the rest goes out when the socket is writable again
+        cd->outq.Push(buf, cls);
+        cd->outq.sent = n;
+        return;
+    }
+
+    if (cd->outq.Add(buf, cls, s_clientQueueLimit, s_clientQueueLimit * CLIENT_QUEUE_HARD_LIMIT_FACTOR) ==
+        EventQueue::ADD_OVERFLOW)
+    {
+        drop_overflowed_client(cd);
+    }
+}
+
+// tell the client how many events it missed while it was behind
+static void report_dropped(ClientData *cd)
+{
+    Debug.Write(wxString::Format("evsrv: cli %p dropped %u events\n", cd->cli, cd->outq.dropped));
+
+    Ev ev("EventsDropped");
+    ev << NV("Count", cd->outq.dropped);
+    cd->totalDropped += cd->outq.dropped;
+    cd->outq.dropped = 0;
+
+    const std::string& msg = ev.line();
+    size_t const n = write_nowait(cd->cli, msg.data(), msg.size());
+    if (n < msg.size())
+    {
+        cd->outq.Push(msg, MSG_RELIABLE);
+        cd->outq.sent = n;
+    }
+}
+
+// write queued messages until the socket would block
+static void flush_client(wxSocketClient *client)
+{
+    ClientData *cd = (ClientData *) client->GetClientData();
+    wxMutexLocker lock(cd->wrlock);
+
+    while (!cd->outq.empty())
     {
-        Debug.Write(wxString::Format("evsrv: cli %p short write %u/%u %s\n", client, client->LastWriteCount(),
-                                     (unsigned int) buf.length(),
-                                     SockErrStr(client->Error() ? client->LastError() : wxSOCKET_NOERROR)));
+        const std::string& msg = cd->outq.msgs.front().data;
+        size_t const n = write_nowait(client, msg.data() + cd->outq.sent, msg.size() - cd->outq.sent);
+        cd->outq.sent += n;
+
+        if (cd->outq.sent < msg.size())
+            return;
+
+        cd->outq.Pop();
+
+        if (cd->outq.empty() && cd->outq.dropped)
+            report_dropped(cd);
     }
 }
 
-static void do_notify1(wxSocketClient *client, const JAry& ary)
+// The message is terminated in place, so nothing can be added to it afterwards.
+
+static void do_notify1(wxSocketClient *client, JAry& ary)
 {
-    send_buf(client, (JAry(ary).str() + "\r\n").ToUTF8());
+    send_buf(client, ary.line());
 }
 
-static void do_notify1(wxSocketClient *client, const JObj& j)
+static void do_notify1(wxSocketClient *client, JObj& j)
 {
-    send_buf(client, (JObj(j).str() + "\r\n").ToUTF8());
+    send_buf(client, j.line());
 }
 
-static void do_notify(const EventServer::CliSockSet& cli, const JObj& jj)
+static void do_notify(const EventServer::CliSockSet& cli, Ev& ev)
 {
-    wxCharBuffer buf = (JObj(jj).str() + "\r\n").ToUTF8();
+    MsgClass const cls = EventMsgClass(ev.m_name);
+    double const now = ::wxGetUTCTimeMillis().ToDouble() / 1000.0;
+    const std::string *buf = nullptr;
 
     for (EventServer::CliSockSet::const_iterator it = cli.begin(); it != cli.end(); ++it)
     {
-        send_buf(*it, buf);
+        ClientData *cd = (ClientData *) (*it)->GetClientData();
+        if (!cd->filter.Pass(ev.m_name, now))
+            continue;
+
+        // encoded once, the same bytes go to every client
+        if (!buf)
+            buf = &ev.line();
+        send_buf(*it, *buf, cls);
     }
 }
 
-inline static void simple_notify(const EventServer::CliSockSet& cli, const wxString& ev)
+static void do_notify(const EventServer::CliSockSet& cli, Ev&& ev)
+{
+    do_notify(cli, ev);
+}
+
+inline static void simple_notify(const EventServer::CliSockSet& cli, const char *ev)
 {
     if (!cli.empty())
         do_notify(cli, Ev(ev));
 }
 
-inline static void simple_notify_ev(const EventServer::CliSockSet& cli, const Ev& ev)
+inline static void simple_notify_ev(const EventServer::CliSockSet& cli, Ev&& ev)
 {
     if (!cli.empty())
         do_notify(cli, ev);
@@ -501,49 +731,59 @@ inline static void simple_notify_ev(const EventServer::CliSockSet& cli, const Ev
 #define SIMPLE_NOTIFY(s) simple_notify(m_eventServerClients, s)
 #define SIMPLE_NOTIFY_EV(ev) simple_notify_ev(m_eventServerClients, ev)
 
-static void send_catchup_events(wxSocketClient *cli)
+// send a catch-up event if the client wants it and, after a subscription change, did not want it before
+static void catchup1(wxSocketClient *cli, const EventFilter *prev, Ev&& ev)
+{
+    const EventFilter& filter = ((ClientData *) cli->GetClientData())->filter;
+    if (filter.Wants(ev.m_name) && (!prev || !prev->Wants(ev.m_name)))
+        do_notify1(cli, ev);
+}
+
+static void send_catchup_events(wxSocketClient *cli, const EventFilter *prev = nullptr)
 {
     EXPOSED_STATE st = Guider::GetExposedState();
 
-    do_notify1(cli, ev_message_version());
+    catchup1(cli, prev, ev_message_version());
 
     if (pFrame->pGuider)
     {
         if (pFrame->pGuider->LockPosition().IsValid())
-            do_notify1(cli, ev_set_lock_position(pFrame->pGuider->LockPosition()));
+            catchup1(cli, prev, ev_set_lock_position(pFrame->pGuider->LockPosition()));
 
         if (pFrame->pGuider->CurrentPosition().IsValid())
-            do_notify1(cli, ev_star_selected(pFrame->pGuider->CurrentPosition()));
+            catchup1(cli, prev, ev_star_selected(pFrame->pGuider->CurrentPosition()));
     }
 
     if (pMount && pMount->IsCalibrated())
-        do_notify1(cli, ev_calibration_complete(pMount));
+        catchup1(cli, prev, ev_calibration_complete(pMount));
 
     if (pSecondaryMount && pSecondaryMount->IsCalibrated())
-        do_notify1(cli, ev_calibration_complete(pSecondaryMount));
+        catchup1(cli, prev, ev_calibration_complete(pSecondaryMount));
 
     if (st == EXPOSED_STATE_GUIDING_LOCKED)
     {
-        do_notify1(cli, ev_start_guiding());
+        catchup1(cli, prev, ev_start_guiding());
     }
     else if (st == EXPOSED_STATE_CALIBRATING)
     {
         Mount *mount = pMount;
         if (pFrame->pGuider->GetState() == STATE_CALIBRATING_SECONDARY)
             mount = pSecondaryMount;
-        do_notify1(cli, ev_start_calibration(mount));
+        catchup1(cli, prev, ev_start_calibration(mount));
     }
     else if (st == EXPOSED_STATE_PAUSED)
     {
-        do_notify1(cli, ev_paused());
+        catchup1(cli, prev, ev_paused());
     }
 
-    do_notify1(cli, ev_app_state());
+    catchup1(cli, prev, ev_app_state());
 }
 
 static void destroy_client(wxSocketClient *cli)
 {
     ClientData *buf = (ClientData *) cli->GetClientData();
+    if (buf->totalDropped + buf->outq.dropped)
+        Debug.Write(wxString::Format("evsrv: cli %p events dropped %u\n", cli, buf->totalDropped + buf->outq.dropped));
     buf->RemoveRef();
 }
 
@@ -1374,6 +1614,26 @@ static void set_beep_for_lost_star(JObj& response, const json_value *params)
     response << jrpc_result(enabled);
 }
 
+static void get_headless(JObj& response, const json_value *params)
+{
+    response << jrpc_result(pFrame->IsHeadless());
+}
+
+static void set_headless(JObj& response, const json_value *params)
+{
+    Params p("enabled", params);
+    const json_value *val = p.param("enabled");
+    if (!val || val->type != JSON_BOOL)
+    {
+        response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected enabled boolean param");
+        return;
+    }
+
+    bool enabled = val->int_value != 0;
+    pFrame->SetHeadless(enabled);
+    response << jrpc_result(enabled);
+}
+
 static void get_mass_change_threshold_enabled(JObj& response, const json_value *params)
 {
     VERIFY_GUIDER(response);
@@ -2440,6 +2700,21 @@ static void get_star_image(JObj& response, const json_value *params)
     response << jrpc_result(rslt);
 }
 
+static void get_frame_stream(JObj& response, const json_value *params)
+{
+    unsigned int clients, sent, dropped;
+    EvtServer.GetFrameStreamStats(&clients, &sent, &dropped);
+
+    JObj rslt;
+    if (EvtServer.FrameStreamPort())
+        rslt << NV("port", EvtServer.FrameStreamPort());
+    else
+        rslt << NV("port", NULL_VALUE);
+    rslt << NV("clients", clients) << NV("frames_sent", sent) << NV("frames_dropped", dropped);
+
+    response << jrpc_result(rslt);
+}
+
 static bool parse_settle(SettleParams *settle, const json_value *j, wxString *error)
 {
     bool found_pixels = false, found_time = false, found_timeout = false;
@@ -3109,7 +3384,7 @@ static void get_algo_param_names(JObj& response, const json_value *params)
 
     JAry names;
     for (auto it = ary.begin(); it != ary.end(); ++it)
-        names << ('"' + json_escape(*it) + '"');
+        names << json_string(*it);
 
     response << jrpc_result(names);
 }
@@ -3313,6 +3588,37 @@ static void set_limit_frame(JObj& response, const json_value *params)
         response << jrpc_result(0);
 }
 
+// per-stage guide loop latency statistics in milliseconds, optionally clearing them
+static void get_timing_stats(JObj& response, const json_value *params)
+{
+    Params p("reset", params);
+    const json_value *val = p.param("reset");
+    if (val && val->type != JSON_BOOL)
+    {
+        response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected reset boolean param");
+        return;
+    }
+
+    JObj rslt;
+
+    for (int i = 0; i < GuideTiming::STAGE_COUNT; i++)
+    {
+        GuideTiming::Summary sum;
+        GuideLoopTiming.GetSummary((GuideTiming::Stage) i, &sum);
+
+        JObj stage;
+        stage << NV("count", sum.count) << NV("total", (unsigned int) sum.total) << NV("min", sum.min, 3)
+              << NV("mean", sum.mean, 3) << NV("p50", sum.p50, 3) << NV("p90", sum.p90, 3) << NV("p99", sum.p99, 3)
+              << NV("max", sum.max, 3) << NV("last", sum.last, 3);
+        rslt << NV(GuideTiming::StageName((GuideTiming::Stage) i), stage);
+    }
+
+    if (val && val->int_value)
+        GuideLoopTiming.Reset();
+
+    response << jrpc_result(rslt);
+}
+
 static GUIDE_DIRECTION dir_param(const json_value *p)
 {
     if (!p || p->type != JSON_STRING)
@@ -3579,6 +3885,124 @@ static void export_config_settings(JObj& response, const json_value *params)
     response << jrpc_result(rslt);
 }
 
+// The event names in params, or "*" for all events
+static bool event_names_param(const json_value *jv, std::vector<std::string> *names)
+{
+    if (!jv)
+        return false;
+
+    if (jv->type == JSON_STRING)
+    {
+        names->push_back(jv->string_value);
+        return true;
+    }
+
+    if (jv->type != JSON_ARRAY)
+        return false;
+
+    json_for_each(t, jv)
+    {
+        if (t->type != JSON_STRING)
+            return false;
+        names->push_back(t->string_value);
+    }
+
+    return !names->empty();
+}
+
+static void subscribe(wxSocketClient *cli, JObj& response, const json_value *params)
+{
+    Params p("events", "every", "interval", params);
+
+    std::vector<std::string> names;
+    if (!event_names_param(p.param("events"), &names))
+    {
+        response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected events param");
+        return;
+    }
+
+    EventSub sub;
+
+    const json_value *jv;
+    if ((jv = p.param("every")) != nullptr)
+    {
+        if (jv->type != JSON_INT || jv->int_value < 1)
+        {
+            response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected every param to be a positive integer");
+            return;
+        }
+        sub.every = jv->int_value;
+    }
+    if ((jv = p.param("interval")) != nullptr)
+    {
+        if (!float_param(jv, &sub.interval) || sub.interval < 0.0)
+        {
+            response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected interval param in seconds");
+            return;
+        }
+    }
+
+    ClientData *cd = (ClientData *) cli->GetClientData();
+    EventFilter prev(cd->filter);
+
+    // the first subscription replaces the default of sending everything
+    if (!cd->filter.subscribed)
+    {
+        cd->filter.subscribed = true;
+        cd->filter.all = false;
+    }
+
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        if (*it == "*")
+        {
+            cd->filter.all = true;
+            cd->filter.allSub = sub;
+            cd->filter.subs.clear();
+        }
+        else
+            cd->filter.subs[*it] = sub;
+    }
+
+    Debug.Write(wxString::Format("evsrv: cli %p subscribe %s every %u interval %.1f\n", cli,
+                                 json_format(p.param("events")), sub.every, sub.interval));
+
+    // bring the client up to date on the state reported by the events it just subscribed to
+    send_catchup_events(cli, &prev);
+
+    response << jrpc_result(0);
+}
+
+static void unsubscribe(wxSocketClient *cli, JObj& response, const json_value *params)
+{
+    Params p("events", params);
+
+    std::vector<std::string> names;
+    if (!event_names_param(p.param("events"), &names))
+    {
+        response << jrpc_error(JSONRPC_INVALID_PARAMS, "expected events param");
+        return;
+    }
+
+    ClientData *cd = (ClientData *) cli->GetClientData();
+
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        if (*it == "*")
+        {
+            cd->filter.all = false;
+            cd->filter.allSub = EventSub();
+            cd->filter.subs.clear();
+        }
+        else
+            cd->filter.subs[*it].on = false;
+    }
+
+    Debug.Write(wxString::Format("evsrv: cli %p unsubscribe %s\n", cli, json_format(p.param("events"))));
+
+    response << jrpc_result(0);
+}
+
 struct JRpcCall
 {
     wxSocketClient *cli;
@@ -3596,7 +4020,7 @@ static void dump_request(const JRpcCall& call)
 
 static void dump_response(const JRpcCall& call)
 {
-    wxString s(const_cast<JRpcResponse&>(call.response).str());
+    wxString s(wxString::FromUTF8(const_cast<JRpcResponse&>(call.response).str().c_str()));
 
     // trim output for huge responses
 
@@ -3682,6 +4106,7 @@ static bool handle_request(JRpcCall& call)
         { "set_lock_shift_params", &set_lock_shift_params },
         { "save_image", &save_image },
         { "get_star_image", &get_star_image },
+        { "get_frame_stream", &get_frame_stream },
         { "get_use_subframes", &get_use_subframes },
         { "get_search_region", &get_search_region },
         { "set_search_region", &set_search_region },
@@ -3691,6 +4116,8 @@ static bool handle_request(JRpcCall& call)
         { "set_max_star_hfd", &set_max_star_hfd },
         { "get_beep_for_lost_star", &get_beep_for_lost_star },
         { "set_beep_for_lost_star", &set_beep_for_lost_star },
+        { "get_headless", &get_headless },
+        { "set_headless", &set_headless },
         { "get_mass_change_threshold_enabled", &get_mass_change_threshold_enabled },
         { "set_mass_change_threshold_enabled", &set_mass_change_threshold_enabled },
         { "get_mass_change_threshold", &get_mass_change_threshold },
@@ -3761,8 +4188,36 @@ static bool handle_request(JRpcCall& call)
         { "set_variable_delay_settings", &set_variable_delay_settings },
         { "get_limit_frame", &get_limit_frame },
         { "set_limit_frame", &set_limit_frame },
+        { "get_timing_stats", &get_timing_stats },
+    };
+
+    // methods that apply to the calling client
+    static struct
+    {
+        const char *name;
+        void (*fn)(wxSocketClient *cli, JObj& response, const json_value *params);
+    } client_methods[] = {
+        { "subscribe", &subscribe },
+        { "unsubscribe", &unsubscribe },
     };
 
+    for (unsigned int i = 0; i < WXSIZEOF(client_methods); i++)
+    {
+        if (strcmp(call.method->string_value, client_methods[i].name) == 0)
+        {
+            (*client_methods[i].fn)(call.cli, call.response, params);
+            if (id)
+            {
+                call.response << jrpc_id(id);
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+
     for (unsigned int i = 0; i < WXSIZEOF(methods); i++)
     {
         if (strcmp(call.method->string_value, methods[i].name) == 0)
@@ -3899,7 +4354,219 @@ static void handle_cli_input(wxSocketClient *cli)
     }
 }
 
-EventServer::EventServer() : m_configEventDebouncer(nullptr) { }
+// Binary guide frame stream
+//
+// The frame stream is off unless the /EventServer/FrameStream global setting is enabled.
+// Clients connecting to the frame stream port (event server port + 100) receive each
+// guide frame as a length-prefixed binary message. All integers are little-endian.
+//
+//   uint32   length of the rest of the message
+//   char[4]  "PHDF"
+//   uint16   format version (1)
+//   uint16   header length in bytes, counted from the start of "PHDF"
+//   uint32   frame number
+//   uint32   full frame width, height
+//   uint32   subframe x, y, width, height (all zero for a full frame)
+//   uint32   width, height of the transmitted pixels
+//   uint16   downsample factor
+//   uint16   star count
+//   float32  x, y of each star in full frame coordinates, primary star first
+//   uint16   pixels, row by row
+//
+// Only the subframe is sent when the camera is using subframes. A client can send
+// "downsample N\n" with N from 1 to 4 to receive N x N averaged pixels instead.
+//
+// Messages are written without blocking. A client that is still receiving the previous
+// frame when a new one arrives skips the new frame, so a slow client never stalls the
+// guide loop.
+
+enum
+{
+    FRAME_STREAM_VERSION = 1,
+    FRAME_STREAM_MAX_DOWNSAMPLE = 4,
+};
+
+typedef std::vector<unsigned char> FrameMsg;
+
+struct FrameStreamClient
+{
+    wxSocketClient *cli;
+    ClientReadBuf rdbuf;
+    unsigned int downsample;
+    std::shared_ptr<const FrameMsg> pending;
+    size_t sent;
+    unsigned int framesSent;
+    unsigned int framesDropped;
+
+    FrameStreamClient(wxSocketClient *cli_) : cli(cli_), downsample(1), sent(0), framesSent(0), framesDropped(0) { }
+};
+
+inline static FrameStreamClient *frame_client(wxSocketClient *cli)
+{
+    return static_cast<FrameStreamClient *>(cli->GetClientData());
+}
+
+static void destroy_frame_client(wxSocketClient *cli)
+{
+    FrameStreamClient *fc = frame_client(cli);
+    Debug.Write(wxString::Format("evsrv: frame cli %p closed, frames sent %u dropped %u\n", cli, fc->framesSent,
+                                 fc->framesDropped));
+    delete fc;
+    cli->Destroy();
+}
+
+inline static void put16(unsigned char *&p, unsigned int val)
+{
+    *p++ = val & 0xff;
+    *p++ = (val >> 8) & 0xff;
+}
+
+inline static void put32(unsigned char *&p, unsigned int val)
+{
+    put16(p, val & 0xffff);
+    put16(p, val >> 16);
+}
+
+inline static void put_float(unsigned char *&p, float val)
+{
+    uint32_t u;
+    memcpy(&u, &val, sizeof(u));
+    put32(p, u);
+}
+
+static std::shared_ptr<const FrameMsg> encode_frame(const usImage *img, const std::vector<PHD_Point>& stars,
+                                                    unsigned int downsample)
+{
+    wxRect src = img->Subframe.IsEmpty() ? wxRect(img->Size) : img->Subframe;
+    unsigned int const width = src.width / downsample;
+    unsigned int const height = src.height / downsample;
+    unsigned int const nstars = wxMin(stars.size(), (size_t) 0xffff);
+
+    unsigned int const hdrlen = 4 + 2 + 2 + 4 + 2 * 4 + 4 * 4 + 2 * 4 + 2 + 2 + nstars * 2 * 4;
+    size_t const pixlen = (size_t) width * height * sizeof(unsigned short);
+
+    auto msg = std::make_shared<FrameMsg>(4 + hdrlen + pixlen);
+    unsigned char *p = msg->data();
+
+    put32(p, (unsigned int) (hdrlen + pixlen));
+    memcpy(p, "PHDF", 4);
+    p += 4;
+    put16(p, FRAME_STREAM_VERSION);
+    put16(p, hdrlen);
+    put32(p, img->FrameNum);
+    put32(p, img->Size.GetWidth());
+    put32(p, img->Size.GetHeight());
+    put32(p, img->Subframe.IsEmpty() ? 0 : img->Subframe.x);
+    put32(p, img->Subframe.IsEmpty() ? 0 : img->Subframe.y);
+    put32(p, img->Subframe.IsEmpty() ? 0 : img->Subframe.width);
+    put32(p, img->Subframe.IsEmpty() ? 0 : img->Subframe.height);
+    put32(p, width);
+    put32(p, height);
+    put16(p, downsample);
+    put16(p, nstars);
+    for (unsigned int i = 0; i < nstars; i++)
+    {
+        put_float(p, (float) stars[i].X);
+        put_float(p, (float) stars[i].Y);
+    }
+
+    // the pixels are sent in host byte order, which is little-endian on all supported platforms
+    unsigned short *dst = reinterpret_cast<unsigned short *>(p);
+    const unsigned short *rect = img->ImageData + (size_t) src.y * img->Size.GetWidth() + src.x;
+    if (downsample == 1)
+        CaptureCopyRect16(dst, width, rect, img->Size.GetWidth(), width, height);
+    else if (img->Subframe.IsEmpty())
+        CaptureBin16(dst, img->ImageData, img->Size.GetWidth(), img->Size.GetHeight(), downsample);
+    else
+    {
+        std::vector<unsigned short> tmp((size_t) src.width * src.height);
+        CaptureCopyRect16(tmp.data(), src.width, rect, img->Size.GetWidth(), src.width, src.height);
+        CaptureBin16(dst, tmp.data(), src.width, src.height, downsample);
+    }
+
+    return msg;
+}
+
+// write as much of the pending frame as the socket will take without blocking; the rest is
+// written when the socket signals wxSOCKET_OUTPUT
+static void flush_frame_client(FrameStreamClient *fc)
+{
+    while (fc->pending)
+    {
+        const FrameMsg& msg = *fc->pending;
+        fc->cli->Write(msg.data() + fc->sent, msg.size() - fc->sent);
+        size_t const n = fc->cli->LastWriteCount();
+        fc->sent += n;
+
+        if (fc->sent == msg.size())
+        {
+            fc->pending.reset();
+            fc->sent = 0;
+            ++fc->framesSent;
+        }
+        else if (n == 0)
+        {
+            if (fc->cli->Error() && fc->cli->LastError() != wxSOCKET_WOULDBLOCK)
+            {
+                Debug.Write(
+                    wxString::Format("evsrv: frame cli %p write error %s\n", fc->cli, SockErrStr(fc->cli->LastError())));
+            }
+            break;
+        }
+    }
+}
+
+static void handle_frame_client_command(FrameStreamClient *fc, const char *line)
+{
+    unsigned int n;
+    if (sscanf(line, "downsample %u", &n) == 1 && n >= 1 && n <= FRAME_STREAM_MAX_DOWNSAMPLE)
+    {
+        Debug.Write(wxString::Format("evsrv: frame cli %p downsample %u\n", fc->cli, n));
+        fc->downsample = n;
+    }
+    else
+        Debug.Write(wxString::Format("evsrv: frame cli %p ignoring command [%s]\n", fc->cli, line));
+}
+
+static void handle_frame_client_input(FrameStreamClient *fc)
+{
+    ClientReadBuf *rdbuf = &fc->rdbuf;
+    wxSocketInputStream sis(*fc->cli);
+
+    while (sis.CanRead())
+    {
+        if (rdbuf->avail() == 0)
+        {
+            drain_input(sis);
+            rdbuf->reset();
+            break;
+        }
+        size_t n = sis.Read(rdbuf->dest, rdbuf->avail()).LastRead();
+        if (n == 0)
+            break;
+
+        rdbuf->dest += n;
+
+        char *end;
+        while ((end = static_cast<char *>(memchr(rdbuf->buf(), '\n', rdbuf->len()))) != nullptr)
+        {
+            *end = 0;
+            if (end > rdbuf->buf() && end[-1] == '\r')
+                end[-1] = 0;
+            handle_frame_client_command(fc, rdbuf->buf());
+
+            char *next = end + 1;
+            size_t len = rdbuf->dest - next;
+            memmove(rdbuf->buf(), next, len);
+            rdbuf->dest = rdbuf->buf() + len;
+        }
+    }
+}
+
+EventServer::EventServer()
+    : m_serverSocket(nullptr), m_configEventDebouncer(nullptr), m_frameServerSocket(nullptr), m_frameStreamPort(0)
+{
+}
 
 EventServer::~EventServer() { }
 
@@ -3911,6 +4578,9 @@ bool EventServer::EventServerStart(unsigned int instanceId)
         return false;
     }
 
+    int limitKB = pConfig->Global.GetInt("/EventServer/ClientQueueLimitKB", DEFAULT_CLIENT_QUEUE_LIMIT_KB);
+    s_clientQueueLimit = (size_t) wxMax(limitKB, 16) * 1024;
+
     unsigned int port = 4400 + instanceId - 1;
     wxIPV4address eventServerAddr;
     eventServerAddr.Service(port);
@@ -3932,6 +4602,31 @@ bool EventServer::EventServerStart(unsigned int instanceId)
 
     Debug.Write(wxString::Format("event server started, listening on port %u\n", port));
 
+    if (!pConfig->Global.GetBoolean("/EventServer/FrameStream", false))
+        return false;
+
+    // the frame stream is optional; the event server keeps running if its port is unavailable
+    unsigned int framePort = port + 100;
+    wxIPV4address frameServerAddr;
+    frameServerAddr.Service(framePort);
+    m_frameServerSocket = new wxSocketServer(frameServerAddr, wxSOCKET_REUSEADDR);
+
+    if (m_frameServerSocket->Ok())
+    {
+        m_frameServerSocket->SetEventHandler(*this, FRAME_SERVER_ID);
+        m_frameServerSocket->SetNotify(wxSOCKET_CONNECTION_FLAG);
+        m_frameServerSocket->Notify(true);
+        m_frameStreamPort = framePort;
+
+        Debug.Write(wxString::Format("frame stream listening on port %u\n", framePort));
+    }
+    else
+    {
+        Debug.Write(wxString::Format("Frame stream failed to start - Could not listen at port %u\n", framePort));
+        delete m_frameServerSocket;
+        m_frameServerSocket = nullptr;
+    }
+
     return false;
 }
 
@@ -3949,6 +4644,16 @@ void EventServer::EventServerStop()
     delete m_serverSocket;
     m_serverSocket = nullptr;
 
+    for (CliSockSet::const_iterator it = m_frameStreamClients.begin(); it != m_frameStreamClients.end(); ++it)
+    {
+        destroy_frame_client(*it);
+    }
+    m_frameStreamClients.clear();
+
+    delete m_frameServerSocket;
+    m_frameServerSocket = nullptr;
+    m_frameStreamPort = 0;
+
     delete m_configEventDebouncer;
     m_configEventDebouncer = nullptr;
 
@@ -3970,7 +4675,7 @@ void EventServer::OnEventServerEvent(wxSocketEvent& event)
     Debug.Write(wxString::Format("evsrv: cli %p connect\n", client));
 
     client->SetEventHandler(*this, EVENT_SERVER_CLIENT_ID);
-    client->SetNotify(wxSOCKET_LOST_FLAG | wxSOCKET_INPUT_FLAG);
+    client->SetNotify(wxSOCKET_LOST_FLAG | wxSOCKET_INPUT_FLAG | wxSOCKET_OUTPUT_FLAG);
     client->SetFlags(wxSOCKET_NOWAIT);
     client->Notify(true);
     client->SetClientData(new ClientData(client));
@@ -3998,12 +4703,118 @@ void EventServer::OnEventServerClientEvent(wxSocketEvent& event)
     {
         handle_cli_input(cli);
     }
+    else if (event.GetSocketEvent() == wxSOCKET_OUTPUT)
+    {
+        flush_client(cli);
+    }
     else
     {
         Debug.Write(wxString::Format("unexpected client socket event %d\n", event.GetSocketEvent()));
     }
 }
 
+void EventServer::DisconnectClient(wxSocketClient *cli)
+{
+    // the client may have disconnected on its own in the meantime
+    if (m_eventServerClients.erase(cli) == 1)
+        destroy_client(cli);
+
+    // drop the reference taken when the queue overflowed
+    ((ClientData *) cli->GetClientData())->RemoveRef();
+}
+
+void EventServer::OnFrameServerEvent(wxSocketEvent& event)
+{
+    wxSocketServer *server = static_cast<wxSocketServer *>(event.GetSocket());
+
+    if (event.GetSocketEvent() != wxSOCKET_CONNECTION)
+        return;
+
+    wxSocketClient *client = static_cast<wxSocketClient *>(server->Accept(false));
+
+    if (!client)
+        return;
+
+    Debug.Write(wxString::Format("evsrv: frame cli %p connect\n", client));
+
+    client->SetEventHandler(*this, FRAME_SERVER_CLIENT_ID);
+    client->SetNotify(wxSOCKET_LOST_FLAG | wxSOCKET_INPUT_FLAG | wxSOCKET_OUTPUT_FLAG);
+    client->SetFlags(wxSOCKET_NOWAIT);
+    client->Notify(true);
+    client->SetClientData(new FrameStreamClient(client));
+
+    m_frameStreamClients.insert(client);
+}
+
+void EventServer::OnFrameServerClientEvent(wxSocketEvent& event)
+{
+    wxSocketClient *cli = static_cast<wxSocketClient *>(event.GetSocket());
+
+    switch (event.GetSocketEvent())
+    {
+    case wxSOCKET_LOST:
+        Debug.Write(wxString::Format("evsrv: frame cli %p disconnect\n", cli));
+        if (m_frameStreamClients.erase(cli) == 1)
+            destroy_frame_client(cli);
+        break;
+    case wxSOCKET_INPUT:
+        handle_frame_client_input(frame_client(cli));
+        break;
+    case wxSOCKET_OUTPUT:
+        flush_frame_client(frame_client(cli));
+        break;
+    default:
+        Debug.Write(wxString::Format("unexpected frame client socket event %d\n", event.GetSocketEvent()));
+        break;
+    }
+}
+
+void EventServer::NotifyGuideFrame(const usImage *img)
+{
+    if (m_frameStreamClients.empty() || !img || !img->ImageData)
+        return;
+
+    std::vector<PHD_Point> stars;
+    if (pFrame && pFrame->pGuider)
+        pFrame->pGuider->GetStarPositions(&stars);
+
+    // encode at most once per downsample factor in use
+    std::shared_ptr<const FrameMsg> msgs[FRAME_STREAM_MAX_DOWNSAMPLE + 1];
+
+    for (CliSockSet::const_iterator it = m_frameStreamClients.begin(); it != m_frameStreamClients.end(); ++it)
+    {
+        FrameStreamClient *fc = frame_client(*it);
+
+        if (fc->pending)
+        {
+            ++fc->framesDropped;
+            // a partially sent frame must be completed; one that has not started is replaced by the newer frame
+            if (fc->sent > 0)
+                continue;
+        }
+
+        std::shared_ptr<const FrameMsg>& msg = msgs[fc->downsample];
+        if (!msg)
+            msg = encode_frame(img, stars, fc->downsample);
+
+        fc->pending = msg;
+        fc->sent = 0;
+        flush_frame_client(fc);
+    }
+}
+
+void EventServer::GetFrameStreamStats(unsigned int *clients, unsigned int *sent, unsigned int *dropped) const
+{
+    *clients = m_frameStreamClients.size();
+    *sent = *dropped = 0;
+    for (CliSockSet::const_iterator it = m_frameStreamClients.begin(); it != m_frameStreamClients.end(); ++it)
+    {
+        const FrameStreamClient *fc = frame_client(*it);
+        *sent += fc->framesSent;
+        *dropped += fc->framesDropped;
+    }
+}
+
 void EventServer::NotifyStartCalibration(const Mount *mount)
 {
     SIMPLE_NOTIFY_EV(ev_start_calibration(mount));
@@ -4173,6 +4984,8 @@ void EventServer::NotifyGuideStep(const GuideStepInfo& step)
     if (m_eventServerClients.empty())
         return;
 
+    TimingProbe probe(GuideTiming::STAGE_EVENT_NOTIFY);
+
     Ev ev("GuideStep");
 
     ev << NV("Frame", step.frameNumber) << NV("Time", step.time, 3) << NVMount(step.mount) << NV("dx", step.cameraOffset.X, 3)
@@ -4261,7 +5074,7 @@ void EventServer::NotifySettling(double distance, double time, double settleTime
 
     Ev ev(ev_settling(distance, time, settleTime, starLocked));
 
-    Debug.Write(wxString::Format("evsrv: %s\n", ev.str()));
+    Debug.Write(wxString::Format("evsrv: %s\n", wxString::FromUTF8(ev.str().c_str())));
 
     do_notify(m_eventServerClients, ev);
 }
@@ -4273,7 +5086,7 @@ void EventServer::NotifySettleDone(const wxString& errorMsg, int settleFrames, i
 
     Ev ev(ev_settle_done(errorMsg, settleFrames, droppedFrames));
 
-    Debug.Write(wxString::Format("evsrv: %s\n", ev.str()));
+    Debug.Write(wxString::Format("evsrv: %s\n", wxString::FromUTF8(ev.str().c_str())));
 
     do_notify(m_eventServerClients, ev);
 }
@@ -36,6 +36,7 @@
 #define EVENT_SERVER_INCLUDED
 
 #include <set>
+#include <vector>
 #include "json_parser.h"
 
 class EventServer : public wxEvtHandler
@@ -47,6 +48,9 @@ private:
     wxSocketServer *m_serverSocket;
     CliSockSet m_eventServerClients;
     wxTimer *m_configEventDebouncer;
+    wxSocketServer *m_frameServerSocket;
+    CliSockSet m_frameStreamClients;
+    unsigned int m_frameStreamPort;
 
 public:
     EventServer();
@@ -84,10 +88,19 @@ public:
     void NotifyGuidingParam(const wxString& name, bool val);
     void NotifyGuidingParam(const wxString& name, const wxString& val);
     void NotifyConfigurationChange();
+    void NotifyGuideFrame(const usImage *img);
+
+    unsigned int FrameStreamPort() const { return m_frameStreamPort; }
+    void GetFrameStreamStats(unsigned int *clients, unsigned int *sent, unsigned int *dropped) const;
+
+    // disconnect a client whose output queue overflowed
+    void DisconnectClient(wxSocketClient *cli);
 
 private:
     void OnEventServerEvent(wxSocketEvent& evt);
     void OnEventServerClientEvent(wxSocketEvent& evt);
+    void OnFrameServerEvent(wxSocketEvent& evt);
+    void OnFrameServerClientEvent(wxSocketEvent& evt);
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -41,10 +41,7 @@
 
 #include <wx/gbsizer.h>
 #include <functional>
-#include <pthread.h>
 
-// Forward declaration for monitor thread
-static void* shm_monitor_thread_func(void* arg);
 // clang-format off
 wxBEGIN_EVENT_TABLE(GearDialog, wxDialog)
     EVT_CHOICE(GEAR_PROFILES, GearDialog::OnProfileChoice)
@@ -129,8 +126,7 @@ wxEND_EVENT_TABLE();
 GearDialog::GearDialog(wxWindow *pParent)
     : wxDialog(pParent, wxID_ANY, _("Connect Equipment"), wxDefaultPosition, wxDefaultSize, wxCAPTION | wxCLOSE_BOX),
       m_cameraUpdated(false), m_mountUpdated(false), m_stepGuiderUpdated(false), m_rotatorUpdated(false),
-      m_showDarksDialog(false), m_camWarningIssued(false), m_camChanged(false), m_imageScaleRatio(1.0), m_flushConfig(false),
-      m_shm_monitor_thread(0), m_shm_monitor_running(0)
+      m_showDarksDialog(false), m_camWarningIssued(false), m_camChanged(false), m_imageScaleRatio(1.0), m_flushConfig(false)
 {
     m_pCamera = nullptr;
     m_pScope = nullptr;
@@ -164,15 +160,6 @@ GearDialog::GearDialog(wxWindow *pParent)
 
 GearDialog::~GearDialog()
 {
-    // Stop SHM monitor thread (it should already be stopped in ShowGearDialog)
-    // but ensure it's stopped in case destructor is called without ShowModal
-    if (m_shm_monitor_thread != 0)
-    {
-        m_shm_monitor_running = 0;
-        pthread_join(m_shm_monitor_thread, NULL);
-        m_shm_monitor_thread = 0;
-    }
-
     delete m_pCamera;
     delete m_pScope;
     if (m_pAuxScope != m_pScope)
@@ -547,25 +534,10 @@ int GearDialog::ShowGearDialog(bool autoConnect)
         GetSizer()->Fit(this);
         CenterOnParent();
 
-        // Start monitor thread to listen for SHM changes
-        if (m_shm_monitor_thread == 0)
-        {
-            m_shm_monitor_running = 1;
-            pthread_create(&m_shm_monitor_thread, NULL, shm_monitor_thread_func, this);
-        }
-
         wxWindow *top = wxGetApp().GetTopWindow();
         wxGetApp().SetTopWindow(this);
         ret = wxDialog::ShowModal();
         wxGetApp().SetTopWindow(top);
-
-        // Stop and clean up monitor thread
-        if (m_shm_monitor_thread != 0)
-        {
-            m_shm_monitor_running = 0;
-            pthread_join(m_shm_monitor_thread, NULL);
-            m_shm_monitor_thread = 0;
-        }
     }
     else
     {
@@ -2444,91 +2416,6 @@ void GearDialog::OnAdvanced(wxCommandEvent& event)
     pFrame->OnAdvanced(event);
 }
 
-// Monitor thread for SHM camera and mount selection changes
-static void* shm_monitor_thread_func(void* arg)
-{
-    GearDialog* dlg = (GearDialog*)arg;
-    static wxString last_camera_id = wxEmptyString;
-
-    while (dlg->m_shm_monitor_running)
-    {
-        // Wait for camera selection change
-        if (shm_camera_wait_client_request() == 0)
-        {
-            // Check if still running (in case we're shutting down)
-            if (!dlg->m_shm_monitor_running)
-                break;
-
-            // Get the new selected camera index from SHM
-            int new_index = CameraSHMManager::GetSelectedCamera();
-
-            if (new_index >= 0)
-            {
-                // Send event to main thread to update GUI
-                wxThreadEvent evt(wxEVT_THREAD);
-                evt.SetInt(new_index);
-                evt.SetString(wxT("camera"));
-                wxQueueEvent(dlg, evt.Clone());
-            }
-
-            // Also check if camera ID changed
-            wxString camera_id = CameraSHMManager::GetSelectedCameraId();
-            if (camera_id != last_camera_id)
-            {
-                last_camera_id = camera_id;
-                if (!camera_id.IsEmpty())
-                {
-                    // Send event to main thread to update camera instance
-                    wxThreadEvent evt(wxEVT_THREAD);
-                    evt.SetString(wxT("camera_id:") + camera_id);
-                    wxQueueEvent(dlg, evt.Clone());
-                }
-            }
-        }
-
-        // Also check for camera ID changes periodically (polling)
-        if (dlg->m_shm_monitor_running)
-        {
-            wxString camera_id = CameraSHMManager::GetSelectedCameraId();
-            if (camera_id != last_camera_id)
-            {
-                last_camera_id = camera_id;
-                if (!camera_id.IsEmpty())
-                {
-                    // Send event to main thread to update camera instance
-                    wxThreadEvent evt(wxEVT_THREAD);
-                    evt.SetString(wxT("camera_id:") + camera_id);
-                    wxQueueEvent(dlg, evt.Clone());
-                }
-            }
-        }
-
-        // Also check for mount selection changes (non-blocking with timeout)
-        // Note: This is a simple polling approach. A more efficient approach would use select()
-        if (dlg->m_shm_monitor_running)
-        {
-            int new_index = MountSHMManager::GetSelectedMount();
-            static int last_mount_index = -2; // Initialize to impossible value
-
-            if (new_index != last_mount_index)
-            {
-                last_mount_index = new_index;
-
-                // Send event to main thread to update GUI
-                wxThreadEvent evt(wxEVT_THREAD);
-                evt.SetInt(new_index);
-                evt.SetString(wxT("mount"));
-                wxQueueEvent(dlg, evt.Clone());
-            }
-
-            // Small sleep to prevent busy-waiting
-            usleep(100000); // 100ms
-        }
-    }
-
-    return NULL;
-}
-
 void GearDialog::OnSHMCameraSelectionChanged(wxThreadEvent& event)
 {
     int new_index = event.GetInt();
@@ -93,9 +93,6 @@ class GearDialog : public wxDialog
     bool m_flushConfig;
 
 public:
-    // Camera SHM monitoring via semaphore (public for thread access)
-    pthread_t m_shm_monitor_thread;
-    volatile int m_shm_monitor_running;
     GearDialog(wxWindow *pParent);
     ~GearDialog();
 
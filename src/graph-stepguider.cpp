@@ -202,20 +202,24 @@ void GraphStepguiderWindow::AppendData(const wxPoint& pos, const PHD_Point& avgP
     assert(wxThread::IsMain());
 
     wxLongLong_t now = ::wxGetUTCTimeMillis().GetValue();
+    bool headless = pFrame->IsHeadless();
 
-    if (m_pClient->m_nItems > 0)
+    if (!headless)
     {
-        double hz = 1000.0 / static_cast<double>(now - m_prevTimestamp);
-        m_hzText->SetLabel(wxString::Format(_("%.1f Hz"), hz));
+        if (m_pClient->m_nItems > 0)
+        {
+            double hz = 1000.0 / static_cast<double>(now - m_prevTimestamp);
+            m_hzText->SetLabel(wxString::Format(_("%.1f Hz"), hz));
+        }
+        else
+            m_hzText->SetLabel(wxEmptyString);
     }
-    else
-        m_hzText->SetLabel(wxEmptyString);
 
     m_prevTimestamp = now;
 
     m_pClient->AppendData(pos, avgPos);
 
-    if (m_visible)
+    if (m_visible && !headless)
     {
         Refresh();
     }
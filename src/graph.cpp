@@ -561,6 +561,13 @@ void GraphLogWindow::EnableTrendLines(bool enable)
 
 void GraphLogWindow::AppendData(const GuideStepInfo& step)
 {
+    if (pFrame->IsHeadless())
+    {
+        // keep the history; the controls and graph are brought up to date when headless mode ends
+        m_pClient->AppendData(step);
+        return;
+    }
+
     if (m_pXControlPane)
         m_pXControlPane->UpdateControls();
     if (m_pYControlPane)
@@ -72,6 +72,8 @@ static const double DefaultNoresetMaxPctPeriod =
     40.; // max percent of worm period elapsed to skip resetting the model when guiding is stopped and resumed
 
 static const bool DefaultComputePeriod = true;
+static const int DefaultPeriodEstimationInterval = 1; // guide steps between FFT period estimations
+static const bool DefaultIncrementalInference = false; // update the GP factorization instead of recomputing it
 
 static void MakeBold(wxControl *ctrl)
 {
@@ -83,7 +85,8 @@ static void MakeBold(wxControl *ctrl)
 GuideAlgorithmGaussianProcess::GPExpertDialog::GPExpertDialog(wxWindow *Parent)
     : wxDialog(Parent, wxID_ANY, _("Expert Settings"), wxDefaultPosition, wxDefaultSize), m_pPeriodLengthsInference(0),
       m_pPeriodLengthsPeriodEstimation(0), m_pNumPointsApproximation(0), m_pSE0KLengthScale(0), m_pSE0KSignalVariance(0),
-      m_pPKLengthScale(0), m_pPKSignalVariance(0), m_pSE1KLengthScale(0), m_pSE1KSignalVariance(0)
+      m_pPKLengthScale(0), m_pPKSignalVariance(0), m_pSE1KLengthScale(0), m_pSE1KSignalVariance(0),
+      m_pPeriodEstimationInterval(0), m_pIncrementalInference(0)
 {
     // create the expert options UI
     wxBoxSizer *vSizer = new wxBoxSizer(wxVERTICAL);
@@ -92,7 +95,7 @@ GuideAlgorithmGaussianProcess::GPExpertDialog::GPExpertDialog(wxWindow *Parent)
     MakeBold(warning);
     vSizer->Add(warning, wxSizerFlags().Center().Border(wxBOTTOM, 10));
 
-    wxFlexGridSizer *flexGrid = new wxFlexGridSizer(10, 2, 5, 5);
+    wxFlexGridSizer *flexGrid = new wxFlexGridSizer(11, 2, 5, 5);
     int width;
 
     width = StringWidth(this, _T("0000"));
@@ -179,6 +182,20 @@ GuideAlgorithmGaussianProcess::GPExpertDialog::GPExpertDialog(wxWindow *Parent)
                   wxString::Format(_("Signal variance (in pixels) of the short-term variations. Default = %.2f"),
                                    DefaultSignalVarianceSE1Ker));
 
+    width = StringWidth(this, _T("000"));
+    m_pPeriodEstimationInterval = pFrame->MakeSpinCtrl(this, wxID_ANY, _T(" "), wxDefaultPosition, wxSize(width, -1),
+                                                       wxSP_ARROW_KEYS, 1, 100, DefaultPeriodEstimationInterval);
+    AddTableEntry(flexGrid, _("Period Estimation Interval"), m_pPeriodEstimationInterval,
+                  wxString::Format(_("Number of guide steps between two estimations of the period length. Larger values "
+                                     "save computation time but adapt the period length more slowly. Default = %d"),
+                                   DefaultPeriodEstimationInterval));
+
+    m_pIncrementalInference = new wxCheckBox(this, wxID_ANY, wxEmptyString);
+    AddTableEntry(flexGrid, _("Incremental Inference"), m_pIncrementalInference,
+                  wxString::Format(_("Update the Gaussian process with each new measurement instead of recomputing it "
+                                     "from all data points. Saves computation time on slow computers. Default = %s"),
+                                   DefaultIncrementalInference ? _("On") : _("Off")));
+
     vSizer->Add(flexGrid);
     SetSizerAndFit(vSizer);
 }
@@ -198,6 +215,8 @@ void GuideAlgorithmGaussianProcess::GPExpertDialog::LoadExpertValues(GuideAlgori
     m_pPeriodLengthsInference->SetValue(m_pGuideAlgorithm->GetPeriodLengthsInference());
     m_pPeriodLengthsPeriodEstimation->SetValue(m_pGuideAlgorithm->GetPeriodLengthsPeriodEstimation());
     m_pNumPointsApproximation->SetValue(m_pGuideAlgorithm->GetNumPointsForApproximation());
+    m_pPeriodEstimationInterval->SetValue(m_pGuideAlgorithm->GetPeriodEstimationInterval());
+    m_pIncrementalInference->SetValue(m_pGuideAlgorithm->GetBoolIncrementalInference());
 
     m_pSE0KLengthScale->SetValue(hyperParams[SE0KLengthScale]);
     m_pSE0KSignalVariance->SetValue(hyperParams[SE0KSignalVariance]);
@@ -213,6 +232,8 @@ void GuideAlgorithmGaussianProcess::GPExpertDialog::UnloadExpertValues(GuideAlgo
     m_pGuideAlgorithm->SetPeriodLengthsInference(m_pPeriodLengthsInference->GetValue());
     m_pGuideAlgorithm->SetPeriodLengthsPeriodEstimation(m_pPeriodLengthsPeriodEstimation->GetValue());
     m_pGuideAlgorithm->SetNumPointsForApproximation(m_pNumPointsApproximation->GetValue());
+    m_pGuideAlgorithm->SetPeriodEstimationInterval(m_pPeriodEstimationInterval->GetValue());
+    m_pGuideAlgorithm->SetBoolIncrementalInference(m_pIncrementalInference->GetValue());
 
     hyperParams[SE0KLengthScale] = m_pSE0KLengthScale->GetValue();
     hyperParams[SE0KSignalVariance] = m_pSE0KSignalVariance->GetValue();
@@ -455,6 +476,8 @@ GuideAlgorithmGaussianProcess::GuideAlgorithmGaussianProcess(Mount *pMount, Guid
     parameters.points_for_approximation_ = DefaultNumPointsForApproximation;
     parameters.prediction_gain_ = DefaultPredictionGain;
     parameters.compute_period_ = DefaultComputePeriod;
+    parameters.period_estimation_interval_ = DefaultPeriodEstimationInterval;
+    parameters.incremental_inference_ = DefaultIncrementalInference;
 
     // create instance of the worker
     GPG = new GaussianProcessGuider(parameters);
@@ -502,6 +525,15 @@ GuideAlgorithmGaussianProcess::GuideAlgorithmGaussianProcess(Mount *pMount, Guid
 
     bool compute_period = pConfig->Profile.GetBoolean(configPath + "/gp_compute_period", DefaultComputePeriod);
     SetBoolComputePeriod(compute_period);
+
+    int period_estimation_interval =
+        pConfig->Profile.GetInt(configPath + "/gp_period_estimation_interval", DefaultPeriodEstimationInterval);
+    SetPeriodEstimationInterval(period_estimation_interval);
+
+    bool incremental_inference =
+        pConfig->Profile.GetBoolean(configPath + "/gp_incremental_inference", DefaultIncrementalInference);
+    SetBoolIncrementalInference(incremental_inference);
+
     m_expertDialog = NULL;
     block_updates_ = !(m_pMount->GetGuidingEnabled());
     guiding_ra_ = math_tools::NaN;
@@ -872,6 +904,38 @@ bool GuideAlgorithmGaussianProcess::SetBoolComputePeriod(bool active)
     return true;
 }
 
+bool GuideAlgorithmGaussianProcess::SetPeriodEstimationInterval(int num_steps)
+{
+    bool error = false;
+
+    try
+    {
+        if (num_steps < 1)
+        {
+            throw ERROR_INFO("invalid period estimation interval");
+        }
+    }
+    catch (const wxString& Msg)
+    {
+        POSSIBLY_UNUSED(Msg);
+        error = true;
+        num_steps = DefaultPeriodEstimationInterval;
+    }
+
+    GPG->SetPeriodEstimationInterval(num_steps);
+
+    pConfig->Profile.SetInt(GetConfigPath() + "/gp_period_estimation_interval", num_steps);
+
+    return error;
+}
+
+bool GuideAlgorithmGaussianProcess::SetBoolIncrementalInference(bool active)
+{
+    GPG->SetBoolIncrementalInference(active);
+    pConfig->Profile.SetBoolean(GetConfigPath() + "/gp_incremental_inference", active);
+    return true;
+}
+
 double GuideAlgorithmGaussianProcess::GetControlGain() const
 {
     return GPG->GetControlGain();
@@ -912,6 +976,16 @@ bool GuideAlgorithmGaussianProcess::GetBoolComputePeriod() const
     return GPG->GetBoolComputePeriod();
 }
 
+int GuideAlgorithmGaussianProcess::GetPeriodEstimationInterval() const
+{
+    return GPG->GetPeriodEstimationInterval();
+}
+
+bool GuideAlgorithmGaussianProcess::GetBoolIncrementalInference() const
+{
+    return GPG->GetBoolIncrementalInference();
+}
+
 bool GuideAlgorithmGaussianProcess::GetDarkTracking() const
 {
     return dark_tracking_mode_;
@@ -937,7 +1011,9 @@ wxString GuideAlgorithmGaussianProcess::GetSettingsSummary() const
                                 "\tSignal variance short range SE kernel = %.3f\n"
                                 "\tPeriod length periodic kernel = %.3f\n"
                                 "\tFFT called after = %.3f worm cycles\n"
-                                "\tAuto-adjust period length = %s\n";
+                                "\tAuto-adjust period length = %s\n"
+                                "\tPeriod estimation interval = %d guide steps\n"
+                                "\tIncremental inference = %s\n";
 
     std::vector<double> hyperparameters = GetGPHyperparameters();
 
@@ -945,7 +1021,8 @@ wxString GuideAlgorithmGaussianProcess::GetSettingsSummary() const
                             hyperparameters[SE0KSignalVariance], hyperparameters[PKLengthScale],
                             hyperparameters[PKSignalVariance], hyperparameters[SE1KLengthScale],
                             hyperparameters[SE1KSignalVariance], hyperparameters[PKPeriodLength],
-                            GetPeriodLengthsPeriodEstimation(), GetBoolComputePeriod() ? "On" : "Off");
+                            GetPeriodLengthsPeriodEstimation(), GetBoolComputePeriod() ? "On" : "Off",
+                            GetPeriodEstimationInterval(), GetBoolIncrementalInference() ? "On" : "Off");
 }
 
 GUIDE_ALGORITHM GuideAlgorithmGaussianProcess::Algorithm() const
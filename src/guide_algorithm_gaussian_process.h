@@ -71,6 +71,8 @@ protected:
         wxSpinCtrlDouble *m_pPKSignalVariance;
         wxSpinCtrlDouble *m_pSE1KLengthScale;
         wxSpinCtrlDouble *m_pSE1KSignalVariance;
+        wxSpinCtrl *m_pPeriodEstimationInterval;
+        wxCheckBox *m_pIncrementalInference;
         void AddTableEntry(wxFlexGridSizer *Grid, const wxString& Label, wxWindow *Ctrl, const wxString& ToolTip);
 
     public:
@@ -143,6 +145,12 @@ protected:
     bool GetBoolComputePeriod() const;
     bool SetBoolComputePeriod(bool);
 
+    int GetPeriodEstimationInterval() const;
+    bool SetPeriodEstimationInterval(int num_steps);
+
+    bool GetBoolIncrementalInference() const;
+    bool SetBoolIncrementalInference(bool);
+
     std::vector<double> GetGPHyperparameters() const;
     bool SetGPHyperparameters(const std::vector<double>& hyperparameters);
 
@@ -39,6 +39,8 @@
 
 #include "phd.h"
 
+#include "guide_kernels.h"
+
 static const double DefaultMinMove = 0.2;
 static const double DefaultHysteresis = 0.1;
 static const double DefaultAggression = 0.7;
@@ -74,14 +76,7 @@ void GuideAlgorithmHysteresis::reset(void)
 
 double GuideAlgorithmHysteresis::result(double input)
 {
-    double dReturn = (1.0 - m_hysteresis) * input + m_hysteresis * m_lastMove;
-
-    dReturn *= m_aggression;
-
-    if (fabs(input) < m_minMove)
-    {
-        dReturn = 0.0;
-    }
+    double dReturn = HysteresisResult(input, m_minMove, m_hysteresis, m_aggression, m_lastMove);
 
     m_lastMove = dReturn;
 
@@ -0,0 +1,92 @@
+/*
+ *  guide_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "guide_kernels.h"
+
+#include <math.h>
+
+double HysteresisResult(double input, double minMove, double hysteresis, double aggression, double lastMove)
+{
+    double dReturn = (1.0 - hysteresis) * input + hysteresis * lastMove;
+
+    dReturn *= aggression;
+
+    if (fabs(input) < minMove)
+    {
+        dReturn = 0.0;
+    }
+
+    return dReturn;
+}
+
+bool MultiStarStabilizing(bool stabilizing, unsigned int count, double primaryDistance, double primarySigma,
+                          double stabilitySigmaX)
+{
+    if (count <= 5)
+        return true; // get some data for primary star movement
+
+    if (!stabilizing)
+        return primaryDistance > stabilitySigmaX * primarySigma;
+    else
+        return primaryDistance > 2 * primarySigma;
+}
+
+MultiStarUse MultiStarClassify(double dx, double dy, double primarySigma, unsigned int *zeroCount, unsigned int *missCount)
+{
+    if (dx == 0. && dy == 0.)
+        return MULTISTAR_DROP;
+
+    // Handle zero-counting - suspect results of exactly zero movement
+    if (dx == 0. || dy == 0.)
+        ++*zeroCount;
+    else if (*zeroCount > 0)
+        --*zeroCount;
+
+    if (*zeroCount == 5)
+        return MULTISTAR_DROP;
+
+    // Handle suspicious excursions - counted as "misses"
+    if (hypot(dx, dy) > 2.5 * primarySigma)
+    {
+        if (++*missCount > 10)
+        {
+            *missCount = 0;
+            return MULTISTAR_RESET;
+        }
+        return MULTISTAR_MISS;
+    }
+    else if (*missCount > 0)
+        --*missCount;
+
+    return MULTISTAR_USE;
+}
@@ -0,0 +1,89 @@
+/*
+ *  guide_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GUIDE_KERNELS_INCLUDED
+#define GUIDE_KERNELS_INCLUDED
+
+// Guide step calculations shared by the guider and the guide algorithms with
+// the replay benchmark. They only do arithmetic on the values passed in; the
+// callers own the state, the logging and the settings.
+
+// GuideAlgorithmHysteresis: blend the input with the previous move and scale
+// it by the aggression; moves for inputs smaller than minMove are suppressed.
+// The result is the lastMove of the next call.
+double HysteresisResult(double input, double minMove, double hysteresis, double aggression, double lastMove);
+
+// GuiderMultiStar stabilization period: secondary stars are not used until
+// the primary star distance has been measured more than 5 times, nor while the
+// primary star has moved more than stabilitySigmaX sigma, until it settles
+// back within 2 sigma. Returns the new stabilizing state.
+bool MultiStarStabilizing(bool stabilizing, unsigned int count, double primaryDistance, double primarySigma,
+                          double stabilitySigmaX);
+
+// what GuiderMultiStar::RefineOffset does with a secondary star it found
+enum MultiStarUse
+{
+    MULTISTAR_USE, // add the star motion to the average
+    MULTISTAR_DROP, // exactly zero motion too often, probably a hot pixel; drop the star
+    MULTISTAR_MISS, // excursion too large compared to the primary star; skip the star this time
+    MULTISTAR_RESET, // too many misses; skip the star and move its reference point to where it is now
+};
+
+// Classify the motion (dx, dy) of a secondary star from its reference point,
+// updating the star's zero and miss counts
+MultiStarUse MultiStarClassify(double dx, double dy, double primarySigma, unsigned int *zeroCount, unsigned int *missCount);
+
+// SNR weighted average of the primary star offset and the usable secondary
+// star motions
+struct MultiStarAverage
+{
+    double sumX;
+    double sumY;
+    double sumWeights;
+    int count; // secondary stars included
+
+    MultiStarAverage(double primaryX, double primaryY) : sumX(primaryX), sumY(primaryY), sumWeights(1.0), count(0) { }
+
+    void Add(double weight, double dx, double dy)
+    {
+        sumX += weight * dx;
+        sumY += weight * dy;
+        sumWeights += weight;
+        ++count;
+    }
+
+    double X() const { return sumX / sumWeights; }
+    double Y() const { return sumY / sumWeights; }
+};
+
+#endif // GUIDE_KERNELS_INCLUDED
@@ -0,0 +1,227 @@
+/*
+ *  guide_timing.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "guide_timing.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+GuideTiming GuideLoopTiming;
+
+static const char *const s_stageNames[GuideTiming::STAGE_COUNT] = {
+    "exposure_delay", "move_wait", "capture",     "dark_subtract", "noise_reduction", "calc_stats", "auto_find",
+    "star_find",      "refine",    "guide_state", "display",       "guide_algorithm", "pulse",      "event_notify",
+    "frame_notify",
+};
+
+static int HighBit(uint64_t v)
+{
+    int n = 0;
+    while (v >>= 1)
+        ++n;
+    return n;
+}
+
+void GuideTiming::Generation::Clear()
+{
+    memset(counts, 0, sizeof(counts));
+    count = 0;
+    sum = 0;
+    min = 0;
+    max = 0;
+}
+
+GuideTiming::GuideTiming()
+{
+    Reset();
+}
+
+const char *GuideTiming::StageName(Stage stage)
+{
+    return stage >= 0 && stage < STAGE_COUNT ? s_stageNames[stage] : "unknown";
+}
+
+int GuideTiming::BucketIndex(uint64_t us)
+{
+    if (us < SUB_BUCKETS)
+        return (int) us;
+
+    int e = HighBit(us);
+    if (e >= MAX_EXPONENT)
+        return BUCKET_COUNT - 1;
+
+    // 16 buckets between 2^e and 2^(e+1), each 2^(e-4) wide
+    return SUB_BUCKETS + (e - 4) * SUB_BUCKETS + (int) ((us >> (e - 4)) - SUB_BUCKETS);
+}
+
+uint64_t GuideTiming::BucketLowerBound(int index)
+{
+    if (index < SUB_BUCKETS)
+        return index;
+
+    int e = 4 + (index - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (e - 4);
+}
+
+uint64_t GuideTiming::BucketWidth(int index)
+{
+    if (index < SUB_BUCKETS)
+        return 1;
+
+    int e = 4 + (index - SUB_BUCKETS) / SUB_BUCKETS;
+    return (uint64_t) 1 << (e - 4);
+}
+
+void GuideTiming::Record(Stage stage, Clock::duration elapsed)
+{
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    RecordMicroseconds(stage, us > 0 ? (uint64_t) us : 0);
+}
+
+void GuideTiming::RecordMicroseconds(Stage stage, uint64_t us)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    StageData& d = m_stages[stage];
+    Generation *g = &d.gen[d.current];
+
+    if (g->count >= WINDOW)
+    {
+        // the current generation is full, drop the older one and start over in its place
+        d.current ^= 1;
+        g = &d.gen[d.current];
+        g->Clear();
+    }
+
+    ++g->counts[BucketIndex(us)];
+    if (g->count == 0 || us < g->min)
+        g->min = us;
+    if (us > g->max)
+        g->max = us;
+    ++g->count;
+    g->sum += us;
+
+    ++d.total;
+    d.last = us;
+}
+
+void GuideTiming::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        StageData& d = m_stages[i];
+        d.gen[0].Clear();
+        d.gen[1].Clear();
+        d.current = 0;
+        d.total = 0;
+        d.last = 0;
+    }
+}
+
+void GuideTiming::GetSummary(Stage stage, Summary *summary) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    const StageData& d = m_stages[stage];
+    const Generation& a = d.gen[0];
+    const Generation& b = d.gen[1];
+
+    memset(summary, 0, sizeof(*summary));
+    summary->total = d.total;
+    summary->count = a.count + b.count;
+    if (summary->count == 0)
+        return;
+
+    uint64_t minVal, maxVal;
+    if (a.count && b.count)
+    {
+        minVal = a.min < b.min ? a.min : b.min;
+        maxVal = a.max > b.max ? a.max : b.max;
+    }
+    else
+    {
+        const Generation& g = a.count ? a : b;
+        minVal = g.min;
+        maxVal = g.max;
+    }
+
+    static const double ptile[] = { 0.50, 0.90, 0.99 };
+    double *const dest[] = { &summary->p50, &summary->p90, &summary->p99 };
+    int next = 0;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < BUCKET_COUNT && next < 3; i++)
+    {
+        seen += a.counts[i] + b.counts[i];
+
+        // a percentile falls in the first bucket that reaches its rank
+        while (next < 3 && seen >= (uint64_t) ceil(ptile[next] * summary->count))
+        {
+            uint64_t v = BucketLowerBound(i) + BucketWidth(i) / 2;
+            if (v < minVal)
+                v = minVal;
+            if (v > maxVal)
+                v = maxVal;
+            *dest[next++] = v / 1000.0;
+        }
+    }
+
+    summary->min = minVal / 1000.0;
+    summary->max = maxVal / 1000.0;
+    summary->mean = (double) (a.sum + b.sum) / summary->count / 1000.0;
+    summary->last = d.last / 1000.0;
+}
+
+std::string GuideTiming::FormatSummary() const
+{
+    std::string s;
+
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        Summary sum;
+        GetSummary((Stage) i, &sum);
+        if (sum.count == 0)
+            continue;
+
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%-16s n=%u min=%.1f mean=%.1f p50=%.1f p90=%.1f p99=%.1f max=%.1f ms\n",
+                 StageName((Stage) i), sum.count, sum.min, sum.mean, sum.p50, sum.p90, sum.p99, sum.max);
+        s += buf;
+    }
+
+    return s;
+}
@@ -0,0 +1,186 @@
+/*
+ *  guide_timing.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GUIDE_TIMING_INCLUDED
+#define GUIDE_TIMING_INCLUDED
+
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+// Guide loop latency histograms
+//
+// Each stage of the guide loop records how long it took into a histogram of
+// microsecond values. Buckets are log-linear, as in an HDR histogram: values
+// below 16 us have their own bucket and every power of two above that is
+// split into 16 buckets, so a percentile read from the histogram is within
+// about 6% of the true value over the whole range.
+//
+// The histograms are rolling: once a stage has recorded WINDOW samples the
+// oldest generation is dropped, so the statistics cover the most recent
+// WINDOW to 2 * WINDOW samples of each stage. Recording takes a lock and
+// increments a counter; it can be done from any thread.
+class GuideTiming
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    enum Stage
+    {
+        STAGE_EXPOSURE_DELAY, // user exposure delay
+        STAGE_MOVE_WAIT, // pipelined guiding, waiting for the previous move to start
+        STAGE_CAPTURE, // camera exposure and download, including dark subtraction
+        STAGE_DARK_SUBTRACT,
+        STAGE_NOISE_REDUCTION,
+        STAGE_CALC_STATS,
+        STAGE_AUTO_FIND,
+        STAGE_STAR_FIND,
+        STAGE_REFINE, // multi-star refinement of the primary star offset
+        STAGE_GUIDE_STATE, // Guider::UpdateGuideState up to the image display
+        STAGE_DISPLAY,
+        STAGE_GUIDE_ALGORITHM,
+        STAGE_PULSE, // guide pulses issued by Mount::MoveOffset
+        STAGE_EVENT_NOTIFY, // GuideStep event
+        STAGE_FRAME_NOTIFY, // guide frame to the frame stream and frame ring
+        STAGE_COUNT
+    };
+
+    enum
+    {
+        WINDOW = 1000,
+        SUB_BUCKETS = 16,
+        MAX_EXPONENT = 38, // values are clamped to 2^38 us, about 76 hours
+        BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - 4) * SUB_BUCKETS,
+    };
+
+    // statistics of one stage, times in milliseconds
+    struct Summary
+    {
+        uint64_t total; // samples since the last Reset()
+        unsigned int count; // samples in the window
+        double min;
+        double mean;
+        double p50;
+        double p90;
+        double p99;
+        double max;
+        double last;
+    };
+
+    GuideTiming();
+
+    static const char *StageName(Stage stage);
+
+    void Record(Stage stage, Clock::duration elapsed);
+    void RecordMicroseconds(Stage stage, uint64_t us);
+    void Reset();
+
+    void GetSummary(Stage stage, Summary *summary) const;
+
+    // one line per stage that has samples
+    std::string FormatSummary() const;
+
+    static int BucketIndex(uint64_t us);
+    static uint64_t BucketLowerBound(int index);
+    static uint64_t BucketWidth(int index);
+
+private:
+    struct Generation
+    {
+        uint32_t counts[BUCKET_COUNT];
+        unsigned int count;
+        uint64_t sum;
+        uint64_t min;
+        uint64_t max;
+
+        void Clear();
+    };
+
+    struct StageData
+    {
+        Generation gen[2];
+        int current;
+        uint64_t total;
+        uint64_t last;
+    };
+
+    mutable std::mutex m_lock;
+    StageData m_stages[STAGE_COUNT];
+};
+
+extern GuideTiming GuideLoopTiming;
+
+// Records the time from construction to Stop() or destruction as one sample of a stage
+class TimingProbe
+{
+    GuideTiming::Stage m_stage;
+    GuideTiming::Clock::time_point m_start;
+    GuideTiming::Clock::duration m_elapsed;
+    bool m_enabled;
+    bool m_running;
+
+public:
+    // a probe that is not enabled records nothing, but still measures
+    explicit TimingProbe(GuideTiming::Stage stage, bool enabled = true)
+        : m_stage(stage), m_start(GuideTiming::Clock::now()), m_elapsed(0), m_enabled(enabled), m_running(true)
+    {
+    }
+    ~TimingProbe() { Stop(); }
+
+    void Stop()
+    {
+        if (m_running)
+        {
+            m_elapsed = GuideTiming::Clock::now() - m_start;
+            m_running = false;
+            if (m_enabled)
+                GuideLoopTiming.Record(m_stage, m_elapsed);
+        }
+    }
+
+    // drop the sample, for a stage that turned out not to run
+    void Cancel() { m_enabled = false; }
+
+    // milliseconds from construction to Stop(), or until now if still running
+    double Milliseconds() const
+    {
+        GuideTiming::Clock::duration d = m_running ? GuideTiming::Clock::now() - m_start : m_elapsed;
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    TimingProbe(const TimingProbe&) = delete;
+    TimingProbe& operator=(const TimingProbe&) = delete;
+};
+
+#endif // GUIDE_TIMING_INCLUDED
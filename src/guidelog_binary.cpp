@@ -0,0 +1,760 @@
+/*
+ *  guidelog_binary.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "guidelog_binary.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <string.h>
+
+// Fixed-point fields hold the value in units of the last digit written in the
+// text log. A value that rounds to zero but is printed with a minus sign is
+// flagged in negZero.
+enum
+{
+    STEP_TIME,
+    STEP_CAMERA_X,
+    STEP_CAMERA_Y,
+    STEP_MOUNT_X,
+    STEP_MOUNT_Y,
+    STEP_GUIDE_RA,
+    STEP_GUIDE_DEC,
+    STEP_MASS,
+    STEP_SNR,
+    STEP_FIXED_FIELDS
+};
+static const int STEP_PREC[STEP_FIXED_FIELDS] = { 3, 3, 3, 3, 3, 3, 3, 0, 2 };
+
+struct StepRecord
+{
+    int32_t fixed[STEP_FIXED_FIELDS];
+    int32_t frameNumber;
+    int32_t durationRA;
+    int32_t durationDec;
+    int32_t starError;
+    uint16_t negZero;
+    uint8_t flags;
+    char directionRA;
+    char directionDec;
+    uint8_t reserved[3];
+};
+
+enum
+{
+    DROP_TIME,
+    DROP_MASS,
+    DROP_SNR,
+    DROP_FIXED_FIELDS
+};
+static const int DROP_PREC[DROP_FIXED_FIELDS] = { 3, 0, 2 };
+
+struct DropRecord
+{
+    int32_t fixed[DROP_FIXED_FIELDS];
+    int32_t frameNumber;
+    int32_t starError;
+    uint16_t negZero;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(StepRecord) == 60, "StepRecord is a file record");
+static_assert(sizeof(DropRecord) == 24, "DropRecord is a file record");
+static_assert(sizeof(GuideLogIndexEntry) == 24, "GuideLogIndexEntry is a file record");
+static_assert(sizeof(GuideLogIndexHeader) == 16, "GuideLogIndexHeader is a file record");
+
+static const char FILE_MAGIC[8] = { 'P', 'H', 'D', '2', 'G', 'L', 'O', 'G' };
+static const char TRAILER_MAGIC[8] = { 'G', 'L', 'O', 'G', 'E', 'N', 'D', '1' };
+
+// The step lines are written for every frame, so they are formatted without
+// printf; the JSON number formatters produce the same text as printf.
+static void AppendField(std::string& line, int val)
+{
+    JsonAppendInt(line, val);
+    line += ',';
+}
+
+// Format a step line from a GuideLogStep or a StepRecord; fixed(i) appends
+// fixed-point field i.
+template<typename Step, typename Fixed>
+static void FormatStep(std::string& line, const Step& step, Fixed fixed)
+{
+    AppendField(line, step.frameNumber);
+    fixed(STEP_TIME);
+    line += (step.flags & GLOG_STEP_AO) ? ",\"AO\"," : ",\"Mount\",";
+    for (int i = STEP_CAMERA_X; i <= STEP_GUIDE_DEC; i++)
+    {
+        fixed(i);
+        line += ',';
+    }
+
+    if (step.flags & GLOG_STEP_AO)
+    {
+        line += ",,,,";
+        AppendField(line, step.durationRA);
+        AppendField(line, step.durationDec);
+    }
+    else
+    {
+        AppendField(line, step.durationRA);
+        if (step.directionRA)
+            line += step.directionRA;
+        line += ',';
+        AppendField(line, step.durationDec);
+        if (step.directionDec)
+            line += step.directionDec;
+        line += ",,,";
+    }
+
+    fixed(STEP_MASS);
+    line += ',';
+    fixed(STEP_SNR);
+    line += ',';
+    JsonAppendInt(line, step.starError);
+    line += '\n';
+}
+
+template<typename Drop, typename Fixed>
+static void FormatDrop(std::string& line, const Drop& drop, Fixed fixed, const char *status, size_t len)
+{
+    AppendField(line, drop.frameNumber);
+    fixed(DROP_TIME);
+    line += ",\"DROP\",,,,,,,,,,,,,";
+    fixed(DROP_MASS);
+    line += ',';
+    fixed(DROP_SNR);
+    line += ',';
+    AppendField(line, drop.starError);
+    line += '"';
+    line.append(status, len);
+    line += "\"\n";
+}
+
+static void StepValues(const GuideLogStep& step, double v[STEP_FIXED_FIELDS])
+{
+    v[STEP_TIME] = step.time;
+    v[STEP_CAMERA_X] = step.cameraX;
+    v[STEP_CAMERA_Y] = step.cameraY;
+    v[STEP_MOUNT_X] = step.mountX;
+    v[STEP_MOUNT_Y] = step.mountY;
+    v[STEP_GUIDE_RA] = step.guideDistanceRA;
+    v[STEP_GUIDE_DEC] = step.guideDistanceDec;
+    v[STEP_MASS] = step.starMass;
+    v[STEP_SNR] = step.starSNR;
+}
+
+static void DropValues(const GuideLogDrop& drop, double v[DROP_FIXED_FIELDS])
+{
+    v[DROP_TIME] = drop.time;
+    v[DROP_MASS] = drop.starMass;
+    v[DROP_SNR] = drop.starSNR;
+}
+
+void GuideLogFormatStep(std::string& line, const GuideLogStep& step)
+{
+    double v[STEP_FIXED_FIELDS];
+    StepValues(step, v);
+    FormatStep(line, step, [&](int i) { JsonAppendFixed(line, v[i], STEP_PREC[i]); });
+}
+
+void GuideLogFormatDrop(std::string& line, const GuideLogDrop& drop, const char *status, size_t len)
+{
+    double v[DROP_FIXED_FIELDS];
+    DropValues(drop, v);
+    FormatDrop(line, drop, [&](int i) { JsonAppendFixed(line, v[i], DROP_PREC[i]); }, status, len);
+}
+
+// Convert a value to fixed point from its text, so that the text can be
+// reproduced exactly. Fails for NaN, infinity and values that do not fit.
+static bool ToFixed(std::string& scratch, double v, int prec, int field, int32_t *fixed, uint16_t *negZero)
+{
+    scratch.clear();
+    JsonAppendFixed(scratch, v, prec);
+
+    const char *p = scratch.c_str();
+    bool neg = *p == '-';
+    if (neg)
+        ++p;
+
+    uint64_t n = 0;
+    int digits = 0;
+    for (; *p; ++p)
+    {
+        if (*p == '.')
+            continue;
+        if (*p < '0' || *p > '9' || ++digits > 10)
+            return false;
+        n = n * 10 + (uint64_t) (*p - '0');
+    }
+    if (digits == 0 || n > INT32_MAX)
+        return false;
+
+    *fixed = neg ? -(int32_t) n : (int32_t) n;
+    if (neg && n == 0)
+        *negZero |= (uint16_t) (1 << field);
+    return true;
+}
+
+static void AppendFixedPoint(std::string& line, int32_t fixed, bool negZero, int prec)
+{
+    static const uint32_t POW10[] = { 1, 10, 100, 1000 };
+
+    if (fixed < 0 || negZero)
+        line += '-';
+    uint32_t n = fixed < 0 ? 0u - (uint32_t) fixed : (uint32_t) fixed;
+    JsonAppendUInt(line, n / POW10[prec]);
+    if (prec > 0)
+    {
+        char digits[3];
+        uint32_t f = n % POW10[prec];
+        for (int i = prec - 1; i >= 0; i--)
+        {
+            digits[i] = (char) ('0' + f % 10);
+            f /= 10;
+        }
+        line += '.';
+        line.append(digits, prec);
+    }
+}
+
+static void PutU32(char *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static void AppendU32(std::string& buf, uint32_t v)
+{
+    buf.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static void AppendU64(std::string& buf, uint64_t v)
+{
+    buf.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static void AppendRecordHeader(std::string& buf, GuideLogRecordType type, size_t size)
+{
+    const char hdr[4] = { (char) type, 0, 0, 0 };
+    buf.append(hdr, sizeof(hdr));
+    AppendU32(buf, (uint32_t) size);
+}
+
+GuideLogBinaryEncoder::GuideLogBinaryEncoder()
+    : m_offset(0), m_segmentStart(0), m_prevIndex(GLOG_NO_INDEX), m_textRecord(std::string::npos)
+{
+}
+
+void GuideLogBinaryEncoder::StartFile(uint64_t textLogSize)
+{
+    m_buf.clear();
+    m_buf.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    AppendU32(m_buf, GUIDELOG_BINARY_VERSION);
+    AppendU32(m_buf, 0);
+    AppendU64(m_buf, textLogSize);
+
+    m_offset = m_buf.size();
+    m_segmentStart = m_offset;
+    m_prevIndex = GLOG_NO_INDEX;
+    m_textRecord = std::string::npos;
+    m_index.clear();
+}
+
+void GuideLogBinaryEncoder::ContinueFile(uint64_t fileSize, uint64_t prevIndex)
+{
+    m_buf.clear();
+    m_offset = fileSize;
+    m_segmentStart = fileSize;
+    m_prevIndex = prevIndex;
+    m_textRecord = std::string::npos;
+    m_index.clear();
+}
+
+void GuideLogBinaryEncoder::Record(GuideLogRecordType type, const void *data, size_t size)
+{
+    AppendRecordHeader(m_buf, type, size);
+    m_buf.append(static_cast<const char *>(data), size);
+    m_offset += GUIDELOG_BINARY_RECORD_HEADER_SIZE + size;
+    m_textRecord = std::string::npos;
+}
+
+void GuideLogBinaryEncoder::Text(const char *text, size_t len)
+{
+    if (len == 0)
+        return;
+
+    // consecutive text goes into one record
+    if (m_textRecord == std::string::npos)
+    {
+        m_textRecord = m_buf.size();
+        AppendRecordHeader(m_buf, GLOG_TEXT, 0);
+        m_offset += GUIDELOG_BINARY_RECORD_HEADER_SIZE;
+    }
+
+    m_buf.append(text, len);
+    m_offset += len;
+    PutU32(&m_buf[m_textRecord + 4], (uint32_t) (m_buf.size() - m_textRecord - GUIDELOG_BINARY_RECORD_HEADER_SIZE));
+}
+
+void GuideLogBinaryEncoder::Step(const GuideLogStep& step)
+{
+    StepRecord rec;
+    memset(&rec, 0, sizeof(rec));
+
+    double v[STEP_FIXED_FIELDS];
+    StepValues(step, v);
+    for (int i = 0; i < STEP_FIXED_FIELDS; i++)
+    {
+        if (!ToFixed(m_scratch, v[i], STEP_PREC[i], i, &rec.fixed[i], &rec.negZero))
+        {
+            m_scratch.clear();
+            GuideLogFormatStep(m_scratch, step);
+            Text(m_scratch.data(), m_scratch.size());
+            return;
+        }
+    }
+
+    rec.frameNumber = step.frameNumber;
+    rec.durationRA = step.durationRA;
+    rec.durationDec = step.durationDec;
+    rec.starError = step.starError;
+    rec.flags = (uint8_t) step.flags;
+    rec.directionRA = step.directionRA;
+    rec.directionDec = step.directionDec;
+
+    Record(GLOG_GUIDE_STEP, &rec, sizeof(rec));
+}
+
+void GuideLogBinaryEncoder::Drop(const GuideLogDrop& drop, const char *status, size_t len)
+{
+    DropRecord rec;
+    memset(&rec, 0, sizeof(rec));
+
+    double v[DROP_FIXED_FIELDS];
+    DropValues(drop, v);
+    for (int i = 0; i < DROP_FIXED_FIELDS; i++)
+    {
+        if (!ToFixed(m_scratch, v[i], DROP_PREC[i], i, &rec.fixed[i], &rec.negZero))
+        {
+            m_scratch.clear();
+            GuideLogFormatDrop(m_scratch, drop, status, len);
+            Text(m_scratch.data(), m_scratch.size());
+            return;
+        }
+    }
+
+    rec.frameNumber = drop.frameNumber;
+    rec.starError = drop.starError;
+
+    AppendRecordHeader(m_buf, GLOG_FRAME_DROPPED, sizeof(rec) + len);
+    m_buf.append(reinterpret_cast<const char *>(&rec), sizeof(rec));
+    m_buf.append(status, len);
+    m_offset += GUIDELOG_BINARY_RECORD_HEADER_SIZE + sizeof(rec) + len;
+    m_textRecord = std::string::npos;
+}
+
+void GuideLogBinaryEncoder::Mark(GuideLogMark mark, int64_t time)
+{
+    GuideLogIndexEntry e;
+    memset(&e, 0, sizeof(e));
+    e.time = time;
+    e.offset = m_offset;
+    e.mark = (uint8_t) mark;
+
+    Record(GLOG_MARK, &e, sizeof(e));
+    m_index.push_back(e);
+}
+
+void GuideLogBinaryEncoder::Finish()
+{
+    GuideLogIndexHeader hdr;
+    hdr.segmentStart = m_segmentStart;
+    hdr.prevIndex = m_prevIndex;
+
+    uint64_t indexOffset = m_offset;
+    size_t size = sizeof(hdr) + m_index.size() * sizeof(GuideLogIndexEntry) + GUIDELOG_BINARY_TRAILER_SIZE;
+
+    AppendRecordHeader(m_buf, GLOG_INDEX, size);
+    m_buf.append(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    if (!m_index.empty())
+        m_buf.append(reinterpret_cast<const char *>(m_index.data()), m_index.size() * sizeof(GuideLogIndexEntry));
+    AppendU64(m_buf, indexOffset);
+    m_buf.append(TRAILER_MAGIC, sizeof(TRAILER_MAGIC));
+
+    m_offset += GUIDELOG_BINARY_RECORD_HEADER_SIZE + size;
+    m_textRecord = std::string::npos;
+
+    // records appended after this start a new segment
+    m_segmentStart = m_offset;
+    m_prevIndex = indexOffset;
+    m_index.clear();
+}
+
+static bool Seek(FILE *fp, uint64_t pos)
+{
+#ifdef _MSC_VER
+    return _fseeki64(fp, (__int64) pos, SEEK_SET) == 0;
+#else
+    return fseeko(fp, (off_t) pos, SEEK_SET) == 0;
+#endif
+}
+
+static uint64_t FileSize(FILE *fp)
+{
+#ifdef _MSC_VER
+    if (_fseeki64(fp, 0, SEEK_END) != 0)
+        return 0;
+    __int64 size = _ftelli64(fp);
+#else
+    if (fseeko(fp, 0, SEEK_END) != 0)
+        return 0;
+    off_t size = ftello(fp);
+#endif
+    return size > 0 ? (uint64_t) size : 0;
+}
+
+static bool ReadAt(FILE *fp, uint64_t pos, void *buf, size_t size)
+{
+    return Seek(fp, pos) && fread(buf, 1, size, fp) == size;
+}
+
+static bool ReadRecordHeader(FILE *fp, uint8_t *type, uint32_t *size)
+{
+    char hdr[GUIDELOG_BINARY_RECORD_HEADER_SIZE];
+    if (fread(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+        return false;
+    *type = (uint8_t) hdr[0];
+    memcpy(size, hdr + 4, sizeof(*size));
+    return true;
+}
+
+// check the file header and position the file at the first record
+static bool ReadFileHeader(FILE *fp, uint64_t *textLogSize)
+{
+    char hdr[GUIDELOG_BINARY_HEADER_SIZE];
+    if (!ReadAt(fp, 0, hdr, sizeof(hdr)) || memcmp(hdr, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        return false;
+
+    uint32_t version;
+    memcpy(&version, hdr + 8, sizeof(version));
+    if (version != GUIDELOG_BINARY_VERSION)
+        return false;
+
+    memcpy(textLogSize, hdr + 16, sizeof(*textLogSize));
+    return true;
+}
+
+uint64_t GuideLogBinaryLastIndex(FILE *fp)
+{
+    uint64_t size = FileSize(fp);
+    const uint64_t minSize = GUIDELOG_BINARY_HEADER_SIZE + GUIDELOG_BINARY_RECORD_HEADER_SIZE + sizeof(GuideLogIndexHeader) +
+        GUIDELOG_BINARY_TRAILER_SIZE;
+    if (size < minSize)
+        return GLOG_NO_INDEX;
+
+    char trailer[GUIDELOG_BINARY_TRAILER_SIZE];
+    if (!ReadAt(fp, size - sizeof(trailer), trailer, sizeof(trailer)) ||
+        memcmp(trailer + 8, TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0)
+    {
+        return GLOG_NO_INDEX;
+    }
+
+    uint64_t offset;
+    memcpy(&offset, trailer, sizeof(offset));
+    if (offset < GUIDELOG_BINARY_HEADER_SIZE || offset + (minSize - GUIDELOG_BINARY_HEADER_SIZE) > size)
+        return GLOG_NO_INDEX;
+
+    // the index record must end at the end of the file
+    uint8_t type;
+    uint32_t recsize;
+    if (!Seek(fp, offset) || !ReadRecordHeader(fp, &type, &recsize) || type != GLOG_INDEX ||
+        offset + GUIDELOG_BINARY_RECORD_HEADER_SIZE + recsize != size)
+    {
+        return GLOG_NO_INDEX;
+    }
+
+    return offset;
+}
+
+// read the index chain ending at the given index record; fails if the chain
+// does not reach back to the first record
+static bool ReadIndexes(FILE *fp, uint64_t offset, std::vector<GuideLogIndexEntry> *marks)
+{
+    std::vector<std::vector<GuideLogIndexEntry>> segments;
+
+    while (true)
+    {
+        uint8_t type;
+        uint32_t size;
+        GuideLogIndexHeader hdr;
+        if (!Seek(fp, offset) || !ReadRecordHeader(fp, &type, &size) || type != GLOG_INDEX ||
+            size < sizeof(hdr) + GUIDELOG_BINARY_TRAILER_SIZE ||
+            (size - sizeof(hdr) - GUIDELOG_BINARY_TRAILER_SIZE) % sizeof(GuideLogIndexEntry) != 0 ||
+            fread(&hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+        {
+            return false;
+        }
+
+        segments.emplace_back((size - sizeof(hdr) - GUIDELOG_BINARY_TRAILER_SIZE) / sizeof(GuideLogIndexEntry));
+        std::vector<GuideLogIndexEntry>& entries = segments.back();
+        if (!entries.empty() &&
+            fread(entries.data(), sizeof(GuideLogIndexEntry), entries.size(), fp) != entries.size())
+        {
+            return false;
+        }
+
+        if (hdr.prevIndex == GLOG_NO_INDEX)
+        {
+            if (hdr.segmentStart != GUIDELOG_BINARY_HEADER_SIZE)
+                return false;
+            break;
+        }
+
+        // indexes are written in file order
+        if (hdr.prevIndex >= offset)
+            return false;
+        offset = hdr.prevIndex;
+    }
+
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+        marks->insert(marks->end(), it->begin(), it->end());
+
+    return true;
+}
+
+// Sequential reader for the records, reading the file in large blocks. A
+// record cut short at the end of the file by a crash ends the log.
+class RecordReader
+{
+    FILE *m_fp;
+    std::vector<char> m_buf;
+    size_t m_pos;
+    size_t m_end;
+
+    // make at least n bytes available in the buffer
+    bool Fill(size_t n)
+    {
+        if (m_end - m_pos >= n)
+            return true;
+        memmove(m_buf.data(), m_buf.data() + m_pos, m_end - m_pos);
+        m_end -= m_pos;
+        m_pos = 0;
+        m_end += fread(m_buf.data() + m_end, 1, m_buf.size() - m_end, m_fp);
+        return m_end >= n;
+    }
+
+public:
+    uint8_t type;
+    uint32_t size;
+
+    // the file must be positioned at the first record
+    RecordReader(FILE *fp) : m_fp(fp), m_buf(64 * 1024), m_pos(0), m_end(0), type(0), size(0) { }
+
+    bool Next()
+    {
+        if (!Fill(GUIDELOG_BINARY_RECORD_HEADER_SIZE))
+            return false;
+        type = (uint8_t) m_buf[m_pos];
+        memcpy(&size, &m_buf[m_pos + 4], sizeof(size));
+        m_pos += GUIDELOG_BINARY_RECORD_HEADER_SIZE;
+        return true;
+    }
+
+    // the payload of the current record
+    bool Read(std::string *payload)
+    {
+        payload->resize(size);
+        if (size == 0)
+            return true;
+
+        Fill(std::min((size_t) size, m_buf.size()));
+        size_t have = std::min((size_t) size, m_end - m_pos);
+        memcpy(&(*payload)[0], &m_buf[m_pos], have);
+        m_pos += have;
+        return have == size || fread(&(*payload)[have], 1, size - have, m_fp) == size - have;
+    }
+
+    bool Skip()
+    {
+        if (m_end - m_pos >= size)
+        {
+            m_pos += size;
+            return true;
+        }
+        uint64_t rest = size - (m_end - m_pos);
+        m_pos = m_end = 0;
+#ifdef _MSC_VER
+        return _fseeki64(m_fp, (__int64) rest, SEEK_CUR) == 0;
+#else
+        return fseeko(m_fp, (off_t) rest, SEEK_CUR) == 0;
+#endif
+    }
+};
+
+bool GuideLogBinaryReadMarks(FILE *fp, std::vector<GuideLogIndexEntry> *marks, uint64_t *textLogSize)
+{
+    marks->clear();
+
+    if (!ReadFileHeader(fp, textLogSize))
+        return false;
+
+    uint64_t lastIndex = GuideLogBinaryLastIndex(fp);
+    if (lastIndex != GLOG_NO_INDEX)
+    {
+        if (ReadIndexes(fp, lastIndex, marks))
+            return true;
+        marks->clear();
+    }
+
+    if (!Seek(fp, GUIDELOG_BINARY_HEADER_SIZE))
+        return false;
+
+    RecordReader rdr(fp);
+    std::string payload;
+
+    while (rdr.Next())
+    {
+        if (rdr.type == GLOG_MARK && rdr.size == sizeof(GuideLogIndexEntry))
+        {
+            if (!rdr.Read(&payload))
+                break;
+            GuideLogIndexEntry e;
+            memcpy(&e, payload.data(), sizeof(e));
+            marks->push_back(e);
+        }
+        else if (!rdr.Skip())
+            break;
+    }
+
+    return true;
+}
+
+bool GuideLogBinaryScan(FILE *fp, GuideLogBinarySummary *summary)
+{
+    std::vector<GuideLogIndexEntry> marks;
+    uint64_t textLogSize;
+
+    if (!GuideLogBinaryReadMarks(fp, &marks, &textLogSize) || textLogSize != 0)
+        return false;
+
+    summary->cal_cnt = 0;
+    summary->guide_cnt = 0;
+    summary->guide_dur = 0.;
+    summary->ga_cnt = 0;
+
+    bool guiding = false;
+    int64_t guidingStarts = 0;
+
+    for (const auto& e : marks)
+    {
+        switch (e.mark)
+        {
+        case GLOG_CALIBRATION_COMPLETE:
+            ++summary->cal_cnt;
+            break;
+        case GLOG_GUIDING_BEGINS:
+            guiding = true;
+            guidingStarts = e.time;
+            break;
+        case GLOG_GUIDING_ENDS:
+            if (guiding && e.time > guidingStarts)
+            {
+                ++summary->guide_cnt;
+                summary->guide_dur += (double) (e.time - guidingStarts);
+            }
+            guiding = false;
+            break;
+        case GLOG_GA_COMPLETE:
+            ++summary->ga_cnt;
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool GuideLogBinaryToText(FILE *in, FILE *out)
+{
+    uint64_t textLogSize;
+    if (!ReadFileHeader(in, &textLogSize))
+        return false;
+
+    enum
+    {
+        FLUSH_SIZE = 64 * 1024,
+    };
+
+    RecordReader rdr(in);
+    std::string payload;
+    std::string text;
+    text.reserve(FLUSH_SIZE + 1024);
+
+    while (rdr.Next())
+    {
+        if ((rdr.type == GLOG_GUIDE_STEP && rdr.size != sizeof(StepRecord)) ||
+            (rdr.type == GLOG_FRAME_DROPPED && rdr.size < sizeof(DropRecord)))
+        {
+            return false;
+        }
+
+        // marks and indexes have no text
+        bool hasText = rdr.type == GLOG_TEXT || rdr.type == GLOG_GUIDE_STEP || rdr.type == GLOG_FRAME_DROPPED;
+        if (!(hasText ? rdr.Read(&payload) : rdr.Skip()))
+            break;
+
+        if (rdr.type == GLOG_TEXT)
+            text += payload;
+        else if (rdr.type == GLOG_GUIDE_STEP)
+        {
+            StepRecord rec;
+            memcpy(&rec, payload.data(), sizeof(rec));
+            FormatStep(text, rec,
+                       [&](int i) { AppendFixedPoint(text, rec.fixed[i], (rec.negZero >> i) & 1, STEP_PREC[i]); });
+        }
+        else if (rdr.type == GLOG_FRAME_DROPPED)
+        {
+            DropRecord rec;
+            memcpy(&rec, payload.data(), sizeof(rec));
+            FormatDrop(
+                text, rec, [&](int i) { AppendFixedPoint(text, rec.fixed[i], (rec.negZero >> i) & 1, DROP_PREC[i]); },
+                payload.data() + sizeof(rec), payload.size() - sizeof(rec));
+        }
+
+        if (text.size() >= FLUSH_SIZE)
+        {
+            if (fwrite(text.data(), 1, text.size(), out) != text.size())
+                return false;
+            text.clear();
+        }
+    }
+
+    return fwrite(text.data(), 1, text.size(), out) == text.size() && fflush(out) == 0;
+}
@@ -0,0 +1,215 @@
+/*
+ *  guidelog_binary.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GUIDELOG_BINARY_INCLUDED
+#define GUIDELOG_BINARY_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Binary guide log
+//
+// An optional companion to the text guide log, PHD2_GuideLog_<timestamp>.bin,
+// holding the same content as records that can be skipped without parsing
+// them. Guide steps and dropped frames are fixed-size records whose values
+// are fixed-point integers at the precision of the text log, every other line
+// of the text log is kept as text, and the start and end of calibration and
+// guiding are recorded as marks. The text log can be reproduced exactly from
+// the records.
+//
+// File layout, in host byte order (little-endian on all supported platforms):
+//
+//   file header   "PHD2GLOG", uint32 version, uint32 reserved,
+//                 uint64 size of the text log when the binary log was started
+//   records       uint8 type, uint8[3] reserved, uint32 payload size, payload
+//   index         on close, a GLOG_INDEX record listing the marks written
+//                 since the log was opened; its payload ends with a trailer,
+//                 uint64 offset of the index record and "GLOGEND1", so the
+//                 trailer is the last 16 bytes of the file
+//
+// A log that is reopened is appended to only if it ends with a trailer, so
+// the indexes of a cleanly closed log form a chain back to the file header.
+
+enum
+{
+    GUIDELOG_BINARY_VERSION = 1,
+    GUIDELOG_BINARY_HEADER_SIZE = 24,
+    GUIDELOG_BINARY_RECORD_HEADER_SIZE = 8,
+    GUIDELOG_BINARY_TRAILER_SIZE = 16,
+};
+
+enum GuideLogRecordType
+{
+    GLOG_TEXT = 1, // text exactly as it appears in the text log
+    GLOG_GUIDE_STEP = 2, // fixed-point GuideLogStep
+    GLOG_FRAME_DROPPED = 3, // fixed-point GuideLogDrop followed by the status text
+    GLOG_MARK = 4, // GuideLogIndexEntry
+    GLOG_INDEX = 5, // GuideLogIndexHeader, GuideLogIndexEntry[], trailer
+};
+
+enum GuideLogMark
+{
+    GLOG_CALIBRATION_BEGINS = 1,
+    GLOG_CALIBRATION_COMPLETE = 2,
+    GLOG_CALIBRATION_FAILED = 3,
+    GLOG_GUIDING_BEGINS = 4,
+    GLOG_GUIDING_ENDS = 5,
+    GLOG_GA_COMPLETE = 6,
+};
+
+enum
+{
+    GLOG_STEP_AO = 1 << 0, // durations are AO steps, negative for left/down
+};
+
+// a guide step; the text log line is made from these fields
+struct GuideLogStep
+{
+    double time;
+    double cameraX;
+    double cameraY;
+    double mountX;
+    double mountY;
+    double guideDistanceRA;
+    double guideDistanceDec;
+    double starMass;
+    double starSNR;
+    int frameNumber;
+    int durationRA;
+    int durationDec;
+    int starError;
+    unsigned int flags;
+    char directionRA; // direction character, 0 when there was no pulse
+    char directionDec;
+};
+
+struct GuideLogDrop
+{
+    double time;
+    double starMass;
+    double starSNR;
+    int frameNumber;
+    int starError;
+};
+
+struct GuideLogIndexEntry
+{
+    int64_t time; // seconds since the epoch
+    uint64_t offset; // file offset of the mark record
+    uint8_t mark;
+    uint8_t reserved[7];
+};
+
+struct GuideLogIndexHeader
+{
+    uint64_t segmentStart; // file offset of the first record covered by the index
+    uint64_t prevIndex; // file offset of the previous index record, or GLOG_NO_INDEX
+};
+
+const uint64_t GLOG_NO_INDEX = ~(uint64_t) 0;
+
+// Append the text log line for a guide step or a dropped frame, including the
+// newline.
+void GuideLogFormatStep(std::string& line, const GuideLogStep& step);
+void GuideLogFormatDrop(std::string& line, const GuideLogDrop& drop, const char *status, size_t len);
+
+// Encodes records into a buffer that the owner writes to the end of the file.
+// The encoder tracks the file offset of the records for the index.
+class GuideLogBinaryEncoder
+{
+    std::string m_buf;
+    uint64_t m_offset; // file offset of the end of m_buf
+    uint64_t m_segmentStart;
+    uint64_t m_prevIndex;
+    size_t m_textRecord; // position in m_buf of a text record that can be extended
+    std::vector<GuideLogIndexEntry> m_index;
+    std::string m_scratch;
+
+    void Record(GuideLogRecordType type, const void *data, size_t size);
+
+public:
+    GuideLogBinaryEncoder();
+
+    // Start a new file, writing the header, or continue a file of fileSize
+    // bytes whose last index record is at prevIndex.
+    void StartFile(uint64_t textLogSize);
+    void ContinueFile(uint64_t fileSize, uint64_t prevIndex);
+
+    void Text(const char *text, size_t len);
+    // steps and dropped frames with values too large for the fixed-point
+    // fields are written as text
+    void Step(const GuideLogStep& step);
+    void Drop(const GuideLogDrop& drop, const char *status, size_t len);
+    void Mark(GuideLogMark mark, int64_t time);
+    // write the index and the trailer
+    void Finish();
+
+    size_t BufferedSize() const { return m_buf.size(); }
+    // the encoded bytes waiting to be written; the owner swaps them out
+    std::string& Buffer()
+    {
+        m_textRecord = std::string::npos;
+        return m_buf;
+    }
+};
+
+// Return the offset of the last index record of a cleanly closed binary log,
+// or GLOG_NO_INDEX if the file does not end with a trailer.
+uint64_t GuideLogBinaryLastIndex(FILE *fp);
+
+struct GuideLogBinarySummary
+{
+    unsigned int cal_cnt;
+    unsigned int guide_cnt;
+    double guide_dur; // seconds
+    unsigned int ga_cnt;
+};
+
+// Read the marks of a binary guide log, from the indexes if the log was closed
+// cleanly and from the records otherwise. Returns false if the file is not a
+// binary guide log.
+bool GuideLogBinaryReadMarks(FILE *fp, std::vector<GuideLogIndexEntry> *marks, uint64_t *textLogSize);
+
+// Summarize the calibration and guiding in a binary guide log. Returns false
+// if the file is not a binary guide log or does not cover the whole text log.
+bool GuideLogBinaryScan(FILE *fp, GuideLogBinarySummary *summary);
+
+// Write the text log contained in a binary guide log. The conversion streams,
+// so logs of any size can be converted. Returns false if the input is not a
+// binary guide log or cannot be read, or the output cannot be written.
+bool GuideLogBinaryToText(FILE *in, FILE *out);
+
+#endif // GUIDELOG_BINARY_INCLUDED
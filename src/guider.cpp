@@ -37,6 +37,8 @@
 #include "polardrift_tool.h"
 #include "staticpa_tool.h"
 #include "guiding_assistant.h"
+#include "shm_frame_ring_integration.h"
+#include "display_kernels.h"
 
 // un-comment to log star deflections to a file
 // #define CAPTURE_DEFLECTIONS
@@ -105,6 +107,7 @@ wxBEGIN_EVENT_TABLE(Guider, wxWindow)
 EVT_PAINT(Guider::OnPaint)
 EVT_CLOSE(Guider::OnClose)
 EVT_ERASE_BACKGROUND(Guider::OnErase)
+EVT_TIMER(wxID_ANY, Guider::OnLostStarFlashTimer)
 wxEND_EVENT_TABLE();
 // clang-format on
 
@@ -168,6 +171,10 @@ Guider::Guider(wxWindow *parent, int xSize, int ySize)
     m_scaleFactor = 1.0;
     m_showBookmarks = true;
     m_displayedImage = new wxImage(XWinSize, YWinSize, true);
+    m_displayLutBlack = 0;
+    m_displayLutWhite = 0;
+    m_displayLutGamma = 0.0;
+    m_displayImageChanged = true;
     m_paused = PAUSE_NONE;
     m_starFoundTimestamp = 0;
     m_avgDistanceNeedReset = false;
@@ -182,6 +189,7 @@ Guider::Guider(wxWindow *parent, int xSize, int ySize)
     m_measurementMode = false;
     m_searchRegion = 0;
     m_pCurrentImage = new usImage(); // so we always have one
+    m_lostStarFlashTimer.SetOwner(this);
 
     SetOverlayMode(DefaultOverlayMode);
 
@@ -209,7 +217,7 @@ Guider::Guider(wxWindow *parent, int xSize, int ySize)
 Guider::~Guider()
 {
     delete m_displayedImage;
-    delete m_pCurrentImage;
+    ImagePool::Release(m_pCurrentImage);
 
     s_deflectionLogger.Uninit();
 }
@@ -247,6 +255,8 @@ void Guider::LoadProfileSettings()
     {
         delete m_displayedImage;
         m_displayedImage = new wxImage(XWinSize, YWinSize, true);
+        m_displaySourceSize = wxSize();
+        m_displayImageChanged = true;
         DisplayImage(new usImage());
     }
 }
@@ -441,24 +451,25 @@ void Guider::OnClose(wxCloseEvent& evt)
     Destroy();
 }
 
-bool Guider::PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC)
+void Guider::RenderDisplay()
 {
-    bool bError = false;
+    const usImage *img = m_pCurrentImage;
 
-    try
-    {
-        GUIDER_STATE state = GetState();
-        GetSize(&XWinSize, &YWinSize);
+    int const winWidth = wxMax(XWinSize, 1);
+    int const winHeight = wxMax(YWinSize, 1);
+    bool full = !m_displayBitmap.IsOk() || m_displayBitmap.GetWidth() != winWidth || m_displayBitmap.GetHeight() != winHeight;
 
-        if (m_pCurrentImage->ImageData)
-        {
-            int blevel = m_pCurrentImage->FiltMin;
-            int wlevel = m_pCurrentImage->FiltMax;
-            m_pCurrentImage->CopyToImage(&m_displayedImage, blevel, wlevel, pFrame->Stretch_gamma);
-        }
+    // the part of the display image that must be converted again
+    wxRect dirty;
+
+    if (img->ImageData)
+    {
+        int imageWidth = img->Size.GetWidth();
+        int imageHeight = img->Size.GetHeight();
+        int newWidth = imageWidth;
+        int newHeight = imageHeight;
 
-        int imageWidth = m_displayedImage->GetWidth();
-        int imageHeight = m_displayedImage->GetHeight();
+        m_scaleFactor = 1.0;
 
         // scale the image if necessary
 
@@ -467,15 +478,9 @@ bool Guider::PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC)
             // The image is not the exact right size -- figure out what to do.
             double xScaleFactor = imageWidth / (double) XWinSize;
             double yScaleFactor = imageHeight / (double) YWinSize;
-            int newWidth = imageWidth;
-            int newHeight = imageHeight;
 
             double newScaleFactor = (xScaleFactor > yScaleFactor) ? xScaleFactor : yScaleFactor;
 
-            //            Debug.Write(wxString::Format("xScaleFactor=%.2f, yScaleFactor=%.2f, newScaleFactor=%.2f\n",
-            //            xScaleFactor,
-            //                    yScaleFactor, newScaleFactor));
-
             // we rescale the image if:
             // - The image is either too big
             // - The image is so small that at least one dimension is less
@@ -484,37 +489,99 @@ bool Guider::PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC)
 
             if (xScaleFactor > 1.0 || yScaleFactor > 1.0 || xScaleFactor < 0.45 || yScaleFactor < 0.45 || m_scaleImage)
             {
-
                 newWidth /= newScaleFactor;
                 newHeight /= newScaleFactor;
+                m_scaleFactor = 1.0 / newScaleFactor;
+            }
+        }
 
-                newScaleFactor = 1.0 / newScaleFactor;
+        newWidth = wxMax(newWidth, 1);
+        newHeight = wxMax(newHeight, 1);
 
-                m_scaleFactor = newScaleFactor;
+        if (m_displayedImage->GetWidth() != newWidth || m_displayedImage->GetHeight() != newHeight ||
+            m_displaySourceSize != img->Size)
+        {
+            delete m_displayedImage;
+            m_displayedImage = new wxImage(newWidth, newHeight, false);
+            full = true;
+        }
 
-                if (imageWidth != newWidth || imageHeight != newHeight)
-                {
-                    //                    Debug.Write(wxString::Format("Resizing image to %d,%d\n", newWidth, newHeight));
+        int blevel = img->FiltMin;
+        int wlevel = img->FiltMax;
+        double gamma = pFrame->Stretch_gamma;
+        bool lutChanged = m_displayLut.empty() || blevel != m_displayLutBlack || wlevel != m_displayLutWhite ||
+            gamma != m_displayLutGamma;
+        if (lutChanged)
+        {
+            m_displayLut.resize(DISPLAY_LUT_SIZE);
+            DisplayBuildLut(&m_displayLut[0], blevel, wlevel, gamma);
+            m_displayLutBlack = blevel;
+            m_displayLutWhite = wlevel;
+            m_displayLutGamma = gamma;
+        }
 
-                    if (newWidth > 0 && newHeight > 0)
-                    {
-                        m_displayedImage->Rescale(newWidth, newHeight, wxIMAGE_QUALITY_BILINEAR);
-                    }
-                }
-            }
-            else
-            {
-                m_scaleFactor = 1.0;
-            }
+        // Outside of the subframe the frame is black whatever the stretch, so
+        // a new subframe only changes the display within itself and the
+        // previous subframe
+        wxRect changed;
+        if (full)
+            changed = wxRect(img->Size);
+        else if (m_displayImageChanged)
+            changed = img->Subframe.IsEmpty() || m_displaySubframe.IsEmpty() ? wxRect(img->Size)
+                                                                              : img->Subframe.Union(m_displaySubframe);
+        else if (lutChanged)
+            changed = img->Subframe.IsEmpty() ? wxRect(img->Size) : img->Subframe;
+
+        m_displaySubframe = img->Subframe;
+        m_displaySourceSize = img->Size;
+
+        if (!changed.IsEmpty())
+        {
+            int x0, y0, x1, y1;
+            DisplayDirtyRect(&x0, &y0, &x1, &y1, newWidth, newHeight, imageWidth, imageHeight, changed.GetLeft(),
+                             changed.GetTop(), changed.GetRight() + 1, changed.GetBottom() + 1);
+            DisplayRender(m_displayedImage->GetData(), newWidth, newHeight, img->ImageData, imageWidth, imageHeight,
+                          &m_displayLut[0], x0, y0, x1, y1);
+            dirty = wxRect(x0, y0, x1 - x0, y1 - y0);
         }
+    }
+    else if (m_displayImageChanged)
+    {
+        // no frame, show the blank display image as it is
+        full = true;
+    }
+
+    m_displayImageChanged = false;
+
+    if (full)
+    {
+        m_displayBitmap.Create(winWidth, winHeight);
+        wxMemoryDC memDC(m_displayBitmap);
+        memDC.SetBackground(*wxBLACK_BRUSH);
+        memDC.Clear();
+        memDC.DrawBitmap(wxBitmap(*m_displayedImage), 0, 0);
+    }
+    else if (!dirty.IsEmpty())
+    {
+        wxMemoryDC memDC(m_displayBitmap);
+        memDC.DrawBitmap(wxBitmap(m_displayedImage->GetSubImage(dirty)), dirty.GetLeft(), dirty.GetTop());
+    }
+}
+
+bool Guider::PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC)
+{
+    bool bError = false;
+
+    try
+    {
+        GUIDER_STATE state = GetState();
+        GetSize(&XWinSize, &YWinSize);
 
-        // important to provide explicit color for r,g,b, optional args to Size().
-        // If default args are provided wxWidgets performs some expensive histogram
-        // operations.
-        wxBitmap DisplayedBitmap(m_displayedImage->Size(wxSize(XWinSize, YWinSize), wxPoint(0, 0), 0, 0, 0));
-        memDC.SelectObject(DisplayedBitmap);
+        RenderDisplay();
 
-        dc.Blit(0, 0, DisplayedBitmap.GetWidth(), DisplayedBitmap.GetHeight(), &memDC, 0, 0, wxCOPY, false);
+        memDC.SelectObject(m_displayBitmap);
+        dc.Blit(0, 0, m_displayBitmap.GetWidth(), m_displayBitmap.GetHeight(), &memDC, 0, 0, wxCOPY, false);
+        memDC.SelectObject(wxNullBitmap);
 
         int XImgSize = m_displayedImage->GetWidth();
         int YImgSize = m_displayedImage->GetHeight();
@@ -733,6 +800,12 @@ bool Guider::PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC)
     return bError;
 }
 
+void Guider::OnLostStarFlashTimer(wxTimerEvent& evt)
+{
+    SetBackgroundColour(m_lostStarFlashPrevColor);
+    Refresh();
+}
+
 void Guider::UpdateImageDisplay(usImage *pImage)
 {
     if (!pImage)
@@ -740,6 +813,12 @@ void Guider::UpdateImageDisplay(usImage *pImage)
         pImage = m_pCurrentImage;
     }
 
+    m_displayImageChanged = true;
+
+    // in headless mode the image is only rendered when a paint is requested
+    if (pFrame->IsHeadless())
+        return;
+
     Debug.Write(
         wxString::Format("UpdateImageDisplay: Size=(%d,%d) min=%u, max=%u, med=%u, FiltMin=%u, FiltMax=%u, Gamma=%.3f\n",
                          pImage->Size.x, pImage->Size.y, pImage->MinADU, pImage->MaxADU, pImage->MedianADU, pImage->FiltMin,
@@ -1260,6 +1339,28 @@ inline static bool IsLoopingState(GUIDER_STATE state)
     return false;
 }
 
+// With pipelined guiding the exposure overlaps the guide pulse for the previous frame. A
+// frame that arrives while that pulse is still running, or that was mostly exposed during
+// it, does not show the full effect of the last correction. No guide pulse is issued for
+// it, but the frame is still logged and graphed as a guide step with no correction.
+static bool MoveOverlapsFrame(const usImage *pImage)
+{
+    if (pMount && pMount->IsBusy())
+    {
+        Debug.Write(wxString::Format("frame %u arrived during a move, no guide move\n", pImage->FrameNum));
+        return true;
+    }
+
+    if (pImage->ImgExpDur > 0 && pImage->MoveOverlap * 2 > (unsigned int) pImage->ImgExpDur)
+    {
+        Debug.Write(wxString::Format("frame %u overlapped a move for %u of %d ms, no guide move\n", pImage->FrameNum,
+                                     pImage->MoveOverlap, pImage->ImgExpDur));
+        return true;
+    }
+
+    return false;
+}
+
 /*************  A new image is ready ************************/
 
 void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
@@ -1267,6 +1368,10 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
     wxString statusMessage;
     bool someException = false;
 
+    // time spent in each step of the guide loop, reported when we exit
+    double findTime = 0.0;
+    TimingProbe stateProbe(GuideTiming::STAGE_GUIDE_STATE, !bStopping);
+
     try
     {
         Debug.Write(wxString::Format("UpdateGuideState(): m_state=%d\n", m_state));
@@ -1295,7 +1400,7 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
             throw THROW_INFO("Stopped Guiding");
         }
 
-        assert(!pMount || !pMount->IsBusy());
+        assert(!pMount || !pMount->IsBusy() || pFrame->GetPipelinedGuiding());
 
         // shift lock position
         if (LockPosShiftEnabled() && IsGuiding())
@@ -1312,7 +1417,12 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
         GuiderOffset ofs;
         FrameDroppedInfo info;
 
-        if (UpdateCurrentPosition(pImage, &ofs, &info)) // true means error
+        TimingProbe findProbe(GuideTiming::STAGE_STAR_FIND);
+        bool posError = UpdateCurrentPosition(pImage, &ofs, &info); // true means error
+        findProbe.Stop();
+        findTime = findProbe.Milliseconds();
+
+        if (posError)
         {
             info.frameNumber = pImage->FrameNum;
             info.time = pFrame->TimeSinceGuidingStarted();
@@ -1350,15 +1460,20 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
 
                 // allow guide algorithms to attempt dead reckoning
                 static GuiderOffset ZERO_OFS;
-                pFrame->SchedulePrimaryMove(pMount, ZERO_OFS, MOVEOPTS_DEDUCED_MOVE);
+                if (!MoveOverlapsFrame(pImage))
+                    pFrame->SchedulePrimaryMove(pMount, ZERO_OFS, MOVEOPTS_DEDUCED_MOVE);
 
-                wxColor prevColor = GetBackgroundColour();
-                SetBackgroundColour(wxColour(64, 0, 0));
-                ClearBackground();
+                // flash the background; the timer restores it so the next exposure is not held up
+                if (!pFrame->IsHeadless())
+                {
+                    if (!m_lostStarFlashTimer.IsRunning())
+                        m_lostStarFlashPrevColor = GetBackgroundColour();
+                    SetBackgroundColour(wxColour(64, 0, 0));
+                    ClearBackground();
+                    m_lostStarFlashTimer.StartOnce(100);
+                }
                 if (pFrame->GetBeepForLostStar())
                     wxBell();
-                wxMilliSleep(100);
-                SetBackgroundColour(prevColor);
                 break;
             }
 
@@ -1385,7 +1500,7 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
 
         if (IsPaused())
         {
-            if (m_state == STATE_GUIDING)
+            if (m_state == STATE_GUIDING && !MoveOverlapsFrame(pImage))
             {
                 // allow guide algorithms to attempt dead reckoning
                 static GuiderOffset ZERO_OFS;
@@ -1518,6 +1633,11 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
             {
                 GuidingAssistant::NotifyBacklashStep(CurrentPosition());
             }
+            else if (MoveOverlapsFrame(pImage))
+            {
+                s_deflectionLogger.Log(CurrentPosition());
+                pFrame->SchedulePrimaryMove(pMount, ofs, MOVEOPTS_OVERLAPPED_STEP);
+            }
             else
             {
                 // ordinary guide step
@@ -1550,10 +1670,27 @@ void Guider::UpdateGuideState(usImage *pImage, bool bStopping)
     }
 
     pFrame->UpdateButtonsStatus();
+    stateProbe.Stop();
 
+    TimingProbe displayProbe(GuideTiming::STAGE_DISPLAY);
     UpdateImageDisplay(pImage);
+    displayProbe.Stop();
 
-    Debug.AddLine("UpdateGuideState exits: " + statusMessage);
+    TimingProbe notifyProbe(GuideTiming::STAGE_FRAME_NOTIFY, !bStopping);
+    EvtServer.NotifyGuideFrame(pImage);
+    FrameRingSHMManager::PublishFrame(pImage, this);
+    notifyProbe.Stop();
+
+    Debug.AddLine(wxString::Format("UpdateGuideState exits: %s (find %.0f ms, guide %.0f ms, display %.0f ms, notify %.0f ms)",
+                                   statusMessage, findTime, stateProbe.Milliseconds() - findTime,
+                                   displayProbe.Milliseconds(), notifyProbe.Milliseconds()));
+}
+
+void Guider::GetStarPositions(std::vector<PHD_Point> *positions) const
+{
+    positions->clear();
+    if (PrimaryStar().WasFound())
+        positions->push_back(PrimaryStar());
 }
 
 bool Guider::ShiftLockPosition()
@@ -1733,6 +1870,7 @@ void Guider::GuiderConfigDialogPane::LayoutControls(Guider *pGuider, BrainCtrlId
     CondAddCtrl(pSharedSizer, CtrlMap, AD_cbReverseDecOnFlip);
     CondAddCtrl(pSharedSizer, CtrlMap, AD_cbEnableGuiding, wxSizerFlags(0).Border(wxLEFT, 35));
     CondAddCtrl(pSharedSizer, CtrlMap, AD_cbSlewDetection);
+    CondAddCtrl(pSharedSizer, CtrlMap, AD_cbConcurrentPulses, wxSizerFlags(0).Border(wxLEFT, 35));
     pShared->Add(pSharedSizer, def_flags);
     pShared->Layout();
 
@@ -137,6 +137,16 @@ struct GuiderOffset
 class Guider : public wxWindow
 {
     wxImage *m_displayedImage;
+    // The display image rendered at the window size. Only the parts of the
+    // display that changed since the last paint are converted again.
+    wxBitmap m_displayBitmap;
+    std::vector<unsigned char> m_displayLut;
+    int m_displayLutBlack;
+    int m_displayLutWhite;
+    double m_displayLutGamma;
+    bool m_displayImageChanged; // a new frame or stretch was set by UpdateImageDisplay()
+    wxSize m_displaySourceSize; // size of the last rendered frame
+    wxRect m_displaySubframe; // subframe of the last rendered frame
     OVERLAY_MODE m_overlayMode;
     OverlaySlitCoords m_overlaySlitCoords;
     const DefectMap *m_defectMapPreview;
@@ -168,6 +178,8 @@ class Guider : public wxWindow
     double m_maxStarHFD;
     bool m_userMultiStarMode;
     unsigned int m_autoSelDownsample; // downsample factor for star auto-selection, 0=Auto
+    wxTimer m_lostStarFlashTimer; // restores the background color after the lost star flash
+    wxColour m_lostStarFlashPrevColor;
 
 protected:
     int m_searchRegion; // how far u/d/l/r do we do the initial search for a star
@@ -203,6 +215,7 @@ protected:
     virtual ~Guider();
 
     bool PaintHelper(wxAutoBufferedPaintDCBase& dc, wxMemoryDC& memDC);
+    void RenderDisplay();
     void SetState(GUIDER_STATE newState);
     void UpdateCurrentDistance(double distance, double distanceRA);
 
@@ -220,6 +233,7 @@ public:
     bool IsGuiding() const;
     void OnClose(wxCloseEvent& evt);
     void OnErase(wxEraseEvent& evt);
+    void OnLostStarFlashTimer(wxTimerEvent& evt);
     void UpdateImageDisplay(usImage *pImage = nullptr);
 
     bool MoveLockPosition(const PHD_Point& mountDelta);
@@ -315,6 +329,7 @@ public:
     virtual bool GetMultiStarMode() const { return false; }
     virtual void SetMultiStarMode(bool On) {};
     virtual wxString GetStarCount() const { return wxEmptyString; }
+    virtual void GetStarPositions(std::vector<PHD_Point> *positions) const;
 
     usImage *CurrentImage() const;
     wxImage *DisplayedImage() const;
@@ -42,6 +42,8 @@
 
 #include "phd.h"
 
+#include "guide_kernels.h"
+
 #include <wx/dir.h>
 #include <algorithm>
 
@@ -202,7 +204,7 @@ wxEND_EVENT_TABLE();
 GuiderMultiStar::GuiderMultiStar(wxWindow *parent)
     : Guider(parent, XWinSize, YWinSize), m_massChecker(new MassChecker()), m_stabilizing(false), m_multiStarMode(true),
       m_lastPrimaryDistance(0), m_lockPositionMoved(false), m_maxStars(DEFAULT_MAX_STAR_COUNT),
-      m_stabilitySigmaX(DEFAULT_STABILITY_SIGMAX), m_lastStarsUsed(0)
+      m_refineTimeBudget(0), m_refineStart(1), m_stabilitySigmaX(DEFAULT_STABILITY_SIGMAX), m_lastStarsUsed(0)
 {
     SetState(STATE_UNINITIALIZED);
     m_primaryDistStats = new DescriptiveStats();
@@ -274,6 +276,9 @@ void GuiderMultiStar::LoadProfileSettings()
     int searchRegion = pConfig->Profile.GetInt("/guider/onestar/SearchRegion", DEFAULT_SEARCH_REGION);
     SetSearchRegion(searchRegion);
 
+    SetMaxStars(pConfig->Profile.GetInt("/guider/multistar/MaxStars", DEFAULT_MAX_STAR_COUNT));
+    SetRefineTimeBudget(pConfig->Profile.GetInt("/guider/multistar/RefineTimeBudget", 0));
+
     SetMultiStarMode(pConfig->Profile.GetBoolean("/guider/multistar/enabled", false));
 }
 
@@ -359,6 +364,45 @@ bool GuiderMultiStar::SetSearchRegion(int searchRegion)
     return bError;
 }
 
+// maximum number of stars, including the primary star, used to refine the guide offset
+bool GuiderMultiStar::SetMaxStars(int maxStars)
+{
+    bool bError = false;
+
+    try
+    {
+        if (maxStars < 1)
+        {
+            m_maxStars = 1;
+            throw ERROR_INFO("maxStars < 1");
+        }
+        else if (maxStars > MAX_LIST_SIZE)
+        {
+            m_maxStars = MAX_LIST_SIZE;
+            throw ERROR_INFO("maxStars > MAX_LIST_SIZE");
+        }
+        m_maxStars = maxStars;
+    }
+    catch (const wxString& Msg)
+    {
+        POSSIBLY_UNUSED(Msg);
+        bError = true;
+    }
+
+    pConfig->Profile.SetInt("/guider/multistar/MaxStars", m_maxStars);
+
+    return bError;
+}
+
+// Time allowed for finding the secondary stars in each frame. Stars not
+// reached in time are skipped for that frame and searched first in the next
+// one; 0 means no limit.
+void GuiderMultiStar::SetRefineTimeBudget(int ms)
+{
+    m_refineTimeBudget = wxMax(ms, 0);
+    pConfig->Profile.SetInt("/guider/multistar/RefineTimeBudget", m_refineTimeBudget);
+}
+
 bool GuiderMultiStar::SetCurrentPosition(const usImage *pImage, const PHD_Point& position)
 {
     bool bError = true;
@@ -710,6 +754,20 @@ wxString GuiderMultiStar::GetStarCount() const
                             static_cast<unsigned int>(m_guideStars.size()));
 }
 
+void GuiderMultiStar::GetStarPositions(std::vector<PHD_Point> *positions) const
+{
+    Guider::GetStarPositions(positions);
+
+    if (!m_multiStarMode || m_guideStars.size() < 2 || !m_primaryStar.WasFound())
+        return;
+
+    for (auto it = m_guideStars.begin() + 1; it != m_guideStars.end() && positions->size() < m_maxStars; ++it)
+    {
+        if (it->WasFound())
+            positions->push_back(*it);
+    }
+}
+
 // Private method to build compact logging string for how secondary stars were used
 static void AppendStarUse(wxString& secondaryInfo, int starNum, double dX, double dY, double weight, const wxString& flag)
 {
@@ -720,42 +778,39 @@ static void AppendStarUse(wxString& secondaryInfo, int starNum, double dX, doubl
 bool GuiderMultiStar::RefineOffset(const usImage *pImage, GuiderOffset *pOffset)
 {
     double primaryDistance;
-    double secondaryDistance;
     double primarySigma = 0;
-    bool averaged = false;
-    int validStars = 0;
     GuiderOffset origOffset = *pOffset;
     m_starsUsed = 1;
-    bool erasures = false;
     bool refined = false;
+    TimingProbe probe(GuideTiming::STAGE_REFINE, m_guideStars.size() > 1);
 
     // Primary star is in position 0 of the list
     try
     {
         if (IsGuiding() && m_guideStars.size() > 1 && pMount->GetGuidingEnabled() && !PhdController::IsSettling())
         {
-            double sumWeights = 1;
-            double sumX = origOffset.cameraOfs.X;
-            double sumY = origOffset.cameraOfs.Y;
-            primaryDistance = hypot(sumX, sumY);
+            primaryDistance = hypot(origOffset.cameraOfs.X, origOffset.cameraOfs.Y);
 
             m_primaryDistStats->AddValue(primaryDistance);
 
 #define Iter_Inx(p) (p - m_guideStars.begin())
 
-            if (m_primaryDistStats->GetCount() > 5)
-            {
+            unsigned int count = m_primaryDistStats->GetCount();
+            if (count > 5)
                 primarySigma = m_primaryDistStats->GetSigma();
-                if (!m_stabilizing && primaryDistance > m_stabilitySigmaX * primarySigma)
+            bool wasStabilizing = m_stabilizing;
+            m_stabilizing = MultiStarStabilizing(m_stabilizing, count, primaryDistance, primarySigma, m_stabilitySigmaX);
+
+            if (count > 5)
+            {
+                if (!wasStabilizing && m_stabilizing)
                 {
-                    m_stabilizing = true;
                     Debug.Write("MultiStar: large primary error, entering stabilization period\n");
                 }
-                else if (m_stabilizing)
+                else if (wasStabilizing)
                 {
-                    if (primaryDistance <= 2 * primarySigma)
+                    if (!m_stabilizing)
                     {
-                        m_stabilizing = false;
                         Debug.Write("MultiStar: exiting stabilization period\n");
                         if (m_lockPositionMoved)
                         {
@@ -793,110 +848,127 @@ bool GuiderMultiStar::RefineOffset(const usImage *pImage, GuiderOffset *pOffset)
                     }
                 }
             }
-            else
-                m_stabilizing = true; // get some data for primary star movement
 
-            if (!m_stabilizing && m_guideStars.size() > 1 && (sumX != 0 || sumY != 0))
+            if (!m_stabilizing && m_guideStars.size() > 1 && (origOffset.cameraOfs.X != 0 || origOffset.cameraOfs.Y != 0))
             {
                 wxString secondaryInfo = "MultiStar: ";
-                for (auto pGS = m_guideStars.begin() + 1; pGS != m_guideStars.end();)
+                MultiStarAverage average(origOffset.cameraOfs.X, origOffset.cameraOfs.Y);
+
+                // Search for the secondary stars in batches no larger than the number of stars still wanted, so that a
+                // batch holds exactly the stars a one-at-a-time search would reach. The searches in a batch run in
+                // parallel on copies of the stars, then the results are applied in list order so that the outcome does
+                // not depend on the number of threads.
+                enum
                 {
-                    if (m_starsUsed >= m_maxStars || m_guideStars.size() == 1)
-                        break;
-                    bool found = false;
-                    if (pGS->wasLost)
-                    {
-                        // Look for it based on its original offset from the primary star
-                        PHD_Point expectedLoc = m_primaryStar + pGS->offsetFromPrimary;
-                        found = pGS->Find(pImage, m_searchRegion, expectedLoc.X, expectedLoc.Y, pFrame->GetStarFindMode(),
-                                          GetMinStarHFD(), GetMaxStarHFD(), pCamera->GetSaturationADU(),
-                                          Star::FIND_LOGGING_MINIMAL);
-                    }
-                    else
-                        // Look for it where we last found it
-                        found = pGS->Find(pImage, m_searchRegion, pGS->X, pGS->Y, pFrame->GetStarFindMode(), GetMinStarHFD(),
-                                          GetMaxStarHFD(), pCamera->GetSaturationADU(), Star::FIND_LOGGING_MINIMAL);
-                    if (found)
+                    SEARCH_SKIPPED,
+                    SEARCH_LOST,
+                    SEARCH_FOUND
+                };
+                Star::FindMode findMode = pFrame->GetStarFindMode();
+                double minHFD = GetMinStarHFD();
+                double maxHFD = GetMaxStarHFD();
+                unsigned short saturation = pCamera->GetSaturationADU();
+                std::chrono::steady_clock::time_point deadline =
+                    std::chrono::steady_clock::now() + std::chrono::milliseconds(m_refineTimeBudget);
+                std::vector<GuideStar> batch;
+                std::vector<char> results;
+                bool outOfTime = false;
+
+                // Start where the previous frame ran out of time, wrapping around the list, so that stars
+                // cut off by the time budget are searched first in this frame rather than never.
+                size_t pos = m_refineStart < m_guideStars.size() ? m_refineStart : 1;
+                size_t remaining = m_guideStars.size() - 1; // secondary stars not yet visited
+                while (remaining > 0 && m_starsUsed < m_maxStars && !outOfTime)
+                {
+                    if (pos == m_guideStars.size())
+                        pos = 1;
+                    int count = (int) std::min<size_t>(std::min<size_t>(m_maxStars - m_starsUsed, remaining),
+                                                       m_guideStars.size() - pos);
+                    batch.assign(m_guideStars.begin() + pos, m_guideStars.begin() + pos + count);
+                    results.assign(count, SEARCH_SKIPPED);
+
+                    WorkerPool::Run(count, [&](int i) {
+                        // stars not searched within the time budget are searched first in the next frame
+                        if (m_refineTimeBudget > 0 && std::chrono::steady_clock::now() >= deadline)
+                            return;
+                        GuideStar& gs = batch[i];
+                        bool found;
+                        if (gs.wasLost)
+                        {
+                            // Look for it based on its original offset from the primary star
+                            PHD_Point expectedLoc = m_primaryStar + gs.offsetFromPrimary;
+                            found = gs.Find(pImage, m_searchRegion, expectedLoc.X, expectedLoc.Y, findMode, minHFD, maxHFD,
+                                            saturation, Star::FIND_LOGGING_MINIMAL);
+                        }
+                        else
+                            // Look for it where we last found it
+                            found = gs.Find(pImage, m_searchRegion, gs.X, gs.Y, findMode, minHFD, maxHFD, saturation,
+                                            Star::FIND_LOGGING_MINIMAL);
+                        results[i] = found ? SEARCH_FOUND : SEARCH_LOST;
+                    });
+
+                    for (int i = 0; i < count; i++)
                     {
-                        double dX = pGS->X - pGS->referencePoint.X;
-                        double dY = pGS->Y - pGS->referencePoint.Y;
-
-                        pGS->wasLost = false;
-                        m_starsUsed++;
-
-                        if (dX != 0. || dY != 0.)
+                        if (results[i] == SEARCH_SKIPPED)
+                        {
+                            outOfTime = true;
+                            break;
+                        }
+                        auto pGS = m_guideStars.begin() + pos;
+                        *pGS = batch[i];
+                        --remaining;
+                        if (results[i] == SEARCH_FOUND)
                         {
-                            // Handle zero-counting - suspect results of exactly zero movement
-                            if (dX == 0. || dY == 0.)
-                                ++pGS->zeroCount;
-                            else if (pGS->zeroCount > 0)
-                                --pGS->zeroCount;
+                            double dX = pGS->X - pGS->referencePoint.X;
+                            double dY = pGS->Y - pGS->referencePoint.Y;
+
+                            pGS->wasLost = false;
+                            m_starsUsed++;
 
-                            if (pGS->zeroCount == 5)
+                            switch (MultiStarClassify(dX, dY, primarySigma, &pGS->zeroCount, &pGS->missCount))
                             {
+                            case MULTISTAR_DROP:
+                                // suspect results of exactly zero movement, probably a hot pixel, drop it
                                 AppendStarUse(secondaryInfo, Iter_Inx(pGS), 0, 0, 0, "DZ");
-                                pGS = m_guideStars.erase(pGS);
-                                erasures = true;
+                                m_guideStars.erase(pGS);
                                 continue;
-                            }
-
-                            // Handle suspicious excursions - counted as "misses"
-                            secondaryDistance = hypot(dX, dY);
-                            if (secondaryDistance > 2.5 * primarySigma)
+                            case MULTISTAR_RESET:
+                                // Reset the reference point to wherever it is now
+                                pGS->referencePoint.X = pGS->X;
+                                pGS->referencePoint.Y = pGS->Y;
+                                AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, 0, "R");
+                                break;
+                            case MULTISTAR_MISS:
+                                AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, 0, "M" + std::to_string(pGS->missCount));
+                                break;
+                            case MULTISTAR_USE:
                             {
-                                if (++pGS->missCount > 10)
-                                {
-                                    // Reset the reference point to wherever it is now
-                                    pGS->referencePoint.X = pGS->X;
-                                    pGS->referencePoint.Y = pGS->Y;
-                                    pGS->missCount = 0;
-                                    AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, 0, "R");
-                                }
-                                else
-                                    AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, 0,
-                                                  "M" + std::to_string(pGS->missCount));
-                                ++pGS;
-                                continue;
+                                // At this point we have usable data from the secondary star
+                                double wt = (pGS->SNR / m_primaryStar.SNR);
+                                average.Add(wt, dX, dY);
+                                AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, wt, "U");
+                                break;
                             }
-                            else if (pGS->missCount > 0)
-                            {
-                                --pGS->missCount;
                             }
-
-                            // At this point we have usable data from the secondary star
-                            double wt = (pGS->SNR / m_primaryStar.SNR);
-                            sumX += wt * dX;
-                            sumY += wt * dY;
-                            sumWeights += wt;
-                            averaged = true;
-                            validStars++;
-
-                            AppendStarUse(secondaryInfo, Iter_Inx(pGS), dX, dY, wt, "U");
                         }
-                        else // exactly zero on both axes, probably a hot pixel, drop it
+                        else
                         {
-                            AppendStarUse(secondaryInfo, Iter_Inx(pGS), 0, 0, 0, "DZ");
-                            pGS = m_guideStars.erase(pGS);
-                            erasures = true;
+                            // star not found in its search region
+                            AppendStarUse(secondaryInfo, Iter_Inx(pGS), 0, 0, 0, "L");
+                            pGS->wasLost = true;
                         }
+                        ++pos;
                     }
-                    else
-                    {
-                        // star not found in its search region
-                        AppendStarUse(secondaryInfo, Iter_Inx(pGS), 0, 0, 0, "L");
-                        pGS->wasLost = true;
-                    }
-                    if (!erasures)
-                        ++pGS;
-                    else
-                        erasures = false;
                 } // End of looping through secondary stars
+                m_refineStart = outOfTime ? pos : 1;
+                if (outOfTime)
+                    secondaryInfo += wxString::Format("[time budget of %u ms reached] ", m_refineTimeBudget);
                 Debug.Write(secondaryInfo + "\n");
 
-                if (averaged)
+                if (average.count > 0)
                 {
-                    sumX = sumX / sumWeights;
-                    sumY = sumY / sumWeights;
+                    double sumX = average.X();
+                    double sumY = average.Y();
                     if (hypot(sumX, sumY) < primaryDistance) // Apply average only if its smaller than single-star delta
                     {
                         pOffset->cameraOfs.X = sumX;
@@ -904,7 +976,7 @@ bool GuiderMultiStar::RefineOffset(const usImage *pImage, GuiderOffset *pOffset)
                         refined = true;
                     }
                     Debug.Write(wxString::Format("%s, %d included, MultiStar: {%0.2f, %0.2f}, one-star: {%0.2f, %0.2f}\n",
-                                                 refined ? "refined" : "single-star", validStars, sumX, sumY,
+                                                 refined ? "refined" : "single-star", average.count, sumX, sumY,
                                                  origOffset.cameraOfs.X, origOffset.cameraOfs.Y));
                 }
             }
@@ -1227,7 +1299,7 @@ void GuiderMultiStar::OnPaint(wxPaintEvent& event)
             if (m_stabilizing)
             {
                 if (m_lastStarsUsed == 0)
-                    m_lastStarsUsed = wxMin(m_guideStars.size(), (size_t) DEFAULT_MAX_STAR_COUNT);
+                    m_lastStarsUsed = wxMin(m_guideStars.size(), (size_t) m_maxStars);
             }
 
             for (std::vector<GuideStar>::const_iterator it = m_guideStars.begin() + 1; it != m_guideStars.end(); ++it)
@@ -1345,7 +1417,12 @@ wxString GuiderMultiStar::GetSettingsSummary() const
         s += _T("disabled");
 
     if (m_multiStarMode)
-        s += wxString::Format(_T(", Multi-star mode, list size = %d\n "), m_guideStars.size());
+    {
+        s += wxString::Format(_T(", Multi-star mode, list size = %d, max stars = %u"), m_guideStars.size(), m_maxStars);
+        if (m_refineTimeBudget > 0)
+            s += wxString::Format(_T(", time budget = %u ms"), m_refineTimeBudget);
+        s += "\n ";
+    }
     else
         s += ", Single-star mode\n";
     return s;
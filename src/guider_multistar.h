@@ -91,6 +91,8 @@ class GuiderMultiStar : public Guider
     bool m_tolerateJumpsEnabled;
     double m_tolerateJumpsThreshold;
     unsigned int m_maxStars;
+    unsigned int m_refineTimeBudget; // ms, 0 for no limit
+    size_t m_refineStart; // secondary star to search first, where the time budget last ran out
     double m_stabilitySigmaX;
 
 public:
@@ -112,6 +114,10 @@ public:
     bool SetMassChangeThreshold(double starMassChangeThreshold);
     bool SetTolerateJumps(bool enable, double threshold);
     bool SetSearchRegion(int searchRegion);
+    unsigned int GetMaxStars() const;
+    bool SetMaxStars(int maxStars);
+    unsigned int GetRefineTimeBudget() const;
+    void SetRefineTimeBudget(int ms);
     bool RefineOffset(const usImage *pImage, GuiderOffset *pOffset);
 
     friend class GuiderMultiStarConfigDialogPane;
@@ -132,6 +138,7 @@ public:
     const Star& PrimaryStar() const override;
     bool GetMultiStarMode() const override;
     wxString GetStarCount() const override;
+    void GetStarPositions(std::vector<PHD_Point> *positions) const override;
     void SetMultiStarMode(bool val) override;
     void ClearSecondaryStars();
     wxString GetSettingsSummary() const override;
@@ -161,6 +168,16 @@ inline int GuiderMultiStar::GetMaxMovePixels() const
     return m_searchRegion;
 }
 
+inline unsigned int GuiderMultiStar::GetMaxStars() const
+{
+    return m_maxStars;
+}
+
+inline unsigned int GuiderMultiStar::GetRefineTimeBudget() const
+{
+    return m_refineTimeBudget;
+}
+
 inline const Star& GuiderMultiStar::PrimaryStar() const
 {
     return m_primaryStar;
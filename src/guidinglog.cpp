@@ -38,13 +38,260 @@
 #include <wx/wfstream.h>
 #include <wx/txtstrm.h>
 
+#include <atomic>
+
 #define GUIDELOG_VERSION _T("2.5")
 
 const int RetentionPeriod = 60;
 
-GuidingLog::GuidingLog() : m_enabled(false), m_keepFile(false), m_isGuiding(false) { }
+enum
+{
+    DEFAULT_FLUSH_INTERVAL = 1000, // milliseconds
+    MIN_FLUSH_INTERVAL = 50,
+    // buffered text that makes the logging thread write the buffer itself
+    BUFFER_LIMIT = 64 * 1024,
+};
+
+class GuideLogWriter : public wxThread
+{
+    GuidingLog *m_log;
+    std::atomic<bool> m_stop;
+    wxSemaphore m_wakeup;
+
+public:
+    std::atomic<unsigned int> m_interval;
+
+    GuideLogWriter(GuidingLog *log, unsigned int interval)
+        : wxThread(wxTHREAD_JOINABLE), m_log(log), m_stop(false), m_interval(interval)
+    {
+    }
+    void Stop()
+    {
+        m_stop = true;
+        m_wakeup.Post();
+    }
+
+protected:
+    ExitCode Entry() override;
+};
+
+wxThread::ExitCode GuideLogWriter::Entry()
+{
+    while (!m_stop)
+    {
+        m_wakeup.WaitTimeout(m_interval);
+        m_log->WriteBuffered(true);
+    }
+
+    return (wxThread::ExitCode) 0;
+}
+
+GuidingLog::GuidingLog()
+    : m_enabled(false), m_keepFile(false), m_isGuiding(false), m_unflushed(false), m_writer(nullptr), m_binLog(false)
+{
+}
+
+GuidingLog::~GuidingLog()
+{
+    StopWriter();
+    WriteBuffered(true);
+}
+
+// called with m_bufLock held
+bool GuidingLog::BufferFull() const
+{
+    return m_buf.size() >= BUFFER_LIMIT || m_bin.BufferedSize() >= BUFFER_LIMIT;
+}
+
+void GuidingLog::Buffered(bool full)
+{
+    // without the writer thread every line goes straight to the file
+    if (full || !m_writer)
+        WriteBuffered(!m_writer);
+}
+
+void GuidingLog::Write(const char *text, size_t len)
+{
+    bool full;
+    {
+        wxMutexLocker lock(m_bufLock);
+        m_buf.append(text, len);
+        if (m_binLog)
+            m_bin.Text(text, len);
+        full = BufferFull();
+    }
+
+    Buffered(full);
+}
+
+void GuidingLog::Write(const char *text)
+{
+    Write(text, strlen(text));
+}
+
+void GuidingLog::Write(const std::string& text)
+{
+    Write(text.data(), text.size());
+}
+
+void GuidingLog::Write(const wxString& text)
+{
+    const wxScopedCharBuffer utf8 = text.utf8_str();
+    Write(utf8.data(), utf8.length());
+}
+
+void GuidingLog::WriteStep(const GuideLogStep& step)
+{
+    m_line.clear();
+    GuideLogFormatStep(m_line, step);
+
+    bool full;
+    {
+        wxMutexLocker lock(m_bufLock);
+        m_buf += m_line;
+        if (m_binLog)
+            m_bin.Step(step);
+        full = BufferFull();
+    }
+
+    Buffered(full);
+}
+
+void GuidingLog::WriteDrop(const GuideLogDrop& drop, const wxString& status)
+{
+    const wxScopedCharBuffer utf8 = status.utf8_str();
+
+    m_line.clear();
+    GuideLogFormatDrop(m_line, drop, utf8.data(), utf8.length());
+
+    bool full;
+    {
+        wxMutexLocker lock(m_bufLock);
+        m_buf += m_line;
+        if (m_binLog)
+            m_bin.Drop(drop, utf8.data(), utf8.length());
+        full = BufferFull();
+    }
+
+    Buffered(full);
+}
+
+void GuidingLog::Mark(GuideLogMark mark, const wxDateTime& time)
+{
+    wxMutexLocker lock(m_bufLock);
+    if (m_binLog)
+        m_bin.Mark(mark, (int64_t) time.GetTicks());
+}
+
+bool GuidingLog::WriteBuffered(bool flush)
+{
+    wxMutexLocker lock(m_writeLock);
+    return WriteBufferedLocked(flush);
+}
+
+bool GuidingLog::WriteBufferedLocked(bool flush)
+{
+    {
+        wxMutexLocker lock(m_bufLock);
+        m_writing.swap(m_buf);
+        if (m_binLog)
+            m_binWriting.swap(m_bin.Buffer());
+    }
+
+    bool ok = true;
+
+    if (!m_writing.empty())
+    {
+        if (m_file.IsOpened())
+        {
+            ok = m_file.Write(m_writing.data(), m_writing.size()) == m_writing.size();
+            m_unflushed = true;
+        }
+        m_writing.clear();
+    }
+
+    if (!m_binWriting.empty())
+    {
+        if (m_binFile.IsOpened())
+        {
+            // the binary log is a secondary copy; its errors do not fail the write
+            m_binFile.Write(m_binWriting.data(), m_binWriting.size());
+            m_unflushed = true;
+        }
+        m_binWriting.clear();
+    }
+
+    if (flush && m_unflushed)
+    {
+        if (m_file.IsOpened())
+            ok = m_file.Flush() && ok;
+        if (m_binFile.IsOpened())
+            m_binFile.Flush();
+        m_unflushed = false;
+    }
 
-GuidingLog::~GuidingLog() { }
+    return ok;
+}
+
+void GuidingLog::StopWriter()
+{
+    if (m_writer)
+    {
+        m_writer->Stop();
+        m_writer->Wait();
+        delete m_writer;
+        m_writer = nullptr;
+    }
+}
+
+// called from the fatal exception handler
+void GuidingLog::FlushOnCrash()
+{
+    if (!m_file.IsOpened())
+        return;
+
+    // the crashing thread may be the one holding a lock; write the buffer
+    // regardless after a while
+    bool locked = false;
+    for (int i = 0; i < 50 && !locked; i++)
+    {
+        locked = m_writeLock.TryLock() == wxMUTEX_NO_ERROR;
+        if (!locked)
+            wxMilliSleep(10);
+    }
+
+    if (m_bufLock.TryLock() == wxMUTEX_NO_ERROR)
+    {
+        // text swapped out by the writer is only ours to write if we hold the write lock
+        std::string& bin = m_bin.Buffer();
+        if (locked)
+        {
+            m_writing += m_buf;
+            m_binWriting += bin;
+        }
+        else
+        {
+            m_file.Write(m_buf.data(), m_buf.size());
+            if (m_binFile.IsOpened())
+                m_binFile.Write(bin.data(), bin.size());
+        }
+        m_buf.clear();
+        bin.clear();
+        m_bufLock.Unlock();
+    }
+    if (locked)
+    {
+        m_file.Write(m_writing.data(), m_writing.size());
+        if (m_binFile.IsOpened())
+            m_binFile.Write(m_binWriting.data(), m_binWriting.size());
+    }
+    m_file.Flush();
+    if (m_binFile.IsOpened())
+        m_binFile.Flush();
+
+    if (locked)
+        m_writeLock.Unlock();
+}
 
 static wxString PierSideStr(PierSide p)
 {
@@ -165,46 +412,48 @@ static wxString PointingInfo()
     return rslt;
 }
 
-static void GuidingHeader(wxFFile& file)
-// output guiding header to log file
+static wxString GuidingHeader()
+// guiding header for the log file
 {
-    file.Write("Equipment Profile = " + pConfig->GetCurrentProfile() + "\n");
+    wxString hdr("Equipment Profile = " + pConfig->GetCurrentProfile() + "\n");
 
-    file.Write(pFrame->GetSettingsSummary());
-    file.Write(pFrame->pGuider->GetSettingsSummary());
+    hdr += pFrame->GetSettingsSummary();
+    hdr += pFrame->pGuider->GetSettingsSummary();
 
     if (pCamera)
     {
-        file.Write(pCamera->GetSettingsSummary());
-        file.Write("Exposure = " + pFrame->ExposureDurationSummary() + "\n");
+        hdr += pCamera->GetSettingsSummary();
+        hdr += "Exposure = " + pFrame->ExposureDurationSummary() + "\n";
     }
 
     if (pMount)
-        file.Write(pMount->GetSettingsSummary());
+        hdr += pMount->GetSettingsSummary();
 
     if (pSecondaryMount)
-        file.Write(pSecondaryMount->GetSettingsSummary());
+        hdr += pSecondaryMount->GetSettingsSummary();
 
-    file.Write(PointingInfo());
-    file.Write("\n");
+    hdr += PointingInfo();
+    hdr += "\n";
 
     const Star& star = pFrame->pGuider->PrimaryStar();
 
-    file.Write(wxString::Format("Lock position = %.3f, %.3f, Star position = %.3f, %.3f, HFD = %.2f px\n",
-                                pFrame->pGuider->LockPosition().X, pFrame->pGuider->LockPosition().Y,
-                                pFrame->pGuider->CurrentPosition().X, pFrame->pGuider->CurrentPosition().Y, star.HFD));
+    hdr += wxString::Format("Lock position = %.3f, %.3f, Star position = %.3f, %.3f, HFD = %.2f px\n",
+                            pFrame->pGuider->LockPosition().X, pFrame->pGuider->LockPosition().Y,
+                            pFrame->pGuider->CurrentPosition().X, pFrame->pGuider->CurrentPosition().Y, star.HFD);
+
+    hdr += "Frame,Time,mount,dx,dy,RARawDistance,DECRawDistance,RAGuideDistance,DECGuideDistance,"
+           "RADuration,RADirection,DECDuration,DECDirection,XStep,YStep,StarMass,SNR,ErrorCode\n";
 
-    file.Write("Frame,Time,mount,dx,dy,RARawDistance,DECRawDistance,RAGuideDistance,DECGuideDistance,"
-               "RADuration,RADirection,DECDuration,DECDirection,XStep,YStep,StarMass,SNR,ErrorCode\n");
+    return hdr;
 }
 
-static void WriteSummaryInfo(wxFFile& file, const GuideLogSummaryInfo& summary)
+static wxString SummaryInfo(const GuideLogSummaryInfo& summary)
 {
     if (!summary.valid)
-        return;
+        return wxEmptyString;
 
-    file.Write(wxString::Format("Log Summary: calcnt:%u gcnt:%u gdur:%.f gacnt:%u\n", summary.cal_cnt, summary.guide_cnt,
-                                summary.guide_dur, summary.ga_cnt));
+    return wxString::Format("Log Summary: calcnt:%u gcnt:%u gdur:%.f gacnt:%u\n", summary.cal_cnt, summary.guide_cnt,
+                            summary.guide_dur, summary.ga_cnt);
 }
 
 void GuideLogSummaryInfo::LoadSummaryInfo(wxFFile& file)
@@ -255,6 +504,51 @@ void GuideLogSummaryInfo::LoadSummaryInfo(wxFFile& file)
     }
 }
 
+// PHD2_GuideLog_<timestamp>.bin for PHD2_GuideLog_<timestamp>.txt
+wxString GuidingLog::BinaryLogName(const wxString& textLogName)
+{
+    return textLogName.BeforeLast('.') + ".bin";
+}
+
+void GuidingLog::OpenBinaryLog()
+{
+    wxString binName = BinaryLogName(m_fileName);
+    uint64_t textLogSize = m_file.Length();
+
+    wxMutexLocker lock(m_writeLock);
+
+    if (!m_binFile.Open(binName, "a+b"))
+    {
+        Debug.Write(wxString::Format("GuideLog: unable to open binary log %s\n", binName));
+        return;
+    }
+
+    uint64_t size = m_binFile.Length();
+    uint64_t lastIndex = size > 0 ? GuideLogBinaryLastIndex(m_binFile.fp()) : GLOG_NO_INDEX;
+
+    wxMutexLocker bufLock(m_bufLock);
+
+    if (size == 0)
+        m_bin.StartFile(textLogSize);
+    else if (lastIndex != GLOG_NO_INDEX)
+        m_bin.ContinueFile(size, lastIndex);
+    else
+    {
+        // the log was cut short by a crash and cannot be appended to; start
+        // again, recording that it does not cover the start of the text log
+        Debug.Write(wxString::Format("GuideLog: binary log %s was not closed, starting a new one\n", binName));
+        m_binFile.Close();
+        if (!m_binFile.Open(binName, "w+b"))
+        {
+            Debug.Write(wxString::Format("GuideLog: unable to open binary log %s\n", binName));
+            return;
+        }
+        m_bin.StartFile(textLogSize);
+    }
+
+    m_binLog = true;
+}
+
 void GuidingLog::EnableLogging()
 {
     if (m_enabled)
@@ -285,13 +579,31 @@ void GuidingLog::EnableLogging()
                 m_keepFile = false;
                 m_summary.valid = true;
             }
+
+            if (pConfig->Global.GetBoolean("/GuideLog/BinaryLog", false))
+                OpenBinaryLog();
         }
 
         assert(m_file.IsOpened());
 
-        m_file.Write(_T("PHD2 version ") FULLVER _T(" [") PHD_OSNAME _T("]")
-                     _T(", Log version ") GUIDELOG_VERSION _T(". Log enabled at ") +
-                     logFileTime.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+        unsigned int interval = wxMax(pConfig->Global.GetInt("/GuideLog/FlushInterval", DEFAULT_FLUSH_INTERVAL),
+                                      (int) MIN_FLUSH_INTERVAL);
+        if (m_writer)
+            m_writer->m_interval = interval;
+        else
+        {
+            m_writer = new GuideLogWriter(this, interval);
+            if (m_writer->Run() != wxTHREAD_NO_ERROR)
+            {
+                // lines will be written by the thread that logs them
+                delete m_writer;
+                m_writer = nullptr;
+            }
+        }
+
+        Write(_T("PHD2 version ") FULLVER _T(" [") PHD_OSNAME _T("]")
+              _T(", Log version ") GUIDELOG_VERSION _T(". Log enabled at ") +
+              logFileTime.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
 
         m_enabled = true;
 
@@ -300,7 +612,7 @@ void GuidingLog::EnableLogging()
 
         // dump guiding header if logging enabled during guide
         if (pFrame && pFrame->pGuider->IsGuiding())
-            GuidingHeader(m_file);
+            Write(GuidingHeader());
 
         Flush();
     }
@@ -327,8 +639,8 @@ void GuidingLog::DisableLogging()
     {
         wxDateTime now = wxDateTime::Now();
 
-        m_file.Write("\n");
-        m_file.Write("Log disabled at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+        Write("\n");
+        Write("Log disabled at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
         Flush();
     }
 
@@ -362,6 +674,7 @@ bool GuidingLog::ChangeDirLog(const wxString& newdir)
 void GuidingLog::RemoveOldFiles()
 {
     Logger::RemoveMatchingFiles("PHD2_GuideLog*.txt", RetentionPeriod);
+    Logger::RemoveMatchingFiles("PHD2_GuideLog*.bin", RetentionPeriod);
 }
 
 bool GuidingLog::Flush()
@@ -375,7 +688,7 @@ bool GuidingLog::Flush()
     {
         assert(m_file.IsOpened());
 
-        if (!m_file.Flush())
+        if (!WriteBuffered(true))
         {
             throw ERROR_INFO("unable to flush file");
         }
@@ -397,13 +710,26 @@ void GuidingLog::CloseGuideLog()
         {
             wxDateTime now = wxDateTime::Now();
 
-            m_file.Write("\n");
-            WriteSummaryInfo(m_file, m_summary);
-            m_file.Write("Log closed at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
-            Flush();
+            Write("\n");
+            Write(SummaryInfo(m_summary));
+            Write("Log closed at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
         }
 
+        wxMutexLocker lock(m_writeLock);
+        {
+            wxMutexLocker bufLock(m_bufLock);
+            if (m_binLog)
+                m_bin.Finish();
+        }
+        WriteBufferedLocked(true);
         m_file.Close();
+
+        if (m_binFile.IsOpened())
+        {
+            m_binFile.Close();
+            wxMutexLocker bufLock(m_bufLock);
+            m_binLog = false;
+        }
     }
 
     m_enabled = false;
@@ -411,6 +737,9 @@ void GuidingLog::CloseGuideLog()
     if (!m_keepFile) // Delete the file if nothing useful was logged
     {
         wxRemove(m_fileName);
+        wxString binName = BinaryLogName(m_fileName);
+        if (wxFileExists(binName))
+            wxRemove(binName);
     }
 }
 
@@ -424,37 +753,38 @@ void GuidingLog::StartCalibration(const Mount *pCalibrationMount)
     assert(m_file.IsOpened());
     wxDateTime now = wxDateTime::Now();
 
-    m_file.Write("\n");
-    m_file.Write("Calibration Begins at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
-    m_file.Write("Equipment Profile = " + pConfig->GetCurrentProfile() + "\n");
+    Write("\n");
+    Write("Calibration Begins at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+    Mark(GLOG_CALIBRATION_BEGINS, now);
+    Write("Equipment Profile = " + pConfig->GetCurrentProfile() + "\n");
 
-    m_file.Write(pFrame->GetSettingsSummary());
-    m_file.Write(pFrame->pGuider->GetSettingsSummary());
+    Write(pFrame->GetSettingsSummary());
+    Write(pFrame->pGuider->GetSettingsSummary());
 
     if (pCamera)
     {
-        m_file.Write(pCamera->GetSettingsSummary());
-        m_file.Write("Exposure = " + pFrame->ExposureDurationSummary() + "\n");
+        Write(pCamera->GetSettingsSummary());
+        Write("Exposure = " + pFrame->ExposureDurationSummary() + "\n");
     }
 
     assert(pCalibrationMount && pCalibrationMount->IsConnected());
 
-    m_file.Write("Mount = " + pCalibrationMount->Name());
+    Write("Mount = " + pCalibrationMount->Name());
     wxString calSettings = pCalibrationMount->CalibrationSettingsSummary();
     if (!calSettings.IsEmpty())
-        m_file.Write(", " + calSettings);
-    m_file.Write("\n");
+        Write(", " + calSettings);
+    Write("\n");
 
-    m_file.Write(PointingInfo());
-    m_file.Write("\n");
+    Write(PointingInfo());
+    Write("\n");
 
     const Star& star = pFrame->pGuider->PrimaryStar();
 
-    m_file.Write(wxString::Format("Lock position = %.3f, %.3f, Star position = %.3f, %.3f, HFD = %.2f px\n",
-                                  pFrame->pGuider->LockPosition().X, pFrame->pGuider->LockPosition().Y,
-                                  pFrame->pGuider->CurrentPosition().X, pFrame->pGuider->CurrentPosition().Y, star.HFD));
+    Write(wxString::Format("Lock position = %.3f, %.3f, Star position = %.3f, %.3f, HFD = %.2f px\n",
+                           pFrame->pGuider->LockPosition().X, pFrame->pGuider->LockPosition().Y,
+                           pFrame->pGuider->CurrentPosition().X, pFrame->pGuider->CurrentPosition().Y, star.HFD));
 
-    m_file.Write("Direction,Step,dx,dy,x,y,Dist\n");
+    Write("Direction,Step,dx,dy,x,y,Dist\n");
 
     Flush();
 
@@ -470,8 +800,9 @@ void GuidingLog::CalibrationFailed(const Mount *pCalibrationMount, const wxStrin
 
     assert(m_file.IsOpened());
 
-    m_file.Write(msg);
-    m_file.Write("\n");
+    Write(msg);
+    Write("\n");
+    Mark(GLOG_CALIBRATION_FAILED, wxDateTime::Now());
     Flush();
 }
 
@@ -483,10 +814,8 @@ void GuidingLog::CalibrationStep(const CalibrationStepInfo& info)
     assert(m_file.IsOpened());
 
     // Direction,Step,dx,dy,x,y,Dist
-    m_file.Write(wxString::Format("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", info.direction, info.stepNumber, info.dx, info.dy,
-                                  info.pos.X, info.pos.Y, info.dist));
-
-    Flush();
+    Write(wxString::Format("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", info.direction, info.stepNumber, info.dx, info.dy,
+                           info.pos.X, info.pos.Y, info.dist));
 }
 
 void GuidingLog::CalibrationDirectComplete(const Mount *pCalibrationMount, const wxString& direction, double angle, double rate,
@@ -497,10 +826,8 @@ void GuidingLog::CalibrationDirectComplete(const Mount *pCalibrationMount, const
 
     assert(m_file.IsOpened());
 
-    m_file.Write(wxString::Format("%s calibration complete. Angle = %.1f deg, Rate = %.3f px/sec, Parity = %s\n", direction,
-                                  degrees(angle), rate * 1000.0, ParityStr(parity)));
-
-    Flush();
+    Write(wxString::Format("%s calibration complete. Angle = %.1f deg, Rate = %.3f px/sec, Parity = %s\n", direction,
+                           degrees(angle), rate * 1000.0, ParityStr(parity)));
 }
 
 void GuidingLog::CalibrationComplete(const Mount *pCalibrationMount)
@@ -514,7 +841,8 @@ void GuidingLog::CalibrationComplete(const Mount *pCalibrationMount)
 
     assert(m_file.IsOpened());
 
-    m_file.Write(wxString::Format("Calibration complete, mount = %s.\n", pCalibrationMount->Name()));
+    Write(wxString::Format("Calibration complete, mount = %s.\n", pCalibrationMount->Name()));
+    Mark(GLOG_CALIBRATION_COMPLETE, wxDateTime::Now());
 
     Flush();
 }
@@ -528,11 +856,12 @@ void GuidingLog::GuidingStarted()
 
     assert(m_file.IsOpened());
 
-    m_file.Write("\n");
-    m_file.Write("Guiding Begins at " + pFrame->m_guidingStarted.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+    Write("\n");
+    Write("Guiding Begins at " + pFrame->m_guidingStarted.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+    Mark(GLOG_GUIDING_BEGINS, pFrame->m_guidingStarted);
 
     // add common guiding header
-    GuidingHeader(m_file);
+    Write(GuidingHeader());
 
     Flush();
 
@@ -551,7 +880,9 @@ void GuidingLog::GuidingStopped()
     ++m_summary.guide_cnt;
     m_summary.guide_dur += pFrame->TimeSinceGuidingStarted();
 
-    m_file.Write("Guiding Ends at " + wxDateTime::Now().Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+    wxDateTime now = wxDateTime::Now();
+    Write("Guiding Ends at " + now.Format(_T("%Y-%m-%d %H:%M:%S")) + "\n");
+    Mark(GLOG_GUIDING_ENDS, now);
     Flush();
 }
 
@@ -562,27 +893,36 @@ void GuidingLog::GuideStep(const GuideStepInfo& step)
 
     assert(m_file.IsOpened());
 
-    m_file.Write(wxString::Format("%d,%.3f,\"%s\",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,", step.frameNumber, step.time,
-                                  step.mount->IsStepGuider() ? "AO" : "Mount", step.cameraOffset.X, step.cameraOffset.Y,
-                                  step.mountOffset.X, step.mountOffset.Y, step.guideDistanceRA, step.guideDistanceDec));
+    GuideLogStep s;
+    s.time = step.time;
+    s.cameraX = step.cameraOffset.X;
+    s.cameraY = step.cameraOffset.Y;
+    s.mountX = step.mountOffset.X;
+    s.mountY = step.mountOffset.Y;
+    s.guideDistanceRA = step.guideDistanceRA;
+    s.guideDistanceDec = step.guideDistanceDec;
+    s.starMass = step.starMass;
+    s.starSNR = step.starSNR;
+    s.frameNumber = step.frameNumber;
+    s.starError = step.starError;
 
     if (step.mount->IsStepGuider())
     {
-        int xSteps = step.directionRA == LEFT ? -step.durationRA : step.durationRA;
-        int ySteps = step.directionDec == DOWN ? -step.durationDec : step.durationDec;
-        m_file.Write(wxString::Format(",,,,%d,%d,", xSteps, ySteps));
+        s.flags = GLOG_STEP_AO;
+        s.durationRA = step.directionRA == LEFT ? -step.durationRA : step.durationRA;
+        s.durationDec = step.directionDec == DOWN ? -step.durationDec : step.durationDec;
+        s.directionRA = s.directionDec = 0;
     }
     else
     {
-        m_file.Write(wxString::Format(
-            "%d,%s,%d,%s,,,", step.durationRA,
-            step.durationRA > 0 ? step.mount->DirectionChar((GUIDE_DIRECTION) step.directionRA) : "", step.durationDec,
-            step.durationDec > 0 ? step.mount->DirectionChar((GUIDE_DIRECTION) step.directionDec) : ""));
+        s.flags = 0;
+        s.durationRA = step.durationRA;
+        s.durationDec = step.durationDec;
+        s.directionRA = step.durationRA > 0 ? step.mount->DirectionChar((GUIDE_DIRECTION) step.directionRA)[0] : 0;
+        s.directionDec = step.durationDec > 0 ? step.mount->DirectionChar((GUIDE_DIRECTION) step.directionDec)[0] : 0;
     }
 
-    m_file.Write(wxString::Format("%.f,%.2f,%d\n", step.starMass, step.starSNR, step.starError));
-
-    Flush();
+    WriteStep(s);
 }
 
 void GuidingLog::FrameDropped(const FrameDroppedInfo& info)
@@ -592,10 +932,14 @@ void GuidingLog::FrameDropped(const FrameDroppedInfo& info)
 
     assert(m_file.IsOpened());
 
-    m_file.Write(wxString::Format("%d,%.3f,\"DROP\",,,,,,,,,,,,,%.f,%.2f,%d,\"%s\"\n", info.frameNumber, info.time,
-                                  info.starMass, info.starSNR, info.starError, info.status));
+    GuideLogDrop d;
+    d.time = info.time;
+    d.starMass = info.starMass;
+    d.starSNR = info.starSNR;
+    d.frameNumber = info.frameNumber;
+    d.starError = info.starError;
 
-    Flush();
+    WriteDrop(d, info.status);
 }
 
 void GuidingLog::CalibrationFrameDropped(const FrameDroppedInfo& info)
@@ -605,10 +949,8 @@ void GuidingLog::CalibrationFrameDropped(const FrameDroppedInfo& info)
 
     assert(m_file.IsOpened());
 
-    m_file.Write(wxString::Format("INFO: STAR LOST during calibration, Mass= %.f, SNR= %.2f, Error= %d, Status=%s\n",
-                                  info.starMass, info.starSNR, info.starError, info.status));
-
-    Flush();
+    Write(wxString::Format("INFO: STAR LOST during calibration, Mass= %.f, SNR= %.2f, Error= %d, Status=%s\n",
+                           info.starMass, info.starSNR, info.starError, info.status));
 }
 
 void GuidingLog::NotifyGuidingDithered(Guider *guider, double dx, double dy)
@@ -616,18 +958,15 @@ void GuidingLog::NotifyGuidingDithered(Guider *guider, double dx, double dy)
     if (!m_enabled || !m_isGuiding)
         return;
 
-    m_file.Write(wxString::Format("INFO: DITHER by %.3f, %.3f, new lock pos = %.3f, %.3f\n", dx, dy, guider->LockPosition().X,
-                                  guider->LockPosition().Y));
-
-    Flush();
+    Write(wxString::Format("INFO: DITHER by %.3f, %.3f, new lock pos = %.3f, %.3f\n", dx, dy, guider->LockPosition().X,
+                           guider->LockPosition().Y));
 }
 
 void GuidingLog::NotifySettlingStateChange(const wxString& msg)
 {
     if (!m_enabled)
         return;
-    m_file.Write(wxString::Format("INFO: SETTLING STATE CHANGE, %s\n", msg));
-    Flush();
+    Write(wxString::Format("INFO: SETTLING STATE CHANGE, %s\n", msg));
 }
 
 void GuidingLog::NotifyGACompleted()
@@ -636,6 +975,7 @@ void GuidingLog::NotifyGACompleted()
         return;
 
     ++m_summary.ga_cnt;
+    Mark(GLOG_GA_COMPLETE, wxDateTime::Now());
 }
 
 void GuidingLog::NotifyGAResult(const wxString& msg)
@@ -644,8 +984,7 @@ void GuidingLog::NotifyGAResult(const wxString& msg)
         return;
 
     // Client needs to handle end-of-line formatting
-    m_file.Write(wxString::Format("INFO: GA Result - %s", msg));
-    Flush();
+    Write(wxString::Format("INFO: GA Result - %s", msg));
 }
 
 void GuidingLog::NotifySetLockPosition(Guider *guider)
@@ -653,10 +992,8 @@ void GuidingLog::NotifySetLockPosition(Guider *guider)
     if (!m_enabled || !m_isGuiding)
         return;
 
-    m_file.Write(wxString::Format("INFO: SET LOCK POSITION, new lock pos = %.3f, %.3f\n", guider->LockPosition().X,
-                                  guider->LockPosition().Y));
-
-    Flush();
+    Write(wxString::Format("INFO: SET LOCK POSITION, new lock pos = %.3f, %.3f\n", guider->LockPosition().X,
+                           guider->LockPosition().Y));
 
     m_keepFile = true;
 }
@@ -677,8 +1014,7 @@ void GuidingLog::NotifyLockShiftParams(const LockPosShiftParams& shiftParams, co
             cameraRate.IsValid() ? cameraRate.Y * 3600.0 : 0.0);
     }
 
-    m_file.Write(wxString::Format("INFO: LOCK SHIFT, enabled = %d %s\n", shiftParams.shiftEnabled, details));
-    Flush();
+    Write(wxString::Format("INFO: LOCK SHIFT, enabled = %d %s\n", shiftParams.shiftEnabled, details));
 
     m_keepFile = true;
 }
@@ -688,8 +1024,7 @@ void GuidingLog::ServerCommand(Guider *guider, const wxString& cmd)
     if (!m_enabled || !m_isGuiding)
         return;
 
-    m_file.Write(wxString::Format("INFO: Server received %s\n", cmd));
-    Flush();
+    Write(wxString::Format("INFO: Server received %s\n", cmd));
 
     m_keepFile = true;
 }
@@ -699,10 +1034,9 @@ void GuidingLog::NotifyManualGuide(const Mount *mount, int direction, int durati
     if (!m_enabled || !m_isGuiding)
         return;
 
-    m_file.Write(wxString::Format("INFO: Manual guide (%s) %s %d %s\n", mount->IsStepGuider() ? "AO" : "Mount",
-                                  mount->DirectionStr(static_cast<GUIDE_DIRECTION>(direction)), duration,
-                                  mount->IsStepGuider() ? (duration != 1 ? "steps" : "step") : "ms"));
-    Flush();
+    Write(wxString::Format("INFO: Manual guide (%s) %s %d %s\n", mount->IsStepGuider() ? "AO" : "Mount",
+                           mount->DirectionStr(static_cast<GUIDE_DIRECTION>(direction)), duration,
+                           mount->IsStepGuider() ? (duration != 1 ? "steps" : "step") : "ms"));
 
     m_keepFile = true;
 }
@@ -727,16 +1061,14 @@ void GuidingLog::SetGuidingParam(const wxString& name, const wxString& val)
     if (!m_enabled || !m_isGuiding)
         return;
 
-    m_file.Write(wxString::Format("INFO: Guiding parameter change, %s = %s\n", name, val));
-    Flush();
+    Write(wxString::Format("INFO: Guiding parameter change, %s = %s\n", name, val));
 
     m_keepFile = true;
 }
 
 void GuidingLog::SetGuidingParam(const wxString& name, const wxString& val, bool AlwaysLog)
 {
-    m_file.Write(wxString::Format("INFO: Guiding parameter change, %s = %s\n", name, val));
-    Flush();
+    Write(wxString::Format("INFO: Guiding parameter change, %s = %s\n", name, val));
 
     m_keepFile = true;
 }
@@ -36,6 +36,7 @@
 #ifndef GUIDINGLOG_INCLUDED
 #define GUIDINGLOG_INCLUDED
 
+#include "guidelog_binary.h"
 #include "logger.h"
 
 class Mount;
@@ -118,6 +119,13 @@ struct GuideLogSummaryInfo
     void LoadSummaryInfo(wxFFile& guidelog);
 };
 
+class GuideLogWriter;
+
+// Lines are appended to an in-memory buffer and written to the file by a
+// background thread every FlushInterval ms, so the guide loop does not wait on
+// the disk. The buffer is written synchronously when it is full and whenever
+// calibration or guiding starts or stops. When /GuideLog/BinaryLog is set, the
+// same content is also written to a binary log (see guidelog_binary.h).
 class GuidingLog : public Logger
 {
     bool m_enabled;
@@ -127,6 +135,33 @@ class GuidingLog : public Logger
     bool m_isGuiding;
     GuideLogSummaryInfo m_summary;
 
+    wxMutex m_bufLock; // protects m_buf
+    std::string m_buf; // UTF-8 text not yet written to the file
+    wxMutex m_writeLock; // held while the buffered text is written to the file
+    std::string m_writing; // text being written, swapped with m_buf
+    bool m_unflushed; // text was written since the last flush
+    GuideLogWriter *m_writer;
+    std::string m_line; // step line being formatted
+
+    wxFFile m_binFile;
+    bool m_binLog; // writing the binary log; protected by m_bufLock
+    GuideLogBinaryEncoder m_bin; // protected by m_bufLock
+    std::string m_binWriting; // records being written, swapped with the encoder buffer
+
+    friend class GuideLogWriter;
+    void Write(const char *text, size_t len);
+    void Write(const char *text);
+    void Write(const std::string& text);
+    void Write(const wxString& text);
+    void WriteStep(const GuideLogStep& step);
+    void WriteDrop(const GuideLogDrop& drop, const wxString& status);
+    void Mark(GuideLogMark mark, const wxDateTime& time);
+    bool BufferFull() const;
+    void Buffered(bool full);
+    bool WriteBuffered(bool flush);
+    bool WriteBufferedLocked(bool flush);
+    void OpenBinaryLog();
+
     void EnableLogging();
     void DisableLogging();
 
@@ -139,6 +174,9 @@ public:
     bool Flush();
     void CloseGuideLog();
 
+    void StopWriter();
+    void FlushOnCrash();
+
     wxFFile& File();
 
     void StartCalibration(const Mount *pCalibrationMount);
@@ -171,6 +209,8 @@ public:
 
     bool ChangeDirLog(const wxString& newdir);
     void RemoveOldFiles();
+
+    static wxString BinaryLogName(const wxString& textLogName);
 };
 
 inline bool GuidingLog::IsEnabled() const
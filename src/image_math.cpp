@@ -34,6 +34,7 @@
 
 #include "phd.h"
 #include "image_math.h"
+#include "denoise_kernels.h"
 
 #include <wx/wfstream.h>
 #include <wx/txtstrm.h>
@@ -103,45 +104,8 @@ bool QuickLRecon(usImage& img)
         tmp.Clear();
     }
 
-#define IX(x_, y_) ((RY + (y_)) * W + RX + (x_))
-
-    unsigned short *d;
-    unsigned int t;
-
-    for (int y = 0; y <= RH - 2; y++)
-    {
-        d = &tmp.ImageData[IX(0, y)];
-
-        for (int x = 0; x <= RW - 2; x++)
-        {
-            t = img.ImageData[IX(x, y)];
-            t += img.ImageData[IX(x + 1, y)];
-            t += img.ImageData[IX(x, y + 1)];
-            t += img.ImageData[IX(x + 1, y + 1)];
-            *d++ = (unsigned short) (t >> 2);
-        }
-
-        // last col
-        t = img.ImageData[IX(RW - 1, y)];
-        t += img.ImageData[IX(RW - 1, y + 1)];
-        *d = (unsigned short) (t >> 1);
-    }
-
-    // last row
-
-    d = &tmp.ImageData[IX(0, RH - 1)];
-
-    for (int x = 0; x <= RW - 2; x++)
-    {
-        t = img.ImageData[IX(x, RH - 1)];
-        t += img.ImageData[IX(x + 1, RH - 1)];
-        *d++ = (unsigned short) (t >> 1);
-    }
-
-    // bottom-right pixel
-    *d = img.ImageData[IX(RW - 1, RH - 1)];
-
-#undef IX
+    size_t const offset = (size_t) RY * W + RX;
+    DenoiseLRecon(tmp.ImageData + offset, W, img.ImageData + offset, W, RW, RH);
 
     img.SwapImageData(tmp);
     return false;
@@ -172,436 +136,11 @@ bool Median3(usImage& img)
     return false;
 }
 
-inline static void swap(unsigned short& a, unsigned short& b)
-{
-    unsigned short const t = a;
-    a = b;
-    b = t;
-}
-
-inline static unsigned short median9(const unsigned short l[9])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3], l4 = l[4];
-    unsigned short x;
-    x = l[5];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-    x = l[6];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-    x = l[7];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-    x = l[8];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-
-    if (l1 > l0)
-        l0 = l1;
-    if (l2 > l0)
-        l0 = l2;
-    if (l3 > l0)
-        l0 = l3;
-    if (l4 > l0)
-        l0 = l4;
-
-    return l0;
-}
-
-inline static unsigned short median8(const unsigned short l[8])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3], l4 = l[4];
-    unsigned short x;
-
-    x = l[5];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-    x = l[6];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-    x = l[7];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    if (x < l4)
-        swap(x, l4);
-
-    if (l2 > l0)
-        swap(l2, l0);
-    if (l2 > l1)
-        swap(l2, l1);
-
-    if (l3 > l0)
-        swap(l3, l0);
-    if (l3 > l1)
-        swap(l3, l1);
-
-    if (l4 > l0)
-        swap(l4, l0);
-    if (l4 > l1)
-        swap(l4, l1);
-
-    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
-}
-
-inline static unsigned short median6(const unsigned short l[6])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2], l3 = l[3];
-    unsigned short x;
-
-    x = l[4];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-    x = l[5];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    if (x < l3)
-        swap(x, l3);
-
-    if (l2 > l0)
-        swap(l2, l0);
-    if (l2 > l1)
-        swap(l2, l1);
-
-    if (l3 > l0)
-        swap(l3, l0);
-    if (l3 > l1)
-        swap(l3, l1);
-
-    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
-}
-
-inline static unsigned short median5(const unsigned short l[5])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
-    unsigned short x;
-    x = l[3];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-    x = l[4];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-
-    if (l1 > l0)
-        l0 = l1;
-    if (l2 > l0)
-        l0 = l2;
-
-    return l0;
-}
-
-inline static unsigned short median4(const unsigned short l[4])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
-    unsigned short x;
-    x = l[3];
-    if (x < l0)
-        swap(x, l0);
-    if (x < l1)
-        swap(x, l1);
-    if (x < l2)
-        swap(x, l2);
-
-    if (l2 > l0)
-        swap(l2, l0);
-    if (l2 > l1)
-        swap(l2, l1);
-
-    return (unsigned short) (((unsigned int) l0 + (unsigned int) l1) / 2);
-}
-
-inline static unsigned short median3(const unsigned short l[3])
-{
-    unsigned short l0 = l[0], l1 = l[1], l2 = l[2];
-    if (l2 < l0)
-        swap(l2, l0);
-    if (l2 < l1)
-        swap(l2, l1);
-    if (l1 > l0)
-        l0 = l1;
-    return l0;
-}
-
 void Median3(unsigned short *dst, const unsigned short *src, const wxSize& size, const wxRect& rect)
 {
     int const W = size.GetWidth();
-    int const RX = rect.GetX();
-    int const RY = rect.GetY();
-    int const RW = rect.GetWidth();
-    int const RH = rect.GetHeight();
-
-    unsigned short a[9];
-    unsigned short *d;
-
-#define IX(x_, y_) ((RY + (y_)) * W + RX + (x_))
-
-    // top row
-    d = &dst[IX(0, 0)];
-
-    // top-left corner
-    a[0] = src[IX(0, 0)];
-    a[1] = src[IX(1, 0)];
-    a[2] = src[IX(0, 1)];
-    a[3] = src[IX(1, 1)];
-    *d++ = median4(a);
-
-    // top row middle pixels
-    for (int x = 1; x <= RW - 2; x++)
-    {
-        a[0] = src[IX(x - 1, 0)];
-        a[1] = src[IX(x, 0)];
-        a[2] = src[IX(x + 1, 0)];
-        a[3] = src[IX(x - 1, 1)];
-        a[4] = src[IX(x, 1)];
-        a[5] = src[IX(x + 1, 1)];
-        *d++ = median6(a);
-    }
-
-    // top-right corner
-    a[0] = src[IX(RW - 2, 0)];
-    a[1] = src[IX(RW - 1, 0)];
-    a[2] = src[IX(RW - 2, 1)];
-    a[3] = src[IX(RW - 1, 1)];
-    *d = median4(a);
-
-    for (int y = 1; y <= RH - 2; y++)
-    {
-        d = &dst[IX(0, y)];
-
-        // leftmost pixel
-        a[0] = src[IX(0, y - 1)];
-        a[1] = src[IX(1, y - 1)];
-        a[2] = src[IX(0, y)];
-        a[3] = src[IX(1, y)];
-        a[4] = src[IX(0, y + 1)];
-        a[5] = src[IX(1, y + 1)];
-        *d++ = median6(a);
-
-        for (int x = 1; x <= RW - 2; x++)
-        {
-            a[0] = src[IX(x - 1, y - 1)];
-            a[1] = src[IX(x, y - 1)];
-            a[2] = src[IX(x + 1, y - 1)];
-            a[3] = src[IX(x - 1, y)];
-            a[4] = src[IX(x, y)];
-            a[5] = src[IX(x + 1, y)];
-            a[6] = src[IX(x - 1, y + 1)];
-            a[7] = src[IX(x, y + 1)];
-            a[8] = src[IX(x + 1, y + 1)];
-            *d++ = median9(a);
-        }
-
-        // rightmost pixel
-        a[0] = src[IX(RW - 2, y - 1)];
-        a[1] = src[IX(RW - 1, y - 1)];
-        a[2] = src[IX(RW - 2, y)];
-        a[3] = src[IX(RW - 1, y)];
-        a[4] = src[IX(RW - 2, y + 1)];
-        a[5] = src[IX(RW - 1, y + 1)];
-        *d++ = median6(a);
-    }
-
-    // bottom row
-    d = &dst[IX(0, RH - 1)];
-
-    // bottom-left corner
-    a[0] = src[IX(0, RH - 2)];
-    a[1] = src[IX(1, RH - 2)];
-    a[2] = src[IX(0, RH - 1)];
-    a[3] = src[IX(1, RH - 1)];
-    *d++ = median4(a);
-
-    // bottom row middle pixels
-    for (int x = 1; x <= RW - 2; x++)
-    {
-        a[0] = src[IX(x - 1, RH - 2)];
-        a[1] = src[IX(x, RH - 2)];
-        a[2] = src[IX(x + 1, RH - 2)];
-        a[3] = src[IX(x - 1, RH - 1)];
-        a[4] = src[IX(x, RH - 1)];
-        a[5] = src[IX(x + 1, RH - 1)];
-        *d++ = median6(a);
-    }
-
-    // bottom-right corner
-    a[0] = src[IX(RW - 2, RH - 2)];
-    a[1] = src[IX(RW - 1, RH - 2)];
-    a[2] = src[IX(RW - 2, RH - 1)];
-    a[3] = src[IX(RW - 1, RH - 1)];
-    *d = median4(a);
-
-#undef IX
-}
-
-static unsigned short MedianBorderingPixels(const usImage& img, int x, int y)
-{
-    unsigned short array[8];
-    int const xsize = img.Size.GetWidth();
-    int const ysize = img.Size.GetHeight();
-
-    if (x > 0 && y > 0 && x < xsize - 1 && y < ysize - 1)
-    {
-        array[0] = img.ImageData[(x - 1) + (y - 1) * xsize];
-        array[1] = img.ImageData[(x) + (y - 1) * xsize];
-        array[2] = img.ImageData[(x + 1) + (y - 1) * xsize];
-        array[3] = img.ImageData[(x - 1) + (y) *xsize];
-        array[4] = img.ImageData[(x + 1) + (y) *xsize];
-        array[5] = img.ImageData[(x - 1) + (y + 1) * xsize];
-        array[6] = img.ImageData[(x) + (y + 1) * xsize];
-        array[7] = img.ImageData[(x + 1) + (y + 1) * xsize];
-        return median8(array);
-    }
-
-    if (x == 0 && y > 0 && y < ysize - 1)
-    {
-        // On left edge
-        array[0] = img.ImageData[(x) + (y - 1) * xsize];
-        array[1] = img.ImageData[(x) + (y + 1) * xsize];
-        array[2] = img.ImageData[(x + 1) + (y - 1) * xsize];
-        array[3] = img.ImageData[(x + 1) + (y) *xsize];
-        array[4] = img.ImageData[(x + 1) + (y + 1) * xsize];
-        return median5(array);
-    }
-
-    if (x == xsize - 1 && y > 0 && y < ysize - 1)
-    {
-        // On right edge
-        array[0] = img.ImageData[(x) + (y - 1) * xsize];
-        array[1] = img.ImageData[(x) + (y + 1) * xsize];
-        array[2] = img.ImageData[(x - 1) + (y - 1) * xsize];
-        array[3] = img.ImageData[(x - 1) + (y) *xsize];
-        array[4] = img.ImageData[(x - 1) + (y + 1) * xsize];
-        return median5(array);
-    }
-
-    if (y == 0 && x > 0 && x < xsize - 1)
-    {
-        // On bottom edge
-        array[0] = img.ImageData[(x - 1) + (y) *xsize];
-        array[1] = img.ImageData[(x - 1) + (y + 1) * xsize];
-        array[2] = img.ImageData[(x) + (y + 1) * xsize];
-        array[3] = img.ImageData[(x + 1) + (y) *xsize];
-        array[4] = img.ImageData[(x + 1) + (y + 1) * xsize];
-        return median5(array);
-    }
-
-    if (y == ysize - 1 && x > 0 && x < xsize - 1)
-    {
-        // On top edge
-        array[0] = img.ImageData[(x - 1) + (y) *xsize];
-        array[1] = img.ImageData[(x - 1) + (y - 1) * xsize];
-        array[2] = img.ImageData[(x) + (y - 1) * xsize];
-        array[3] = img.ImageData[(x + 1) + (y) *xsize];
-        array[4] = img.ImageData[(x + 1) + (y - 1) * xsize];
-        return median5(array);
-    }
-
-    if (x == 0 && y == 0)
-    {
-        // At lower left corner
-        array[0] = img.ImageData[(x + 1) + (y) *xsize];
-        array[1] = img.ImageData[(x) + (y + 1) * xsize];
-        array[2] = img.ImageData[(x + 1) + (y + 1) * xsize];
-    }
-    else if (x == 0 && y == ysize - 1)
-    {
-        // At upper left corner
-        array[0] = img.ImageData[(x + 1) + (y) *xsize];
-        array[1] = img.ImageData[(x) + (y - 1) * xsize];
-        array[2] = img.ImageData[(x + 1) + (y - 1) * xsize];
-    }
-    else if (x == xsize - 1 && y == ysize - 1)
-    {
-        // At upper right corner
-        array[0] = img.ImageData[(x - 1) + (y) *xsize];
-        array[1] = img.ImageData[(x) + (y - 1) * xsize];
-        array[2] = img.ImageData[(x - 1) + (y - 1) * xsize];
-    }
-    else if (x == xsize - 1 && y == 0)
-    {
-        // At lower right corner
-        array[0] = img.ImageData[(x - 1) + (y) *xsize];
-        array[1] = img.ImageData[(x) + (y + 1) * xsize];
-        array[2] = img.ImageData[(x - 1) + (y + 1) * xsize];
-    }
-    else
-    {
-        // unreachable
-        return 0;
-    }
-
-    return median3(array);
+    size_t const offset = (size_t) rect.GetY() * W + rect.GetX();
+    DenoiseMedian3(dst + offset, W, src + offset, W, rect.GetWidth(), rect.GetHeight());
 }
 
 bool SquarePixels(usImage& img, float xsize, float ysize)
@@ -1164,7 +703,8 @@ bool RemoveDefects(usImage& light, const DefectMap& defectMap)
             // Check to see if we are within the subframe before correcting the defect
             if (light.Subframe.Contains(pt))
             {
-                light.Pixel(pt.x, pt.y) = MedianBorderingPixels(light, pt.x, pt.y);
+                light.Pixel(pt.x, pt.y) = DenoiseDefectPixel(light.ImageData, light.Size.GetWidth(), light.Size.GetHeight(),
+                                                             pt.x, pt.y);
             }
         }
     }
@@ -1179,7 +719,7 @@ bool RemoveDefects(usImage& light, const DefectMap& defectMap)
 
             if (x >= 0 && x < light.Size.GetWidth() && y >= 0 && y < light.Size.GetHeight())
             {
-                light.Pixel(x, y) = MedianBorderingPixels(light, x, y);
+                light.Pixel(x, y) = DenoiseDefectPixel(light.ImageData, light.Size.GetWidth(), light.Size.GetHeight(), x, y);
             }
         }
     }
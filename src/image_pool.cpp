@@ -0,0 +1,168 @@
+/*
+ *  image_pool.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "phd.h"
+#include "image_pool.h"
+
+#include <vector>
+
+enum
+{
+    MAX_POOLED_IMAGES = 4, // the exposing frame, the current frame and the image logger's saved frames
+};
+
+struct ImagePoolState
+{
+    wxCriticalSection lock;
+    std::vector<usImage *> images;
+    bool active;
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int discards;
+
+    ImagePoolState() : active(false), hits(0), misses(0), discards(0) { }
+};
+
+static ImagePoolState s_pool;
+
+void ImagePool::Init()
+{
+    wxCriticalSectionLocker lck(s_pool.lock);
+    s_pool.images.reserve(MAX_POOLED_IMAGES);
+    s_pool.active = true;
+}
+
+void ImagePool::Destroy()
+{
+    LogStats();
+
+    std::vector<usImage *> images;
+    {
+        wxCriticalSectionLocker lck(s_pool.lock);
+        s_pool.active = false;
+        images.swap(s_pool.images);
+    }
+
+    for (usImage *img : images)
+        delete img;
+}
+
+usImage *ImagePool::Acquire(const wxSize& size)
+{
+    usImage *img = nullptr;
+    bool hit = false;
+    unsigned int hits, misses;
+
+    {
+        wxCriticalSectionLocker lck(s_pool.lock);
+
+        unsigned int npixels = size.GetWidth() > 0 && size.GetHeight() > 0 ? size.GetWidth() * size.GetHeight() : 0;
+
+        // prefer a buffer of the right size; usImage::Init will then reuse it as-is
+        for (auto it = s_pool.images.begin(); it != s_pool.images.end(); ++it)
+        {
+            if (npixels && (*it)->NPixels == npixels)
+            {
+                img = *it;
+                s_pool.images.erase(it);
+                hit = true;
+                break;
+            }
+        }
+
+        // otherwise take the most recently returned image; its buffer will be reallocated by Init
+        if (!img && !s_pool.images.empty())
+        {
+            img = s_pool.images.back();
+            s_pool.images.pop_back();
+        }
+
+        if (hit)
+            ++s_pool.hits;
+        else
+            ++s_pool.misses;
+
+        hits = s_pool.hits;
+        misses = s_pool.misses;
+    }
+
+    if (img)
+        img->ResetForReuse();
+    else
+        img = new usImage();
+
+    if (!hit)
+    {
+        Debug.Write(wxString::Format("ImagePool: miss for %dx%d frame, hits=%u misses=%u\n", size.GetWidth(),
+                                     size.GetHeight(), hits, misses));
+    }
+
+    return img;
+}
+
+void ImagePool::Release(usImage *img)
+{
+    if (!img)
+        return;
+
+    {
+        wxCriticalSectionLocker lck(s_pool.lock);
+
+        if (s_pool.active && s_pool.images.size() < MAX_POOLED_IMAGES)
+        {
+            s_pool.images.push_back(img);
+            return;
+        }
+
+        ++s_pool.discards;
+    }
+
+    delete img;
+}
+
+void ImagePool::LogStats()
+{
+    unsigned int hits, misses, discards;
+    size_t pooled;
+
+    {
+        wxCriticalSectionLocker lck(s_pool.lock);
+        hits = s_pool.hits;
+        misses = s_pool.misses;
+        discards = s_pool.discards;
+        pooled = s_pool.images.size();
+    }
+
+    Debug.Write(wxString::Format("ImagePool: hits=%u misses=%u discards=%u pooled=%u\n", hits, misses, discards,
+                                 (unsigned int) pooled));
+}
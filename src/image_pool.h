@@ -0,0 +1,63 @@
+/*
+ *  image_pool.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef IMAGE_POOL_INCLUDED
+#define IMAGE_POOL_INCLUDED
+
+// A small, bounded pool of recycled usImage frame buffers.
+//
+// The exposure pipeline allocates a new usImage for every frame and frees it
+// a few frames later (after the guider and the image logger are done with
+// it).  With large guide sensors this means a full-frame heap allocation and
+// free at the guide cadence.  Frames are drawn from this pool instead and
+// returned to it when released, so that buffers of a matching geometry are
+// reused without touching the allocator.
+class ImagePool
+{
+public:
+    static void Init();
+    static void Destroy();
+
+    // Get an image, preferring a pooled image whose buffer already holds the
+    // given number of pixels. The caller owns the returned image until it is
+    // passed to Release().
+    static usImage *Acquire(const wxSize& size);
+
+    // Return an image to the pool. When the pool is full (or not active) the
+    // image is deleted. Null is accepted and ignored.
+    static void Release(usImage *img);
+
+    static void LogStats();
+};
+
+#endif // IMAGE_POOL_INCLUDED
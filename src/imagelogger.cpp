@@ -70,12 +70,16 @@ struct IL
     void Destroy()
     {
         for (int i = 0; i < SAVE_IMAGES; i++)
-            delete saved_image[i];
+        {
+            ImagePool::Release(saved_image[i]);
+            saved_image[i] = 0;
+        }
     }
 
     void SaveImage(usImage *img)
     {
-        delete saved_image[0];
+        // the oldest saved frame is no longer referenced anywhere, recycle its buffer
+        ImagePool::Release(saved_image[0]);
         for (int i = 1; i < SAVE_IMAGES; i++)
             saved_image[i - 1] = saved_image[i];
         saved_image[SAVE_IMAGES - 1] = img;
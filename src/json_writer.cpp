@@ -0,0 +1,186 @@
+/*
+ *  json_writer.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "json_writer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void JsonAppendString(std::string& out, const char *s, size_t len)
+{
+    static const char HEX[] = "0123456789abcdef";
+
+    out += '"';
+
+    const char *run = s;
+    const char *const end = s + len;
+    for (; s < end; s++)
+    {
+        unsigned char c = (unsigned char) *s;
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        out.append(run, s - run);
+        run = s + 1;
+
+        out += '\\';
+        switch (c)
+        {
+        case '"':
+        case '\\':
+            out += (char) c;
+            break;
+        case '\n':
+            out += 'n';
+            break;
+        case '\r':
+            out += 'r';
+            break;
+        case '\t':
+            out += 't';
+            break;
+        case '\b':
+            out += 'b';
+            break;
+        case '\f':
+            out += 'f';
+            break;
+        default:
+        {
+            char u[5] = { 'u', '0', '0', HEX[c >> 4], HEX[c & 0xf] };
+            out.append(u, sizeof(u));
+            break;
+        }
+        }
+    }
+    out.append(run, end - run);
+
+    out += '"';
+}
+
+void JsonAppendString(std::string& out, const char *s)
+{
+    JsonAppendString(out, s, strlen(s));
+}
+
+void JsonAppendUInt(std::string& out, unsigned long long v)
+{
+    char buf[20];
+    char *const end = buf + sizeof(buf);
+    char *p = end;
+    do
+    {
+        *--p = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v);
+    out.append(p, end - p);
+}
+
+void JsonAppendInt(std::string& out, long long v)
+{
+    if (v < 0)
+    {
+        out += '-';
+        JsonAppendUInt(out, 0ULL - (unsigned long long) v);
+    }
+    else
+        JsonAppendUInt(out, (unsigned long long) v);
+}
+
+static void AppendPrintf(std::string& out, const char *fmt, int prec, double v)
+{
+    char buf[64];
+    int n = snprintf(buf, sizeof(buf), fmt, prec, v);
+    if (n < 0)
+        return;
+    if (n < (int) sizeof(buf))
+    {
+        out.append(buf, n);
+        return;
+    }
+    // very large values in fixed notation
+    size_t pos = out.size();
+    out.resize(pos + n + 1);
+    snprintf(&out[pos], n + 1, fmt, prec, v);
+    out.resize(pos + n);
+}
+
+void JsonAppendFixed(std::string& out, double v, int prec)
+{
+    static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    static const unsigned long long UPOW10[] = { 1ULL,      10ULL,      100ULL,      1000ULL,      10000ULL,
+                                                 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL };
+
+    // The value is scaled to an integer number of units of the last digit and
+    // rounded. Below 1e9 units the error of the scaling is far smaller than
+    // the margin around a halfway case, so the rounding agrees with printf,
+    // which rounds the exact binary value. Halfway cases, large values, NaN
+    // and infinity go to printf.
+    if (prec >= 0 && prec <= 9)
+    {
+        double a = fabs(v) * POW10[prec];
+        if (a < 1e9)
+        {
+            double ip = floor(a);
+            double frac = a - ip;
+            if (fabs(frac - 0.5) > 1e-6)
+            {
+                unsigned long long n = (unsigned long long) ip + (frac > 0.5 ? 1 : 0);
+                if (signbit(v))
+                    out += '-';
+                JsonAppendUInt(out, n / UPOW10[prec]);
+                if (prec > 0)
+                {
+                    unsigned long long f = n % UPOW10[prec];
+                    char digits[9];
+                    for (int i = prec - 1; i >= 0; i--)
+                    {
+                        digits[i] = (char) ('0' + f % 10);
+                        f /= 10;
+                    }
+                    out += '.';
+                    out.append(digits, prec);
+                }
+                return;
+            }
+        }
+    }
+
+    AppendPrintf(out, "%.*f", prec, v);
+}
+
+void JsonAppendDouble(std::string& out, double v)
+{
+    AppendPrintf(out, "%.*g", 6, v);
+}
@@ -0,0 +1,186 @@
+/*
+ *  json_writer.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef JSON_WRITER_INCLUDED
+#define JSON_WRITER_INCLUDED
+
+#include <stddef.h>
+#include <string>
+
+// Streaming JSON encoder used by the event server. Values are appended as
+// UTF-8 text to a byte buffer that keeps its capacity when it is cleared, so
+// an event can be encoded without allocating once the buffer has grown, and
+// the encoded bytes are sent as they are to every client.
+
+// Append a value to a JSON text buffer. Strings are UTF-8; they are quoted
+// and escaped.
+void JsonAppendString(std::string& out, const char *s, size_t len);
+void JsonAppendString(std::string& out, const char *s);
+void JsonAppendInt(std::string& out, long long v);
+void JsonAppendUInt(std::string& out, unsigned long long v);
+// same text as printf("%.*f", prec, v)
+void JsonAppendFixed(std::string& out, double v, int prec);
+// same text as printf("%g", v)
+void JsonAppendDouble(std::string& out, double v);
+
+class JsonWriter
+{
+    std::string m_buf;
+    bool m_needComma; // a value was written at the current nesting level
+
+    void Sep()
+    {
+        if (m_needComma)
+            m_buf += ',';
+        m_needComma = true;
+    }
+
+public:
+    JsonWriter() : m_needComma(false) { }
+
+    // discard the text but keep the buffer
+    void Clear()
+    {
+        m_buf.clear();
+        m_needComma = false;
+    }
+    void Reserve(size_t n) { m_buf.reserve(n); }
+
+    const std::string& Str() const { return m_buf; }
+    const char *Data() const { return m_buf.data(); }
+    size_t Size() const { return m_buf.size(); }
+
+    JsonWriter& BeginObject()
+    {
+        Sep();
+        m_buf += '{';
+        m_needComma = false;
+        return *this;
+    }
+    JsonWriter& EndObject()
+    {
+        m_buf += '}';
+        m_needComma = true;
+        return *this;
+    }
+    JsonWriter& BeginArray()
+    {
+        Sep();
+        m_buf += '[';
+        m_needComma = false;
+        return *this;
+    }
+    JsonWriter& EndArray()
+    {
+        m_buf += ']';
+        m_needComma = true;
+        return *this;
+    }
+
+    // member name; the next value written is the member's value
+    JsonWriter& Key(const char *name)
+    {
+        Sep();
+        JsonAppendString(m_buf, name);
+        m_buf += ':';
+        m_needComma = false;
+        return *this;
+    }
+
+    JsonWriter& String(const char *s, size_t len)
+    {
+        Sep();
+        JsonAppendString(m_buf, s, len);
+        return *this;
+    }
+    JsonWriter& String(const char *s)
+    {
+        Sep();
+        JsonAppendString(m_buf, s);
+        return *this;
+    }
+    JsonWriter& String(const std::string& s) { return String(s.data(), s.size()); }
+    JsonWriter& Int(long long v)
+    {
+        Sep();
+        JsonAppendInt(m_buf, v);
+        return *this;
+    }
+    JsonWriter& UInt(unsigned long long v)
+    {
+        Sep();
+        JsonAppendUInt(m_buf, v);
+        return *this;
+    }
+    JsonWriter& Fixed(double v, int prec)
+    {
+        Sep();
+        JsonAppendFixed(m_buf, v, prec);
+        return *this;
+    }
+    JsonWriter& Double(double v)
+    {
+        Sep();
+        JsonAppendDouble(m_buf, v);
+        return *this;
+    }
+    JsonWriter& Bool(bool v)
+    {
+        Sep();
+        m_buf += v ? "true" : "false";
+        return *this;
+    }
+    JsonWriter& Null()
+    {
+        Sep();
+        m_buf += "null";
+        return *this;
+    }
+    // a value that is already JSON text
+    JsonWriter& Raw(const char *json, size_t len)
+    {
+        Sep();
+        m_buf.append(json, len);
+        return *this;
+    }
+    JsonWriter& Raw(const std::string& json) { return Raw(json.data(), json.size()); }
+
+    // terminate the text with the line ending used by the event server protocol
+    JsonWriter& EndLine()
+    {
+        m_buf += "\r\n";
+        return *this;
+    }
+};
+
+#endif // JSON_WRITER_INCLUDED
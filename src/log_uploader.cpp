@@ -214,6 +214,27 @@ static void FillActivity(wxGrid *grid, int row, const Session& session, bool res
     }
 }
 
+// Summarize a session from its binary guide log when there is one covering
+// the whole text log; this reads the log index instead of every line
+static bool LoadBinarySummary(Session& session)
+{
+    wxFileName fn(Debug.GetLogDir(), GuidingLog::BinaryLogName(GuideLogName(session)));
+    if (!fn.FileExists())
+        return false;
+
+    wxFFile file(fn.GetFullPath(), "rb");
+    GuideLogBinarySummary sum;
+    if (!file.IsOpened() || !GuideLogBinaryScan(file.fp(), &sum))
+        return false;
+
+    session.summary.cal_cnt = sum.cal_cnt;
+    session.summary.guide_cnt = sum.guide_cnt;
+    session.summary.guide_dur = sum.guide_dur;
+    session.summary.ga_cnt = sum.ga_cnt;
+    session.summary.valid = true;
+    return true;
+}
+
 void LogScanner::FindNextRow()
 {
     while (!m_q.empty())
@@ -226,6 +247,14 @@ void LogScanner::FindNextRow()
 
         int row = s_grid_row[idx];
 
+        if (LoadBinarySummary(session))
+        {
+            session.summary_loaded = ST_LOADED;
+            FillActivity(m_grid, row, session, true);
+            m_q.pop_front();
+            continue;
+        }
+
         wxFileName fn(Debug.GetLogDir(), GuideLogName(session));
         m_ifs.open(fn.GetFullPath().fn_str());
         if (!m_ifs)
@@ -418,6 +447,8 @@ static void ReallyFlush(const wxFFile& ffile)
 static void FlushLogs()
 {
     ReallyFlush(Debug);
+    // write out the lines buffered for the guide log writer thread
+    GuideLog.Flush();
     ReallyFlush(GuideLog.File());
 }
 
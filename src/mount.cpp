@@ -37,6 +37,7 @@
 #include "backlash_comp.h"
 #include "guiding_assistant.h"
 #include "gaussian_process_guider.h"
+#include "shm_frame_ring_integration.h"
 
 #include <wx/tokenzr.h>
 #include <cstdarg>
@@ -964,6 +965,7 @@ void Mount::LogGuideStepInfo()
     pFrame->UpdateStatusBarGuiderInfo(m_lastStep);
     GuideLog.GuideStep(m_lastStep);
     EvtServer.NotifyGuideStep(m_lastStep);
+    FrameRingSHMManager::PublishGuideStep(m_lastStep);
 
     if (m_lastStep.moveOptions & MOVEOPT_GRAPH)
     {
@@ -979,6 +981,10 @@ Mount::MOVE_RESULT Mount::MoveOffset(GuiderOffset *ofs, unsigned int moveOptions
 {
     MOVE_RESULT result = MOVE_OK;
 
+    // only guide steps are timed, direct moves do not go through the guide algorithms
+    bool timed = (moveOptions & (MOVEOPT_ALGO_RESULT | MOVEOPT_ALGO_DEDUCE)) != 0;
+    TimingProbe algoProbe(GuideTiming::STAGE_GUIDE_ALGORITHM, timed);
+
     try
     {
         double xDistance, yDistance;
@@ -1015,7 +1021,14 @@ Mount::MOVE_RESULT Mount::MoveOffset(GuiderOffset *ofs, unsigned int moveOptions
             if (m_backlashComp)
                 m_backlashComp->TrackBLCResults(moveOptions, yDistance);
 
-            if (moveOptions & MOVEOPT_ALGO_RESULT)
+            if (moveOptions & MOVEOPT_NO_PULSE)
+            {
+                // the frame does not show the full effect of the previous move, so it is
+                // recorded but kept away from the guide algorithms
+                xDistance = 0.0;
+                yDistance = 0.0;
+            }
+            else if (moveOptions & MOVEOPT_ALGO_RESULT)
             {
                 // Feed the raw distances to the guide algorithms
                 if (m_pXGuideAlgorithm)
@@ -1036,18 +1049,42 @@ Mount::MOVE_RESULT Mount::MoveOffset(GuiderOffset *ofs, unsigned int moveOptions
 
         int requestedXAmount = ROUND(fabs(xDistance / m_xRate));
         MoveResultInfo xMoveResult;
-        result = MoveAxis(xDirection, requestedXAmount, moveOptions, &xMoveResult);
-
         MoveResultInfo yMoveResult;
-        if (result != MOVE_ERROR_SLEWING && result != MOVE_ERROR_AO_LIMIT_REACHED)
+
+        algoProbe.Stop();
+        TimingProbe pulseProbe(GuideTiming::STAGE_PULSE, timed);
+
+        if (moveOptions & MOVEOPT_NO_PULSE)
         {
+            Debug.Write("no guide pulse for overlapped frame\n");
+        }
+        else if (CanMoveAxesConcurrently())
+        {
+            // start both moves together so the step takes as long as the longer of the two moves
             int requestedYAmount = ROUND(fabs(yDistance / m_cal.yRate));
 
             if (m_backlashComp)
                 m_backlashComp->ApplyBacklashComp(moveOptions, yDistance, &requestedYAmount);
 
-            result = MoveAxis(yDirection, requestedYAmount, moveOptions, &yMoveResult);
+            result = MoveAxes(xDirection, requestedXAmount, yDirection, requestedYAmount, moveOptions, &xMoveResult,
+                              &yMoveResult);
         }
+        else
+        {
+            result = MoveAxis(xDirection, requestedXAmount, moveOptions, &xMoveResult);
+
+            if (result != MOVE_ERROR_SLEWING && result != MOVE_ERROR_AO_LIMIT_REACHED)
+            {
+                int requestedYAmount = ROUND(fabs(yDistance / m_cal.yRate));
+
+                if (m_backlashComp)
+                    m_backlashComp->ApplyBacklashComp(moveOptions, yDistance, &requestedYAmount);
+
+                result = MoveAxis(yDirection, requestedYAmount, moveOptions, &yMoveResult);
+            }
+        }
+
+        pulseProbe.Stop();
 
         // Record the info about the guide step. The info will be picked up back in the main UI thread.
         // We don't want to do anything with the info here in the worker thread since UI operations are
@@ -1435,6 +1472,20 @@ bool Mount::SynchronousOnly()
     return false;
 }
 
+bool Mount::CanMoveAxesConcurrently()
+{
+    return false;
+}
+
+Mount::MOVE_RESULT Mount::MoveAxes(GUIDE_DIRECTION xDirection, int xAmount, GUIDE_DIRECTION yDirection, int yAmount,
+                                   unsigned int moveOptions, MoveResultInfo *xMoveResult, MoveResultInfo *yMoveResult)
+{
+    MOVE_RESULT result = MoveAxis(xDirection, xAmount, moveOptions, xMoveResult);
+    if (result != MOVE_ERROR_SLEWING && result != MOVE_ERROR_AO_LIMIT_REACHED)
+        result = MoveAxis(yDirection, yAmount, moveOptions, yMoveResult);
+    return result;
+}
+
 bool Mount::HasSetupDialog() const
 {
     return false;
@@ -1518,6 +1569,8 @@ wxString DumpMoveOptionBits(unsigned int moveOptions)
         *p++ = 'G';
     if (moveOptions & MOVEOPT_MANUAL)
         *p++ = 'M';
+    if (moveOptions & MOVEOPT_NO_PULSE)
+        *p++ = 'N';
     *p = 0;
     return buf;
 }
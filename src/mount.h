@@ -129,6 +129,7 @@ enum MountMoveOptionBits
     MOVEOPT_USE_BLC = (1 << 2), // use backlash comp for this move
     MOVEOPT_GRAPH = (1 << 3), // display the move on the graphs
     MOVEOPT_MANUAL = (1 << 4), // manual move - allow even when guiding disabled
+    MOVEOPT_NO_PULSE = (1 << 5), // record the step without moving (frame overlapped the previous move)
 };
 
 enum
@@ -138,6 +139,7 @@ enum
     MOVEOPTS_DEDUCED_MOVE = MOVEOPT_ALGO_DEDUCE | MOVEOPT_USE_BLC | MOVEOPT_GRAPH,
     MOVEOPTS_RECOVERY_MOVE = MOVEOPT_USE_BLC,
     MOVEOPTS_AO_BUMP = MOVEOPT_USE_BLC,
+    MOVEOPTS_OVERLAPPED_STEP = MOVEOPT_NO_PULSE | MOVEOPT_GRAPH,
 };
 
 extern wxString DumpMoveOptionBits(unsigned int moveOptions);
@@ -342,6 +344,11 @@ public:
 public:
     virtual bool HasNonGuiMove();
     virtual bool SynchronousOnly();
+    // true if the x and y moves of a guide step can run at the same time, see MoveAxes()
+    virtual bool CanMoveAxesConcurrently();
+    // move both axes, starting the two moves together and returning when both have finished
+    virtual MOVE_RESULT MoveAxes(GUIDE_DIRECTION xDirection, int xAmount, GUIDE_DIRECTION yDirection, int yAmount,
+                                 unsigned int moveOptions, MoveResultInfo *xMoveResult, MoveResultInfo *yMoveResult);
     virtual bool HasSetupDialog() const;
     virtual void SetupDialog();
 
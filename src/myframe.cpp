@@ -46,6 +46,7 @@
 #include "shm_camera_integration.h"
 #include "shm_mount_integration.h"
 #include "shm_monitor.h"
+#include "shm_frame_ring_integration.h"
 #include "camera_config_manager.h"
 #include "camera_config_monitor.h"
 
@@ -66,6 +67,8 @@ static const bool DefaultDitherRaOnly = false;
 static const DitherMode DefaultDitherMode = DITHER_RANDOM;
 static const bool DefaultServerMode = true;
 static const int DefaultTimelapse = 0;
+static const bool DefaultPipelinedGuiding = false;
+static const int DefaultPipelineDelay = 0;
 static const int DefaultFocalLength = 0;
 static const int DefaultExposureDuration = 1000;
 static const int DefaultAutoExpMin = 1000;
@@ -221,10 +224,16 @@ MyFrame::MyFrame()
     m_mgr.SetManagedWindow(this);
 
     m_frameCounter = 0;
+    m_headless = false;
     m_pPrimaryWorkerThread = nullptr;
     StartWorkerThread(m_pPrimaryWorkerThread);
     m_pSecondaryWorkerThread = nullptr;
     StartWorkerThread(m_pSecondaryWorkerThread);
+    m_movePipeline = new MovePipeline();
+    m_pMoveWorkerThread = nullptr; // started when pipelined guiding is enabled
+    m_lastMoveTime = 0;
+    m_pipelinedGuiding = DefaultPipelinedGuiding;
+    m_pipelineDelay = DefaultPipelineDelay;
 
     m_statusbarTimer.SetOwner(this, STATUSBAR_TIMER_EVENT);
 
@@ -238,6 +247,9 @@ MyFrame::MyFrame()
     
     // Initialize mount list shared memory
     MountSHMManager::Initialize();
+
+    // The guide frame ring is created on the first frame if it is enabled
+    FrameRingSHMManager::Initialize();
     
     // Start global SHM monitor thread for headless mode support
     SHMMonitor::Start();
@@ -455,9 +467,14 @@ MyFrame::~MyFrame()
     // Shutdown mount list shared memory
     MountSHMManager::Shutdown();
 
+    // Remove the guide frame ring
+    FrameRingSHMManager::Shutdown();
+
     delete pGearDialog;
     pGearDialog = nullptr;
 
+    delete m_movePipeline;
+
     pAdvancedDialog->Destroy();
 
     if (pDriftTool)
@@ -892,6 +909,9 @@ void MyFrame::LoadProfileSettings()
     int timeLapse = pConfig->Profile.GetInt("/frame/timeLapse", DefaultTimelapse);
     SetTimeLapse(timeLapse);
 
+    SetPipelinedGuiding(pConfig->Profile.GetBoolean("/frame/PipelinedGuiding", DefaultPipelinedGuiding));
+    SetPipelineDelay(pConfig->Profile.GetInt("/frame/PipelineDelay", DefaultPipelineDelay));
+
     SetVariableDelayConfig(pConfig->Profile.GetBoolean("/frame/var_delay/enabled", false),
                            pConfig->Profile.GetInt("/frame/var_delay/short_delay", 1000),
                            pConfig->Profile.GetInt("/frame/var_delay/long_delay", 10000));
@@ -1759,7 +1779,7 @@ void MyFrame::ScheduleExposure()
 
     m_exposurePending = true;
 
-    usImage *img = new usImage();
+    usImage *img = ImagePool::Acquire(pCamera ? pCamera->FrameSize : wxSize());
 
     wxCriticalSectionLocker lock(m_CSpWorkerThread);
 
@@ -1780,6 +1800,14 @@ void MyFrame::SchedulePrimaryMove(Mount *mount, const GuiderOffset& ofs, unsigne
     if ((moveOptions & MOVEOPT_MANUAL) == 0)
         mount->IncrementRequestCount();
 
+    if (m_pipelinedGuiding && m_pMoveWorkerThread && !mount->SynchronousOnly())
+    {
+        // the move runs on its own thread so the primary thread can start the next exposure;
+        // mounts that guide through the camera must stay synchronous with it
+        m_pMoveWorkerThread->EnqueueWorkerThreadMoveRequest(mount, ofs, moveOptions, m_movePipeline);
+        return;
+    }
+
     assert(m_pPrimaryWorkerThread);
     m_pPrimaryWorkerThread->EnqueueWorkerThreadMoveRequest(mount, ofs, moveOptions);
 }
@@ -1818,6 +1846,14 @@ void MyFrame::ScheduleAxisMove(Mount *mount, const GUIDE_DIRECTION direction, in
     if ((moveOptions & MOVEOPT_MANUAL) == 0)
         mount->IncrementRequestCount();
 
+    if (m_pipelinedGuiding && m_pMoveWorkerThread && mount == pMount && !mount->SynchronousOnly())
+    {
+        // the mount's guide moves run on the move thread, so its calibration and manual moves must
+        // too, otherwise two threads could drive the mount at once
+        m_pMoveWorkerThread->EnqueueWorkerThreadAxisMove(mount, direction, duration, moveOptions, m_movePipeline);
+        return;
+    }
+
     assert(m_pPrimaryWorkerThread);
     m_pPrimaryWorkerThread->EnqueueWorkerThreadAxisMove(mount, direction, duration, moveOptions);
 }
@@ -1898,6 +1934,7 @@ void MyFrame::StartCapturing()
 
         CaptureActive = true;
         m_frameCounter = 0;
+        m_cycleTimer.Start();
 
         CheckDarkFrameGeometry();
         UpdateButtonsStatus();
@@ -1935,6 +1972,10 @@ bool MyFrame::StopCapturing()
         StatusMsgNoTimeout(_("Waiting for devices..."));
         m_continueCapturing = false;
 
+        // a pipelined guide pulse may still be running on the move thread
+        if (m_pMoveWorkerThread)
+            m_pMoveWorkerThread->RequestStop();
+
         if (m_exposurePending)
         {
             m_pPrimaryWorkerThread->RequestStop();
@@ -2203,6 +2244,8 @@ void MyFrame::OnClose(wxCloseEvent& event)
     bool killed = StopWorkerThread(m_pPrimaryWorkerThread);
     if (StopWorkerThread(m_pSecondaryWorkerThread))
         killed = true;
+    if (StopWorkerThread(m_pMoveWorkerThread))
+        killed = true;
 
     // disconnect all gear
     pGearDialog->Shutdown(killed);
@@ -2299,6 +2342,7 @@ void MyFrame::NotifyGuidingStarted()
     m_guidingStarted = wxDateTime::UNow();
     m_guidingElapsed.Start();
     m_frameCounter = 0;
+    GuideLoopTiming.Reset();
 
     if (pMount)
         pMount->NotifyGuidingStarted();
@@ -2322,6 +2366,8 @@ void MyFrame::NotifyGuidingStopped()
     EvtServer.NotifyGuidingStopped();
     GuideLog.GuidingStopped();
     PhdController::AbortController("Guiding stopped");
+
+    Debug.Write("Guide loop timing:\n" + wxString(GuideLoopTiming.FormatSummary()));
 }
 
 void MyFrame::SetAutoLoadCalibration(bool val)
@@ -2472,6 +2518,94 @@ static bool save_multi_darks(const ExposureImgMap& darks, const wxString& fname,
     return bError;
 }
 
+static int read_dark_exposure(fitsfile *fptr)
+{
+    int status = 0;
+    char keyname[] = "EXPOSURE";
+    float exposure;
+    if (fits_read_key(fptr, TFLOAT, keyname, &exposure, nullptr, &status))
+    {
+        exposure = (float) pFrame->RequestedExposureDuration() / 1000.0;
+        Debug.Write(wxString::Format("missing EXPOSURE value, assume %.3f\n", exposure));
+    }
+    return ROUNDF(exposure * 1000.0);
+}
+
+// Read a single frame of the dark library. Only the frame headers are read when the library
+// is loaded; the pixels of a frame are read here when the frame is first used. Can be called from the
+// camera worker thread, so errors are only logged; the caller alerts the user.
+usImage *MyFrame::ReadDarkLibraryFrame(const wxString& fname, int hdu)
+{
+    fitsfile *fptr = 0;
+    int status = 0; // CFITSIO status value MUST be initialized to zero!
+    std::unique_ptr<usImage> img;
+
+    try
+    {
+        if (PHD_fits_open_diskfile(&fptr, fname, READONLY, &status))
+        {
+            throw ERROR_INFO("error opening dark library " + fname);
+        }
+
+        long fsize[2];
+        if (fits_movabs_hdu(fptr, hdu, nullptr, &status) || fits_get_img_size(fptr, 2, fsize, &status))
+        {
+            throw ERROR_INFO("error reading dark library " + fname);
+        }
+
+        img.reset(new usImage());
+
+        if (img->Init((int) fsize[0], (int) fsize[1]))
+        {
+            throw ERROR_INFO("Memory Allocation failure");
+        }
+
+        long fpixel[] = { 1, 1, 1 };
+        if (fits_read_pix(fptr, TUSHORT, fpixel, fsize[0] * fsize[1], nullptr, img->ImageData, nullptr, &status))
+        {
+            throw ERROR_INFO("error reading dark library " + fname);
+        }
+
+        img->ImgExpDur = read_dark_exposure(fptr);
+
+        char binning_key[] = "XBINNING";
+        int binning = 1;
+        fits_read_key(fptr, TINT, binning_key, &binning, nullptr, &status);
+        img->Binning = wxMax(binning, 1);
+        status = 0;
+
+        char saturate_key[] = "SATURATE";
+        int saturate = 65535;
+        fits_read_key(fptr, TINT, saturate_key, &saturate, nullptr, &status);
+        img->BitsPerPixel = saturate >= 256 ? 16 : 8;
+        status = 0;
+
+        char gain_key[] = "GAIN";
+        int gain = 0;
+        fits_read_key(fptr, TINT, gain_key, &gain, nullptr, &status);
+        img->Gain = gain;
+        status = 0;
+
+        img->CalcStats();
+
+        Debug.Write(wxString::Format("loaded dark frame exposure = %d, med = %u, %dx%d bin %d, bpp = %d, gain = %d\n",
+                                     img->ImgExpDur, img->MedianADU, img->Size.x, img->Size.y, img->Binning, img->BitsPerPixel,
+                                     img->Gain));
+    }
+    catch (const wxString& Msg)
+    {
+        POSSIBLY_UNUSED(Msg);
+        img.reset();
+    }
+
+    if (fptr)
+    {
+        PHD_fits_close_file(fptr);
+    }
+
+    return img.release();
+}
+
 static bool load_multi_darks(GuideCamera *camera, const wxString& fname)
 {
     bool bError = false;
@@ -2523,60 +2657,16 @@ static bool load_multi_darks(GuideCamera *camera, const wxString& fname)
                 last_frame_size[0] = fsize[0];
                 last_frame_size[1] = fsize[1];
 
-                std::unique_ptr<usImage> img(new usImage());
-
-                if (img->Init((int) fsize[0], (int) fsize[1]))
-                {
-                    pFrame->Alert(wxString::Format(_("Memory allocation error reading FITS file %s"), fname));
-                    throw ERROR_INFO("Memory Allocation failure");
-                }
-
-                long fpixel[] = { 1, 1, 1 };
-                if (fits_read_pix(fptr, TUSHORT, fpixel, fsize[0] * fsize[1], nullptr, img->ImageData, nullptr, &status))
-                {
-                    pFrame->Alert(wxString::Format(_("Error reading data from %s"), fname));
-                    throw ERROR_INFO("Error reading");
-                }
-
-                char keyname[] = "EXPOSURE";
-                float exposure;
-                if (fits_read_key(fptr, TFLOAT, keyname, &exposure, nullptr, &status))
-                {
-                    exposure = (float) pFrame->RequestedExposureDuration() / 1000.0;
-                    Debug.Write(wxString::Format("missing EXPOSURE value, assume %.3f\n", exposure));
-                    status = 0;
-                }
-                img->ImgExpDur = ROUNDF(exposure * 1000.0);
-
-                char binning_key[] = "XBINNING";
-                int binning = 1;
-                fits_read_key(fptr, TINT, binning_key, &binning, nullptr, &status);
-                img->Binning = wxMax(binning, 1);
-                status = 0;
-
-                char saturate_key[] = "SATURATE";
-                int saturate = 65535;
-                fits_read_key(fptr, TINT, saturate_key, &saturate, nullptr, &status);
-                img->BitsPerPixel = saturate >= 256 ? 16 : 8;
-                status = 0;
-
-                char gain_key[] = "GAIN";
-                int gain = 0;
-                fits_read_key(fptr, TINT, gain_key, &gain, nullptr, &status);
-                img->Gain = gain;
-                status = 0;
-
-                img->CalcStats();
+                // only index the frame here, the pixels are read when the frame is selected
+                int exposure = read_dark_exposure(fptr);
+                int hdunr = 0;
+                fits_get_hdu_num(fptr, &hdunr);
 
-                Debug.Write(wxString::Format("loaded dark frame exposure = %d, med = %u, %dx%d bin %d, bpp = %d, gain = %d\n",
-                                             img->ImgExpDur, img->MedianADU, img->Size.x, img->Size.y, img->Binning,
-                                             img->BitsPerPixel, img->Gain));
+                Debug.Write(wxString::Format("found dark frame exposure = %d, hdu = %d\n", exposure, hdunr));
 
-                camera->AddDark(img.release());
+                camera->AddLibraryDark(fname, exposure, hdunr);
 
                 // if this is the last hdu, we are done
-                int hdunr = 0;
-                fits_get_hdu_num(fptr, &hdunr);
                 if (status || hdunr >= nhdus)
                     break;
 
@@ -2756,7 +2846,8 @@ void MyFrame::SaveDarkLibrary(const wxString& note)
 
     Debug.Write("saving dark library\n");
 
-    if (save_multi_darks(pCamera->Darks, filename, note))
+    // the library file is about to be replaced, so any darks still in it must be read first
+    if (!pCamera->LoadAllDarks() || save_multi_darks(pCamera->Darks, filename, note))
     {
         Alert(wxString::Format(_("Error saving darks FITS file %s"), filename));
     }
@@ -2812,6 +2903,47 @@ bool MyFrame::SetTimeLapse(int timeLapse)
     return bError;
 }
 
+// In pipelined mode the first mount's guide moves run on a separate worker thread, and the
+// next exposure starts once the guide pulse has been issued plus the pipeline delay instead
+// of after the pulse completes. The move thread is started the first time pipelining is enabled.
+void MyFrame::SetPipelinedGuiding(bool pipelined)
+{
+    if (pipelined && StartWorkerThread(m_pMoveWorkerThread))
+    {
+        Debug.Write("Could not start the move worker thread, pipelined guiding disabled\n");
+        pipelined = false;
+    }
+
+    m_pipelinedGuiding = pipelined;
+    pConfig->Profile.SetBoolean("/frame/PipelinedGuiding", m_pipelinedGuiding);
+    Debug.Write(wxString::Format("Pipelined guiding set to %s\n", pipelined ? "true" : "false"));
+}
+
+bool MyFrame::SetPipelineDelay(int delay)
+{
+    bool bError = false;
+
+    try
+    {
+        if (delay < 0)
+        {
+            throw ERROR_INFO("pipelineDelay < 0");
+        }
+
+        m_pipelineDelay = delay;
+    }
+    catch (const wxString& Msg)
+    {
+        POSSIBLY_UNUSED(Msg);
+        bError = true;
+        m_pipelineDelay = DefaultPipelineDelay;
+    }
+
+    pConfig->Profile.SetInt("/frame/PipelineDelay", m_pipelineDelay);
+
+    return bError;
+}
+
 bool MyFrame::SetFocalLength(int focalLength)
 {
     bool bError = false;
@@ -2903,17 +3035,47 @@ void MyFrame::SetBeepForLostStar(bool beep)
     Debug.Write(wxString::Format("Beep for lost star set to %s\n", beep ? "true" : "false"));
 }
 
+// In headless mode the guide loop does no display work: the guider image is
+// only rendered when a paint is requested, and the graph, target and stats
+// windows just collect their data. Leaving headless mode brings them all up
+// to date.
+void MyFrame::SetHeadless(bool headless)
+{
+    if (headless == m_headless)
+        return;
+
+    m_headless = headless;
+    Debug.Write(wxString::Format("Headless mode set to %s\n", headless ? "true" : "false"));
+
+    if (!headless)
+    {
+        if (pGuider)
+        {
+            pStatsWin->UpdateImageSize(pGuider->CurrentImage()->Size);
+            pGuider->UpdateImageDisplay();
+        }
+        pGraphLog->UpdateControls();
+        pGraphLog->Refresh();
+        pTarget->Refresh();
+        pStepGuiderGraph->Refresh();
+        pStatsWin->UpdateStats();
+    }
+}
+
 wxString MyFrame::GetSettingsSummary() const
 {
     // return a loggable summary of current global configs managed by MyFrame
     return wxString::Format(
-        "Dither = %s, Dither scale = %.3f, Image noise reduction = %s, Guide-frame time lapse = %d, Server %s\n"
+        "Dither = %s, Dither scale = %.3f, Image noise reduction = %s, Guide-frame time lapse = %d, Server %s, "
+        "Pipelined guiding = %s\n"
         "%s\n",
         m_ditherRaOnly ? "RA only" : "both axes", m_ditherScaleFactor,
         m_noiseReductionMethod == NR_NONE          ? "none"
             : m_noiseReductionMethod == NR_2x2MEAN ? "2x2 mean"
                                                    : "3x3 median",
-        m_timeLapse, m_serverMode ? "enabled" : "disabled", PixelScaleSummary());
+        m_timeLapse, m_serverMode ? "enabled" : "disabled",
+        m_pipelinedGuiding ? wxString::Format("enabled, delay = %d", m_pipelineDelay) : wxString("disabled"),
+        PixelScaleSummary());
 }
 
 void MyFrame::RegisterTextCtrl(wxTextCtrl *ctrl)
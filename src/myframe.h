@@ -38,6 +38,7 @@
 #define MYFRAME_H_INCLUDED
 
 class WorkerThread;
+class MovePipeline;
 class MyFrame;
 class RefineDefMap;
 struct alert_params;
@@ -200,9 +201,12 @@ private:
     DitherSpiral m_ditherSpiral;
     bool m_serverMode;
     int m_timeLapse; // Delay between frames (useful for vid cameras)
+    bool m_pipelinedGuiding; // start the next exposure while the guide pulse is running
+    int m_pipelineDelay; // ms after the guide pulse starts before the next exposure may start
     VarDelayCfg m_varDelayConfig;
     int m_focalLength;
     bool m_beepForLostStar;
+    bool m_headless; // skip all display work in the guide loop
     double m_sampling;
     bool m_autoLoadCalibration;
 
@@ -391,6 +395,7 @@ public:
     void SaveDarkLibrary(const wxString& note);
     static void DeleteDarkLibraryFiles(int profileID);
     static wxString DarkLibFileName(int profileId);
+    static usImage *ReadDarkLibraryFrame(const wxString& fname, int hdu);
     void SetDarkMenuState();
     bool LoadDarkHandler(bool checkIt); // Use to also set menu item states
     void LoadDefectMapHandler(bool checkIt);
@@ -404,6 +409,12 @@ public:
     static void PlaceWindowOnScreen(wxWindow *window, int x, int y);
     bool GetBeepForLostStar();
     void SetBeepForLostStar(bool beep);
+    bool IsHeadless() const;
+    void SetHeadless(bool headless);
+    bool GetPipelinedGuiding() const;
+    void SetPipelinedGuiding(bool pipelined);
+    int GetPipelineDelay() const;
+    bool SetPipelineDelay(int delay);
 
     MyFrameConfigDialogPane *GetConfigDialogPane(wxWindow *pParent);
     MyFrameConfigDialogCtrlSet *GetConfigDlgCtrlSet(MyFrame *pFrame, AdvancedDialog *pAdvancedDialog, BrainCtrlIdMap& CtrlMap);
@@ -489,6 +500,10 @@ private:
     wxCriticalSection m_CSpWorkerThread;
     WorkerThread *m_pPrimaryWorkerThread;
     WorkerThread *m_pSecondaryWorkerThread;
+    WorkerThread *m_pMoveWorkerThread; // first mount's guide moves when guiding is pipelined
+    MovePipeline *m_movePipeline;
+    long m_lastMoveTime; // duration of the last completed move of the first mount, ms
+    wxStopWatch m_cycleTimer; // time since the previous exposure completed
 
     wxSocketServer *SocketServer;
     wxTimer m_statusbarTimer;
@@ -711,6 +726,8 @@ enum
     SOCK_SERVER_CLIENT_ID,
     EVENT_SERVER_ID,
     EVENT_SERVER_CLIENT_ID,
+    FRAME_SERVER_ID,
+    FRAME_SERVER_CLIENT_ID,
 };
 
 wxDECLARE_EVENT(APPSTATE_NOTIFY_EVENT, wxCommandEvent);
@@ -777,11 +794,26 @@ inline bool MyFrame::GetServerMode() const
     return m_serverMode;
 }
 
+inline bool MyFrame::IsHeadless() const
+{
+    return m_headless;
+}
+
 inline int MyFrame::GetTimeLapse() const
 {
     return m_timeLapse;
 }
 
+inline bool MyFrame::GetPipelinedGuiding() const
+{
+    return m_pipelinedGuiding;
+}
+
+inline int MyFrame::GetPipelineDelay() const
+{
+    return m_pipelineDelay;
+}
+
 inline int MyFrame::GetFocalLength() const
 {
     return m_focalLength;
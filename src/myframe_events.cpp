@@ -525,9 +525,12 @@ void MyFrame::OnExposeComplete(usImage *pNewFrame, bool err)
 
         m_exposurePending = false;
 
+        long cycleTime = m_cycleTimer.Time();
+        m_cycleTimer.Start();
+
         if (pGuider->GetPauseType() == PAUSE_FULL)
         {
-            delete pNewFrame;
+            ImagePool::Release(pNewFrame);
             Debug.Write("guider is paused, ignoring frame, not scheduling exposure\n");
             return;
         }
@@ -536,7 +539,7 @@ void MyFrame::OnExposeComplete(usImage *pNewFrame, bool err)
         {
             Debug.Write("OnExposeComplete: Capture Error reported\n");
 
-            delete pNewFrame;
+            ImagePool::Release(pNewFrame);
 
             bool stopping = !m_continueCapturing;
             StopCapturing();
@@ -575,9 +578,20 @@ void MyFrame::OnExposeComplete(usImage *pNewFrame, bool err)
             CheckDarkFrameGeometry();
         }
 
+        unsigned int frameNum = pNewFrame->FrameNum;
+        unsigned int captureTime = pNewFrame->CaptureTime;
+        unsigned int moveOverlap = pNewFrame->MoveOverlap;
+        wxStopWatch swatch;
+
         pGuider->UpdateGuideState(pNewFrame, !m_continueCapturing);
         pNewFrame = NULL; // the guider owns it now
 
+        // the move is the last one completed, which in pipelined mode may overlap this frame
+        Debug.Write(wxString::Format("Guide cycle: frame %u, cycle %ld ms, capture %u ms, process %ld ms, move %ld ms, "
+                                     "overlap %u ms, pipelined %d\n",
+                                     frameNum, cycleTime, captureTime, swatch.Time(), m_lastMoveTime, moveOverlap,
+                                     m_pipelinedGuiding));
+
         PhdController::UpdateControllerState();
 
         Debug.Write(wxString::Format("OnExposeComplete: CaptureActive=%d m_continueCapturing=%d\n", CaptureActive,
@@ -625,6 +639,9 @@ void MyFrame::OnMoveComplete(wxThreadEvent& event_)
         assert(mount->IsBusy());
         mount->DecrementRequestCount();
 
+        if (mount == pMount)
+            m_lastMoveTime = event.moveTime;
+
         Mount::MOVE_RESULT moveResult = event.result;
 
         mount->LogGuideStepInfo();
@@ -747,7 +764,8 @@ bool MyFrame::LoadDarkHandler(bool checkIt)
     }
     else
     {
-        if (!pCamera->CurrentDarkFrame)
+        // the selected dark may not have been read yet, so check for the library rather than the current dark
+        if (pCamera->Darks.empty())
         {
             m_useDarksMenuItem->Check(false); // shouldn't have gotten here
             return false;
@@ -780,7 +798,7 @@ void MyFrame::LoadDefectMapHandler(bool checkIt)
         DefectMap *defectMap = DefectMap::LoadDefectMap(pConfig->GetCurrentProfileId());
         if (defectMap)
         {
-            if (pCamera->CurrentDarkFrame)
+            if (!pCamera->Darks.empty())
                 LoadDarkHandler(false);
             pCamera->SetDefectMap(defectMap);
             m_useDarksMenuItem->Check(false);
@@ -1033,7 +1051,7 @@ static void SuppressDarksAlert(intptr_t)
 
 static void ValidateDarksLoaded(void)
 {
-    if (!pCamera->CurrentDarkFrame && !pCamera->CurrentDefectMap)
+    if (pCamera->Darks.empty() && !pCamera->CurrentDefectMap)
     {
         pFrame->SuppressibleAlert(DarksWarningEnabledKey(),
                                   _("For best results, use a Dark Library or a Bad-pixel Map "
@@ -62,3 +62,14 @@ bool OnboardST4::ST4PulseGuideScope(int direction, int duration)
     assert(false);
     return true;
 }
+
+bool OnboardST4::ST4CanPulseAxesConcurrently(void)
+{
+    return false;
+}
+
+// default implementation for hosts that can only drive one ST4 output at a time
+bool OnboardST4::ST4PulseGuideScopeAxes(int raDirection, int raDuration, int decDirection, int decDuration)
+{
+    return ST4PulseGuideScope(raDirection, raDuration) || ST4PulseGuideScope(decDirection, decDuration);
+}
@@ -44,6 +44,8 @@ public:
     virtual bool ST4HasNonGuiMove();
     virtual bool ST4SynchronousOnly();
     virtual bool ST4PulseGuideScope(int direction, int duration);
+    virtual bool ST4CanPulseAxesConcurrently();
+    virtual bool ST4PulseGuideScopeAxes(int raDirection, int raDuration, int decDirection, int decDuration);
 };
 
 #endif // ONBOARD_ST4_H_INCLUDED
@@ -65,6 +65,9 @@ int YWinSize = 512;
 
 static const wxCmdLineEntryDesc cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "?", "help", "display this help and exit" },
+    { wxCMD_LINE_OPTION, "c", "convert-guidelog", "convert a binary guide log to a text guide log (<file>.txt) and exit",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_SWITCH, "H", "headless", "start without rendering the image, graphs or stats during guiding" },
     { wxCMD_LINE_OPTION, "i", "instanceNumber", "sets the PHD2 instance number (default = 1)", wxCMD_LINE_VAL_NUMBER,
       wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_OPTION, "l", "load", "load settings from file and exit", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
@@ -123,6 +126,7 @@ struct ExecFuncThreadEvent : public wxThreadEvent
 PhdApp::PhdApp()
 {
     m_resetConfig = false;
+    m_headless = false;
     m_instanceNumber = 1;
 #ifdef __linux__
     XInitThreads();
@@ -499,6 +503,9 @@ bool PhdApp::OnInit()
         return false;
     }
 
+    // get a chance to flush the debug log if we crash
+    wxHandleFatalExceptions();
+
 #if defined(__WINDOWS__)
     // on MSW, do not strip off the Debug/ and Release/ build subdirs
     // so that GetResourcesDir() is the same as the location of phd2.exe
@@ -610,12 +617,17 @@ bool PhdApp::OnInit()
     PhdController::OnAppInit();
 
     ImageLogger::Init();
+    ImagePool::Init();
+    WorkerPool::Init();
 
     wxImage::AddHandler(new wxJPEGHandler);
     wxImage::AddHandler(new wxPNGHandler);
 
     pFrame = new MyFrame();
 
+    if (m_headless)
+        pFrame->SetHeadless(true);
+
     pFrame->Show(true);
 
     if (pConfig->IsNewInstance() || (pConfig->NumProfiles() == 1 && pFrame->pGearDialog->IsEmptyProfile()))
@@ -635,6 +647,8 @@ int PhdApp::OnExit()
     assert(!pCamera);
 
     ImageLogger::Destroy();
+    ImagePool::Destroy();
+    WorkerPool::Destroy();
 
     PhdController::OnAppExit();
 
@@ -646,15 +660,65 @@ int PhdApp::OnExit()
     delete m_instanceChecker;
     m_instanceChecker = nullptr;
 
+    // lines logged from here on are written directly
+    GuideLog.StopWriter();
+    Debug.StopWriter();
+
     return wxApp::OnExit();
 }
 
+void PhdApp::OnFatalException()
+{
+    GuideLog.FlushOnCrash();
+    Debug.FlushOnCrash();
+}
+
 void PhdApp::OnInitCmdLine(wxCmdLineParser& parser)
 {
     parser.SetDesc(cmdLineDesc);
     parser.SetSwitchChars(wxT("-"));
 }
 
+static bool ConvertGuideLog(const wxString& path)
+{
+    wxString outPath = path + ".txt";
+    if (wxFileExists(outPath))
+    {
+        wxPrintf("%s already exists\n", outPath);
+        return false;
+    }
+
+    FILE *in = wxFopen(path, "rb");
+    if (!in)
+    {
+        wxPrintf("cannot open %s\n", path);
+        return false;
+    }
+
+    FILE *out = wxFopen(outPath, "wb");
+    if (!out)
+    {
+        wxPrintf("cannot create %s\n", outPath);
+        fclose(in);
+        return false;
+    }
+
+    bool ok = GuideLogBinaryToText(in, out);
+    fclose(in);
+    if (fclose(out) != 0)
+        ok = false;
+
+    if (ok)
+        wxPrintf("wrote %s\n", outPath);
+    else
+    {
+        wxPrintf("%s is not a binary guide log or could not be converted\n", path);
+        wxRemoveFile(outPath);
+    }
+
+    return ok;
+}
+
 bool PhdApp::OnCmdLineParsed(wxCmdLineParser& parser)
 {
     if (parser.Found("?"))
@@ -668,6 +732,10 @@ bool PhdApp::OnCmdLineParsed(wxCmdLineParser& parser)
         ::exit(0);
     }
 
+    wxString binaryLog;
+    if (parser.Found("c", &binaryLog))
+        ::exit(ConvertGuideLog(binaryLog) ? 0 : 1);
+
     parser.Found("i", &m_instanceNumber);
 
     if (parser.Found("l", &s_configPath))
@@ -676,6 +744,7 @@ bool PhdApp::OnCmdLineParsed(wxCmdLineParser& parser)
         s_configOp = CONFIG_OP_SAVE;
 
     m_resetConfig = parser.Found("R");
+    m_headless = parser.Found("H");
 
     return true;
 }
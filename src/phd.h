@@ -75,6 +75,7 @@
 #include <functional>
 #include <map>
 #include <math.h>
+#include <memory>
 #include <stdarg.h>
 
 #define APPNAME _T("PHD2 Guiding")
@@ -158,6 +159,7 @@ WX_DEFINE_ARRAY_DOUBLE(double, ArrayOfDbl);
 #include "point.h"
 #include "star.h"
 #include "circbuf.h"
+#include "capture_kernels.h"
 #include "guidinglog.h"
 #include "graph.h"
 #include "statswindow.h"
@@ -189,6 +191,9 @@ WX_DEFINE_ARRAY_DOUBLE(double, ArrayOfDbl);
 #include "runinbg.h"
 #include "fitsiowrap.h"
 #include "imagelogger.h"
+#include "image_pool.h"
+#include "worker_pool.h"
+#include "guide_timing.h"
 
 class wxSingleInstanceChecker;
 
@@ -216,6 +221,7 @@ class PhdApp : public wxApp
     wxSingleInstanceChecker *m_instanceChecker;
     long m_instanceNumber;
     bool m_resetConfig;
+    bool m_headless;
     wxString m_resourcesDir;
     wxDateTime m_logFileTime;
 
@@ -226,6 +232,7 @@ public:
     PhdApp();
     bool OnInit();
     int OnExit();
+    void OnFatalException();
     void OnInitCmdLine(wxCmdLineParser& parser);
     bool OnCmdLineParsed(wxCmdLineParser& parser);
     void TerminateApp();
@@ -109,6 +109,7 @@ Scope::Scope()
     EnableDecCompensation(val);
 
     m_hasHPEncoders = pConfig->Profile.GetBoolean("/scope/HiResEncoders", false);
+    m_concurrentPulses = false;
 
     m_backlashComp = new BacklashComp(this);
 }
@@ -475,6 +476,8 @@ Scope *Scope::Factory(const wxString& choice)
             // virtual function call means we cannot do this in the Scope constructor
             pReturn->EnableStopGuidingWhenSlewing(
                 pConfig->Profile.GetBoolean("/scope/StopGuidingWhenSlewing", pReturn->CanCheckSlewing()));
+            pReturn->EnableConcurrentPulses(
+                pConfig->Profile.GetBoolean("/scope/ConcurrentPulses", pReturn->ConcurrentPulsesByDefault()));
         }
     }
     catch (const wxString& Msg)
@@ -534,6 +537,13 @@ void Scope::EnableStopGuidingWhenSlewing(bool enable)
     m_stopGuidingWhenSlewing = enable;
 }
 
+void Scope::EnableConcurrentPulses(bool enable)
+{
+    Debug.Write(wxString::Format("Scope: concurrent RA and Dec pulses %s\n", enable ? "enabled" : "disabled"));
+    pConfig->Profile.SetBoolean("/scope/ConcurrentPulses", enable);
+    m_concurrentPulses = enable;
+}
+
 void Scope::StartDecDrift()
 {
     m_saveDecGuideMode = m_decGuideMode;
@@ -700,92 +710,103 @@ void Scope::AlertLimitReached(int duration, GuideAxis axis)
     }
 }
 
-Mount::MOVE_RESULT Scope::MoveAxis(GUIDE_DIRECTION direction, int duration, unsigned int moveOptions,
-                                   MoveResultInfo *moveResult)
+// Compute the actual guide duration, enforcing the dec guide mode and the max durations
+// for guide step (or deduced step) moves
+int Scope::LimitMoveDuration(GUIDE_DIRECTION direction, int duration, unsigned int moveOptions, bool *limitReached)
 {
-    MOVE_RESULT result = MOVE_OK;
-    bool limitReached = false;
+    bool limited = false;
 
-    try
+    switch (direction)
     {
-        Debug.Write(
-            wxString::Format("MoveAxis(%s, %d, %s)\n", DirectionChar(direction), duration, DumpMoveOptionBits(moveOptions)));
-
-        if (!m_guidingEnabled && (moveOptions & MOVEOPT_MANUAL) == 0)
-        {
-            throw THROW_INFO("Guiding disabled");
-        }
+    case NORTH:
+    case SOUTH:
 
-        // Compute the actual guide durations
-
-        switch (direction)
+        // Enforce dec guide mode and max duration for guide step (or deduced step) moves
+        if (moveOptions & (MOVEOPT_ALGO_RESULT | MOVEOPT_ALGO_DEDUCE))
         {
-        case NORTH:
-        case SOUTH:
+            if ((m_decGuideMode == DEC_NONE) || (direction == SOUTH && m_decGuideMode == DEC_NORTH) ||
+                (direction == NORTH && m_decGuideMode == DEC_SOUTH))
+            {
+                duration = 0;
+                Debug.Write("duration set to 0 by GuideMode\n");
+            }
 
-            // Enforce dec guide mode and max duration for guide step (or deduced step) moves
-            if (moveOptions & (MOVEOPT_ALGO_RESULT | MOVEOPT_ALGO_DEDUCE))
+            if (duration > m_maxDecDuration)
             {
-                if ((m_decGuideMode == DEC_NONE) || (direction == SOUTH && m_decGuideMode == DEC_NORTH) ||
-                    (direction == NORTH && m_decGuideMode == DEC_SOUTH))
-                {
-                    duration = 0;
-                    Debug.Write("duration set to 0 by GuideMode\n");
-                }
+                duration = m_maxDecDuration;
+                Debug.Write(wxString::Format("duration set to %d by maxDecDuration\n", duration));
+                limited = true;
+            }
 
-                if (duration > m_maxDecDuration)
-                {
-                    duration = m_maxDecDuration;
-                    Debug.Write(wxString::Format("duration set to %d by maxDecDuration\n", duration));
-                    limitReached = true;
-                }
+            if (limited && direction == m_decLimitReachedDirection)
+            {
+                if (++m_decLimitReachedCount >= LIMIT_REACHED_WARN_COUNT)
+                    AlertLimitReached(duration, GUIDE_DEC);
+            }
+            else
+                m_decLimitReachedCount = 0;
 
-                if (limitReached && direction == m_decLimitReachedDirection)
-                {
-                    if (++m_decLimitReachedCount >= LIMIT_REACHED_WARN_COUNT)
-                        AlertLimitReached(duration, GUIDE_DEC);
-                }
-                else
-                    m_decLimitReachedCount = 0;
+            if (limited)
+                m_decLimitReachedDirection = direction;
+            else
+                m_decLimitReachedDirection = NONE;
+        }
+        break;
+    case EAST:
+    case WEST:
 
-                if (limitReached)
-                    m_decLimitReachedDirection = direction;
-                else
-                    m_decLimitReachedDirection = NONE;
+        // Enforce max duration for guide step (or deduced step) moves
+        if (moveOptions & (MOVEOPT_ALGO_RESULT | MOVEOPT_ALGO_DEDUCE))
+        {
+            if (duration > m_maxRaDuration)
+            {
+                duration = m_maxRaDuration;
+                Debug.Write(wxString::Format("duration set to %d by maxRaDuration\n", duration));
+                limited = true;
             }
-            break;
-        case EAST:
-        case WEST:
 
-            // Enforce max duration for guide step (or deduced step) moves
-            if (moveOptions & (MOVEOPT_ALGO_RESULT | MOVEOPT_ALGO_DEDUCE))
+            if (limited && direction == m_raLimitReachedDirection)
             {
-                if (duration > m_maxRaDuration)
-                {
-                    duration = m_maxRaDuration;
-                    Debug.Write(wxString::Format("duration set to %d by maxRaDuration\n", duration));
-                    limitReached = true;
-                }
+                if (++m_raLimitReachedCount >= LIMIT_REACHED_WARN_COUNT)
+                    AlertLimitReached(duration, GUIDE_RA);
+            }
+            else
+                m_raLimitReachedCount = 0;
 
-                if (limitReached && direction == m_raLimitReachedDirection)
-                {
-                    if (++m_raLimitReachedCount >= LIMIT_REACHED_WARN_COUNT)
-                        AlertLimitReached(duration, GUIDE_RA);
-                }
-                else
-                    m_raLimitReachedCount = 0;
+            if (limited)
+                m_raLimitReachedDirection = direction;
+            else
+                m_raLimitReachedDirection = NONE;
+        }
+        break;
 
-                if (limitReached)
-                    m_raLimitReachedDirection = direction;
-                else
-                    m_raLimitReachedDirection = NONE;
-            }
-            break;
+    case NONE:
+        break;
+    }
 
-        case NONE:
-            break;
+    *limitReached = limited;
+    return duration;
+}
+
+Mount::MOVE_RESULT Scope::MoveAxis(GUIDE_DIRECTION direction, int duration, unsigned int moveOptions,
+                                   MoveResultInfo *moveResult)
+{
+    MOVE_RESULT result = MOVE_OK;
+    bool limitReached = false;
+
+    try
+    {
+        Debug.Write(
+            wxString::Format("MoveAxis(%s, %d, %s)\n", DirectionChar(direction), duration, DumpMoveOptionBits(moveOptions)));
+
+        if (!m_guidingEnabled && (moveOptions & MOVEOPT_MANUAL) == 0)
+        {
+            throw THROW_INFO("Guiding disabled");
         }
 
+        // Compute the actual guide durations
+        duration = LimitMoveDuration(direction, duration, moveOptions, &limitReached);
+
         // Actually do the guide
         if (duration > 0)
         {
@@ -815,6 +836,82 @@ Mount::MOVE_RESULT Scope::MoveAxis(GUIDE_DIRECTION direction, int duration, unsi
     return result;
 }
 
+bool Scope::CanGuideAxesConcurrently()
+{
+    return false;
+}
+
+bool Scope::ConcurrentPulsesByDefault()
+{
+    return true;
+}
+
+bool Scope::CanMoveAxesConcurrently()
+{
+    return m_concurrentPulses && CanGuideAxesConcurrently();
+}
+
+Mount::MOVE_RESULT Scope::GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration)
+{
+    MOVE_RESULT result = Guide(raDirection, raDuration);
+    if (result == MOVE_OK)
+        result = Guide(decDirection, decDuration);
+    return result;
+}
+
+// Guide step with the RA and Dec pulses running at the same time, so the step takes as long as
+// the longer of the two pulses instead of their sum
+Mount::MOVE_RESULT Scope::MoveAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration,
+                                   unsigned int moveOptions, MoveResultInfo *raMoveResult, MoveResultInfo *decMoveResult)
+{
+    MOVE_RESULT result = MOVE_OK;
+    bool raLimitReached = false;
+    bool decLimitReached = false;
+
+    try
+    {
+        Debug.Write(wxString::Format("MoveAxes(%s, %d, %s, %d, %s)\n", DirectionChar(raDirection), raDuration,
+                                     DirectionChar(decDirection), decDuration, DumpMoveOptionBits(moveOptions)));
+
+        if (!m_guidingEnabled && (moveOptions & MOVEOPT_MANUAL) == 0)
+        {
+            throw THROW_INFO("Guiding disabled");
+        }
+
+        raDuration = LimitMoveDuration(raDirection, raDuration, moveOptions, &raLimitReached);
+        decDuration = LimitMoveDuration(decDirection, decDuration, moveOptions, &decLimitReached);
+
+        if (raDuration > 0 && decDuration > 0)
+            result = GuideAxes(raDirection, raDuration, decDirection, decDuration);
+        else if (raDuration > 0)
+            result = Guide(raDirection, raDuration);
+        else if (decDuration > 0)
+            result = Guide(decDirection, decDuration);
+
+        if (result != MOVE_OK)
+        {
+            throw ERROR_INFO("guide failed");
+        }
+    }
+    catch (const wxString& Msg)
+    {
+        POSSIBLY_UNUSED(Msg);
+        if (result == MOVE_OK)
+            result = MOVE_ERROR;
+        raDuration = 0;
+        decDuration = 0;
+    }
+
+    Debug.Write(wxString::Format("Move returns status %d, amounts %d, %d\n", result, raDuration, decDuration));
+
+    raMoveResult->amountMoved = raDuration;
+    raMoveResult->limited = raLimitReached;
+    decMoveResult->amountMoved = decDuration;
+    decMoveResult->limited = decLimitReached;
+
+    return result;
+}
+
 static wxString CalibrationWarningKey(CalibrationIssueType etype)
 {
     wxString qual;
@@ -2019,6 +2116,17 @@ ScopeConfigDialogCtrlSet::ScopeConfigDialogCtrlSet(wxWindow *pParent, Scope *pSc
     else
         m_pStopGuidingWhenSlewing = 0;
 
+    if (pScope && pScope->CanGuideAxesConcurrently())
+    {
+        m_pConcurrentPulses =
+            new wxCheckBox(GetParentWindow(AD_cbConcurrentPulses), wxID_ANY, _("Send RA and Dec pulses together"));
+        AddCtrl(CtrlMap, AD_cbConcurrentPulses, m_pConcurrentPulses,
+                _("When checked, RA and Dec guide pulses are started at the same time so that a guide step takes as long "
+                  "as the longer pulse. Uncheck if the mount cuts short a pulse when the other axis is pulsed."));
+    }
+    else
+        m_pConcurrentPulses = 0;
+
     m_assumeOrthogonal = new wxCheckBox(GetParentWindow(AD_cbAssumeOrthogonal), wxID_ANY, _("Assume Dec orthogonal to RA"));
     m_assumeOrthogonal->Enable(enableCtrls);
     AddCtrl(CtrlMap, AD_cbAssumeOrthogonal, m_assumeOrthogonal,
@@ -2118,6 +2226,8 @@ void ScopeConfigDialogCtrlSet::LoadValues()
     m_pNeedFlipDec->SetValue(m_pScope->CalibrationFlipRequiresDecFlip());
     if (m_pStopGuidingWhenSlewing)
         m_pStopGuidingWhenSlewing->SetValue(m_pScope->IsStopGuidingWhenSlewingEnabled());
+    if (m_pConcurrentPulses)
+        m_pConcurrentPulses->SetValue(m_pScope->IsConcurrentPulsesEnabled());
     m_assumeOrthogonal->SetValue(m_pScope->IsAssumeOrthogonal());
     int pulseSize;
     int floor;
@@ -2166,6 +2276,8 @@ void ScopeConfigDialogCtrlSet::UnloadValues()
     }
     if (m_pStopGuidingWhenSlewing)
         m_pScope->EnableStopGuidingWhenSlewing(m_pStopGuidingWhenSlewing->GetValue());
+    if (m_pConcurrentPulses)
+        m_pScope->EnableConcurrentPulses(m_pConcurrentPulses->GetValue());
     m_pScope->SetAssumeOrthogonal(m_assumeOrthogonal->GetValue());
     int newBC = m_pBacklashPulse->GetValue();
     int newFloor;
@@ -54,6 +54,7 @@ class ScopeConfigDialogCtrlSet : public MountConfigDialogCtrlSet
     wxSpinCtrl *m_pCalibrationDuration;
     wxCheckBox *m_pNeedFlipDec;
     wxCheckBox *m_pStopGuidingWhenSlewing;
+    wxCheckBox *m_pConcurrentPulses;
     wxCheckBox *m_assumeOrthogonal;
     wxSpinCtrl *m_pMaxRaDuration;
     wxSpinCtrl *m_pMaxDecDuration;
@@ -140,6 +141,7 @@ class Scope : public Mount
 
     bool m_useDecCompensation;
     bool m_hasHPEncoders;
+    bool m_concurrentPulses; // use concurrent RA and Dec pulses when the mount supports them
 
     enum CALIBRATION_STATE
     {
@@ -249,7 +251,9 @@ public:
     bool HasHPEncoders() const override;
     void SetCalibrationFlipRequiresDecFlip(bool val);
     void EnableStopGuidingWhenSlewing(bool enable);
+    void EnableConcurrentPulses(bool enable);
     bool IsStopGuidingWhenSlewingEnabled() const;
+    bool IsConcurrentPulsesEnabled() const;
     void SetAssumeOrthogonal(bool val);
     bool IsAssumeOrthogonal() const;
     void HandleSanityCheckDialog();
@@ -273,6 +277,11 @@ public:
     // Does not get called unless guiding was started interactively (by clicking the guide button)
     virtual bool PreparePositionInteractive();
     virtual bool CanPulseGuide();
+    // true if the mount interface can run an RA and a Dec guide pulse at the same time
+    virtual bool CanGuideAxesConcurrently();
+    // default for the /scope/ConcurrentPulses setting
+    virtual bool ConcurrentPulsesByDefault();
+    bool CanMoveAxesConcurrently() override;
 
     void StartDecDrift() override;
     void EndDecDrift() override;
@@ -284,6 +293,9 @@ private:
     MOVE_RESULT MoveAxis(GUIDE_DIRECTION direction, int durationMs, unsigned int moveOptions,
                          MoveResultInfo *moveResultInfo) final;
     MOVE_RESULT MoveAxis(GUIDE_DIRECTION direction, int duration, unsigned int moveOptions) final;
+    MOVE_RESULT MoveAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration,
+                         unsigned int moveOptions, MoveResultInfo *raMoveResult, MoveResultInfo *decMoveResult) final;
+    int LimitMoveDuration(GUIDE_DIRECTION direction, int duration, unsigned int moveOptions, bool *limitReached);
     int CalibrationMoveSize() override;
     void CheckCalibrationDuration(int currDuration);
     int CalibrationTotDistance() override;
@@ -297,6 +309,11 @@ private:
     // these MUST be supplied by a subclass
 private:
     virtual MOVE_RESULT Guide(GUIDE_DIRECTION direction, int durationMs) = 0;
+
+    // subclasses returning true from CanGuideAxesConcurrently() override this to start both
+    // pulses together and return when both have completed
+    virtual MOVE_RESULT GuideAxes(GUIDE_DIRECTION raDirection, int raDurationMs, GUIDE_DIRECTION decDirection,
+                                  int decDurationMs);
 };
 
 inline bool Scope::IsStopGuidingWhenSlewingEnabled() const
@@ -304,6 +321,11 @@ inline bool Scope::IsStopGuidingWhenSlewingEnabled() const
     return m_stopGuidingWhenSlewing;
 }
 
+inline bool Scope::IsConcurrentPulsesEnabled() const
+{
+    return m_concurrentPulses;
+}
+
 inline bool Scope::IsAssumeOrthogonal() const
 {
     return m_assumeOrthogonal;
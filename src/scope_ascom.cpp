@@ -367,6 +367,7 @@ bool ScopeASCOM::Connect()
         }
 
         m_checkForSyncPulseGuide = false;
+        m_serialPulsesOnly = false;
 
         if (m_Name.Find(_T("AstroPhysicsV2")) != wxNOT_FOUND)
         {
@@ -513,13 +514,149 @@ static void SuppressSyncPulseGuideAlert(long)
     pConfig->Global.SetBoolean(SyncPulseGuideAlertEnabledKey(), false);
 }
 
+// Issue a PulseGuide command. Most drivers return before the pulse has completed.
+void ScopeASCOM::StartPulse(DispatchObj *scope, GUIDE_DIRECTION direction, int duration)
+{
+    VARIANTARG rgvarg[2];
+    rgvarg[1].vt = VT_I2;
+    rgvarg[1].iVal = direction;
+    rgvarg[0].vt = VT_I4;
+    rgvarg[0].lVal = (long) duration;
+
+    DISPPARAMS dispParms;
+    dispParms.cArgs = 2;
+    dispParms.rgvarg = rgvarg;
+    dispParms.cNamedArgs = 0;
+    dispParms.rgdispidNamedArgs = NULL;
+
+    HRESULT hr;
+    ExcepInfo excep;
+    Variant vRes;
+
+    if (FAILED(hr = scope->IDisp()->Invoke(dispid_pulseguide, IID_NULL, LOCALE_USER_DEFAULT, DISPATCH_METHOD, &dispParms, &vRes,
+                                           &excep, NULL)))
+    {
+        Debug.Write(wxString::Format("pulseguide: [%x] %s\n", hr, _com_error(hr).ErrorMessage()));
+
+        // Make sure nothing got by us and the mount can really handle pulse guide - HIGHLY unlikely
+        if (scope->GetProp(&vRes, L"CanPulseGuide") && vRes.boolVal != VARIANT_TRUE)
+        {
+            Debug.Write("Tried to guide mount that has no PulseGuide support\n");
+            // This will trigger a nice alert the next time through Guide
+            m_canPulseGuide = false;
+        }
+        throw ERROR_INFO("ASCOM Scope: pulseguide command failed: " + ExcepMsg(excep));
+    }
+}
+
+// Wait for the pulses started when swatch was started to complete
+void ScopeASCOM::WaitForPulse(DispatchObj *scope, int duration, const wxStopWatch& swatch, MOVE_RESULT *result)
+{
+    long elapsed = swatch.Time();
+
+    if (elapsed < (long) duration)
+    {
+        unsigned long rem = (unsigned long) ((long) duration - elapsed);
+
+        Debug.Write(wxString::Format("PulseGuide returned control before completion, sleep %lu\n", rem + 10));
+
+        if (WorkerThread::MilliSleep(rem + 10))
+            throw ERROR_INFO("ASCOM Scope: thread terminate requested");
+    }
+
+    if (IsGuiding(scope))
+    {
+        Debug.Write("scope still moving after pulse duration time elapsed\n");
+
+        // try waiting a little longer. If scope does not stop moving after 1 second, try doing AbortSlew
+        // if it still does not stop after 2 seconds, bail out with an error
+
+        enum
+        {
+            GRACE_PERIOD_MS = 1000,
+            TIMEOUT_MS = GRACE_PERIOD_MS + 1000,
+        };
+
+        bool timeoutExceeded = false;
+        bool didAbortSlew = false;
+
+        while (true)
+        {
+            ::wxMilliSleep(20);
+
+            if (WorkerThread::InterruptRequested())
+                throw ERROR_INFO("ASCOM Scope: thread interrupt requested");
+
+            CheckSlewing(scope, result);
+
+            if (!IsGuiding(scope))
+            {
+                Debug.Write(wxString::Format("scope move finished after %ld + %ld ms\n", (long) duration,
+                                             swatch.Time() - (long) duration));
+                break;
+            }
+
+            long now = swatch.Time();
+
+            if (!didAbortSlew && now > duration + GRACE_PERIOD_MS && m_abortSlewWhenGuidingStuck)
+            {
+                Debug.Write(wxString::Format("scope still moving after %ld + %ld ms, try aborting slew\n", (long) duration,
+                                             now - (long) duration));
+                AbortSlew(scope);
+                didAbortSlew = true;
+                continue;
+            }
+
+            if (now > duration + TIMEOUT_MS)
+            {
+                timeoutExceeded = true;
+                break;
+            }
+        }
+
+        if (timeoutExceeded && IsGuiding(scope))
+        {
+            throw ERROR_INFO("timeout exceeded waiting for guiding pulse to complete");
+        }
+    }
+}
+
 Mount::MOVE_RESULT ScopeASCOM::Guide(GUIDE_DIRECTION direction, int duration)
+{
+    return PulseGuide(direction, duration, NONE, 0);
+}
+
+bool ScopeASCOM::CanGuideAxesConcurrently()
+{
+    return m_canPulseGuide && !m_serialPulsesOnly;
+}
+
+// Some drivers accept a PulseGuide on the second axis but silently cut short the pulse already
+// running on the first, which cannot be detected from IsPulseGuiding. Leave concurrent pulses
+// off until the user turns them on in the Guiding tab of the advanced dialog.
+bool ScopeASCOM::ConcurrentPulsesByDefault()
+{
+    return false;
+}
+
+Mount::MOVE_RESULT ScopeASCOM::GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection,
+                                         int decDuration)
+{
+    return PulseGuide(raDirection, raDuration, decDirection, decDuration);
+}
+
+// Pulse guide in one direction, or in two directions at once when duration2 > 0. Asynchronous
+// drivers should accept a pulse on each axis at the same time; for drivers that do not, the
+// second pulse is issued after the first one completes and later guide steps use serial pulses.
+Mount::MOVE_RESULT ScopeASCOM::PulseGuide(GUIDE_DIRECTION direction, int duration, GUIDE_DIRECTION direction2, int duration2)
 {
     MOVE_RESULT result = MOVE_OK;
 
     try
     {
         Debug.Write(wxString::Format("Guiding  Dir = %d, Dur = %d\n", direction, duration));
+        if (duration2 > 0)
+            Debug.Write(wxString::Format("Guiding  Dir = %d, Dur = %d\n", direction2, duration2));
 
         if (!IsConnected())
         {
@@ -567,38 +704,9 @@ Mount::MOVE_RESULT ScopeASCOM::Guide(GUIDE_DIRECTION direction, int duration)
 
         // Do the move
 
-        VARIANTARG rgvarg[2];
-        rgvarg[1].vt = VT_I2;
-        rgvarg[1].iVal = direction;
-        rgvarg[0].vt = VT_I4;
-        rgvarg[0].lVal = (long) duration;
-
-        DISPPARAMS dispParms;
-        dispParms.cArgs = 2;
-        dispParms.rgvarg = rgvarg;
-        dispParms.cNamedArgs = 0;
-        dispParms.rgdispidNamedArgs = NULL;
-
         wxStopWatch swatch;
 
-        HRESULT hr;
-        ExcepInfo excep;
-        Variant vRes;
-
-        if (FAILED(hr = scope.IDisp()->Invoke(dispid_pulseguide, IID_NULL, LOCALE_USER_DEFAULT, DISPATCH_METHOD, &dispParms,
-                                              &vRes, &excep, NULL)))
-        {
-            Debug.Write(wxString::Format("pulseguide: [%x] %s\n", hr, _com_error(hr).ErrorMessage()));
-
-            // Make sure nothing got by us and the mount can really handle pulse guide - HIGHLY unlikely
-            if (scope.GetProp(&vRes, L"CanPulseGuide") && vRes.boolVal != VARIANT_TRUE)
-            {
-                Debug.Write("Tried to guide mount that has no PulseGuide support\n");
-                // This will trigger a nice alert the next time through Guide
-                m_canPulseGuide = false;
-            }
-            throw ERROR_INFO("ASCOM Scope: pulseguide command failed: " + ExcepMsg(excep));
-        }
+        StartPulse(&scope, direction, duration);
 
         long elapsed = swatch.Time();
 
@@ -616,71 +724,44 @@ Mount::MOVE_RESULT ScopeASCOM::Guide(GUIDE_DIRECTION direction, int duration)
             }
         }
 
-        if (elapsed < (long) duration)
+        if (duration2 > 0)
         {
-            unsigned long rem = (unsigned long) ((long) duration - elapsed);
-
-            Debug.Write(wxString::Format("PulseGuide returned control before completion, sleep %lu\n", rem + 10));
-
-            if (WorkerThread::MilliSleep(rem + 10))
-                throw ERROR_INFO("ASCOM Scope: thread terminate requested");
-        }
+            bool started = false;
 
-        if (IsGuiding(&scope))
-        {
-            Debug.Write("scope still moving after pulse duration time elapsed\n");
-
-            // try waiting a little longer. If scope does not stop moving after 1 second, try doing AbortSlew
-            // if it still does not stop after 2 seconds, bail out with an error
-
-            enum
+            if (duration >= 250 && elapsed >= duration - 30)
             {
-                GRACE_PERIOD_MS = 1000,
-                TIMEOUT_MS = GRACE_PERIOD_MS + 1000,
-            };
-
-            bool timeoutExceeded = false;
-            bool didAbortSlew = false;
-
-            while (true)
+                // the first pulse has already completed, the pulses cannot overlap with this driver
+                Debug.Write("ASCOM Scope: synchronous PulseGuide, using serial pulses\n");
+            }
+            else
             {
-                ::wxMilliSleep(20);
-
-                if (WorkerThread::InterruptRequested())
-                    throw ERROR_INFO("ASCOM Scope: thread interrupt requested");
-
-                CheckSlewing(&scope, &result);
-
-                if (!IsGuiding(&scope))
+                try
                 {
-                    Debug.Write(wxString::Format("scope move finished after %ld + %ld ms\n", (long) duration,
-                                                 swatch.Time() - (long) duration));
-                    break;
+                    StartPulse(&scope, direction2, duration2);
+                    started = true;
                 }
-
-                long now = swatch.Time();
-
-                if (!didAbortSlew && now > duration + GRACE_PERIOD_MS && m_abortSlewWhenGuidingStuck)
+                catch (const wxString& msg)
                 {
-                    Debug.Write(wxString::Format("scope still moving after %ld + %ld ms, try aborting slew\n", (long) duration,
-                                                 now - (long) duration));
-                    AbortSlew(&scope);
-                    didAbortSlew = true;
-                    continue;
-                }
-
-                if (now > duration + TIMEOUT_MS)
-                {
-                    timeoutExceeded = true;
-                    break;
+                    POSSIBLY_UNUSED(msg);
+                    Debug.Write("ASCOM Scope: pulse on second axis rejected while guiding, using serial pulses\n");
                 }
             }
 
-            if (timeoutExceeded && IsGuiding(&scope))
+            if (started)
             {
-                throw ERROR_INFO("timeout exceeded waiting for guiding pulse to complete");
+                duration = wxMax(duration, duration2);
+            }
+            else
+            {
+                m_serialPulsesOnly = true;
+                WaitForPulse(&scope, duration, swatch, &result);
+                swatch.Start();
+                StartPulse(&scope, direction2, duration2);
+                duration = duration2;
             }
         }
+
+        WaitForPulse(&scope, duration, swatch, &result);
     }
     catch (const wxString& msg)
     {
@@ -74,6 +74,7 @@ class ScopeASCOM : public Scope
 
     bool m_abortSlewWhenGuidingStuck;
     bool m_checkForSyncPulseGuide;
+    bool m_serialPulsesOnly; // driver cannot run pulses on both axes at once
 
     wxString m_choice; // name of chosen scope
 
@@ -82,6 +83,10 @@ class ScopeASCOM : public Scope
     bool IsGuiding(DispatchObj *pScopeDriver);
     bool IsSlewing(DispatchObj *pScopeDriver);
     void AbortSlew(DispatchObj *pScopeDriver);
+    void StartPulse(DispatchObj *pScopeDriver, GUIDE_DIRECTION direction, int duration);
+    void WaitForPulse(DispatchObj *pScopeDriver, int duration, const wxStopWatch& swatch, MOVE_RESULT *result);
+    MOVE_RESULT PulseGuide(GUIDE_DIRECTION direction, int duration, GUIDE_DIRECTION direction2, int duration2);
+    MOVE_RESULT GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration) override;
 
 public:
     ScopeASCOM(const wxString& choice);
@@ -106,6 +111,8 @@ public:
     bool CanSlewAsync() override;
     bool CanReportPosition() override;
     bool CanPulseGuide() override;
+    bool CanGuideAxesConcurrently() override;
+    bool ConcurrentPulsesByDefault() override;
     bool SlewToCoordinates(double ra, double dec) override;
     bool SlewToCoordinatesAsync(double ra, double dec) override;
     void AbortSlew() override;
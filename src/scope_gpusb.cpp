@@ -469,6 +469,42 @@ static bool GPUSB_RAMAssert()
     return true;
 }
 
+static bool GPUSB_DecPDeassert()
+{
+    if (!pGPUSB)
+        return false;
+
+    GPUSB_SetBit(3, 0);
+    return true;
+}
+
+static bool GPUSB_DecMDeassert()
+{
+    if (!pGPUSB)
+        return false;
+
+    GPUSB_SetBit(2, 0);
+    return true;
+}
+
+static bool GPUSB_RAPDeassert()
+{
+    if (!pGPUSB)
+        return false;
+
+    GPUSB_SetBit(1, 0);
+    return true;
+}
+
+static bool GPUSB_RAMDeassert()
+{
+    if (!pGPUSB)
+        return false;
+
+    GPUSB_SetBit(0, 0);
+    return true;
+}
+
 static bool GPUSB_AllDirDeassert()
 {
     if (!pGPUSB)
@@ -506,10 +542,8 @@ bool ScopeGpUsb::Disconnect()
     return false;
 }
 
-Mount::MOVE_RESULT ScopeGpUsb::Guide(GUIDE_DIRECTION direction, int duration)
+static void AssertDirection(GUIDE_DIRECTION direction)
 {
-    GPUSB_AllDirDeassert();
-    GPUSB_LEDGreen();
     switch (direction)
     {
     case NORTH:
@@ -527,12 +561,74 @@ Mount::MOVE_RESULT ScopeGpUsb::Guide(GUIDE_DIRECTION direction, int duration)
     case NONE:
         break;
     }
+}
+
+static void DeassertDirection(GUIDE_DIRECTION direction)
+{
+    switch (direction)
+    {
+    case NORTH:
+        GPUSB_DecPDeassert();
+        break;
+    case SOUTH:
+        GPUSB_DecMDeassert();
+        break;
+    case EAST:
+        GPUSB_RAMDeassert();
+        break;
+    case WEST:
+        GPUSB_RAPDeassert();
+        break;
+    case NONE:
+        break;
+    }
+}
+
+Mount::MOVE_RESULT ScopeGpUsb::Guide(GUIDE_DIRECTION direction, int duration)
+{
+    GPUSB_AllDirDeassert();
+    GPUSB_LEDGreen();
+    AssertDirection(direction);
     WorkerThread::MilliSleep(duration, WorkerThread::INT_ANY);
     GPUSB_AllDirDeassert();
     GPUSB_LEDRed();
     return MOVE_OK;
 }
 
+// the RA and Dec relays are independent, so both can be closed at once
+bool ScopeGpUsb::CanGuideAxesConcurrently(void)
+{
+    return true;
+}
+
+Mount::MOVE_RESULT ScopeGpUsb::GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection,
+                                         int decDuration)
+{
+    GUIDE_DIRECTION first = raDirection;
+    GUIDE_DIRECTION second = decDirection;
+    int firstDuration = raDuration;
+    int secondDuration = decDuration;
+
+    if (secondDuration < firstDuration)
+    {
+        std::swap(first, second);
+        std::swap(firstDuration, secondDuration);
+    }
+
+    GPUSB_AllDirDeassert();
+    GPUSB_LEDGreen();
+    AssertDirection(first);
+    AssertDirection(second);
+    bool interrupted = WorkerThread::MilliSleep(firstDuration, WorkerThread::INT_ANY) != 0;
+    DeassertDirection(first);
+    // on interrupt, release the longer pulse now as well
+    if (!interrupted)
+        WorkerThread::MilliSleep(secondDuration - firstDuration, WorkerThread::INT_ANY);
+    GPUSB_AllDirDeassert();
+    GPUSB_LEDRed();
+    return MOVE_OK;
+}
+
 bool ScopeGpUsb::HasNonGuiMove(void)
 {
     return true;
@@ -43,6 +43,8 @@ public:
     bool Connect(void) override;
     bool Disconnect(void) override;
     MOVE_RESULT Guide(GUIDE_DIRECTION direction, int duration) override;
+    MOVE_RESULT GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration) override;
+    bool CanGuideAxesConcurrently(void) override;
     bool HasNonGuiMove(void) override;
 };
 
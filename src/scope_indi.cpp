@@ -85,8 +85,7 @@ private:
 
     wxMutex sync_lock;
     wxCondition sync_cond;
-    bool guide_active;
-    GuideAxis guide_active_axis;
+    bool guide_active[2]; // pulse in progress, indexed by GuideAxis
 
     long INDIport;
     wxString INDIhost;
@@ -99,6 +98,9 @@ private:
     bool ConnectToDriver(RunInBg *ctx);
     void ClearStatus();
     void CheckState();
+    bool StartPulse(GUIDE_DIRECTION direction, int duration);
+    MOVE_RESULT WaitForPulses();
+    MOVE_RESULT GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration) override;
 
 protected:
     void newDevice(INDI::BaseDevice dp) override;
@@ -122,6 +124,7 @@ public:
     bool HasNonGuiMove() override;
 
     bool CanPulseGuide() override { return pulseGuideNS_prop && pulseGuideEW_prop; }
+    bool CanGuideAxesConcurrently() override { return pulseGuideNS_prop && pulseGuideEW_prop; }
     bool CanReportPosition() override { return coord_prop ? true : false; }
     bool CanSlew() override { return coord_prop ? true : false; }
     bool CanSlewAsync() override;
@@ -173,7 +176,8 @@ void ScopeINDI::ClearStatus()
     // reset connection status
     m_ready = false;
     eod_coord = false;
-    guide_active = false;
+    guide_active[GUIDE_RA] = false;
+    guide_active[GUIDE_DEC] = false;
     sync_cond.Broadcast(); // just in case worker thread was blocked waiting for guide pulse to complete
 }
 
@@ -456,19 +460,17 @@ void ScopeINDI::updateProperty(INDI::Property property)
         if (nvp == pulseGuideEW_prop || nvp == pulseGuideNS_prop)
         {
             bool notify = false;
+            GuideAxis axis = nvp == pulseGuideEW_prop ? GUIDE_RA : GUIDE_DEC;
             {
                 wxMutexLocker lck(sync_lock);
-                if (guide_active && nvp->s != IPS_BUSY &&
-                    ((guide_active_axis == GUIDE_RA && nvp == pulseGuideEW_prop) ||
-                     (guide_active_axis == GUIDE_DEC && nvp == pulseGuideNS_prop)))
+                if (guide_active[axis] && nvp->s != IPS_BUSY)
                 {
-                    guide_active = false;
+                    guide_active[axis] = false;
                     notify = true;
                 }
-                else if (!guide_active && nvp->s == IPS_BUSY)
+                else if (!guide_active[axis] && nvp->s == IPS_BUSY)
                 {
-                    guide_active = true;
-                    guide_active_axis = nvp == pulseGuideEW_prop ? GUIDE_RA : GUIDE_DEC;
+                    guide_active[axis] = true;
                 }
             }
             if (notify)
@@ -601,90 +603,125 @@ void ScopeINDI::newProperty(INDI::Property property)
     CheckState();
 }
 
-Mount::MOVE_RESULT ScopeINDI::Guide(GUIDE_DIRECTION direction, int duration)
+// Start a timed pulse, returns true on error
+bool ScopeINDI::StartPulse(GUIDE_DIRECTION direction, int duration)
 {
-    if (pulseGuideNS_prop && pulseGuideEW_prop)
+    if (INDIConfig::Verbose())
+        Debug.Write(wxString::Format("INDI Mount: timed pulse dir %d dur %d ms\n", direction, duration));
+
+    switch (direction)
     {
-        if (INDIConfig::Verbose())
-            Debug.Write(wxString::Format("INDI Mount: timed pulse dir %d dur %d ms\n", direction, duration));
+    case EAST:
+    case WEST:
+    case NORTH:
+    case SOUTH:
+        break;
+    default:
+        Debug.Write("INDI Mount error ScopeINDI::Guide NONE\n");
+        return true;
+    }
 
-        switch (direction)
+    GuideAxis axis = direction == EAST || direction == WEST ? GUIDE_RA : GUIDE_DEC;
+
+    // set guide active before initiating the pulse
+
+    {
+        wxMutexLocker lck(sync_lock);
+
+        if (guide_active[axis])
         {
-        case EAST:
-        case WEST:
-        case NORTH:
-        case SOUTH:
-            break;
-        default:
-            Debug.Write("INDI Mount error ScopeINDI::Guide NONE\n");
-            return MOVE_ERROR;
+            // todo: try to abort it?
+            Debug.Write("Cannot guide with guide pulse in progress!\n");
+            return true;
         }
 
-        // set guide active before initiating the pulse
+        guide_active[axis] = true;
 
-        {
-            wxMutexLocker lck(sync_lock);
+    } // lock scope
+
+    // despite what is said in INDI standard properties description, every telescope driver expect the guided time in msec.
+    switch (direction)
+    {
+    case EAST:
+        pulseE_prop->value = duration;
+        pulseW_prop->value = 0;
+        sendNewNumber(pulseGuideEW_prop);
+        break;
+    case WEST:
+        pulseE_prop->value = 0;
+        pulseW_prop->value = duration;
+        sendNewNumber(pulseGuideEW_prop);
+        break;
+    case NORTH:
+        pulseN_prop->value = duration;
+        pulseS_prop->value = 0;
+        sendNewNumber(pulseGuideNS_prop);
+        break;
+    case SOUTH:
+        pulseN_prop->value = 0;
+        pulseS_prop->value = duration;
+        sendNewNumber(pulseGuideNS_prop);
+        break;
+    default:
+        break;
+    }
+
+    return false;
+}
 
-            if (guide_active)
+// Wait for the pulses in progress on both axes to complete
+Mount::MOVE_RESULT ScopeINDI::WaitForPulses()
+{
+    if (INDIConfig::Verbose())
+        Debug.Write("INDI Mount: wait for move complete\n");
+
+    {
+        // lock scope
+        wxMutexLocker lck(sync_lock);
+        while (guide_active[GUIDE_RA] || guide_active[GUIDE_DEC])
+        {
+            sync_cond.WaitTimeout(100);
+            if (WorkerThread::InterruptRequested())
             {
-                // todo: try to abort it?
-                Debug.Write("Cannot guide with guide pulse in progress!\n");
+                Debug.Write("interrupt requested\n");
                 return MOVE_ERROR;
             }
+        }
+    } // lock scope
 
-            guide_active = true;
-            guide_active_axis = direction == EAST || direction == WEST ? GUIDE_RA : GUIDE_DEC;
+    if (INDIConfig::Verbose())
+        Debug.Write("INDI Mount: move completed\n");
 
-        } // lock scope
+    return MOVE_OK;
+}
 
-        // despite what is said in INDI standard properties description, every telescope driver expect the guided time in msec.
-        switch (direction)
-        {
-        case EAST:
-            pulseE_prop->value = duration;
-            pulseW_prop->value = 0;
-            sendNewNumber(pulseGuideEW_prop);
-            break;
-        case WEST:
-            pulseE_prop->value = 0;
-            pulseW_prop->value = duration;
-            sendNewNumber(pulseGuideEW_prop);
-            break;
-        case NORTH:
-            pulseN_prop->value = duration;
-            pulseS_prop->value = 0;
-            sendNewNumber(pulseGuideNS_prop);
-            break;
-        case SOUTH:
-            pulseN_prop->value = 0;
-            pulseS_prop->value = duration;
-            sendNewNumber(pulseGuideNS_prop);
-            break;
-        default:
-            break;
-        }
+Mount::MOVE_RESULT ScopeINDI::GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection,
+                                        int decDuration)
+{
+    if (!pulseGuideNS_prop || !pulseGuideEW_prop)
+    {
+        Debug.Write(wxString::Format("INDI Mount: pulse guide properties unavailable!\n"));
+        return MOVE_ERROR;
+    }
 
-        if (INDIConfig::Verbose())
-            Debug.Write("INDI Mount: wait for move complete\n");
+    // the EW and NS pulse properties are independent, so both pulses can be started before waiting
+    if (StartPulse(raDirection, raDuration))
+        return MOVE_ERROR;
 
-        {
-            // lock scope
-            wxMutexLocker lck(sync_lock);
-            while (guide_active)
-            {
-                sync_cond.WaitTimeout(100);
-                if (WorkerThread::InterruptRequested())
-                {
-                    Debug.Write("interrupt requested\n");
-                    return MOVE_ERROR;
-                }
-            }
-        } // lock scope
+    bool err = StartPulse(decDirection, decDuration);
+    MOVE_RESULT result = WaitForPulses();
 
-        if (INDIConfig::Verbose())
-            Debug.Write("INDI Mount: move completed\n");
+    return err ? MOVE_ERROR : result;
+}
 
-        return MOVE_OK;
+Mount::MOVE_RESULT ScopeINDI::Guide(GUIDE_DIRECTION direction, int duration)
+{
+    if (pulseGuideNS_prop && pulseGuideEW_prop)
+    {
+        if (StartPulse(direction, duration))
+            return MOVE_ERROR;
+
+        return WaitForPulses();
     }
     // guide using motion rate and telescope motion
     // !!! untested as no driver implement TELESCOPE_MOTION_RATE at the moment (INDI 0.9.9) !!!
@@ -52,7 +52,10 @@ public:
     bool HasNonGuiMove(void) override;
     bool SynchronousOnly(void) override;
 
+    bool CanGuideAxesConcurrently(void) override;
+
     MOVE_RESULT Guide(GUIDE_DIRECTION direction, int duration) override;
+    MOVE_RESULT GuideAxes(GUIDE_DIRECTION raDirection, int raDuration, GUIDE_DIRECTION decDirection, int decDuration) override;
 };
 
 #endif // SCOPE_ONBOARD_ST4_H_INCLUDED
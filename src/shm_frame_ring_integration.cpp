@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ *  shm_frame_ring_integration.cpp
+ *  PHD Guiding
+ *
+ *  Integration wrapper for the guide frame ring shared memory
+ *
+ */
+
+#include "phd.h"
+#include "shm_frame_ring_integration.h"
+#include "shm_guider.h"
+
+// Number of recent frames kept in the ring
+static const uint32_t FRAME_RING_SLOTS = 4;
+
+// Global pointer to shared memory
+static FrameRingSHM* g_frame_ring_shm = NULL;
+static bool g_frame_ring_failed = false;
+static bool g_frame_ring_enabled = false;
+
+void FrameRingSHMManager::Initialize(void)
+{
+    g_frame_ring_enabled = pConfig->Global.GetBoolean("/FrameRing/Enabled", false);
+    Debug.Write(wxString::Format("FrameRingSHMManager: frame ring %s\n", g_frame_ring_enabled ? "enabled" : "disabled"));
+}
+
+void FrameRingSHMManager::Shutdown(void)
+{
+    if (g_frame_ring_shm != NULL)
+    {
+        shm_frame_ring_cleanup(g_frame_ring_shm, 1); // Unlink on cleanup
+        g_frame_ring_shm = NULL;
+        Debug.Write("FrameRingSHMManager: Shared memory shut down\n");
+    }
+}
+
+void FrameRingSHMManager::PublishFrame(const usImage *img, const Guider *guider)
+{
+    if (!g_frame_ring_enabled || img == NULL || img->ImageData == NULL)
+    {
+        return;
+    }
+
+    // size the ring for full frames so that subframes always fit
+    uint32_t maxPixels = img->Size.GetWidth() * img->Size.GetHeight();
+    if (g_frame_ring_shm == NULL || g_frame_ring_shm->max_pixels < maxPixels)
+    {
+        if (g_frame_ring_failed && g_frame_ring_shm == NULL)
+        {
+            return; // don't retry on every frame
+        }
+
+        g_frame_ring_shm = shm_frame_ring_init(wxGetApp().GetInstanceNumber(), FRAME_RING_SLOTS, maxPixels);
+        if (g_frame_ring_shm == NULL)
+        {
+            Debug.Write(wxString::Format("FrameRingSHMManager: Failed to create ring for %dx%d frames\n",
+                                         img->Size.GetWidth(), img->Size.GetHeight()));
+            g_frame_ring_failed = true;
+            return;
+        }
+
+        Debug.Write(wxString::Format("FrameRingSHMManager: Ring created for %dx%d frames\n", img->Size.GetWidth(),
+                                     img->Size.GetHeight()));
+    }
+
+    wxRect rect = img->Subframe.IsEmpty() ? wxRect(img->Size) : img->Subframe;
+
+    FrameRingRecord rec;
+    memset(&rec, 0, sizeof(rec));
+
+    rec.frame_number = img->FrameNum;
+    rec.width = rect.GetWidth();
+    rec.height = rect.GetHeight();
+    rec.full_width = img->Size.GetWidth();
+    rec.full_height = img->Size.GetHeight();
+    rec.origin_x = rect.GetLeft();
+    rec.origin_y = rect.GetTop();
+
+    if (guider)
+    {
+        const Star& star = guider->PrimaryStar();
+        if (star.WasFound())
+        {
+            rec.flags |= FRAME_RING_STAR_FOUND;
+            rec.star_x = star.X;
+            rec.star_y = star.Y;
+            rec.star_mass = star.Mass;
+            rec.star_snr = star.SNR;
+            rec.star_hfd = star.HFD;
+        }
+
+        const PHD_Point& lock = guider->LockPosition();
+        if (lock.IsValid())
+        {
+            rec.flags |= FRAME_RING_LOCK_VALID;
+            rec.lock_x = lock.X;
+            rec.lock_y = lock.Y;
+        }
+
+        if (guider->IsGuiding())
+            rec.flags |= FRAME_RING_GUIDING;
+
+        std::vector<PHD_Point> stars;
+        guider->GetStarPositions(&stars);
+        rec.num_stars = wxMin(stars.size(), (size_t) PHD2_FRAME_RING_MAX_STARS);
+        for (uint32_t i = 0; i < rec.num_stars; i++)
+        {
+            rec.stars[i][0] = stars[i].X;
+            rec.stars[i][1] = stars[i].Y;
+        }
+    }
+
+    const unsigned short *pixels = img->ImageData + rect.GetTop() * img->Size.GetWidth() + rect.GetLeft();
+    shm_frame_ring_publish(g_frame_ring_shm, &rec, pixels, img->Size.GetWidth());
+}
+
+void FrameRingSHMManager::PublishGuideStep(const GuideStepInfo& info)
+{
+    if (g_frame_ring_shm == NULL || info.frameNumber < 0)
+    {
+        return;
+    }
+
+    FrameRingStep step;
+    memset(&step, 0, sizeof(step));
+
+    step.camera_dx = info.cameraOffset.X;
+    step.camera_dy = info.cameraOffset.Y;
+    step.ra_distance = info.mountOffset.X;
+    step.dec_distance = info.mountOffset.Y;
+    step.ra_duration = info.durationRA;
+    step.dec_duration = info.durationDec;
+    step.ra_direction = info.durationRA > 0 ? info.directionRA : FRAME_RING_DIR_NONE;
+    step.dec_direction = info.durationDec > 0 ? info.directionDec : FRAME_RING_DIR_NONE;
+    step.ra_limited = info.raLimited;
+    step.dec_limited = info.decLimited;
+
+    shm_frame_ring_publish_step(g_frame_ring_shm, info.frameNumber, &step);
+}
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ *  shm_frame_ring_integration.h
+ *  PHD Guiding
+ *
+ *  Integration wrapper for the guide frame ring shared memory
+ *  Publishes each guide frame and the guide step issued for it
+ *
+ */
+
+#ifndef SHM_FRAME_RING_INTEGRATION_H_INCLUDED
+#define SHM_FRAME_RING_INTEGRATION_H_INCLUDED
+
+#include <wx/wx.h>
+
+class usImage;
+class Guider;
+struct GuideStepInfo;
+
+/**
+ * C++ wrapper class for the guide frame ring shared memory
+ */
+class FrameRingSHMManager
+{
+public:
+    /**
+     * Read the frame ring setting. Frames are published only when the
+     * /FrameRing/Enabled global setting is on.
+     */
+    static void Initialize(void);
+
+    /**
+     * Shutdown and remove the frame ring
+     */
+    static void Shutdown(void);
+
+    /**
+     * Publish a guide frame with the guider's star positions. The ring is
+     * created on the first frame and re-created when the frame size grows.
+     * Does nothing unless the frame ring is enabled.
+     * @param img Guide frame
+     * @param guider Guider that processed the frame
+     */
+    static void PublishFrame(const usImage *img, const Guider *guider);
+
+    /**
+     * Attach a guide step to the frame it was computed from
+     * @param info Guide step
+     */
+    static void PublishGuideStep(const GuideStepInfo& info);
+
+private:
+    FrameRingSHMManager() {}
+};
+
+#endif // SHM_FRAME_RING_INTEGRATION_H_INCLUDED
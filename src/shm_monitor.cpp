@@ -41,118 +41,177 @@
 #include "shm_monitor.h"
 #include "shm_camera_integration.h"
 #include "shm_mount_integration.h"
+#include "shm_guider.h"
 
 #include <pthread.h>
-#include <unistd.h>
 
-static pthread_t g_shm_monitor_thread = 0;
+// External clients signal the client request semaphores after writing a new
+// selection, so the monitor threads sleep until there is something to do. The
+// timed wait lets Stop() end the threads, and also picks up selections written
+// by clients that do not signal. These threads are the only waiters on the
+// semaphores; changes are forwarded to the gear dialog from here.
+static const int SHM_MONITOR_RECHECK_MS = 5000;
+
+static pthread_t g_camera_monitor_thread = 0;
+static pthread_t g_mount_monitor_thread = 0;
 static volatile int g_shm_monitor_running = 0;
 
-static void* shm_monitor_thread_func(void* arg)
+static void check_camera_selection(int& last_camera_index, wxString& last_camera_id)
 {
-    Debug.Write("SHM Monitor: Thread started\n");
-    
-    wxString last_camera_id;
-    int last_camera_index = -2;
-    int last_mount_index = -2;
-    
-    while (g_shm_monitor_running)
+    // Check for camera index changes
+    int camera_index = CameraSHMManager::GetSelectedCamera();
+    if (camera_index != last_camera_index)
     {
-        // Check for camera index changes
-        int camera_index = CameraSHMManager::GetSelectedCamera();
-        if (camera_index != last_camera_index)
+        last_camera_index = camera_index;
+        if (camera_index >= 0 && pFrame)
         {
-            last_camera_index = camera_index;
-            if (camera_index >= 0 && pFrame)
+            // Camera selection changed via SHM - queue event to gear dialog if open
+            if (pFrame->pGearDialog)
             {
-                // Camera selection changed via SHM - queue event to gear dialog if open
-                if (pFrame->pGearDialog)
-                {
-                    wxThreadEvent evt(wxEVT_THREAD);
-                    evt.SetInt(camera_index);
-                    evt.SetString(wxT("camera"));
-                    wxQueueEvent(pFrame->pGearDialog, evt.Clone());
-                }
-                Debug.Write(wxString::Format("SHM Monitor: Camera index changed to %d\n", camera_index));
+                wxThreadEvent evt(wxEVT_THREAD);
+                evt.SetInt(camera_index);
+                evt.SetString(wxT("camera"));
+                wxQueueEvent(pFrame->pGearDialog, evt.Clone());
             }
+            Debug.Write(wxString::Format("SHM Monitor: Camera index changed to %d\n", camera_index));
         }
-        
-        // Check for camera ID changes
-        wxString camera_id = CameraSHMManager::GetSelectedCameraId();
-        if (camera_id != last_camera_id)
+    }
+
+    // Check for camera ID changes
+    wxString camera_id = CameraSHMManager::GetSelectedCameraId();
+    if (camera_id != last_camera_id)
+    {
+        last_camera_id = camera_id;
+        if (!camera_id.IsEmpty() && pFrame)
         {
-            last_camera_id = camera_id;
-            if (!camera_id.IsEmpty() && pFrame)
+            Debug.Write(wxString::Format("SHM Monitor: Camera ID changed to %s\n", camera_id));
+
+            // Queue event to gear dialog if open
+            if (pFrame->pGearDialog)
             {
-                Debug.Write(wxString::Format("SHM Monitor: Camera ID changed to %s\n", camera_id));
-                
-                // Queue event to gear dialog if open
-                if (pFrame->pGearDialog)
-                {
-                    wxThreadEvent evt(wxEVT_THREAD);
-                    evt.SetString(wxT("camera_id:") + camera_id);
-                    wxQueueEvent(pFrame->pGearDialog, evt.Clone());
-                }
+                wxThreadEvent evt(wxEVT_THREAD);
+                evt.SetString(wxT("camera_id:") + camera_id);
+                wxQueueEvent(pFrame->pGearDialog, evt.Clone());
             }
         }
-        
-        // Check for mount index changes
-        int mount_index = MountSHMManager::GetSelectedMount();
-        if (mount_index != last_mount_index)
+    }
+}
+
+static void check_mount_selection(int& last_mount_index)
+{
+    int mount_index = MountSHMManager::GetSelectedMount();
+    if (mount_index != last_mount_index)
+    {
+        last_mount_index = mount_index;
+
+        // Queue event to gear dialog if open
+        if (pFrame && pFrame->pGearDialog)
+        {
+            wxThreadEvent evt(wxEVT_THREAD);
+            evt.SetInt(mount_index);
+            evt.SetString(wxT("mount"));
+            wxQueueEvent(pFrame->pGearDialog, evt.Clone());
+        }
+
+        if (mount_index >= 0)
         {
-            last_mount_index = mount_index;
-            if (mount_index >= 0)
+            Debug.Write(wxString::Format("SHM Monitor: Mount index changed to %d\n", mount_index));
+
+            // Save mount selection to config for persistence (works in headless and GUI modes)
+            wxArrayString mount_names;
+            MountSHMManager::GetMountList(mount_names);
+            if (mount_index >= 0 && mount_index < (int)mount_names.Count())
             {
-                Debug.Write(wxString::Format("SHM Monitor: Mount index changed to %d\n", mount_index));
-                
-                // Save mount selection to config for persistence (works in headless and GUI modes)
-                wxArrayString mount_names;
-                MountSHMManager::GetMountList(mount_names);
-                if (mount_index >= 0 && mount_index < (int)mount_names.Count())
-                {
-                    pConfig->Profile.SetString("/scope/LastMenuChoice", mount_names[mount_index]);
-                    Debug.Write(wxString::Format("SHM Monitor: Saved mount selection to config: %s\n", mount_names[mount_index]));
-                }
+                pConfig->Profile.SetString("/scope/LastMenuChoice", mount_names[mount_index]);
+                Debug.Write(wxString::Format("SHM Monitor: Saved mount selection to config: %s\n", mount_names[mount_index]));
             }
         }
-        
-        usleep(500000);  // Poll every 0.5 seconds
     }
-    
-    Debug.Write("SHM Monitor: Thread stopped\n");
+}
+
+static void* camera_monitor_thread_func(void* arg)
+{
+    Debug.Write("SHM Monitor: Camera thread started\n");
+
+    wxString last_camera_id;
+    int last_camera_index = -2;
+
+    while (g_shm_monitor_running)
+    {
+        check_camera_selection(last_camera_index, last_camera_id);
+        shm_camera_timedwait_client_request(SHM_MONITOR_RECHECK_MS);
+    }
+
+    Debug.Write("SHM Monitor: Camera thread stopped\n");
+    return NULL;
+}
+
+static void* mount_monitor_thread_func(void* arg)
+{
+    Debug.Write("SHM Monitor: Mount thread started\n");
+
+    int last_mount_index = -2;
+
+    while (g_shm_monitor_running)
+    {
+        check_mount_selection(last_mount_index);
+        shm_mount_timedwait_client_request(SHM_MONITOR_RECHECK_MS);
+    }
+
+    Debug.Write("SHM Monitor: Mount thread stopped\n");
     return NULL;
 }
 
 bool SHMMonitor::Start()
 {
-    if (g_shm_monitor_thread != 0)
+    if (g_camera_monitor_thread != 0)
     {
         return true;  // Already running
     }
-    
+
     g_shm_monitor_running = 1;
-    if (pthread_create(&g_shm_monitor_thread, NULL, shm_monitor_thread_func, NULL) != 0)
+    if (pthread_create(&g_camera_monitor_thread, NULL, camera_monitor_thread_func, NULL) != 0)
     {
         Debug.Write("SHM Monitor: Failed to create thread\n");
+        g_camera_monitor_thread = 0;
         g_shm_monitor_running = 0;
         return false;
     }
-    
+
+    if (pthread_create(&g_mount_monitor_thread, NULL, mount_monitor_thread_func, NULL) != 0)
+    {
+        Debug.Write("SHM Monitor: Failed to create thread\n");
+        g_mount_monitor_thread = 0;
+        Stop();
+        return false;
+    }
+
     Debug.Write("SHM Monitor: Started\n");
     return true;
 }
 
 void SHMMonitor::Stop()
 {
-    if (g_shm_monitor_thread == 0)
+    if (g_camera_monitor_thread == 0)
     {
         return;
     }
-    
+
     g_shm_monitor_running = 0;
-    pthread_join(g_shm_monitor_thread, NULL);
-    g_shm_monitor_thread = 0;
-    
+
+    // Wake the threads so they see the stop request right away
+    shm_camera_signal_client_request();
+    shm_mount_signal_client_request();
+
+    pthread_join(g_camera_monitor_thread, NULL);
+    g_camera_monitor_thread = 0;
+
+    if (g_mount_monitor_thread != 0)
+    {
+        pthread_join(g_mount_monitor_thread, NULL);
+        g_mount_monitor_thread = 0;
+    }
+
     Debug.Write("SHM Monitor: Stopped\n");
 }
 
@@ -0,0 +1,82 @@
+/*
+ *  simd.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SIMD_INCLUDED
+#define SIMD_INCLUDED
+
+// Helpers for the runtime-dispatched SIMD image kernels.
+//
+// Kernels are compiled for several instruction sets in the same translation unit
+// using per-function target attributes, so no special compiler flags are needed.
+// The best available implementation is selected at run time with SimdGetLevel().
+// Every vectorized kernel must produce results that are bit-identical to its
+// scalar reference implementation.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+# define PHD_SIMD_X86 1
+#else
+# define PHD_SIMD_X86 0
+#endif
+
+#if PHD_SIMD_X86
+# include <emmintrin.h>
+# include <immintrin.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  define PHD_TARGET_SSE2
+#  define PHD_TARGET_AVX2
+# else
+#  define PHD_TARGET_SSE2 __attribute__((target("sse2")))
+#  define PHD_TARGET_AVX2 __attribute__((target("avx2")))
+# endif
+#endif
+
+enum SimdLevel
+{
+    SIMD_NONE,
+    SIMD_SSE2,
+    SIMD_AVX2,
+};
+
+// instruction set supported by the CPU and OS
+extern SimdLevel SimdDetect();
+
+// instruction set used by the kernels; defaults to SimdDetect()
+extern SimdLevel SimdGetLevel();
+
+// restrict the kernels to a lower instruction set (for benchmarks and verification);
+// the level is clamped to what SimdDetect() reports
+extern void SimdSetLevel(SimdLevel level);
+
+extern const char *SimdLevelName(SimdLevel level);
+
+#endif // SIMD_INCLUDED
@@ -36,6 +36,9 @@
  */
 
 #include "phd.h"
+#include "autofind_kernels.h"
+#include "star_kernels.h"
+
 #include <algorithm>
 
 Star::Star()
@@ -69,59 +72,10 @@ void Star::SetError(FindResult error)
     m_lastFindResult = error;
 }
 
-// helper struct for HFR calculation
-struct R2M
-{
-    double r2;
-    wxPoint p;
-    double m;
-    R2M() { }
-    R2M(int x, int y, double m_) : p(x, y), m(m_) { }
-    bool operator<(const R2M& rhs) const { return r2 < rhs.r2; }
-};
-
-static double hfr(std::vector<R2M>& vec, double cx, double cy, double mass)
-{
-    if (vec.size() == 1) // hot pixel?
-        return 0.25;
-
-    // compute Half Flux Radius (HFR)
-    for (auto it = vec.begin(); it != vec.end(); ++it)
-    {
-        double dx = (double) it->p.x - cx;
-        double dy = (double) it->p.y - cy;
-        it->r2 = dx * dx + dy * dy;
-    }
-    std::sort(vec.begin(), vec.end()); // sort by ascending radius^2
-
-    // find radius of half-mass
-    double r20, r21, m0, m1;
-    r20 = r21 = m0 = m1 = 0.0;
-    double halfm = 0.5 * mass;
-    for (auto it = vec.begin(); it != vec.end(); ++it)
-    {
-        const R2M& rm = *it;
-        r20 = r21;
-        m0 = m1;
-        r21 = rm.r2;
-        m1 += rm.m;
-        if (m1 > halfm)
-            break;
-    }
-
-    // interpolate
-    double hfr;
-    if (m1 > m0)
-    {
-        double r0 = sqrt(r20), r1 = sqrt(r21);
-        double s = (r1 - r0) / (m1 - m0);
-        hfr = r0 + s * (halfm - m0);
-    }
-    else
-        hfr = 0.25;
-
-    return hfr;
-}
+static_assert((int) Star::STAR_SATURATED == STAR_FIND_SATURATED && (int) Star::STAR_LOWSNR == STAR_FIND_LOWSNR &&
+                  (int) Star::STAR_LOWMASS == STAR_FIND_LOWMASS && (int) Star::STAR_LOWHFD == STAR_FIND_LOWHFD &&
+                  (int) Star::STAR_HIHFD == STAR_FIND_HIHFD && (int) Star::STAR_ERROR == STAR_FIND_ERROR,
+              "StarFindStatus values must match Star::FindResult");
 
 bool Star::Find(const usImage *pImg, int searchRegion, int base_x, int base_y, FindMode mode, double minHFD, double maxHFD,
                 unsigned short maxADU, StarFindLogType loggingControl)
@@ -137,313 +91,59 @@ bool Star::Find(const usImage *pImg, int searchRegion, int base_x, int base_y, F
                                          base_x, base_y, mode, pImg->Subframe.x, pImg->Subframe.y, pImg->Subframe.width,
                                          pImg->Subframe.height, minHFD, maxHFD, maxADU, pImg->FrameNum));
 
-        int minx, miny, maxx, maxy;
+        StarFindParams params;
 
         if (pImg->Subframe.IsEmpty())
         {
-            minx = miny = 0;
-            maxx = pImg->Size.GetWidth() - 1;
-            maxy = pImg->Size.GetHeight() - 1;
+            params.minx = params.miny = 0;
+            params.maxx = pImg->Size.GetWidth() - 1;
+            params.maxy = pImg->Size.GetHeight() - 1;
         }
         else
         {
-            minx = pImg->Subframe.GetLeft();
-            maxx = pImg->Subframe.GetRight();
-            miny = pImg->Subframe.GetTop();
-            maxy = pImg->Subframe.GetBottom();
-        }
-
-        // search region bounds
-        int start_x = wxMax(base_x - searchRegion, minx);
-        int end_x = wxMin(base_x + searchRegion, maxx);
-        int start_y = wxMax(base_y - searchRegion, miny);
-        int end_y = wxMin(base_y + searchRegion, maxy);
-
-        if (end_x <= start_x || end_y <= start_y)
-        {
-            throw ERROR_INFO("coordinates are invalid");
-        }
-
-        const unsigned short *imgdata = pImg->ImageData;
-        int rowsize = pImg->Size.GetWidth();
-
-        int peak_x = 0, peak_y = 0;
-        unsigned int peak_val = 0;
-        unsigned short max3[3] = { 0, 0, 0 };
-
-        if (mode == FIND_PEAK)
-        {
-            for (int y = start_y; y <= end_y; y++)
-            {
-                for (int x = start_x; x <= end_x; x++)
-                {
-                    unsigned short val = imgdata[y * rowsize + x];
-
-                    if (val > peak_val)
-                    {
-                        peak_val = val;
-                        peak_x = x;
-                        peak_y = y;
-                    }
-                }
-            }
-
-            PeakVal = peak_val;
-        }
-        else
-        {
-            // find the peak value within the search region using a smoothing function
-            // also check for saturation
-
-            for (int y = start_y + 1; y <= end_y - 1; y++)
-            {
-                for (int x = start_x + 1; x <= end_x - 1; x++)
-                {
-                    unsigned short p = imgdata[y * rowsize + x];
-                    unsigned int val = 4 * (unsigned int) p + imgdata[(y - 1) * rowsize + (x - 1)] +
-                        imgdata[(y - 1) * rowsize + (x + 1)] + imgdata[(y + 1) * rowsize + (x - 1)] +
-                        imgdata[(y + 1) * rowsize + (x + 1)] + 2 * imgdata[(y - 1) * rowsize + (x + 0)] +
-                        2 * imgdata[(y + 0) * rowsize + (x - 1)] + 2 * imgdata[(y + 0) * rowsize + (x + 1)] +
-                        2 * imgdata[(y + 1) * rowsize + (x + 0)];
-
-                    if (val > peak_val)
-                    {
-                        peak_val = val;
-                        peak_x = x;
-                        peak_y = y;
-                    }
-
-                    if (p > max3[0])
-                        std::swap(p, max3[0]);
-                    if (p > max3[1])
-                        std::swap(p, max3[1]);
-                    if (p > max3[2])
-                        std::swap(p, max3[2]);
-                }
-            }
-
-            PeakVal = max3[0]; // raw peak val
-            peak_val /= 16; // smoothed peak value
-        }
-
-        // measure noise in the annulus with inner radius A and outer radius B
-        int const A = 7; // inner radius
-        int const B = 12; // outer radius
-        int const A2 = A * A;
-        int const B2 = B * B;
-
-        // center window around peak value
-        start_x = wxMax(peak_x - B, minx);
-        end_x = wxMin(peak_x + B, maxx);
-        start_y = wxMax(peak_y - B, miny);
-        end_y = wxMin(peak_y + B, maxy);
-
-        // find the mean and stdev of the background
-
-        unsigned int nbg;
-        double mean_bg = 0., prev_mean_bg;
-        double sigma2_bg = 0.;
-        double sigma_bg = 0.;
-
-        for (int iter = 0; iter < 9; iter++)
-        {
-            double sum = 0.0;
-            double a = 0.0;
-            double q = 0.0;
-            nbg = 0;
-
-            const unsigned short *row = imgdata + rowsize * start_y;
-            for (int y = start_y; y <= end_y; y++, row += rowsize)
-            {
-                int dy = y - peak_y;
-                int dy2 = dy * dy;
-                for (int x = start_x; x <= end_x; x++)
-                {
-                    int dx = x - peak_x;
-                    int r2 = dx * dx + dy2;
-
-                    // exclude points not in annulus
-                    if (r2 <= A2 || r2 > B2)
-                        continue;
-
-                    double const val = (double) row[x];
-
-                    if (iter > 0 && (val < mean_bg - 2.0 * sigma_bg || val > mean_bg + 2.0 * sigma_bg))
-                        continue;
-
-                    sum += val;
-                    ++nbg;
-                    double const k = (double) nbg;
-                    double const a0 = a;
-                    a += (val - a) / k;
-                    q += (val - a0) * (val - a);
-                }
-            }
-
-            if (nbg < 10) // only possible after the first iteration
-            {
-                Debug.Write(wxString::Format("Star::Find: too few background points! nbg=%u mean=%.1f sigma=%.1f\n", nbg,
-                                             mean_bg, sigma_bg));
-                break;
-            }
-
-            prev_mean_bg = mean_bg;
-            mean_bg = sum / (double) nbg;
-            sigma2_bg = q / (double) (nbg - 1);
-            sigma_bg = sqrt(sigma2_bg);
-
-            if (iter > 0 && fabs(mean_bg - prev_mean_bg) < 0.5)
-                break;
+            params.minx = pImg->Subframe.GetLeft();
+            params.maxx = pImg->Subframe.GetRight();
+            params.miny = pImg->Subframe.GetTop();
+            params.maxy = pImg->Subframe.GetBottom();
         }
 
-        unsigned short thresh;
-
-        double cx = 0.0;
-        double cy = 0.0;
-        double mass = 0.0;
-        unsigned int n;
+        params.searchRegion = searchRegion;
+        params.peakMode = mode == FIND_PEAK;
+        params.minHFD = minHFD;
+        params.maxHFD = maxHFD;
+        params.maxADU = maxADU;
+        params.pedestal = pImg->Pedestal;
+        params.bitsPerPixel = pImg->BitsPerPixel;
 
         std::vector<R2M> hfrvec;
+        StarFindOutput out;
 
-        if (mode == FIND_PEAK)
-        {
-            mass = peak_val;
-            n = 1;
-            thresh = 0;
-        }
-        else
-        {
-            thresh = (unsigned short) (mean_bg + 3.0 * sigma_bg + 0.5);
-
-            // find pixels over threshold within aperture; compute mass and centroid
-
-            start_x = wxMax(peak_x - A, minx);
-            end_x = wxMin(peak_x + A, maxx);
-            start_y = wxMax(peak_y - A, miny);
-            end_y = wxMin(peak_y + A, maxy);
-
-            n = 0;
-
-            const unsigned short *row = imgdata + rowsize * start_y;
-            for (int y = start_y; y <= end_y; y++, row += rowsize)
-            {
-                int dy = y - peak_y;
-                int dy2 = dy * dy;
-                if (dy2 > A2)
-                    continue;
-
-                for (int x = start_x; x <= end_x; x++)
-                {
-                    int dx = x - peak_x;
+        StarFindStatus status = StarFind(&out, &hfrvec, pImg->ImageData, pImg->Size.GetWidth(), params, base_x, base_y);
 
-                    // exclude points outside aperture
-                    if (dx * dx + dy2 > A2)
-                        continue;
-
-                    // exclude points below threshold
-                    unsigned short val = row[x];
-                    if (val < thresh)
-                        continue;
-
-                    double const d = (double) val - mean_bg;
-
-                    cx += dx * d;
-                    cy += dy * d;
-                    mass += d;
-                    ++n;
-
-                    hfrvec.push_back(R2M(x, y, d));
-                }
-            }
-        }
-
-        Mass = mass;
-
-        // SNR estimate from: Measuring the Signal-to-Noise Ratio S/N of the CCD Image of a Star or Nebula, J.H.Simonetti, 2004
-        // January 8
-        //     http://www.phys.vt.edu/~jhs/phys3154/snr20040108.pdf
-        double const gain = .5; // electrons per ADU, nominal
-        SNR = n > 0 ? mass / sqrt(mass / gain + sigma2_bg * (double) n * (1.0 + 1.0 / (double) nbg)) : 0.0;
-
-        double const LOW_SNR = 3.0;
-
-        // a few scattered pixels over threshold can give a false positive
-        // avoid this by requiring the smoothed peak value to be above the threshold
-        if (peak_val <= thresh && SNR >= LOW_SNR)
+        if (status == STAR_FIND_ERROR)
         {
-            Debug.Write(wxString::Format("Star::Find false star n=%u nbg=%u bg=%.1f sigma=%.1f thresh=%u peak=%u\n", n, nbg,
-                                         mean_bg, sigma_bg, thresh, peak_val));
-            SNR = LOW_SNR - 0.1;
-        }
-
-        if (mass < 10.0)
-        {
-            HFD = 0.;
-            Result = STAR_LOWMASS;
-            goto done;
+            throw ERROR_INFO("coordinates are invalid");
         }
 
-        if (SNR < LOW_SNR)
+        if (out.bg.tooFew) // only possible after the first iteration
         {
-            HFD = 0.;
-            Result = STAR_LOWSNR;
-            goto done;
+            Debug.Write(wxString::Format("Star::Find: too few background points! nbg=%u mean=%.1f sigma=%.1f\n", out.bg.nbg,
+                                         out.bg.mean, out.bg.sigma));
         }
 
-        newX = peak_x + cx / mass;
-        newY = peak_y + cy / mass;
-
-        HFD = 2.0 * hfr(hfrvec, newX, newY, mass);
-        // Check for constraints on HFD value
-        if (mode != FIND_PEAK)
-        {
-            if (HFD < minHFD)
-            {
-                Result = STAR_LOWHFD;
-                goto done;
-            }
-            if (HFD > maxHFD)
-            {
-                Result = STAR_HIHFD;
-                goto done;
-            }
-        }
-
-        // check for saturation
-
-        unsigned int mx = (unsigned int) max3[0];
-
-        // remove pedestal
-        if (mx >= pImg->Pedestal)
-            mx -= pImg->Pedestal;
-        else
-            mx = 0; // unlikely
-
-        if (maxADU > 0)
+        if (out.falseStar)
         {
-            // maxADU is known
-            if (mx >= maxADU)
-                Result = STAR_SATURATED;
-            goto done;
+            Debug.Write(wxString::Format("Star::Find false star n=%u nbg=%u bg=%.1f sigma=%.1f thresh=%u peak=%u\n", out.n,
+                                         out.bg.nbg, out.bg.mean, out.bg.sigma, out.thresh, out.smoothedPeak));
         }
 
-        // maxADU not known, use the "flat-top" heuristic
-        //
-        // even at saturation, the max values may vary a bit due to noise
-        // Call it saturated if the the top three values are within 32 parts per 65535 of max for 16-bit cameras,
-        // or within 1 part per 191 for 8-bit cameras
-        unsigned int d = (unsigned int) (max3[0] - max3[2]);
-
-        if (pImg->BitsPerPixel < 12)
-        {
-            if (d * 191U < 1U * mx)
-                Result = STAR_SATURATED;
-        }
-        else
-        {
-            if (d * 65535U < 32U * mx)
-                Result = STAR_SATURATED;
-        }
+        PeakVal = out.peakVal;
+        Mass = out.mass;
+        SNR = out.snr;
+        HFD = out.hfd;
+        newX = out.x;
+        newY = out.y;
+        Result = (FindResult) status;
     }
     catch (const wxString& Msg)
     {
@@ -455,7 +155,6 @@ bool Star::Find(const usImage *pImg, int searchRegion, int base_x, int base_y, F
         }
     }
 
-done:
     // update state
     SetXY(newX, newY);
     m_lastFindResult = Result;
@@ -487,60 +186,50 @@ struct FloatImg
     float *px;
     wxSize Size;
     unsigned int NPixels;
+    unsigned int Capacity; // allocated size of px
 
-    FloatImg() : px(0) { }
-    FloatImg(const wxSize& size) : px(0) { Init(size); }
-    FloatImg(const usImage& img) : px(0)
-    {
-        Init(img.Size);
-        for (unsigned int i = 0; i < NPixels; i++)
-            px[i] = (float) img.ImageData[i];
-    }
+    FloatImg() : px(0), NPixels(0), Capacity(0) { }
+    FloatImg(const wxSize& size) : px(0), NPixels(0), Capacity(0) { Init(size); }
     ~FloatImg() { delete[] px; }
+    // the buffer is only reallocated when it is too small
     void Init(const wxSize& sz)
     {
-        delete[] px;
         Size = sz;
         NPixels = Size.GetWidth() * Size.GetHeight();
-        px = new float[NPixels];
+        if (NPixels > Capacity)
+        {
+            delete[] px;
+            px = new float[NPixels];
+            Capacity = NPixels;
+        }
+    }
+    void CopyFrom(const usImage& img)
+    {
+        Init(img.Size);
+        for (unsigned int i = 0; i < NPixels; i++)
+            px[i] = (float) img.ImageData[i];
     }
     void Swap(FloatImg& other)
     {
         std::swap(px, other.px);
         std::swap(Size, other.Size);
         std::swap(NPixels, other.NPixels);
+        std::swap(Capacity, other.Capacity);
     }
 };
 
-static void GetStats(double *mean, double *stdev, const FloatImg& img, const wxRect& win)
+// intermediate AutoFind images, kept between calls so that the full-frame
+// buffers are not reallocated each time
+static struct
 {
-    // Determine the mean and standard deviation
-    double sum = 0.0;
-    double a = 0.0;
-    double q = 0.0;
-    double k = 1.0;
-    double km1 = 0.0;
-
-    const int width = img.Size.GetWidth();
-    const float *p0 = &img.px[win.GetTop() * width + win.GetLeft()];
-    for (int y = 0; y < win.GetHeight(); y++)
-    {
-        const float *end = p0 + win.GetWidth();
-        for (const float *p = p0; p < end; p++)
-        {
-            double const x = (double) *p;
-            sum += x;
-            double const a0 = a;
-            a += (x - a) / k;
-            q += (x - a0) * (x - a);
-            km1 = k;
-            k += 1.0;
-        }
-        p0 += width;
-    }
+    wxCriticalSection lock;
+    FloatImg conv;
+    FloatImg tmp;
+} s_autofind;
 
-    *mean = sum / km1;
-    *stdev = sqrt(q / km1);
+static void GetStats(double *mean, double *stdev, const FloatImg& img, const wxRect& win)
+{
+    AutoFindStats(mean, stdev, img.px, img.Size.GetWidth(), win.GetLeft(), win.GetTop(), win.GetWidth(), win.GetHeight());
 }
 
 // un-comment to save the intermediate autofind image
@@ -571,88 +260,21 @@ static void SaveImage(const FloatImg& img, const char *name)
 #endif // SAVE_AUTOFIND_IMG
 }
 
+// minimum number of rows in a band of work handed to the worker pool
+enum
+{
+    AUTOFIND_BAND_ROWS = 32
+};
+
 static void psf_conv(FloatImg& dst, const FloatImg& src)
 {
     dst.Init(src.Size);
 
-    //                       A      B1     B2    C1     C2    C3     D1     D2     D3
-    const double PSF[] = { 0.906, 0.584, 0.365, .117, .049, -0.05, -.064, -.074, -.094 };
-
     int const width = src.Size.GetWidth();
     int const height = src.Size.GetHeight();
 
-    memset(dst.px, 0, src.NPixels * sizeof(float));
-
-    /* PSF Grid is:
-    D3 D3 D3 D3 D3 D3 D3 D3 D3
-    D3 D3 D3 D2 D1 D2 D3 D3 D3
-    D3 D3 C3 C2 C1 C2 C3 D3 D3
-    D3 D2 C2 B2 B1 B2 C2 D2 D3
-    D3 D1 C1 B1 A  B1 C1 D1 D3
-    D3 D2 C2 B2 B1 B2 C2 D2 D3
-    D3 D3 C3 C2 C1 C2 C3 D3 D3
-    D3 D3 D3 D2 D1 D2 D3 D3 D3
-    D3 D3 D3 D3 D3 D3 D3 D3 D3
-
-    1@A
-    4@B1, B2, C1, C3, D1
-    8@C2, D2
-    44 * D3
-    */
-
-    int psf_size = 4;
-
-    for (int y = psf_size; y < height - psf_size; y++)
-    {
-        for (int x = psf_size; x < width - psf_size; x++)
-        {
-            float A, B1, B2, C1, C2, C3, D1, D2, D3;
-
-#define PX(dx, dy) *(src.px + width * (y + (dy)) + x + (dx))
-            A = PX(+0, +0);
-            B1 = PX(+0, -1) + PX(+0, +1) + PX(+1, +0) + PX(-1, +0);
-            B2 = PX(-1, -1) + PX(+1, -1) + PX(-1, +1) + PX(+1, +1);
-            C1 = PX(+0, -2) + PX(-2, +0) + PX(+2, +0) + PX(+0, +2);
-            C2 = PX(-1, -2) + PX(+1, -2) + PX(-2, -1) + PX(+2, -1) + PX(-2, +1) + PX(+2, +1) + PX(-1, +2) + PX(+1, +2);
-            C3 = PX(-2, -2) + PX(+2, -2) + PX(-2, +2) + PX(+2, +2);
-            D1 = PX(+0, -3) + PX(-3, +0) + PX(+3, +0) + PX(+0, +3);
-            D2 = PX(-1, -3) + PX(+1, -3) + PX(-3, -1) + PX(+3, -1) + PX(-3, +1) + PX(+3, +1) + PX(-1, +3) + PX(+1, +3);
-            D3 = PX(-4, -2) + PX(-3, -2) + PX(+3, -2) + PX(+4, -2) + PX(-4, -1) + PX(+4, -1) + PX(-4, +0) + PX(+4, +0) +
-                PX(-4, +1) + PX(+4, +1) + PX(-4, +2) + PX(-3, +2) + PX(+3, +2) + PX(+4, +2);
-#undef PX
-            int i;
-            const float *uptr;
-
-            uptr = src.px + width * (y - 4) + (x - 4);
-            for (i = 0; i < 9; i++)
-                D3 += *uptr++;
-
-            uptr = src.px + width * (y - 3) + (x - 4);
-            for (i = 0; i < 3; i++)
-                D3 += *uptr++;
-            uptr += 3;
-            for (i = 0; i < 3; i++)
-                D3 += *uptr++;
-
-            uptr = src.px + width * (y + 3) + (x - 4);
-            for (i = 0; i < 3; i++)
-                D3 += *uptr++;
-            uptr += 3;
-            for (i = 0; i < 3; i++)
-                D3 += *uptr++;
-
-            uptr = src.px + width * (y + 4) + (x - 4);
-            for (i = 0; i < 9; i++)
-                D3 += *uptr++;
-
-            double mean = (A + B1 + B2 + C1 + C2 + C3 + D1 + D2 + D3) / 81.0;
-            double PSF_fit = PSF[0] * (A - mean) + PSF[1] * (B1 - 4.0 * mean) + PSF[2] * (B2 - 4.0 * mean) +
-                PSF[3] * (C1 - 4.0 * mean) + PSF[4] * (C2 - 8.0 * mean) + PSF[5] * (C3 - 4.0 * mean) +
-                PSF[6] * (D1 - 4.0 * mean) + PSF[7] * (D2 - 8.0 * mean) + PSF[8] * (D3 - 44.0 * mean);
-
-            dst.px[width * y + x] = (float) PSF_fit;
-        }
-    }
+    WorkerPool::RunRows(0, height, AUTOFIND_BAND_ROWS,
+                        [&](int y0, int y1) { AutoFindPsfConv(dst.px, src.px, width, height, 1, y0, y1); });
 }
 
 static void Downsample(FloatImg& dst, const FloatImg& src, int downsample)
@@ -663,55 +285,14 @@ static void Downsample(FloatImg& dst, const FloatImg& src, int downsample)
 
     dst.Init(wxSize(dw, dh));
 
-    float const d2 = downsample * downsample;
-
-    for (int yy = 0; yy < dh; yy++)
-    {
-        for (int xx = 0; xx < dw; xx++)
-        {
-            float sum = 0.0;
-            for (int j = 0; j < downsample; j++)
-                for (int i = 0; i < downsample; i++)
-                    sum += src.px[(yy * downsample + j) * width + xx * downsample + i];
-            float val = sum / d2;
-            dst.px[yy * dw + xx] = val;
-        }
-    }
-}
-
-struct Peak
-{
-    int x;
-    int y;
-    float val;
-
-    Peak() { }
-    Peak(int x_, int y_, float val_) : x(x_), y(y_), val(val_) { }
-    bool operator<(const Peak& rhs) const { return val < rhs.val; }
-};
-
-static void RemoveItems(std::set<Peak>& stars, const std::set<int>& to_erase)
-{
-    int n = 0;
-    for (std::set<Peak>::iterator it = stars.begin(); it != stars.end(); n++)
-    {
-        if (to_erase.find(n) != to_erase.end())
-        {
-            std::set<Peak>::iterator next = it;
-            ++next;
-            stars.erase(it);
-            it = next;
-        }
-        else
-            ++it;
-    }
+    WorkerPool::RunRows(0, dh, AUTOFIND_BAND_ROWS,
+                        [&](int y0, int y1) { AutoFindDownsample(dst.px, dw, src.px, width, downsample, y0, y1); });
 }
 
 static bool CloseToReference(const GuideStar& referencePoint, const GuideStar& other)
 {
     // test whether star is close to the reference star for purposes of detecting duplicates and improving spacial sampling
-    const double minSeparation = 25.0;
-    return other.Distance(referencePoint) < minSeparation;
+    return other.Distance(referencePoint) < AUTOFIND_MIN_SEPARATION;
 }
 
 // Multi-star version of AutoFind.
@@ -725,6 +306,7 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     }
 
     wxBusyCursor busy;
+    TimingProbe probe(GuideTiming::STAGE_AUTO_FIND);
 
     Debug.Write(wxString::Format("Star::AutoFind called with edgeAllowance = %d "
                                  "searchRegion = %d roi = %dx%d@%d,%d\n",
@@ -751,8 +333,11 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     }
     Median3(smoothed);
 
+    wxCriticalSectionLocker lck(s_autofind.lock);
+
     // convert to floating point
-    FloatImg conv(smoothed);
+    FloatImg& conv = s_autofind.conv;
+    conv.CopyFrom(smoothed);
 
     // downsample the source image
     int downsample = pFrame->pGuider->GetAutoSelDownsample();
@@ -771,14 +356,14 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     if (downsample > 1)
     {
         Debug.Write(wxString::Format("AutoFind: downsample %dx\n", downsample));
-        FloatImg tmp;
+        FloatImg& tmp = s_autofind.tmp;
         Downsample(tmp, conv, downsample);
         conv.Swap(tmp);
     }
 
     // run the PSF convolution
     {
-        FloatImg tmp;
+        FloatImg& tmp = s_autofind.tmp;
         psf_conv(tmp, conv);
         conv.Swap(tmp);
     }
@@ -793,12 +378,6 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
 
     SaveImage(conv, "PHD2_AutoFind.fit");
 
-    enum
-    {
-        TOP_N = 100
-    }; // keep track of the brightest stars
-    std::set<Peak> stars; // sorted by ascending intensity
-
     double global_mean, global_stdev;
     GetStats(&global_mean, &global_stdev, conv, convRect);
 
@@ -807,141 +386,57 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     const double threshold = 0.1;
     Debug.Write(wxString::Format("AutoFind: using threshold = %.1f\n", threshold));
 
-    // find each local maximum
+    // find each local maximum, one band of rows at a time
     int srch = 4;
-    for (int y = convRect.GetTop() + srch; y <= convRect.GetBottom() - srch; y++)
+    int const scanTop = convRect.GetTop() + srch;
+    int const scanBottom = convRect.GetBottom() - srch + 1;
+    int const nbands = WorkerPool::BandCount(scanBottom - scanTop, AUTOFIND_BAND_ROWS);
+    std::vector<std::vector<AutoFindCandidate>> candidates(nbands);
+
+    WorkerPool::Run(nbands, [&](int band) {
+        int y0 = scanTop + (int) ((long long) (scanBottom - scanTop) * band / nbands);
+        int y1 = scanTop + (int) ((long long) (scanBottom - scanTop) * (band + 1) / nbands);
+        AutoFindLocalMaxima(&candidates[band], conv.px, dw, convRect.GetLeft(), convRect.GetTop(), convRect.GetRight(),
+                            convRect.GetBottom(), srch, global_stdev, threshold, y0, y1);
+    });
+
+    // merge the bands in raster order so that the result is the same as a
+    // single pass over the whole image, keeping track of the brightest stars
+    enum
     {
-        for (int x = convRect.GetLeft() + srch; x <= convRect.GetRight() - srch; x++)
-        {
-            float val = conv.px[dw * y + x];
-            bool ismax = false;
-            if (val > 0.0)
-            {
-                ismax = true;
-                for (int j = -srch; j <= srch; j++)
-                {
-                    for (int i = -srch; i <= srch; i++)
-                    {
-                        if (i == 0 && j == 0)
-                            continue;
-                        if (conv.px[dw * (y + j) + (x + i)] > val)
-                        {
-                            ismax = false;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (!ismax)
-                continue;
-
-            // compare local maximum to mean value of surrounding pixels
-            const int local = 7;
-            double local_mean, local_stdev;
-            wxRect localRect(x - local, y - local, 2 * local + 1, 2 * local + 1);
-            localRect.Intersect(convRect);
-            GetStats(&local_mean, &local_stdev, conv, localRect);
-
-            // this is our measure of star intensity
-            double h = (val - local_mean) / global_stdev;
-
-            if (h < threshold)
-            {
-                //  Debug.Write(wxString::Format("AG: local max REJECT [%d, %d] PSF %.1f SNR %.1f\n", imgx, imgy, val, SNR));
-                continue;
-            }
-
-            // coordinates on the original image
-            int imgx = x * downsample + downsample / 2;
-            int imgy = y * downsample + downsample / 2;
-
-            stars.insert(Peak(imgx, imgy, h));
-            if (stars.size() > TOP_N)
-                stars.erase(stars.begin());
-        }
-    }
+        TOP_N = 100
+    };
+    std::vector<AutoFindPeak> stars; // sorted by ascending intensity
+    AutoFindTopPeaks(&stars, candidates, downsample, TOP_N);
 
-    for (std::set<Peak>::const_reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
+    for (std::vector<AutoFindPeak>::const_reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
         Debug.Write(wxString::Format("AutoFind: local max [%d, %d] %.1f\n", it->x, it->y, it->val));
 
-    // merge stars that are very close into a single star
-    {
-        const int minlimitsq = 5 * 5;
-    repeat:
-        for (std::set<Peak>::const_iterator a = stars.begin(); a != stars.end(); ++a)
-        {
-            std::set<Peak>::const_iterator b = a;
-            ++b;
-            for (; b != stars.end(); ++b)
-            {
-                int dx = a->x - b->x;
-                int dy = a->y - b->y;
-                int d2 = dx * dx + dy * dy;
-                if (d2 < minlimitsq)
-                {
-                    // very close, treat as single star
-                    Debug.Write(wxString::Format("AutoFind: merge [%d, %d] %.1f - [%d, %d] %.1f\n", a->x, a->y, a->val, b->x,
-                                                 b->y, b->val));
-                    // erase the dimmer one
-                    stars.erase(a);
-                    goto repeat;
-                }
-            }
-        }
-    }
+    // merge stars that are very close, exclude stars that would fit within a
+    // single searchRegion box and stars too close to the edge
+    std::vector<AutoFindPeakNote> notes;
+    AutoFindSeparatePeaks(&stars, &notes, searchRegion, searchRegion + extraEdgeAllowance, image.Size.GetWidth(),
+                          image.Size.GetHeight());
 
-    // exclude stars that would fit within a single searchRegion box
+    for (const AutoFindPeakNote& n : notes)
     {
-        // build a list of stars to be excluded
-        std::set<int> to_erase;
-        const int extra = 5; // extra safety margin
-        const int fullw = searchRegion + extra;
-        for (std::set<Peak>::const_iterator a = stars.begin(); a != stars.end(); ++a)
+        switch (n.action)
         {
-            std::set<Peak>::const_iterator b = a;
-            ++b;
-            for (; b != stars.end(); ++b)
-            {
-                int dx = abs(a->x - b->x);
-                int dy = abs(a->y - b->y);
-                if (dx <= fullw && dy <= fullw)
-                {
-                    // stars closer than search region, exclude them both
-                    // but do not let a very dim star eliminate a very bright star
-                    if (b->val / a->val >= 5.0)
-                    {
-                        Debug.Write(wxString::Format("AutoFind: close dim-bright [%d, %d] %.1f - [%d, %d] %.1f\n", a->x, a->y,
-                                                     a->val, b->x, b->y, b->val));
-                    }
-                    else
-                    {
-                        Debug.Write(wxString::Format("AutoFind: too close [%d, %d] %.1f - [%d, %d] %.1f\n", a->x, a->y, a->val,
-                                                     b->x, b->y, b->val));
-                        to_erase.insert(std::distance(stars.begin(), a));
-                        to_erase.insert(std::distance(stars.begin(), b));
-                    }
-                }
-            }
-        }
-        RemoveItems(stars, to_erase);
-    }
-
-    // exclude stars too close to the edge
-    {
-        int edgeDist = searchRegion + extraEdgeAllowance;
-
-        std::set<Peak>::iterator it = stars.begin();
-        while (it != stars.end())
-        {
-            std::set<Peak>::iterator next = it;
-            ++next;
-            if (it->x <= edgeDist || it->x >= image.Size.GetWidth() - edgeDist || it->y <= edgeDist ||
-                it->y >= image.Size.GetHeight() - edgeDist)
-            {
-                Debug.Write(wxString::Format("AutoFind: too close to edge [%d, %d] %.1f\n", it->x, it->y, it->val));
-                stars.erase(it);
-            }
-            it = next;
+        case AUTOFIND_MERGED:
+            Debug.Write(wxString::Format("AutoFind: merge [%d, %d] %.1f - [%d, %d] %.1f\n", n.a.x, n.a.y, n.a.val, n.b.x,
+                                         n.b.y, n.b.val));
+            break;
+        case AUTOFIND_DIM_BRIGHT:
+            Debug.Write(wxString::Format("AutoFind: close dim-bright [%d, %d] %.1f - [%d, %d] %.1f\n", n.a.x, n.a.y,
+                                         n.a.val, n.b.x, n.b.y, n.b.val));
+            break;
+        case AUTOFIND_TOO_CLOSE:
+            Debug.Write(wxString::Format("AutoFind: too close [%d, %d] %.1f - [%d, %d] %.1f\n", n.a.x, n.a.y, n.a.val,
+                                         n.b.x, n.b.y, n.b.val));
+            break;
+        case AUTOFIND_NEAR_EDGE:
+            Debug.Write(wxString::Format("AutoFind: too close to edge [%d, %d] %.1f\n", n.a.x, n.a.y, n.a.val));
+            break;
         }
     }
 
@@ -980,7 +475,7 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
 
         // next see if any of the stars has a flat-top
         bool foundSaturated = false;
-        for (std::set<Peak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
+        for (std::vector<AutoFindPeak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
         {
             Star tmp;
             tmp.Find(&image, searchRegion, it->x, it->y, FIND_CENTROID, pFrame->pGuider->GetMinStarHFD(),
@@ -1035,7 +530,7 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     foundStars.clear();
     if (maxStars > 1)
     {
-        for (std::set<Peak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
+        for (std::vector<AutoFindPeak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
         {
             GuideStar tmp;
             tmp.Find(&image, searchRegion, it->x, it->y, FIND_CENTROID, pFrame->pGuider->GetMinStarHFD(), maxHFD,
@@ -1066,7 +561,7 @@ bool GuideStar::AutoFind(const usImage& image, int extraEdgeAllowance, int searc
     {
         Debug.Write(wxString::Format("AutoFind: finding best star pass %d\n", pass));
 
-        for (std::set<Peak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
+        for (std::vector<AutoFindPeak>::reverse_iterator it = stars.rbegin(); it != stars.rend(); ++it)
         {
             GuideStar tmp;
             tmp.Find(&image, searchRegion, it->x, it->y, FIND_CENTROID, pFrame->pGuider->GetMinStarHFD(), maxHFD,
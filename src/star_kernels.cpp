@@ -0,0 +1,941 @@
+/*
+ *  star_kernels.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "star_kernels.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+
+static inline void UpdateMax3(unsigned short max3[3], unsigned short p)
+{
+    if (p > max3[0])
+        std::swap(p, max3[0]);
+    if (p > max3[1])
+        std::swap(p, max3[1]);
+    if (p > max3[2])
+        std::swap(p, max3[2]);
+}
+
+static inline unsigned int Smooth3x3(const unsigned short *img, int rowsize, int x, int y)
+{
+    return 4 * (unsigned int) img[y * rowsize + x] + img[(y - 1) * rowsize + (x - 1)] + img[(y - 1) * rowsize + (x + 1)] +
+        img[(y + 1) * rowsize + (x - 1)] + img[(y + 1) * rowsize + (x + 1)] + 2 * img[(y - 1) * rowsize + (x + 0)] +
+        2 * img[(y + 0) * rowsize + (x - 1)] + 2 * img[(y + 0) * rowsize + (x + 1)] + 2 * img[(y + 1) * rowsize + (x + 0)];
+}
+
+// largest s with s * s <= n, for n >= 0
+static inline int isqrt(int n)
+{
+    int s = (int) sqrt((double) n);
+    while (s * s > n)
+        --s;
+    while ((s + 1) * (s + 1) <= n)
+        ++s;
+    return s;
+}
+
+/*************      smoothed peak      **************************/
+
+static void SmoothedPeakScalar(StarPeak *peak, const unsigned short *img, int rowsize, int x0, int y0, int x1, int y1)
+{
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            unsigned int val = Smooth3x3(img, rowsize, x, y);
+
+            if (val > peak->val)
+            {
+                peak->val = val;
+                peak->x = x;
+                peak->y = y;
+            }
+
+            UpdateMax3(peak->max3, img[y * rowsize + x]);
+        }
+    }
+}
+
+#if PHD_SIMD_X86
+
+enum
+{
+    PEAK_SEGMENT = 256, // row segment processed per pass
+};
+
+// The vector implementations compute the smoothed values of a row segment into a
+// buffer while tracking the segment maximum. If the segment maximum exceeds the
+// current peak, the first pixel in the segment having that value becomes the new
+// peak, which matches the raster-order scan of the scalar version. Raw pixels are
+// only fed to the top-3 tracker when they exceed the current third-largest value,
+// since smaller values cannot change it.
+static void FinishSegment(StarPeak *peak, const unsigned int *buf, unsigned int segmax, int xs, int y)
+{
+    if (segmax > peak->val)
+    {
+        int i = 0;
+        while (buf[i] != segmax)
+            ++i;
+        peak->val = segmax;
+        peak->x = xs + i;
+        peak->y = y;
+    }
+}
+
+PHD_TARGET_SSE2 static inline __m128i Max32SSE2(__m128i a, __m128i b)
+{
+    // smoothed values are < 2^20, so a signed compare is safe
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+PHD_TARGET_SSE2 static inline void Row121SSE2(__m128i *lo, __m128i *hi, const unsigned short *p)
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i l = _mm_loadu_si128((const __m128i *) (p - 1));
+    __m128i c = _mm_loadu_si128((const __m128i *) p);
+    __m128i r = _mm_loadu_si128((const __m128i *) (p + 1));
+    *lo = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(l, zero), _mm_unpacklo_epi16(r, zero)),
+                        _mm_slli_epi32(_mm_unpacklo_epi16(c, zero), 1));
+    *hi = _mm_add_epi32(_mm_add_epi32(_mm_unpackhi_epi16(l, zero), _mm_unpackhi_epi16(r, zero)),
+                        _mm_slli_epi32(_mm_unpackhi_epi16(c, zero), 1));
+}
+
+PHD_TARGET_SSE2 static inline bool AnyAboveSSE2(__m128i c, unsigned short thresh)
+{
+    __m128i above = _mm_subs_epu16(c, _mm_set1_epi16((short) thresh));
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(above, _mm_setzero_si128())) != 0xffff;
+}
+
+PHD_TARGET_SSE2 static void SmoothedPeakSSE2(StarPeak *peak, const unsigned short *img, int rowsize, int x0, int y0, int x1,
+                                             int y1)
+{
+    unsigned int buf[PEAK_SEGMENT];
+
+    for (int y = y0; y <= y1; y++)
+    {
+        const unsigned short *r0 = img + (y - 1) * rowsize;
+        const unsigned short *r1 = img + y * rowsize;
+        const unsigned short *r2 = img + (y + 1) * rowsize;
+
+        for (int xs = x0; xs <= x1; xs += PEAK_SEGMENT)
+        {
+            int xe = std::min(xs + PEAK_SEGMENT - 1, x1);
+            __m128i vmax = _mm_setzero_si128();
+            int x = xs;
+
+            for (; x + 7 <= xe; x += 8)
+            {
+                __m128i a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+                Row121SSE2(&a_lo, &a_hi, r0 + x);
+                Row121SSE2(&b_lo, &b_hi, r1 + x);
+                Row121SSE2(&c_lo, &c_hi, r2 + x);
+
+                __m128i v_lo = _mm_add_epi32(_mm_add_epi32(a_lo, c_lo), _mm_slli_epi32(b_lo, 1));
+                __m128i v_hi = _mm_add_epi32(_mm_add_epi32(a_hi, c_hi), _mm_slli_epi32(b_hi, 1));
+                _mm_storeu_si128((__m128i *) (buf + (x - xs)), v_lo);
+                _mm_storeu_si128((__m128i *) (buf + (x - xs) + 4), v_hi);
+                vmax = Max32SSE2(vmax, Max32SSE2(v_lo, v_hi));
+
+                if (AnyAboveSSE2(_mm_loadu_si128((const __m128i *) (r1 + x)), peak->max3[2]))
+                {
+                    for (int i = 0; i < 8; i++)
+                        UpdateMax3(peak->max3, r1[x + i]);
+                }
+            }
+
+            vmax = Max32SSE2(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+            vmax = Max32SSE2(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+            unsigned int segmax = (unsigned int) _mm_cvtsi128_si32(vmax);
+
+            for (; x <= xe; x++)
+            {
+                unsigned int val = Smooth3x3(img, rowsize, x, y);
+                buf[x - xs] = val;
+                if (val > segmax)
+                    segmax = val;
+                UpdateMax3(peak->max3, r1[x]);
+            }
+
+            FinishSegment(peak, buf, segmax, xs, y);
+        }
+    }
+}
+
+PHD_TARGET_AVX2 static inline __m256i Row121AVX2(const unsigned short *p)
+{
+    __m256i l = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (p - 1)));
+    __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) p));
+    __m256i r = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (p + 1)));
+    return _mm256_add_epi32(_mm256_add_epi32(l, r), _mm256_slli_epi32(c, 1));
+}
+
+PHD_TARGET_AVX2 static void SmoothedPeakAVX2(StarPeak *peak, const unsigned short *img, int rowsize, int x0, int y0, int x1,
+                                             int y1)
+{
+    unsigned int buf[PEAK_SEGMENT];
+
+    for (int y = y0; y <= y1; y++)
+    {
+        const unsigned short *r0 = img + (y - 1) * rowsize;
+        const unsigned short *r1 = img + y * rowsize;
+        const unsigned short *r2 = img + (y + 1) * rowsize;
+
+        for (int xs = x0; xs <= x1; xs += PEAK_SEGMENT)
+        {
+            int xe = std::min(xs + PEAK_SEGMENT - 1, x1);
+            __m256i vmax = _mm256_setzero_si256();
+            int x = xs;
+
+            for (; x + 7 <= xe; x += 8)
+            {
+                __m256i v = _mm256_add_epi32(_mm256_add_epi32(Row121AVX2(r0 + x), Row121AVX2(r2 + x)),
+                                             _mm256_slli_epi32(Row121AVX2(r1 + x), 1));
+                _mm256_storeu_si256((__m256i *) (buf + (x - xs)), v);
+                vmax = _mm256_max_epi32(vmax, v);
+
+                __m128i c = _mm_loadu_si128((const __m128i *) (r1 + x));
+                __m128i above = _mm_subs_epu16(c, _mm_set1_epi16((short) peak->max3[2]));
+                if (!_mm_testz_si128(above, above))
+                {
+                    for (int i = 0; i < 8; i++)
+                        UpdateMax3(peak->max3, r1[x + i]);
+                }
+            }
+
+            __m128i m = _mm_max_epi32(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+            m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+            m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+            unsigned int segmax = (unsigned int) _mm_cvtsi128_si32(m);
+
+            for (; x <= xe; x++)
+            {
+                unsigned int val = Smooth3x3(img, rowsize, x, y);
+                buf[x - xs] = val;
+                if (val > segmax)
+                    segmax = val;
+                UpdateMax3(peak->max3, r1[x]);
+            }
+
+            FinishSegment(peak, buf, segmax, xs, y);
+        }
+    }
+}
+
+#endif // PHD_SIMD_X86
+
+void StarSmoothedPeak(StarPeak *peak, const unsigned short *img, int rowsize, int x0, int y0, int x1, int y1)
+{
+#if PHD_SIMD_X86
+    switch (SimdGetLevel())
+    {
+    case SIMD_AVX2:
+        SmoothedPeakAVX2(peak, img, rowsize, x0, y0, x1, y1);
+        return;
+    case SIMD_SSE2:
+        SmoothedPeakSSE2(peak, img, rowsize, x0, y0, x1, y1);
+        return;
+    default:
+        break;
+    }
+#endif
+    SmoothedPeakScalar(peak, img, rowsize, x0, y0, x1, y1);
+}
+
+/*************      annulus background      **************************/
+
+static void AnnulusBackgroundScalar(StarBackground *bg, const unsigned short *img, int rowsize, int px, int py, int A, int B,
+                                    int minx, int miny, int maxx, int maxy)
+{
+    int const A2 = A * A;
+    int const B2 = B * B;
+
+    int start_x = std::max(px - B, minx);
+    int end_x = std::min(px + B, maxx);
+    int start_y = std::max(py - B, miny);
+    int end_y = std::min(py + B, maxy);
+
+    unsigned int nbg = 0;
+    double mean_bg = 0., prev_mean_bg;
+    double sigma2_bg = 0.;
+    double sigma_bg = 0.;
+
+    bg->tooFew = false;
+
+    for (int iter = 0; iter < 9; iter++)
+    {
+        double sum = 0.0;
+        double a = 0.0;
+        double q = 0.0;
+        nbg = 0;
+
+        const unsigned short *row = img + rowsize * start_y;
+        for (int y = start_y; y <= end_y; y++, row += rowsize)
+        {
+            int dy = y - py;
+            int dy2 = dy * dy;
+            for (int x = start_x; x <= end_x; x++)
+            {
+                int dx = x - px;
+                int r2 = dx * dx + dy2;
+
+                // exclude points not in annulus
+                if (r2 <= A2 || r2 > B2)
+                    continue;
+
+                double const val = (double) row[x];
+
+                if (iter > 0 && (val < mean_bg - 2.0 * sigma_bg || val > mean_bg + 2.0 * sigma_bg))
+                    continue;
+
+                sum += val;
+                ++nbg;
+                double const k = (double) nbg;
+                double const a0 = a;
+                a += (val - a) / k;
+                q += (val - a0) * (val - a);
+            }
+        }
+
+        if (nbg < 10) // only possible after the first iteration
+        {
+            bg->tooFew = true;
+            break;
+        }
+
+        prev_mean_bg = mean_bg;
+        mean_bg = sum / (double) nbg;
+        sigma2_bg = q / (double) (nbg - 1);
+        sigma_bg = sqrt(sigma2_bg);
+
+        if (iter > 0 && fabs(mean_bg - prev_mean_bg) < 0.5)
+            break;
+    }
+
+    bg->mean = mean_bg;
+    bg->sigma = sigma_bg;
+    bg->sigma2 = sigma2_bg;
+    bg->nbg = nbg;
+}
+
+enum
+{
+    MAX_ANNULUS_PIXELS = 1024,
+};
+
+// Gather the annulus pixels once, in raster order, using the per-row spans of the
+// annulus rather than testing the radius of every pixel in the bounding square.
+static int GatherAnnulus(double *vals, const unsigned short *img, int rowsize, int px, int py, int A, int B, int minx, int miny,
+                         int maxx, int maxy)
+{
+    int const A2 = A * A;
+    int const B2 = B * B;
+
+    int start_y = std::max(py - B, miny);
+    int end_y = std::min(py + B, maxy);
+    int lo = std::max(px - B, minx) - px;
+    int hi = std::min(px + B, maxx) - px;
+
+    int n = 0;
+
+    for (int y = start_y; y <= end_y; y++)
+    {
+        const unsigned short *row = img + rowsize * y + px;
+        int dy2 = (y - py) * (y - py);
+        int bx = isqrt(B2 - dy2);
+        // pixels with dx * dx <= A2 - dy2 are inside the inner radius
+        int ax = A2 - dy2 >= 0 ? isqrt(A2 - dy2) : -1;
+
+        if (ax < 0)
+        {
+            for (int dx = std::max(-bx, lo); dx <= std::min(bx, hi); dx++)
+                vals[n++] = (double) row[dx];
+        }
+        else
+        {
+            for (int dx = std::max(-bx, lo); dx <= std::min(-ax - 1, hi); dx++)
+                vals[n++] = (double) row[dx];
+            for (int dx = std::max(ax + 1, lo); dx <= std::min(bx, hi); dx++)
+                vals[n++] = (double) row[dx];
+        }
+    }
+
+    return n;
+}
+
+typedef void (*ClipMaskFn)(uint32_t *mask, const double *vals, int n, double lo, double hi);
+
+#if !PHD_SIMD_X86
+static void ClipMaskScalar(uint32_t *mask, const double *vals, int n, double lo, double hi)
+{
+    for (int i = 0; i < (n + 31) / 32; i++)
+        mask[i] = 0;
+    for (int i = 0; i < n; i++)
+        if (!(vals[i] < lo || vals[i] > hi))
+            mask[i >> 5] |= 1U << (i & 31);
+}
+#endif
+
+#if PHD_SIMD_X86
+
+PHD_TARGET_SSE2 static void ClipMaskSSE2(uint32_t *mask, const double *vals, int n, double lo, double hi)
+{
+    __m128d const vlo = _mm_set1_pd(lo);
+    __m128d const vhi = _mm_set1_pd(hi);
+
+    for (int i = 0; i < (n + 31) / 32; i++)
+        mask[i] = 0;
+
+    int i = 0;
+    for (; i + 1 < n; i += 2)
+    {
+        __m128d v = _mm_loadu_pd(vals + i);
+        __m128d out = _mm_or_pd(_mm_cmplt_pd(v, vlo), _mm_cmpgt_pd(v, vhi));
+        uint32_t in = (uint32_t) (~_mm_movemask_pd(out) & 0x3);
+        mask[i >> 5] |= in << (i & 31);
+    }
+    for (; i < n; i++)
+        if (!(vals[i] < lo || vals[i] > hi))
+            mask[i >> 5] |= 1U << (i & 31);
+}
+
+PHD_TARGET_AVX2 static void ClipMaskAVX2(uint32_t *mask, const double *vals, int n, double lo, double hi)
+{
+    __m256d const vlo = _mm256_set1_pd(lo);
+    __m256d const vhi = _mm256_set1_pd(hi);
+
+    for (int i = 0; i < (n + 31) / 32; i++)
+        mask[i] = 0;
+
+    int i = 0;
+    for (; i + 3 < n; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(vals + i);
+        __m256d out = _mm256_or_pd(_mm256_cmp_pd(v, vlo, _CMP_LT_OQ), _mm256_cmp_pd(v, vhi, _CMP_GT_OQ));
+        uint32_t in = (uint32_t) (~_mm256_movemask_pd(out) & 0xf);
+        mask[i >> 5] |= in << (i & 31);
+    }
+    for (; i < n; i++)
+        if (!(vals[i] < lo || vals[i] > hi))
+            mask[i >> 5] |= 1U << (i & 31);
+}
+
+#endif // PHD_SIMD_X86
+
+// The sigma-clipping iterations run over the gathered pixels with a vectorized
+// clipping mask. The running mean/variance update is kept sequential and in the
+// original order so the result is bit-identical to the scalar version. When an
+// iteration selects exactly the same pixels as the previous one, it would
+// reproduce the previous mean and stop, so it is skipped.
+static void AnnulusBackgroundGathered(StarBackground *bg, const unsigned short *img, int rowsize, int px, int py, int A, int B,
+                                      int minx, int miny, int maxx, int maxy, ClipMaskFn clipMask)
+{
+    double vals[MAX_ANNULUS_PIXELS];
+    uint32_t mask[MAX_ANNULUS_PIXELS / 32];
+    uint32_t prev_mask[MAX_ANNULUS_PIXELS / 32];
+
+    int const nvals = GatherAnnulus(vals, img, rowsize, px, py, A, B, minx, miny, maxx, maxy);
+    int const nwords = (nvals + 31) / 32;
+
+    unsigned int nbg = 0;
+    double mean_bg = 0., prev_mean_bg;
+    double sigma2_bg = 0.;
+    double sigma_bg = 0.;
+
+    bg->tooFew = false;
+
+    for (int iter = 0; iter < 9; iter++)
+    {
+        if (iter == 0)
+        {
+            for (int i = 0; i < nwords; i++)
+                mask[i] = 0xffffffffU;
+            if (nvals & 31)
+                mask[nwords - 1] = (1U << (nvals & 31)) - 1;
+        }
+        else
+        {
+            clipMask(mask, vals, nvals, mean_bg - 2.0 * sigma_bg, mean_bg + 2.0 * sigma_bg);
+            if (std::equal(mask, mask + nwords, prev_mask))
+                break;
+        }
+
+        double sum = 0.0;
+        double a = 0.0;
+        double q = 0.0;
+        nbg = 0;
+
+        for (int w = 0; w < nwords; w++)
+        {
+            uint32_t bits = mask[w];
+            const double *v = vals + w * 32;
+            for (int i = 0; bits; i++, bits >>= 1)
+            {
+                if (!(bits & 1))
+                    continue;
+
+                double const val = v[i];
+                sum += val;
+                ++nbg;
+                double const k = (double) nbg;
+                double const a0 = a;
+                a += (val - a) / k;
+                q += (val - a0) * (val - a);
+            }
+        }
+
+        if (nbg < 10) // only possible after the first iteration
+        {
+            bg->tooFew = true;
+            break;
+        }
+
+        prev_mean_bg = mean_bg;
+        mean_bg = sum / (double) nbg;
+        sigma2_bg = q / (double) (nbg - 1);
+        sigma_bg = sqrt(sigma2_bg);
+
+        if (iter > 0 && fabs(mean_bg - prev_mean_bg) < 0.5)
+            break;
+
+        std::copy(mask, mask + nwords, prev_mask);
+    }
+
+    bg->mean = mean_bg;
+    bg->sigma = sigma_bg;
+    bg->sigma2 = sigma2_bg;
+    bg->nbg = nbg;
+}
+
+void StarAnnulusBackground(StarBackground *bg, const unsigned short *img, int rowsize, int px, int py, int A, int B, int minx,
+                           int miny, int maxx, int maxy)
+{
+    if ((2 * B + 1) * (2 * B + 1) <= MAX_ANNULUS_PIXELS)
+    {
+#if PHD_SIMD_X86
+        switch (SimdGetLevel())
+        {
+        case SIMD_AVX2:
+            AnnulusBackgroundGathered(bg, img, rowsize, px, py, A, B, minx, miny, maxx, maxy, ClipMaskAVX2);
+            return;
+        case SIMD_SSE2:
+            AnnulusBackgroundGathered(bg, img, rowsize, px, py, A, B, minx, miny, maxx, maxy, ClipMaskSSE2);
+            return;
+        default:
+            break;
+        }
+#else
+        AnnulusBackgroundGathered(bg, img, rowsize, px, py, A, B, minx, miny, maxx, maxy, ClipMaskScalar);
+        return;
+#endif
+    }
+
+    AnnulusBackgroundScalar(bg, img, rowsize, px, py, A, B, minx, miny, maxx, maxy);
+}
+
+/*************      aperture centroid      **************************/
+
+static void ApertureCentroidScalar(StarCentroid *c, std::vector<R2M> *pixels, const unsigned short *img, int rowsize, int px,
+                                   int py, int A, unsigned short thresh, double mean_bg, int minx, int miny, int maxx, int maxy)
+{
+    int const A2 = A * A;
+
+    int start_x = std::max(px - A, minx);
+    int end_x = std::min(px + A, maxx);
+    int start_y = std::max(py - A, miny);
+    int end_y = std::min(py + A, maxy);
+
+    double cx = 0.0;
+    double cy = 0.0;
+    double mass = 0.0;
+    unsigned int n = 0;
+
+    const unsigned short *row = img + rowsize * start_y;
+    for (int y = start_y; y <= end_y; y++, row += rowsize)
+    {
+        int dy = y - py;
+        int dy2 = dy * dy;
+        if (dy2 > A2)
+            continue;
+
+        for (int x = start_x; x <= end_x; x++)
+        {
+            int dx = x - px;
+
+            // exclude points outside aperture
+            if (dx * dx + dy2 > A2)
+                continue;
+
+            // exclude points below threshold
+            unsigned short val = row[x];
+            if (val < thresh)
+                continue;
+
+            double const d = (double) val - mean_bg;
+
+            cx += dx * d;
+            cy += dy * d;
+            mass += d;
+            ++n;
+
+            pixels->push_back(R2M(x, y, d));
+        }
+    }
+
+    c->cx = cx;
+    c->cy = cy;
+    c->mass = mass;
+    c->n = n;
+}
+
+#if PHD_SIMD_X86
+
+// Threshold the pixels of each aperture row span eight at a time and accumulate the
+// selected pixels in raster order, exactly as the scalar version does.
+PHD_TARGET_SSE2 static void ApertureCentroidSSE2(StarCentroid *c, std::vector<R2M> *pixels, const unsigned short *img,
+                                                 int rowsize, int px, int py, int A, unsigned short thresh, double mean_bg,
+                                                 int minx, int miny, int maxx, int maxy)
+{
+    int const A2 = A * A;
+
+    int start_y = std::max(py - A, miny);
+    int end_y = std::min(py + A, maxy);
+
+    __m128i const vthresh = _mm_set1_epi16((short) thresh);
+    __m128i const zero = _mm_setzero_si128();
+
+    double cx = 0.0;
+    double cy = 0.0;
+    double mass = 0.0;
+    unsigned int n = 0;
+
+    for (int y = start_y; y <= end_y; y++)
+    {
+        const unsigned short *row = img + rowsize * y;
+        int dy = y - py;
+        int ax = isqrt(A2 - dy * dy);
+        int x0 = std::max(px - ax, minx);
+        int x1 = std::min(px + ax, maxx);
+
+        for (int x = x0; x <= x1; x += 8)
+        {
+            unsigned int bits;
+            if (x + 7 <= x1)
+            {
+                // val >= thresh  <=>  thresh - val saturates to zero
+                __m128i below = _mm_subs_epu16(vthresh, _mm_loadu_si128((const __m128i *) (row + x)));
+                bits = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi16(below, zero)) & 0x5555;
+            }
+            else
+            {
+                bits = 0;
+                for (int i = 0; x + i <= x1; i++)
+                    if (row[x + i] >= thresh)
+                        bits |= 1U << (2 * i);
+            }
+
+            for (int i = 0; bits; i++, bits >>= 2)
+            {
+                if (!(bits & 1))
+                    continue;
+
+                int dx = x + i - px;
+                double const d = (double) row[x + i] - mean_bg;
+
+                cx += dx * d;
+                cy += dy * d;
+                mass += d;
+                ++n;
+
+                pixels->push_back(R2M(x + i, y, d));
+            }
+        }
+    }
+
+    c->cx = cx;
+    c->cy = cy;
+    c->mass = mass;
+    c->n = n;
+}
+
+#endif // PHD_SIMD_X86
+
+void StarApertureCentroid(StarCentroid *c, std::vector<R2M> *pixels, const unsigned short *img, int rowsize, int px, int py,
+                          int A, unsigned short thresh, double mean_bg, int minx, int miny, int maxx, int maxy)
+{
+#if PHD_SIMD_X86
+    // the 128-bit threshold test is all that pays off for an aperture this small, so
+    // the AVX2 level uses it as well
+    if (SimdGetLevel() >= SIMD_SSE2)
+    {
+        ApertureCentroidSSE2(c, pixels, img, rowsize, px, py, A, thresh, mean_bg, minx, miny, maxx, maxy);
+        return;
+    }
+#endif
+    ApertureCentroidScalar(c, pixels, img, rowsize, px, py, A, thresh, mean_bg, minx, miny, maxx, maxy);
+}
+
+/*************      half flux radius      **************************/
+
+double StarHFR(std::vector<R2M>& vec, double cx, double cy, double mass)
+{
+    if (vec.size() == 1) // hot pixel?
+        return 0.25;
+
+    // compute Half Flux Radius (HFR)
+    for (auto it = vec.begin(); it != vec.end(); ++it)
+    {
+        double dx = (double) it->x - cx;
+        double dy = (double) it->y - cy;
+        it->r2 = dx * dx + dy * dy;
+    }
+    std::sort(vec.begin(), vec.end()); // sort by ascending radius^2
+
+    // find radius of half-mass
+    double r20, r21, m0, m1;
+    r20 = r21 = m0 = m1 = 0.0;
+    double halfm = 0.5 * mass;
+    for (auto it = vec.begin(); it != vec.end(); ++it)
+    {
+        const R2M& rm = *it;
+        r20 = r21;
+        m0 = m1;
+        r21 = rm.r2;
+        m1 += rm.m;
+        if (m1 > halfm)
+            break;
+    }
+
+    // interpolate
+    double hfr;
+    if (m1 > m0)
+    {
+        double r0 = sqrt(r20), r1 = sqrt(r21);
+        double s = (r1 - r0) / (m1 - m0);
+        hfr = r0 + s * (halfm - m0);
+    }
+    else
+        hfr = 0.25;
+
+    return hfr;
+}
+
+StarFindStatus StarFind(StarFindOutput *out, std::vector<R2M> *hfrvec, const unsigned short *img, int rowsize,
+                        const StarFindParams& params, int base_x, int base_y)
+{
+    int const minx = params.minx, miny = params.miny, maxx = params.maxx, maxy = params.maxy;
+
+    out->x = base_x;
+    out->y = base_y;
+    out->mass = 0.0;
+    out->snr = 0.0;
+    out->hfd = 0.0;
+    out->peakVal = 0;
+    out->bg = StarBackground();
+    out->smoothedPeak = 0;
+    out->thresh = 0;
+    out->n = 0;
+    out->falseStar = false;
+
+    // search region bounds
+    int start_x = std::max(base_x - params.searchRegion, minx);
+    int end_x = std::min(base_x + params.searchRegion, maxx);
+    int start_y = std::max(base_y - params.searchRegion, miny);
+    int end_y = std::min(base_y + params.searchRegion, maxy);
+
+    if (end_x <= start_x || end_y <= start_y)
+        return STAR_FIND_ERROR; // coordinates are invalid
+
+    int peak_x = 0, peak_y = 0;
+    unsigned int peak_val = 0;
+    unsigned short max3[3] = { 0, 0, 0 };
+
+    if (params.peakMode)
+    {
+        for (int y = start_y; y <= end_y; y++)
+        {
+            for (int x = start_x; x <= end_x; x++)
+            {
+                unsigned short val = img[y * rowsize + x];
+
+                if (val > peak_val)
+                {
+                    peak_val = val;
+                    peak_x = x;
+                    peak_y = y;
+                }
+            }
+        }
+
+        out->peakVal = (unsigned short) peak_val;
+    }
+    else
+    {
+        // find the peak value within the search region using a smoothing function
+        // also check for saturation
+
+        StarPeak peak = { 0, 0, 0, { 0, 0, 0 } };
+        StarSmoothedPeak(&peak, img, rowsize, start_x + 1, start_y + 1, end_x - 1, end_y - 1);
+
+        peak_x = peak.x;
+        peak_y = peak.y;
+        peak_val = peak.val;
+        max3[0] = peak.max3[0];
+        max3[1] = peak.max3[1];
+        max3[2] = peak.max3[2];
+
+        out->peakVal = max3[0]; // raw peak val
+        peak_val /= 16; // smoothed peak value
+    }
+
+    out->smoothedPeak = peak_val;
+
+    // measure noise in the annulus with inner radius A and outer radius B
+    int const A = 7; // inner radius
+    int const B = 12; // outer radius
+
+    // find the mean and stdev of the background
+
+    StarBackground& bg = out->bg;
+    StarAnnulusBackground(&bg, img, rowsize, peak_x, peak_y, A, B, minx, miny, maxx, maxy);
+
+    unsigned short thresh;
+
+    double cx = 0.0;
+    double cy = 0.0;
+    double mass = 0.0;
+    unsigned int n;
+
+    hfrvec->clear();
+
+    if (params.peakMode)
+    {
+        mass = peak_val;
+        n = 1;
+        thresh = 0;
+    }
+    else
+    {
+        thresh = (unsigned short) (bg.mean + 3.0 * bg.sigma + 0.5);
+
+        // find pixels over threshold within aperture; compute mass and centroid
+
+        StarCentroid c;
+        StarApertureCentroid(&c, hfrvec, img, rowsize, peak_x, peak_y, A, thresh, bg.mean, minx, miny, maxx, maxy);
+
+        cx = c.cx;
+        cy = c.cy;
+        mass = c.mass;
+        n = c.n;
+    }
+
+    out->thresh = thresh;
+    out->n = n;
+    out->mass = mass;
+
+    // SNR estimate from: Measuring the Signal-to-Noise Ratio S/N of the CCD Image of a Star or Nebula, J.H.Simonetti, 2004
+    // January 8
+    //     http://www.phys.vt.edu/~jhs/phys3154/snr20040108.pdf
+    double const gain = .5; // electrons per ADU, nominal
+    double snr = n > 0 ? mass / sqrt(mass / gain + bg.sigma2 * (double) n * (1.0 + 1.0 / (double) bg.nbg)) : 0.0;
+
+    double const LOW_SNR = 3.0;
+
+    // a few scattered pixels over threshold can give a false positive
+    // avoid this by requiring the smoothed peak value to be above the threshold
+    if (peak_val <= thresh && snr >= LOW_SNR)
+    {
+        out->falseStar = true;
+        snr = LOW_SNR - 0.1;
+    }
+
+    out->snr = snr;
+
+    if (mass < 10.0)
+        return STAR_FIND_LOWMASS;
+
+    if (snr < LOW_SNR)
+        return STAR_FIND_LOWSNR;
+
+    out->x = peak_x + cx / mass;
+    out->y = peak_y + cy / mass;
+
+    out->hfd = 2.0 * StarHFR(*hfrvec, out->x, out->y, mass);
+
+    // Check for constraints on HFD value
+    if (!params.peakMode)
+    {
+        if (out->hfd < params.minHFD)
+            return STAR_FIND_LOWHFD;
+        if (out->hfd > params.maxHFD)
+            return STAR_FIND_HIHFD;
+    }
+
+    // check for saturation
+
+    unsigned int mx = (unsigned int) max3[0];
+
+    // remove pedestal
+    if (mx >= params.pedestal)
+        mx -= params.pedestal;
+    else
+        mx = 0; // unlikely
+
+    if (params.maxADU > 0)
+    {
+        // maxADU is known
+        return mx >= params.maxADU ? STAR_FIND_SATURATED : STAR_FIND_OK;
+    }
+
+    // maxADU not known, use the "flat-top" heuristic
+    //
+    // even at saturation, the max values may vary a bit due to noise
+    // Call it saturated if the the top three values are within 32 parts per 65535 of max for 16-bit cameras,
+    // or within 1 part per 191 for 8-bit cameras
+    unsigned int d = (unsigned int) (max3[0] - max3[2]);
+
+    if (params.bitsPerPixel < 12)
+    {
+        if (d * 191U < 1U * mx)
+            return STAR_FIND_SATURATED;
+    }
+    else
+    {
+        if (d * 65535U < 32U * mx)
+            return STAR_FIND_SATURATED;
+    }
+
+    return STAR_FIND_OK;
+}
@@ -0,0 +1,152 @@
+/*
+ *  star_kernels.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef STAR_KERNELS_INCLUDED
+#define STAR_KERNELS_INCLUDED
+
+#include <vector>
+
+// Pixel kernels used by Star::Find.
+//
+// Each kernel has a scalar reference implementation and SSE2/AVX2
+// implementations selected at run time (see simd.h); all implementations give
+// bit-identical results.
+
+// per-pixel mass and squared radius for the half-flux radius calculation
+struct R2M
+{
+    double r2;
+    int x;
+    int y;
+    double m;
+    R2M() { }
+    R2M(int x_, int y_, double m_) : x(x_), y(y_), m(m_) { }
+    bool operator<(const R2M& rhs) const { return r2 < rhs.r2; }
+};
+
+struct StarPeak
+{
+    int x;
+    int y;
+    unsigned int val; // 16x the smoothed peak value
+    unsigned short max3[3]; // three largest raw pixel values, descending
+};
+
+struct StarBackground
+{
+    double mean;
+    double sigma;
+    double sigma2;
+    unsigned int nbg; // pixels in the final iteration
+    bool tooFew; // the last iteration had fewer than 10 background pixels
+};
+
+struct StarCentroid
+{
+    double cx; // mass-weighted offset from the peak
+    double cy;
+    double mass;
+    unsigned int n;
+};
+
+// Search the rectangle [x0,x1] x [y0,y1] for the peak of the image smoothed with a
+// 3x3 [1 2 1] kernel. The rectangle must have a one pixel margin inside the image.
+// peak is both input and output so the search can be continued; initialize it with
+// val = 0 and max3 = {0, 0, 0}.
+extern void StarSmoothedPeak(StarPeak *peak, const unsigned short *img, int rowsize, int x0, int y0, int x1, int y1);
+
+// Sigma-clipped mean and standard deviation of the background in the annulus
+// A^2 < r^2 <= B^2 around (px, py), restricted to the bounds [minx,maxx] x [miny,maxy].
+extern void StarAnnulusBackground(StarBackground *bg, const unsigned short *img, int rowsize, int px, int py, int A, int B,
+                                  int minx, int miny, int maxx, int maxy);
+
+// Mass and centroid of the pixels at or above thresh within radius A of (px, py),
+// restricted to the bounds [minx,maxx] x [miny,maxy]. The contributing pixels are
+// appended to pixels for the half-flux radius calculation.
+extern void StarApertureCentroid(StarCentroid *c, std::vector<R2M> *pixels, const unsigned short *img, int rowsize, int px,
+                                 int py, int A, unsigned short thresh, double mean_bg, int minx, int miny, int maxx, int maxy);
+
+// half-flux radius of the pixels around the centroid (cx, cy)
+extern double StarHFR(std::vector<R2M>& vec, double cx, double cy, double mass);
+
+// Result of StarFind(), with the same values as Star::FindResult
+enum StarFindStatus
+{
+    STAR_FIND_OK = 0,
+    STAR_FIND_SATURATED = 1,
+    STAR_FIND_LOWSNR = 2,
+    STAR_FIND_LOWMASS = 3,
+    STAR_FIND_LOWHFD = 4,
+    STAR_FIND_HIHFD = 5,
+    STAR_FIND_ERROR = 8,
+};
+
+struct StarFindParams
+{
+    int minx; // bounds of the image or subframe, inclusive
+    int miny;
+    int maxx;
+    int maxy;
+    int searchRegion;
+    bool peakMode; // locate the brightest pixel instead of the centroid
+    double minHFD;
+    double maxHFD;
+    unsigned short maxADU; // saturation level, 0 when it is not known
+    unsigned short pedestal; // added by dark subtraction
+    unsigned char bitsPerPixel;
+};
+
+struct StarFindOutput
+{
+    double x; // the star position, or the starting position when it was not measured
+    double y;
+    double mass;
+    double snr;
+    double hfd;
+    unsigned short peakVal; // raw peak value
+
+    // details for the caller's log
+    StarBackground bg;
+    unsigned int smoothedPeak;
+    unsigned short thresh;
+    unsigned int n; // pixels in the aperture over the threshold
+    bool falseStar; // scattered pixels over the threshold, SNR was lowered
+};
+
+// The measurement made by Star::Find: locate the star within searchRegion of
+// (base_x, base_y), measure the background, centroid, SNR and HFD, and check
+// the HFD limits and saturation. hfrvec is scratch space.
+extern StarFindStatus StarFind(StarFindOutput *out, std::vector<R2M> *hfrvec, const unsigned short *img, int rowsize,
+                               const StarFindParams& params, int base_x, int base_y);
+
+#endif // STAR_KERNELS_INCLUDED
@@ -175,10 +175,7 @@ static wxString arcsecs(double px, double sampling)
 
 void StatsWindow::UpdateStats(void)
 {
-    if (!m_visible)
-        return;
-
-    if (!pFrame || !pFrame->pGraphLog)
+    if (!m_visible || !pFrame || pFrame->IsHeadless() || !pFrame->pGraphLog)
         return;
 
     int length = pFrame->pGraphLog->GetLength();
@@ -280,7 +277,7 @@ static wxString fov(const wxSize& sensorFormat, double sampling)
 
 void StatsWindow::UpdateImageSize(const wxSize& frameSize)
 {
-    if (m_visible && frameSize != m_lastFrameSize)
+    if (m_visible && frameSize != m_lastFrameSize && !pFrame->IsHeadless())
     {
         wxString sensorStr = wxString::Format("%d x %d %s", frameSize.x, frameSize.y, _("px"));
         m_grid2->SetCellValue(m_frameSizeRow, 1, sensorStr);
@@ -144,7 +144,7 @@ void TargetWindow::AppendData(const GuideStepInfo& step)
 {
     m_pClient->AppendData(step);
 
-    if (this->m_visible)
+    if (this->m_visible && !pFrame->IsHeadless())
     {
         Refresh();
     }
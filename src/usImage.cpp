@@ -34,77 +34,11 @@
 
 #include "phd.h"
 #include "image_math.h"
+#include "denoise_kernels.h"
+#include "display_kernels.h"
 
 #include <algorithm>
-
-class HistogramBuilder
-{
-public:
-    int *histo;
-    unsigned short MinADU, MaxADU;
-    int pixCount;
-
-    HistogramBuilder()
-    {
-        histo = new int[65536];
-        MinADU = 0;
-        MaxADU = 0;
-        pixCount = 0;
-    }
-
-    ~HistogramBuilder() { delete[] histo; }
-
-    unsigned short median() const
-    {
-        int pixelLeft = pixCount / 2;
-
-        for (int i = MinADU; i < MaxADU; ++i)
-        {
-            if (histo[i] > pixelLeft)
-            {
-                return i;
-            }
-            pixelLeft -= histo[i];
-        }
-        return MaxADU;
-    }
-
-    void scan(const unsigned short *t, int len)
-    {
-        if (pixCount == 0)
-        {
-            unsigned short v = t[0];
-            // Initialization
-            MinADU = t[0];
-            MaxADU = t[0];
-            histo[t[0]] = 0;
-        }
-
-        for (int i = 0; i < len; ++i)
-        {
-            unsigned short v = t[i];
-            if (v < MinADU)
-            {
-                for (int k = v; k < MinADU; ++k)
-                {
-                    histo[k] = 0;
-                }
-                MinADU = v;
-            }
-            if (v > MaxADU)
-            {
-                for (int k = MaxADU + 1; k <= v; ++k)
-                {
-                    histo[k] = 0;
-                }
-                MaxADU = v;
-            }
-            histo[v]++;
-        }
-
-        pixCount += len;
-    }
-};
+#include <vector>
 
 bool usImage::Init(const wxSize& size)
 {
@@ -144,114 +78,40 @@ void usImage::SwapImageData(usImage& other)
     other.ImageData = t;
 }
 
+void usImage::ResetForReuse()
+{
+    // reset everything except the pixel buffer so a recycled image looks like a new one
+    Subframe = wxRect(0, 0, 0, 0);
+    LimitFrame = wxRect();
+    MinADU = MaxADU = MedianADU = 0;
+    FiltMin = FiltMax = 0;
+    ImgStartTime = wxDateTime();
+    ImgExpDur = 0;
+    ImgStackCnt = 1;
+    Binning = 0;
+    BitsPerPixel = 0;
+    Gain = 0;
+    Pedestal = 0;
+    FrameNum = 0;
+    CaptureTime = 0;
+    MoveOverlap = 0;
+}
+
 void usImage::CalcStats()
 {
     if (!ImageData || !NPixels)
         return;
 
-    MinADU = 65535;
-    MaxADU = 0;
-    FiltMin = 65535;
-    FiltMax = 0;
+    wxRect const rect = Subframe.IsEmpty() ? wxRect(Size) : Subframe;
 
-    if (Subframe.IsEmpty())
-    {
-        // full frame, no subframe
-
-        HistogramBuilder hb;
-        hb.scan(ImageData, NPixels);
-        MinADU = hb.MinADU;
-        MaxADU = hb.MaxADU;
-        MedianADU = hb.median();
-
-        unsigned short *tmpdata = new unsigned short[NPixels];
-
-        Median3(tmpdata, ImageData, Size, wxRect(Size));
-
-        const unsigned short *src = tmpdata;
-        for (unsigned int i = 0; i < NPixels; i++)
-        {
-            unsigned short d = *src++;
-            if (d < FiltMin)
-                FiltMin = d;
-            if (d > FiltMax)
-                FiltMax = d;
-        }
-
-        delete[] tmpdata;
-    }
-    else
-    {
-        // Subframe
-
-        unsigned int pixcnt = Subframe.width * Subframe.height;
-        unsigned short *tmpdata = new unsigned short[pixcnt];
-
-        unsigned short *dst;
-
-        dst = tmpdata;
-        for (int y = 0; y < Subframe.height; y++)
-        {
-            const unsigned short *src = ImageData + Subframe.x + (Subframe.y + y) * Size.GetWidth();
-            for (int x = 0; x < Subframe.width; x++)
-            {
-                unsigned short d = *src;
-                *dst++ = *src++;
-            }
-        }
-
-        HistogramBuilder hb;
-        hb.scan(tmpdata, pixcnt);
-        MinADU = hb.MinADU;
-        MaxADU = hb.MaxADU;
-        MedianADU = hb.median();
+    DenoiseStats stats;
+    DenoiseImageStats(&stats, ImageData + rect.y * Size.GetWidth() + rect.x, Size.GetWidth(), rect.width, rect.height);
 
-        dst = new unsigned short[pixcnt];
-
-        Median3(dst, tmpdata, Subframe.GetSize(), wxRect(Subframe.GetSize()));
-
-        const unsigned short *src = dst;
-        for (unsigned int i = 0; i < pixcnt; i++)
-        {
-            unsigned short d = *src++;
-            if (d < FiltMin)
-                FiltMin = d;
-            if (d > FiltMax)
-                FiltMax = d;
-        }
-
-        delete[] dst;
-        delete[] tmpdata;
-    }
-}
-
-static unsigned char *buildGammaLookupTable(int blevel, int wlevel, double power)
-{
-    unsigned char *result = new unsigned char[0x10000];
-
-    if (blevel < 0)
-        blevel = 0;
-    if (wlevel < 0)
-        wlevel = 0;
-    if (blevel > 0xffff)
-        blevel = 0xffff;
-    if (wlevel > 0xffff)
-        blevel = 0xffff;
-
-    for (int i = 0; i <= blevel; ++i)
-        result[i] = 0;
-
-    float range = wlevel - blevel;
-    for (int i = blevel + 1; i < wlevel; ++i)
-    {
-        float d = (i - blevel) / range;
-        result[i] = pow(d, (float) power) * 255.0;
-    }
-
-    for (int i = wlevel; i < 0x10000; ++i)
-        result[i] = 255;
-
-    return result;
+    MinADU = stats.minADU;
+    MaxADU = stats.maxADU;
+    MedianADU = stats.medianADU;
+    FiltMin = stats.filtMin;
+    FiltMax = stats.filtMax;
 }
 
 bool usImage::CopyToImage(wxImage **rawimg, int blevel, int wlevel, double power)
@@ -265,21 +125,12 @@ bool usImage::CopyToImage(wxImage **rawimg, int blevel, int wlevel, double power
         img = new wxImage(Size.GetWidth(), Size.GetHeight(), false);
     }
 
-    unsigned char *ImgPtr = img->GetData();
-    unsigned short *RawPtr = ImageData;
-
-    unsigned char *lutTable = buildGammaLookupTable(blevel, wlevel, power);
-
-    for (unsigned int i = 0; i < NPixels; i++, RawPtr++)
-    {
-        unsigned short v = *RawPtr;
-        unsigned char d = lutTable[v];
-        *ImgPtr++ = d;
-        *ImgPtr++ = d;
-        *ImgPtr++ = d;
-    }
+    std::vector<unsigned char> lut(DISPLAY_LUT_SIZE);
+    DisplayBuildLut(&lut[0], blevel, wlevel, power);
 
-    delete[] lutTable;
+    int const w = Size.GetWidth();
+    int const h = Size.GetHeight();
+    DisplayRender(img->GetData(), w, h, ImageData, w, h, &lut[0], 0, 0, w, h);
 
     *rawimg = img;
     return false;
@@ -56,10 +56,12 @@ public:
     unsigned int Gain;
     unsigned short Pedestal;
     unsigned int FrameNum;
+    unsigned int CaptureTime; // milli-seconds from the start of the exposure request until the image was ready
+    unsigned int MoveOverlap; // milli-seconds of the exposure during which a pipelined mount move was running
 
     usImage()
         : ImageData(nullptr), NPixels(0), MinADU(0), MaxADU(0), MedianADU(0), FiltMin(0), FiltMax(0), ImgExpDur(0),
-          ImgStackCnt(1), Binning(0), BitsPerPixel(0), Gain(0), Pedestal(0), FrameNum(0)
+          ImgStackCnt(1), Binning(0), BitsPerPixel(0), Gain(0), Pedestal(0), FrameNum(0), CaptureTime(0), MoveOverlap(0)
     {
     }
     ~usImage() { delete[] ImageData; }
@@ -67,6 +69,7 @@ public:
     bool Init(const wxSize& size);
     bool Init(int width, int height) { return Init(wxSize(width, height)); }
     void SwapImageData(usImage& other);
+    void ResetForReuse();
     void CalcStats();
     void InitImgStartTime();
     bool CopyFrom(const usImage& src);
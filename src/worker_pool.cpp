@@ -0,0 +1,214 @@
+/*
+ *  worker_pool.cpp
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct WorkerPoolState
+{
+    std::mutex submit_lock; // serializes callers of Run()
+
+    std::mutex lock; // protects the fields below
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned int> threadCount; // size of threads, readable without the lock
+    bool terminate;
+    unsigned int generation; // incremented for each batch of work
+
+    // current batch
+    const std::function<void(int)> *fn;
+    int count;
+    std::atomic<int> next;
+    unsigned int busy; // workers still running the current batch
+
+    WorkerPoolState() : threadCount(0), terminate(false), generation(0), fn(nullptr), count(0), next(0), busy(0) { }
+};
+
+static WorkerPoolState s_wp;
+
+// true on the pool threads and on a thread that is currently running a batch
+static thread_local bool s_inWorker;
+
+static void RunItems(const std::function<void(int)>& fn, int count)
+{
+    int i;
+    while ((i = s_wp.next.fetch_add(1)) < count)
+        fn(i);
+}
+
+// seen is the batch generation when the pool was started, so that a pool
+// restarted by Init() does not pick up the batch last run by the previous threads
+static void WorkerMain(unsigned int seen)
+{
+    s_inWorker = true;
+
+    while (true)
+    {
+        const std::function<void(int)> *fn;
+        int count;
+        {
+            std::unique_lock<std::mutex> lk(s_wp.lock);
+            s_wp.work_cv.wait(lk, [&seen] { return s_wp.terminate || s_wp.generation != seen; });
+            if (s_wp.terminate)
+                break;
+            seen = s_wp.generation;
+            fn = s_wp.fn;
+            count = s_wp.count;
+        }
+
+        RunItems(*fn, count);
+
+        {
+            std::lock_guard<std::mutex> lk(s_wp.lock);
+            if (--s_wp.busy == 0)
+                s_wp.done_cv.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Init(unsigned int threads)
+{
+    Destroy();
+
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::lock_guard<std::mutex> submit(s_wp.submit_lock);
+
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lk(s_wp.lock);
+        s_wp.terminate = false;
+        s_wp.fn = nullptr;
+        s_wp.count = 0;
+        s_wp.busy = 0;
+        generation = s_wp.generation;
+    }
+
+    for (unsigned int i = 1; i < threads; i++)
+        s_wp.threads.emplace_back(WorkerMain, generation);
+    s_wp.threadCount = s_wp.threads.size();
+}
+
+void WorkerPool::Destroy()
+{
+    std::lock_guard<std::mutex> submit(s_wp.submit_lock);
+
+    s_wp.threadCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lk(s_wp.lock);
+        s_wp.terminate = true;
+    }
+    s_wp.work_cv.notify_all();
+
+    for (auto& t : s_wp.threads)
+        t.join();
+    s_wp.threads.clear();
+}
+
+unsigned int WorkerPool::ThreadCount()
+{
+    return s_wp.threadCount + 1;
+}
+
+void WorkerPool::Run(int count, const std::function<void(int)>& fn)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || s_inWorker || s_wp.threadCount == 0)
+    {
+        for (int i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(s_wp.submit_lock);
+
+    if (s_wp.threads.empty()) // destroyed while we were waiting
+    {
+        for (int i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(s_wp.lock);
+        s_wp.fn = &fn;
+        s_wp.count = count;
+        s_wp.next = 0;
+        s_wp.busy = s_wp.threads.size();
+        ++s_wp.generation;
+    }
+    s_wp.work_cv.notify_all();
+
+    s_inWorker = true;
+    RunItems(fn, count);
+    s_inWorker = false;
+
+    std::unique_lock<std::mutex> lk(s_wp.lock);
+    s_wp.done_cv.wait(lk, [] { return s_wp.busy == 0; });
+    s_wp.fn = nullptr;
+}
+
+int WorkerPool::BandCount(int rows, int minRows)
+{
+    if (rows <= 0)
+        return 0;
+
+    // a few bands per thread so that uneven bands balance out
+    return std::max(std::min((int) ThreadCount() * 4, rows / std::max(minRows, 1)), 1);
+}
+
+void WorkerPool::RunRows(int y0, int y1, int minRows, const std::function<void(int, int)>& fn)
+{
+    int const rows = y1 - y0;
+    int const bands = BandCount(rows, minRows);
+    if (bands == 0)
+        return;
+    if (bands == 1)
+    {
+        fn(y0, y1);
+        return;
+    }
+
+    Run(bands, [&](int i) { fn(y0 + (int) ((long long) rows * i / bands), y0 + (int) ((long long) rows * (i + 1) / bands)); });
+}
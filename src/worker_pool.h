@@ -0,0 +1,71 @@
+/*
+ *  worker_pool.h
+ *  PHD2 Guiding
+ *
+ *  Copyright (c) 2026 openphdguiding.org
+ *  All rights reserved.
+ *
+ *  This source code is distributed under the following "BSD" license
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *    Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *    Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *    Neither the name of OpenPHDGuiding.org nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef WORKER_POOL_INCLUDED
+#define WORKER_POOL_INCLUDED
+
+#include <functional>
+
+// A fixed set of worker threads for data-parallel image processing.
+//
+// Work is submitted as a range of independent items; the calling thread takes
+// part in the work and Run() returns once every item has been processed. Only
+// one range is in flight at a time: concurrent callers are serialized, and a
+// call made from inside a work item runs inline on the calling worker.
+//
+// When the pool has not been initialized (or has a single thread) all work
+// runs on the calling thread.
+class WorkerPool
+{
+public:
+    // Start the pool with the given number of threads including the caller;
+    // 0 selects the number of hardware threads.
+    static void Init(unsigned int threads = 0);
+    static void Destroy();
+
+    static unsigned int ThreadCount();
+
+    // Call fn(i) for each i in [0, count)
+    static void Run(int count, const std::function<void(int)>& fn);
+
+    // Number of bands of at least minRows rows that RunRows() splits a range
+    // of rows into
+    static int BandCount(int rows, int minRows);
+
+    // Split rows [y0, y1) into bands of at least minRows rows and call
+    // fn(band_y0, band_y1) for each band. Bands do not overlap and are
+    // visited in no particular order.
+    static void RunRows(int y0, int y1, int minRows, const std::function<void(int, int)>& fn);
+};
+
+#endif // WORKER_POOL_INCLUDED
@@ -67,6 +67,67 @@ void WorkerThread::EnqueueMessage(const WORKER_THREAD_REQUEST& message)
     assert(queueError == wxMSGQUEUE_NO_ERROR);
 }
 
+/*************      Move pipeline      **************************/
+
+MovePipeline::MovePipeline() : m_cond(m_lock), m_queued(0), m_moving(false), m_overlap(true), m_moveStart(0), m_busyTime(0) { }
+
+void MovePipeline::MoveQueued()
+{
+    wxMutexLocker lock(m_lock);
+    ++m_queued;
+}
+
+void MovePipeline::MoveStarted(bool overlap)
+{
+    wxMutexLocker lock(m_lock);
+    --m_queued;
+    m_moving = true;
+    m_overlap = overlap;
+    m_moveStart = m_clock.Time();
+    m_cond.Broadcast();
+}
+
+void MovePipeline::MoveFinished()
+{
+    wxMutexLocker lock(m_lock);
+    m_moving = false;
+    m_busyTime += m_clock.Time() - m_moveStart;
+    m_cond.Broadcast();
+}
+
+unsigned int MovePipeline::WaitForMoveStart(int delay)
+{
+    enum
+    {
+        MAX_WAIT = 100
+    };
+
+    wxMutexLocker lock(m_lock);
+
+    while (true)
+    {
+        long wait;
+        if (m_queued > 0 || (m_moving && !m_overlap))
+            wait = MAX_WAIT;
+        else if (m_moving && m_clock.Time() - m_moveStart < delay)
+            wait = wxMin(delay - (m_clock.Time() - m_moveStart), (long) MAX_WAIT);
+        else
+            return 0;
+
+        m_cond.WaitTimeout(wait);
+
+        unsigned int val = WorkerThread::InterruptRequested() & WorkerThread::INT_ANY;
+        if (val)
+            return val;
+    }
+}
+
+long MovePipeline::BusyTime()
+{
+    wxMutexLocker lock(m_lock);
+    return m_moving ? m_busyTime + m_clock.Time() - m_moveStart : m_busyTime;
+}
+
 /*************      Terminate      **************************/
 
 void WorkerThread::EnqueueWorkerThreadTerminateRequest(void)
@@ -176,13 +237,28 @@ static void CameraROITest(usImage *img)
 bool WorkerThread::HandleExpose(EXPOSE_REQUEST *req)
 {
     bool bError = false;
+    wxStopWatch swatch;
 
     try
     {
+        TimingProbe delayProbe(GuideTiming::STAGE_EXPOSURE_DELAY);
         if (WorkerThread::MilliSleep(m_pFrame->GetExposureDelay(), INT_ANY))
         {
             throw ERROR_INFO("Time lapse interrupted");
         }
+        delayProbe.Stop();
+
+        // with pipelined guiding the guide pulse for the previous frame may not have been issued yet
+        MovePipeline *pipeline = m_pFrame->m_movePipeline;
+        TimingProbe waitProbe(GuideTiming::STAGE_MOVE_WAIT, m_pFrame->GetPipelinedGuiding());
+        if (pipeline->WaitForMoveStart(m_pFrame->GetPipelineDelay()))
+        {
+            throw ERROR_INFO("Exposure interrupted waiting for move");
+        }
+        waitProbe.Stop();
+        long busyStart = pipeline->BusyTime();
+
+        TimingProbe captureProbe(GuideTiming::STAGE_CAPTURE);
 
         if (pCamera->HasNonGuiCapture())
         {
@@ -215,12 +291,17 @@ bool WorkerThread::HandleExpose(EXPOSE_REQUEST *req)
             req->pSemaphore = NULL;
         }
 
-        Debug.Write("Exposure complete\n");
+        captureProbe.Stop();
+        req->pImage->MoveOverlap = pipeline->BusyTime() - busyStart;
+
+        Debug.Write(wxString::Format("Exposure complete, %ld ms, move overlap %u ms\n", swatch.Time(),
+                                     req->pImage->MoveOverlap));
 
         if (!bError)
         {
             CameraROITest(req->pImage);
 
+            TimingProbe nrProbe(GuideTiming::STAGE_NOISE_REDUCTION, m_pFrame->GetNoiseReductionMethod() != NR_NONE);
             switch (m_pFrame->GetNoiseReductionMethod())
             {
             case NR_NONE:
@@ -232,8 +313,12 @@ bool WorkerThread::HandleExpose(EXPOSE_REQUEST *req)
                 Median3(*req->pImage);
                 break;
             }
+            nrProbe.Stop();
 
+            TimingProbe statsProbe(GuideTiming::STAGE_CALC_STATS);
             req->pImage->CalcStats();
+            statsProbe.Stop();
+            req->pImage->CaptureTime = swatch.Time();
         }
     }
     catch (const wxString& Msg)
@@ -255,7 +340,8 @@ void WorkerThread::SendWorkerThreadExposeComplete(usImage *pImage, bool bError)
 
 /*************      Move       **************************/
 
-void WorkerThread::EnqueueWorkerThreadMoveRequest(Mount *mount, const GuiderOffset& ofs, unsigned int moveOptions)
+void WorkerThread::EnqueueWorkerThreadMoveRequest(Mount *mount, const GuiderOffset& ofs, unsigned int moveOptions,
+                                                  MovePipeline *pipeline)
 {
     m_interruptRequested &= ~INT_STOP;
 
@@ -271,12 +357,16 @@ void WorkerThread::EnqueueWorkerThreadMoveRequest(Mount *mount, const GuiderOffs
     message.args.move.ofs = ofs;
     message.args.move.moveOptions = moveOptions;
     message.args.move.semaphore = nullptr;
+    message.args.move.pipeline = pipeline;
+
+    if (pipeline)
+        pipeline->MoveQueued();
 
     EnqueueMessage(message);
 }
 
 void WorkerThread::EnqueueWorkerThreadAxisMove(Mount *mount, const GUIDE_DIRECTION direction, int duration,
-                                               unsigned int moveOptions)
+                                               unsigned int moveOptions, MovePipeline *pipeline)
 {
     m_interruptRequested &= ~INT_STOP;
 
@@ -292,6 +382,10 @@ void WorkerThread::EnqueueWorkerThreadAxisMove(Mount *mount, const GUIDE_DIRECTI
     message.args.move.duration = duration;
     message.args.move.moveOptions = moveOptions;
     message.args.move.semaphore = nullptr;
+    message.args.move.pipeline = pipeline;
+
+    if (pipeline)
+        pipeline->MoveQueued();
 
     EnqueueMessage(message);
 }
@@ -299,6 +393,11 @@ void WorkerThread::EnqueueWorkerThreadAxisMove(Mount *mount, const GUIDE_DIRECTI
 void WorkerThread::HandleMove(MOVE_REQUEST *req)
 {
     Mount::MOVE_RESULT result = Mount::MOVE_OK;
+    wxStopWatch swatch;
+
+    // calibration and manual axis moves are not overlapped with an exposure
+    if (req->pipeline)
+        req->pipeline->MoveStarted(!req->axisMove);
 
     try
     {
@@ -362,14 +461,19 @@ void WorkerThread::HandleMove(MOVE_REQUEST *req)
             result = Mount::MOVE_ERROR;
     }
 
-    Debug.Write(wxString::Format("move complete, result=%d\n", result));
+    req->moveTime = swatch.Time();
+
+    if (req->pipeline)
+        req->pipeline->MoveFinished();
+
+    Debug.Write(wxString::Format("move complete, result=%d, %ld ms\n", result, req->moveTime));
 
     req->moveResult = result;
 }
 
 MoveCompleteEvent::MoveCompleteEvent(const MOVE_REQUEST& move)
     : wxThreadEvent(wxEVT_THREAD, MYFRAME_WORKER_THREAD_MOVE_COMPLETE), moveOptions(move.moveOptions), result(move.moveResult),
-      mount(move.mount)
+      mount(move.mount), moveTime(move.moveTime)
 {
 }
 
@@ -427,7 +531,7 @@ wxThread::ExitCode WorkerThread::Entry()
             if (m_skipSendExposeComplete)
             {
                 Debug.Write("worker thread skipping SendWorkerThreadExposeComplete\n");
-                delete message.args.expose.pImage; // should be null though
+                ImagePool::Release(message.args.expose.pImage);
                 message.args.expose.pImage = 0;
                 m_skipSendExposeComplete = false;
             }
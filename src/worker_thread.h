@@ -54,8 +54,15 @@ class MyFrame;
  * the work item by looking first on the high priority queue and then the low
  * priority queue.
  *
+ * With pipelined guiding enabled, the first mount's guide moves run on a third worker
+ * thread instead of the primary thread, so the next exposure can start while the guide
+ * pulse is still running. The MovePipeline tracks those moves so that the exposure can
+ * wait for the pulse to be issued and record how long the frame overlapped a move.
+ *
  */
 
+class MovePipeline;
+
 struct EXPOSE_REQUEST
 {
     usImage *pImage;
@@ -76,6 +83,8 @@ struct MOVE_REQUEST
     Mount::MOVE_RESULT moveResult;
     GuiderOffset ofs;
     wxSemaphore *semaphore;
+    MovePipeline *pipeline;
+    long moveTime; // milli-seconds
 };
 
 struct MoveCompleteEvent : public wxThreadEvent
@@ -83,10 +92,36 @@ struct MoveCompleteEvent : public wxThreadEvent
     unsigned int moveOptions;
     Mount::MOVE_RESULT result;
     Mount *mount;
+    long moveTime;
 
     MoveCompleteEvent(const MOVE_REQUEST& move);
 };
 
+class MovePipeline
+{
+    wxMutex m_lock;
+    wxCondition m_cond;
+    wxStopWatch m_clock;
+    int m_queued; // moves enqueued but not started
+    bool m_moving;
+    bool m_overlap; // the next exposure may start while the current move runs
+    long m_moveStart;
+    long m_busyTime; // total time of the completed moves
+
+public:
+    MovePipeline();
+
+    void MoveQueued();
+    void MoveStarted(bool overlap);
+    void MoveFinished();
+
+    // wait until no move is queued and the current move has been running for at least delay ms,
+    // or has finished if it does not allow an overlapping exposure
+    unsigned int WaitForMoveStart(int delay);
+    // total milli-seconds spent moving, the overlap of an exposure is the difference between two readings
+    long BusyTime();
+};
+
 class WorkerThread : public wxThread
 {
     // types and routines for the server->worker message queue
@@ -190,8 +225,10 @@ protected:
 
     /*************      Guide       **************************/
 public:
-    void EnqueueWorkerThreadMoveRequest(Mount *mount, const GuiderOffset& ofs, unsigned int moveOptions);
-    void EnqueueWorkerThreadAxisMove(Mount *mount, const GUIDE_DIRECTION direction, int duration, unsigned int moveOptions);
+    void EnqueueWorkerThreadMoveRequest(Mount *mount, const GuiderOffset& ofs, unsigned int moveOptions,
+                                        MovePipeline *pipeline = nullptr);
+    void EnqueueWorkerThreadAxisMove(Mount *mount, const GUIDE_DIRECTION direction, int duration, unsigned int moveOptions,
+                                     MovePipeline *pipeline = nullptr);
 
 protected:
     void HandleMove(MOVE_REQUEST *args);